@@ -116,6 +116,31 @@ typedef void callgraph_walk_func(ir_graph *g, void *env);
 FIRM_API void callgraph_walk(callgraph_walk_func *pre,
                              callgraph_walk_func *post, void *env);
 
+/**
+ * A function type for functions passed to callgraph_walk_scc().
+ *
+ * @param members  the graphs forming the strongly connected component
+ * @param n        number of graphs in @p members
+ * @param env      the environment passed to callgraph_walk_scc()
+ */
+typedef void callgraph_scc_func(ir_graph *const *members, size_t n,
+                                void *env);
+
+/**
+ * Walks over the strongly connected components of the callgraph bottom-up.
+ *
+ * Every graph of the irp is part of exactly one component. A component is
+ * visited only after all components containing its callees have been visited,
+ * so the callees of non-recursive calls are always processed before their
+ * callers. Graphs calling each other recursively form a single component.
+ *
+ * Expects a computed callgraph, see compute_callgraph().
+ *
+ * @param func  called once for every strongly connected component
+ * @param env   environment, passed to func
+ */
+FIRM_API void callgraph_walk_scc(callgraph_scc_func *func, void *env);
+
 /**
  * Compute the backedges that represent recursions and a looptree.
  */
@@ -77,6 +77,7 @@
 #include "firm_types.h"
 #include "heights.h"
 #include "ident.h"
+#include "ircache.h"
 #include "ircgopt.h"
 #include "ircons.h"
 #include "irconsconfirm.h"
@@ -263,6 +263,10 @@ typedef enum mtp_additional_properties {
 	mtp_temporary                   = 1u << 12,
 	/** marker used for oo analyses needing info whether method is constructor or not */
 	mtp_property_is_constructor     = 1u << 13,
+	/** This method is executed frequently. GCC: __attribute__((hot)). */
+	mtp_property_hot                = 1u << 14,
+	/** This method is executed rarely. GCC: __attribute__((cold)). */
+	mtp_property_cold               = 1u << 15,
 } mtp_additional_properties;
 ENUM_BITSET(mtp_additional_properties)
 
@@ -0,0 +1,100 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Content addressed cache for per-function compilation results.
+ */
+#ifndef FIRM_IR_IRCACHE_H
+#define FIRM_IR_IRCACHE_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "firm_types.h"
+
+#include "begin.h"
+
+/**
+ * @defgroup ircache Compilation Result Cache
+ *
+ * Maps a content hash of a graph to data produced from it, typically the
+ * optimized graph or the code emitted for it. The hash covers the canonical
+ * form of the graph (see ir_export_irg_canonical()), the graphs of all
+ * functions reachable from it, which inlining and interprocedural
+ * optimizations may copy from, the signatures of all entities and types they
+ * reference, the target fingerprint built from the target triple and the
+ * options passed to ir_target_option(), and a
+ * user supplied fingerprint for everything else that influences the result
+ * (optimization settings, compiler version, ...).
+ *
+ * Entries are stored as files in a directory. When the total size of the
+ * entries exceeds the size limit, the least recently used ones are removed.
+ * @{
+ */
+
+/** A compilation result cache. */
+typedef struct ir_cache_t ir_cache_t;
+
+/** Size of a buffer holding a cache key including the terminating 0. */
+#define IR_CACHE_KEY_SIZE 33
+
+/**
+ * Opens the cache stored in @p directory, which must exist.
+ *
+ * @param directory    the directory holding the cache entries
+ * @param max_size     the maximum total size of all entries in bytes
+ * @param fingerprint  describes the settings that influence the cached
+ *                     results, may be NULL
+ * @returns the cache
+ */
+FIRM_API ir_cache_t *ir_cache_open(char const *directory, size_t max_size,
+                                   char const *fingerprint);
+
+/**
+ * Writes back the usage information of @p cache and frees it.
+ *
+ * @returns 0 on success, other values if the index could not be written
+ */
+FIRM_API int ir_cache_close(ir_cache_t *cache);
+
+/**
+ * Computes the key of @p irg and stores it in @p key, which must have room
+ * for IR_CACHE_KEY_SIZE characters. This should be done before optimizing
+ * the graph. The graphs of all functions reachable from @p irg are hashed as
+ * well, so computing the key takes time linear in their total size.
+ *
+ * @returns 0 on success, other values if the graph could not be hashed
+ */
+FIRM_API int ir_cache_key(ir_cache_t const *cache, ir_graph *irg, char *key);
+
+/**
+ * Looks up the entry for @p key and marks it as recently used.
+ *
+ * @returns a file opened for reading the entry, or NULL if there is no entry
+ *          for @p key. The caller has to close the file.
+ */
+FIRM_API FILE *ir_cache_lookup(ir_cache_t *cache, char const *key);
+
+/**
+ * Stores @p size bytes at @p data as entry for @p key, replacing a previous
+ * entry, and evicts least recently used entries if the cache grows too large.
+ *
+ * @returns 0 on success, other values if the entry could not be written
+ */
+FIRM_API int ir_cache_store(ir_cache_t *cache, char const *key,
+                            void const *data, size_t size);
+
+/**
+ * Same as ir_cache_store() but stores the contents of @p data from its current
+ * position to its end.
+ */
+FIRM_API int ir_cache_store_file(ir_cache_t *cache, char const *key,
+                                 FILE *data);
+
+/** @} */
+
+#include "end.h"
+
+#endif
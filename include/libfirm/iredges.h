@@ -77,6 +77,16 @@ FIRM_API const ir_edge_t *get_irn_out_edge_next(const ir_node *irn,
  * A convenience iteration macro over all out edges of a node, which is safe
  * against alteration of the current edge.
  *
+ * The out edges are kept in a vector and removing an edge moves the last one
+ * into its slot.  Therefore the body may
+ *  - remove or redirect the current edge,
+ *  - remove or redirect edges that were already visited and
+ *  - add edges to @p irn, which are not visited.
+ * It must not remove or redirect any other edge that was not visited yet,
+ * including the next one: an already visited edge would be moved into its slot
+ * and visited twice.  This also rules out exchanging a user that refers to
+ * @p irn more than once, e.g. Add(irn, irn).
+ *
  * @param irn  The node.
  * @param edge An ir_edge_t pointer which shall be set to the current edge.
  * @param kind The kind of the edge.
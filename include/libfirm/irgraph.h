@@ -397,6 +397,16 @@ typedef enum ir_graph_properties_t {
 	IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE        = 1U << 11,
 	/** graph contains as many returns as possible */
 	IR_GRAPH_PROPERTY_MANY_RETURNS                   = 1U << 12,
+	/**
+	 * the inliner's size and call site summary of the graph may be reused.
+	 * It is not part of IR_GRAPH_PROPERTIES_ALL, so any pass confirming its
+	 * properties drops it.
+	 */
+	IR_GRAPH_PROPERTY_CONSISTENT_INLINE_SUMMARY      = 1U << 13,
+	/** the memory SSA of the graph is computed and up to date */
+	IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA              = 1U << 14,
+	/** the scalar evolutions of the graph are computed and up to date */
+	IR_GRAPH_PROPERTY_CONSISTENT_SCEV                = 1U << 15,
 
 	/**
 	 * List of all graph properties that are only affected by control flow
@@ -421,7 +431,9 @@ typedef enum ir_graph_properties_t {
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
 		| IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE
-		| IR_GRAPH_PROPERTY_MANY_RETURNS,
+		| IR_GRAPH_PROPERTY_MANY_RETURNS
+		| IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA
+		| IR_GRAPH_PROPERTY_CONSISTENT_SCEV,
 
 } ir_graph_properties_t;
 ENUM_BITSET(ir_graph_properties_t)
@@ -52,6 +52,17 @@ FIRM_API int ir_import(const char *filename);
  */
 FIRM_API int ir_import_file(FILE *input, const char *inputname);
 
+/**
+ * Writes a canonical textual form of the graph @p irg to @p output.
+ * Nodes, labels and frame entities are numbered in walk order, other entities
+ * and types are described by their signature (linker name, owner, layout)
+ * instead of by number. Graphs
+ * with the same structure therefore produce the same output, even across
+ * separate compiler runs, which makes the output suitable as a content hash
+ * input. The output cannot be imported again.
+ */
+FIRM_API void ir_export_irg_canonical(FILE *output, ir_graph *irg);
+
 /** @} */
 
 #include "end.h"
@@ -370,6 +370,32 @@ FIRM_API void normalize_n_returns(ir_graph *irg);
  */
 FIRM_API void scalar_replacement_opt(ir_graph *irg);
 
+/**
+ * Promotes heap allocations to the stack frame.
+ * Calls of functions with the property mtp_property_malloc allocating at
+ * most @p max_size bytes are replaced by frame entities if the allocated
+ * object does not escape the function.  Calls freeing the object are
+ * removed.  Objects only accessed at constant offsets are scalar replaced
+ * afterwards.
+ *
+ * @param irg       the graph which should be optimized
+ * @param max_size  the maximum size of promoted objects in bytes
+ */
+FIRM_API void opt_heap_to_stack(ir_graph *irg, unsigned max_size);
+
+/**
+ * Speculatively devirtualizes indirect calls.
+ * An indirect call with at most @p max_targets known callees is replaced by
+ * direct calls of these callees, each guarded by a comparison of the called
+ * address.  The indirect call is kept as fallback for unknown callees.
+ * Uses the callee information computed by cgana().
+ *
+ * @param irg          the graph which should be optimized
+ * @param max_targets  the maximum number of guarded direct calls per call
+ */
+FIRM_API void opt_speculative_devirtualization(ir_graph *irg,
+                                               unsigned max_targets);
+
 /**
  * Optimizes tail-recursion calls by converting them into loops.
  * Depends on the flag opt_tail_recursion.
@@ -386,6 +412,21 @@ FIRM_API void scalar_replacement_opt(ir_graph *irg);
  */
 FIRM_API void opt_tail_rec_irg(ir_graph *irg);
 
+/**
+ * Marks Calls which may be implemented as sibling calls, i.e. by a jump
+ * after the frame of the calling function has been torn down.
+ * Such a Call is directly followed by a Return of its results, no entity of
+ * the frame has its address taken and the function neither allocates stack
+ * memory dynamically nor is variadic. Whether the calling conventions allow
+ * the jump is left to the backend.
+ *
+ * Stale marks are cleared, so the marks are only valid until the graph is
+ * changed next.
+ *
+ * @param irg   the graph to analyze
+ */
+FIRM_API void mark_tail_calls(ir_graph *irg);
+
 /**
  * CLiff Click's combo algorithm from
  *   "Combining Analyses, combining Optimizations".
@@ -414,6 +455,29 @@ typedef void (*opt_ptr)(ir_graph *irg);
 FIRM_API void inline_functions(unsigned maxsize, int inline_threshold,
                                opt_ptr after_inline_opt);
 
+/**
+ * Heuristic inliner with a program wide code growth budget.
+ *
+ * Works like inline_functions(). The graphs are processed bottom-up along the
+ * strongly connected components of the callgraph, so callees are inlined into
+ * and optimized before they are inlined themselves. Once inlining has grown
+ * the program by more than @p max_growth percent of its original size, only
+ * calls to always_inline functions are inlined.
+ *
+ * Summaries of the graphs (size, call sites, argument usage) are cached across
+ * calls and only recomputed for graphs changed in between.
+ *
+ * @param maxsize             Do not inline any calls if a method has more than
+ *                            maxsize firm nodes.
+ * @param inline_threshold    inlining threshold
+ * @param max_growth          maximum program growth in percent, 0 for no limit
+ * @param after_inline_opt    optimizations performed immediately after inlining
+ *                            into a graph
+ */
+FIRM_API void inline_functions_budget(unsigned maxsize, int inline_threshold,
+                                      unsigned max_growth,
+                                      opt_ptr after_inline_opt);
+
 /**
  * Combines congruent blocks into one.
  *
@@ -449,6 +513,55 @@ FIRM_API void unroll_loops(ir_graph *irg, unsigned factor, unsigned maxsize);
  */
 FIRM_API void do_loop_peeling(ir_graph *irg);
 
+/**
+ * Unswitches loops containing a branch on a loop invariant condition.
+ *
+ * The condition is evaluated in front of the loop, which is duplicated for
+ * both outcomes.  In each copy the branch is fixed, so local optimizations and
+ * control flow optimization should run afterwards to remove the dead code.
+ * Branches in frequently executed blocks are handled first; if no execution
+ * frequencies are present they are estimated.
+ *
+ * @param irg         the graph to optimize
+ * @param max_growth  the maximum number of nodes added to the graph
+ */
+FIRM_API void unswitch_loops(ir_graph *irg, unsigned max_growth);
+
+/**
+ * Inserts software prefetches for Loads with a constant stride in innermost
+ * loops.
+ *
+ * The prefetch distance is estimated from the size of the loop body so that
+ * @p latency cycles are hidden.  Loops with a known small trip count or with
+ * few iterations per entry according to the block execution frequencies are
+ * skipped; if no frequencies are present they are estimated.
+ *
+ * The prefetches are threaded into the memory chain, so this should run after
+ * the memory optimizations.
+ *
+ * @param irg      the graph to optimize
+ * @param latency  memory latency in cycles, 0 selects a default
+ */
+FIRM_API void insert_prefetches(ir_graph *irg, unsigned latency);
+
+/**
+ * Replaces innermost loops computing a well-known function by the function.
+ *
+ * Loops storing a constant to a contiguous range of memory become memset
+ * calls, loops copying a range become memcpy or memmove calls (CopyB nodes if
+ * the size is constant).  Loops counting the set bits or the trailing zeros
+ * of a value become popcount and ctz Builtins.  The calls and Builtins are
+ * expanded by the backend in the best way for the target.
+ *
+ * Freestanding code cannot assume that the libc functions exist, so the
+ * memory loops are only replaced if @p libc_calls is set.  The bodies of
+ * memset, memcpy and memmove themselves are never turned into calls.
+ *
+ * @param irg         the graph to optimize
+ * @param libc_calls  if non-zero, memory loops may become calls to libc
+ */
+FIRM_API void opt_loop_idioms(ir_graph *irg, int libc_calls);
+
 /**
  * Removes all entities which are unused.
  *
@@ -10,6 +10,7 @@
 #ifndef FIRM_JIT_H
 #define FIRM_JIT_H
 
+#include <stddef.h>
 #include "firm_types.h"
 
 #include "begin.h"
@@ -72,6 +73,122 @@ FIRM_API unsigned be_get_function_size(ir_jit_function_t const *function);
  */
 FIRM_API void be_emit_function(char *buffer, ir_jit_function_t *function);
 
+/**
+ * Manager for executable memory. Memory is taken from the operating system in
+ * slabs, every slab holds blocks of one size class. Memory is never writable
+ * and executable at the same time: be_jit_memory_protect() turns the pages
+ * written since its last call executable, later blocks are taken from the
+ * pages behind them. The blocks sharing the last page with protected code and
+ * freed blocks in executable pages are only written again once all blocks of
+ * their slab are freed, so running code never becomes writable.
+ */
+typedef struct ir_jit_memory_t ir_jit_memory_t;
+
+/**
+ * Create a new executable memory manager.
+ */
+FIRM_API ir_jit_memory_t *be_new_jit_memory(void);
+
+/**
+ * Destroy \p memory and release all its memory.
+ */
+FIRM_API void be_destroy_jit_memory(ir_jit_memory_t *memory);
+
+/**
+ * Return a writable block of at least \p size bytes. The block is not
+ * executable until be_jit_memory_protect() is called.
+ */
+FIRM_API void *be_jit_memory_alloc(ir_jit_memory_t *memory, size_t size);
+
+/**
+ * Free block \p code returned by be_jit_memory_alloc() or be_jit_memory_emit().
+ * The block is reused by later allocations of similar size.
+ */
+FIRM_API void be_jit_memory_free(ir_jit_memory_t *memory, void const *code);
+
+/**
+ * Emit \p function into memory managed by \p memory and return its address.
+ * Referenced private constant entities without an address are copied into
+ * the same block behind the code and are freed with it. If \p replace is not
+ * NULL, it is a block of \p memory holding an older version of the function,
+ * which is freed after the new code is written to a different block. The old
+ * code must not be executed anymore, references to it have to be redirected
+ * to the new code. The code is not executable until be_jit_memory_protect()
+ * is called.
+ */
+FIRM_API void const *be_jit_memory_emit(ir_jit_memory_t *memory,
+                                        ir_jit_function_t *function,
+                                        void const *replace);
+
+/**
+ * Make all memory written since the last call executable and read only.
+ * Code in slabs written to since the last call must not be executed before.
+ */
+FIRM_API void be_jit_memory_protect(ir_jit_memory_t *memory);
+
+/**
+ * Lazy compilation environment. Hands out a stub for every registered
+ * function and compiles the function when the stub is called first.
+ */
+typedef struct ir_jit_lazy_t ir_jit_lazy_t;
+
+/**
+ * Callbacks of a lazy compilation environment.
+ */
+typedef struct ir_jit_lazy_callbacks_t {
+	/** Returns @p size bytes of memory which is writable and executable.
+	 * Stubs are patched while running, so memory from an ir_jit_memory_t
+	 * cannot be used. */
+	void *(*alloc_code)(void *data, size_t size);
+	/** Acquires the lock serializing all libFirm calls before a function is
+	 * compiled on its first call, may be NULL. */
+	void (*lock)(void *data);
+	/** Releases the lock acquired by lock, may be NULL. */
+	void (*unlock)(void *data);
+	/** Passed to the callbacks. */
+	void *data;
+} ir_jit_lazy_callbacks_t;
+
+/**
+ * Create a new lazy compilation environment compiling into \p segment.
+ * Returns NULL if the target does not support lazy compilation. The target
+ * has to match the host.
+ */
+FIRM_API ir_jit_lazy_t *be_new_jit_lazy(ir_jit_segment_t *segment,
+                                        ir_jit_lazy_callbacks_t const *callbacks);
+
+/**
+ * Destroy lazy compilation environment \p lazy. Memory returned by the
+ * alloc_code callback is not freed.
+ */
+FIRM_API void be_destroy_jit_lazy(ir_jit_lazy_t *lazy);
+
+/**
+ * Register graph \p irg for lazy compilation and return the address of its
+ * stub. The address of the graph entity is set to the stub, so calls from
+ * other jit compiled code go through the stub until \p irg is compiled.
+ * The graph must not be modified afterwards.
+ */
+FIRM_API void const *be_jit_lazy_add(ir_jit_lazy_t *lazy, ir_graph *irg);
+
+/**
+ * Compile the function of \p entity unless it is already compiled, patch its
+ * stub and return the address of its code. Registered functions called by it
+ * are put into the compile queue, more frequently called ones first.
+ */
+FIRM_API void const *be_jit_lazy_compile(ir_jit_lazy_t *lazy,
+                                         ir_entity *entity);
+
+/**
+ * Compile up to \p max functions from the compile queue and return the
+ * number of compiled functions. Meant to be called from a worker thread or
+ * when idle, so likely callees are ready before they are called. Like all
+ * other libFirm functions this must be called with the lock passed to
+ * be_new_jit_lazy() held.
+ */
+FIRM_API unsigned be_jit_lazy_compile_queued(ir_jit_lazy_t *lazy,
+                                             unsigned max);
+
 /** @} */
 
 #include "end.h"
@@ -501,7 +501,12 @@ typedef enum ir_initializer_kind_t {
 	/** initializes type with default values (usually 0) */
 	IR_INITIALIZER_NULL,
 	/** list of initializers used to initialize a compound or array type */
-	IR_INITIALIZER_COMPOUND
+	IR_INITIALIZER_COMPOUND,
+	/**
+	 * raw bytes in target memory order, used to initialize large constant
+	 * data without an initializer per element
+	 */
+	IR_INITIALIZER_BLOB
 } ir_initializer_kind_t;
 
 /** Returns the kind of an initializer */
@@ -545,6 +550,29 @@ FIRM_API void set_initializer_compound_value(ir_initializer_t *initializer,
 FIRM_API ir_initializer_t *get_initializer_compound_value(
 		const ir_initializer_t *initializer, size_t index);
 
+/**
+ * Creates a blob initializer holding a copy of the @p size bytes at @p data.
+ * The bytes are in target memory order, the rest of the initialized object
+ * is zero.
+ */
+FIRM_API ir_initializer_t *create_initializer_blob(const void *data,
+                                                   size_t size);
+
+/**
+ * Creates a blob initializer referencing the @p size bytes at @p data
+ * without copying them (e.g. from an mmapped file).  The memory must stay
+ * valid and unchanged as long as the initializer is used.
+ */
+FIRM_API ir_initializer_t *create_initializer_blob_ref(const void *data,
+                                                       size_t size);
+
+/** Returns the number of bytes of a blob initializer */
+FIRM_API size_t get_initializer_blob_size(const ir_initializer_t *initializer);
+
+/** Returns the bytes of a blob initializer */
+FIRM_API const unsigned char *get_initializer_blob_data(
+		const ir_initializer_t *initializer);
+
 /** @} */
 
 /** Sets the initializer of an entity. */
@@ -73,6 +73,18 @@ FIRM_API ir_relation vrp_cmp(const ir_node *left, const ir_node *right);
  */
 FIRM_API vrp_attr *vrp_get_info(const ir_node *n);
 
+/**
+ * Computes the known bits and value ranges of the parameters of private
+ * methods from all their call sites and those of the results of all methods
+ * from their returns.  The information is attached to the method entities and
+ * used by the known bits analysis of later optimizations and by
+ * set_vrp_data() as long as the method types do not change.
+ *
+ * Run mark_private_methods() before.  The information must be recomputed
+ * when calls with new arguments are created.
+ */
+FIRM_API void compute_interprocedural_bits(void);
+
 /** @} */
 
 #include "end.h"
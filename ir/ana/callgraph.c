@@ -23,6 +23,8 @@
 #include "pmap.h"
 #include "raw_bitset.h"
 #include "util.h"
+#include "xmalloc.h"
+#include <stdbool.h>
 #include <stdlib.h>
 
 static ir_visited_t master_cg_visited = 0;
@@ -320,6 +322,82 @@ void callgraph_walk(callgraph_walk_func *pre, callgraph_walk_func *post, void *e
 	}
 }
 
+/** Per-graph state of the SCC walk in callgraph_walk_scc(). */
+typedef struct scc_walk_node {
+	size_t dfn;      /**< depth first number, 0 if not visited yet */
+	size_t lowlink;  /**< smallest dfn reachable from this graph */
+	bool   in_stack; /**< graph is on the Tarjan stack */
+} scc_walk_node;
+
+typedef struct scc_walk_env {
+	scc_walk_node     *nodes;   /**< state indexed by graph index */
+	ir_graph         **stack;   /**< Tarjan stack */
+	size_t             next_dfn;
+	callgraph_scc_func *func;
+	void              *env;
+} scc_walk_env;
+
+static void scc_walk(scc_walk_env *const env, ir_graph *const irg)
+{
+	scc_walk_node *const node = &env->nodes[get_irg_idx(irg)];
+	node->dfn      = ++env->next_dfn;
+	node->lowlink  = node->dfn;
+	node->in_stack = true;
+	ARR_APP1(ir_graph*, env->stack, irg);
+
+	for (size_t i = 0, n_callees = get_irg_n_callees(irg); i < n_callees; ++i) {
+		ir_graph      *const callee      = get_irg_callee(irg, i);
+		scc_walk_node *const callee_node = &env->nodes[get_irg_idx(callee)];
+		if (callee_node->dfn == 0) {
+			scc_walk(env, callee);
+			node->lowlink = MIN(node->lowlink, callee_node->lowlink);
+		} else if (callee_node->in_stack) {
+			node->lowlink = MIN(node->lowlink, callee_node->dfn);
+		}
+	}
+
+	if (node->lowlink != node->dfn)
+		return;
+
+	/* irg is the root of an SCC: pop it off the stack */
+	size_t begin = ARR_LEN(env->stack);
+	ir_graph *member;
+	do {
+		member = env->stack[--begin];
+		env->nodes[get_irg_idx(member)].in_stack = false;
+	} while (member != irg);
+
+	env->func(&env->stack[begin], ARR_LEN(env->stack) - begin, env->env);
+	ARR_SHRINKLEN(env->stack, begin);
+}
+
+void callgraph_walk_scc(callgraph_scc_func *func, void *env)
+{
+	assert(get_irp_callgraph_state() != irp_callgraph_none);
+	scc_walk_env walk_env = {
+		.nodes    = XMALLOCNZ(scc_walk_node, get_irp_last_idx()),
+		.stack    = NEW_ARR_F(ir_graph*, 0),
+		.next_dfn = 0,
+		.func     = func,
+		.env      = env,
+	};
+
+	/* roots are methods which have no callers in the current program */
+	foreach_irp_irg(i, irg) {
+		if (get_irg_n_callers(irg) == 0
+		    && walk_env.nodes[get_irg_idx(irg)].dfn == 0)
+			scc_walk(&walk_env, irg);
+	}
+	/* remaining graphs are only reachable through call cycles */
+	foreach_irp_irg(i, irg) {
+		if (walk_env.nodes[get_irg_idx(irg)].dfn == 0)
+			scc_walk(&walk_env, irg);
+	}
+
+	DEL_ARR_F(walk_env.stack);
+	free(walk_env.nodes);
+}
+
 static ir_graph *outermost_ir_graph;   /**< The outermost graph the scc is computed
                                             for */
 static ir_loop *current_loop;      /**< Current cfloop construction is working
@@ -400,6 +400,7 @@ static void add_method_address_inititializer(ir_initializer_t const *const initi
 	}
 	case IR_INITIALIZER_TARVAL:
 	case IR_INITIALIZER_NULL:
+	case IR_INITIALIZER_BLOB:
 		return;
 	case IR_INITIALIZER_COMPOUND:
 		for (size_t i = 0; i < initializer->compound.n_initializers; ++i) {
@@ -737,6 +737,8 @@ undefined:
 						o = b->o;
 						goto set_info;
 					}
+					if (get_interprocedural_bits(irn, &z, &o))
+						goto set_info;
 					goto cannot_analyse;
 				}
 
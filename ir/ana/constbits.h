@@ -39,4 +39,21 @@ void constbits_analyze(ir_graph *irg);
  */
 void constbits_clear(ir_graph *irg);
 
+/**
+ * Returns the known bits of the argument or call result @p proj computed by
+ * compute_interprocedural_bits() in @p z and @p o.
+ *
+ * @return true if there is information for @p proj
+ */
+bool get_interprocedural_bits(ir_node const *proj, ir_tarval **z, ir_tarval **o);
+
+/**
+ * Returns the value range of the argument or call result @p proj computed by
+ * compute_interprocedural_bits() in @p bottom and @p top.
+ *
+ * @return true if there is a nonempty range narrower than the mode of @p proj
+ */
+bool get_interprocedural_range(ir_node const *proj, ir_tarval **bottom,
+                               ir_tarval **top);
+
 #endif
@@ -0,0 +1,407 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Interprocedural propagation of known bits and value ranges.
+ *
+ * The known bits and VRP ranges of the parameters of private methods are
+ * the join over the arguments at all their call sites, those of the results
+ * of a method are the join over all its Returns.  Both start at bottom and
+ * are iterated to a fixpoint with a worklist of graphs: a graph is
+ * reanalyzed when the parameters of its method or the results of a method
+ * it calls change.  Ranges which keep growing, e.g. by a recursive call with
+ * an incremented argument, are widened to the whole mode.  The results are
+ * attached to the method entities and seed constbits and VRP at arguments
+ * and call results.
+ */
+#include "array.h"
+#include "constbits.h"
+#include "debug.h"
+#include "entity_t.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "irprog_t.h"
+#include "pdeq.h"
+#include "pmap.h"
+#include "pset_new.h"
+#include "tv.h"
+#include "vrp.h"
+
+/** number of times a range may grow before it is widened to the whole mode */
+#define MAX_RANGE_JOINS 8
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+typedef struct ipa_env_t {
+	deq_t      worklist;
+	pset_new_t queued;  /**< graphs in the worklist */
+	pmap      *callers; /**< maps graphs to an array of their callers */
+} ipa_env_t;
+
+static bool has_valid_bits(ir_entity const *const ent)
+{
+	return ent->attr.mtd_attr.bits_type == get_entity_type(ent);
+}
+
+/**
+ * Returns the analyzed method whose parameters (@p is_param) or results
+ * contain the argument or call result @p proj, NULL if there is none.
+ */
+static ir_entity *get_analyzed_method(ir_node const *const proj,
+                                      bool *const is_param)
+{
+	ir_node *const pred = get_Proj_pred(proj);
+	if (!is_Proj(pred))
+		return NULL;
+
+	ir_node   *const tuple = get_Proj_pred(pred);
+	ir_entity *ent;
+	if (is_Start(tuple) && get_Proj_num(pred) == pn_Start_T_args) {
+		ent       = get_irg_entity(get_irn_irg(proj));
+		*is_param = true;
+	} else if (is_Call(tuple) && get_Proj_num(pred) == pn_Call_T_result) {
+		ent = get_Call_callee(tuple);
+		if (ent == NULL || get_entity_linktime_irg(ent) == NULL)
+			return NULL;
+		*is_param = false;
+	} else {
+		return NULL;
+	}
+	return has_valid_bits(ent) ? ent : NULL;
+}
+
+bool get_interprocedural_bits(ir_node const *const proj, ir_tarval **const z,
+                              ir_tarval **const o)
+{
+	bool             is_param;
+	ir_entity *const ent = get_analyzed_method(proj, &is_param);
+	if (ent == NULL)
+		return false;
+
+	ir_known_bits *const bits = is_param ? ent->attr.mtd_attr.param_bits
+	                                     : ent->attr.mtd_attr.res_bits;
+	unsigned       const num  = get_Proj_num(proj);
+	if (num >= ARR_LEN(bits) || bits[num].z == NULL
+	    || get_tarval_mode(bits[num].z) != get_irn_mode(proj))
+		return false;
+	*z = bits[num].z;
+	*o = bits[num].o;
+	return true;
+}
+
+bool get_interprocedural_range(ir_node const *const proj,
+                               ir_tarval **const bottom, ir_tarval **const top)
+{
+	bool             is_param;
+	ir_entity *const ent = get_analyzed_method(proj, &is_param);
+	if (ent == NULL)
+		return false;
+
+	ir_known_range *const ranges = is_param ? ent->attr.mtd_attr.param_ranges
+	                                        : ent->attr.mtd_attr.res_ranges;
+	unsigned        const num    = get_Proj_num(proj);
+	if (num >= ARR_LEN(ranges) || ranges[num].bottom == NULL)
+		return false;
+	ir_known_range const *const range = &ranges[num];
+	ir_mode              *const mode  = get_irn_mode(proj);
+	if (get_tarval_mode(range->bottom) != mode
+	    || tarval_cmp(range->bottom, range->top) == ir_relation_greater
+	    || (range->bottom == get_mode_min(mode)
+	        && range->top == get_mode_max(mode)))
+		return false;
+	*bottom = range->bottom;
+	*top    = range->top;
+	return true;
+}
+
+/**
+ * Creates the known bits of the @p n parameters or results of @p mtp: bottom
+ * if they are analyzed, top otherwise.
+ */
+static ir_known_bits *new_known_bits(ir_type const *const mtp, size_t const n,
+                                     ir_type *(*get_type)(ir_type const*, size_t),
+                                     bool const analyze)
+{
+	ir_known_bits *const bits = NEW_ARR_F(ir_known_bits, n);
+	for (size_t i = 0; i < n; ++i) {
+		ir_mode *const mode = get_type_mode(get_type(mtp, i));
+		if (mode == NULL || !mode_is_int(mode)) {
+			bits[i] = (ir_known_bits) { NULL, NULL };
+		} else if (analyze) {
+			bits[i] = (ir_known_bits) { get_mode_null(mode), get_mode_all_one(mode) };
+		} else {
+			bits[i] = (ir_known_bits) { get_mode_all_one(mode), get_mode_null(mode) };
+		}
+	}
+	return bits;
+}
+
+/**
+ * Creates the value ranges of the @p n parameters or results of @p mtp: empty
+ * if they are analyzed, the whole mode otherwise.
+ */
+static ir_known_range *new_known_ranges(ir_type const *const mtp,
+                                        size_t const n,
+                                        ir_type *(*get_type)(ir_type const*, size_t),
+                                        bool const analyze)
+{
+	ir_known_range *const ranges = NEW_ARR_F(ir_known_range, n);
+	for (size_t i = 0; i < n; ++i) {
+		ir_mode *const mode = get_type_mode(get_type(mtp, i));
+		if (mode == NULL || !mode_is_int(mode)) {
+			ranges[i] = (ir_known_range) { NULL, NULL, 0 };
+		} else if (analyze) {
+			ranges[i] = (ir_known_range) { get_mode_max(mode), get_mode_min(mode), 0 };
+		} else {
+			ranges[i] = (ir_known_range) { get_mode_min(mode), get_mode_max(mode), 0 };
+		}
+	}
+	return ranges;
+}
+
+static void init_known_bits(ir_entity *const ent)
+{
+	method_ent_attr *const attr = &ent->attr.mtd_attr;
+	if (attr->param_bits != NULL)
+		DEL_ARR_F(attr->param_bits);
+	if (attr->res_bits != NULL)
+		DEL_ARR_F(attr->res_bits);
+	if (attr->param_ranges != NULL)
+		DEL_ARR_F(attr->param_ranges);
+	if (attr->res_ranges != NULL)
+		DEL_ARR_F(attr->res_ranges);
+
+	/* only the parameters of private methods have all call sites known */
+	ir_type *const mtp     = get_entity_type(ent);
+	bool     const private = get_entity_additional_properties(ent)
+	                         & mtp_property_private;
+	attr->bits_type  = mtp;
+	attr->param_bits = new_known_bits(mtp, get_method_n_params(mtp),
+	                                  get_method_param_type, private);
+	attr->res_bits   = new_known_bits(mtp, get_method_n_ress(mtp),
+	                                  get_method_res_type, true);
+	attr->param_ranges = new_known_ranges(mtp, get_method_n_params(mtp),
+	                                      get_method_param_type, private);
+	attr->res_ranges   = new_known_ranges(mtp, get_method_n_ress(mtp),
+	                                      get_method_res_type, true);
+}
+
+/** Sets @p bits to top. */
+static bool set_unknown(ir_known_bits *const bits)
+{
+	if (bits->z == NULL)
+		return false;
+	ir_mode *const mode = get_tarval_mode(bits->z);
+	if (bits->o == get_mode_null(mode) && bits->z == get_mode_all_one(mode))
+		return false;
+	bits->z = get_mode_all_one(mode);
+	bits->o = get_mode_null(mode);
+	return true;
+}
+
+/** Joins the known bits of @p value into @p bits. */
+static bool join_known_bits(ir_known_bits *const bits, ir_node const *const value)
+{
+	if (bits->z == NULL)
+		return false;
+	bitinfo const *const b = get_bitinfo(value);
+	if (b == NULL || get_irn_mode(value) != get_tarval_mode(bits->z))
+		return set_unknown(bits);
+	ir_tarval *const z = tarval_or(bits->z, b->z);
+	ir_tarval *const o = tarval_and(bits->o, b->o);
+	if (z == bits->z && o == bits->o)
+		return false;
+	bits->z = z;
+	bits->o = o;
+	return true;
+}
+
+/** Sets @p range to the whole mode. */
+static bool set_range_unknown(ir_known_range *const range)
+{
+	if (range->bottom == NULL)
+		return false;
+	ir_mode *const mode = get_tarval_mode(range->bottom);
+	if (range->bottom == get_mode_min(mode) && range->top == get_mode_max(mode))
+		return false;
+	range->bottom = get_mode_min(mode);
+	range->top    = get_mode_max(mode);
+	return true;
+}
+
+/** Joins the VRP range of @p value into @p range. */
+static bool join_known_range(ir_known_range *const range,
+                             ir_node const *const value)
+{
+	if (range->bottom == NULL)
+		return false;
+	/* VRP cannot represent bottom, a value which constbits found to be
+	 * bottom is joined when its graph is reanalyzed with more information */
+	bitinfo const *const b = get_bitinfo(value);
+	if (b != NULL && !tarval_is_null(tarval_andnot(b->o, b->z)))
+		return false;
+	vrp_attr const *const vrp = vrp_get_info(value);
+	if (vrp == NULL || vrp->range_type != VRP_RANGE
+	    || get_irn_mode(value) != get_tarval_mode(range->bottom))
+		return set_range_unknown(range);
+	bool changed = false;
+	if (tarval_cmp(vrp->range_bottom, range->bottom) == ir_relation_less) {
+		range->bottom = vrp->range_bottom;
+		changed       = true;
+	}
+	if (tarval_cmp(vrp->range_top, range->top) == ir_relation_greater) {
+		range->top = vrp->range_top;
+		changed    = true;
+	}
+	/* widen ranges which keep growing to terminate */
+	if (changed && ++range->n_joins > MAX_RANGE_JOINS)
+		set_range_unknown(range);
+	return changed;
+}
+
+static void enqueue(ipa_env_t *const env, ir_graph *const irg)
+{
+	if (pset_new_insert(&env->queued, irg))
+		deq_push_pointer_right(&env->worklist, irg);
+}
+
+static void add_caller(ipa_env_t *const env, ir_graph *const callee,
+                       ir_graph *const caller)
+{
+	ir_graph **callers = pmap_get(ir_graph*, env->callers, callee);
+	if (callers == NULL)
+		callers = NEW_ARR_F(ir_graph*, 0);
+	for (size_t i = 0, n = ARR_LEN(callers); i < n; ++i) {
+		if (callers[i] == caller)
+			return;
+	}
+	ARR_APP1(ir_graph*, callers, caller);
+	pmap_insert(env->callers, callee, callers);
+}
+
+static bool is_reachable(ir_node const *const node)
+{
+	bitinfo const *const b = get_bitinfo(get_nodes_block(node));
+	return b == NULL || b->z != tarval_b_false;
+}
+
+static void update_call(ipa_env_t *const env, ir_node *const call)
+{
+	ir_entity *const callee     = get_Call_callee(call);
+	ir_graph  *const callee_irg = callee != NULL
+		? get_entity_linktime_irg(callee) : NULL;
+	if (callee_irg == NULL || !has_valid_bits(callee))
+		return;
+	add_caller(env, callee_irg, get_irn_irg(call));
+	if (!is_reachable(call))
+		return;
+
+	ir_known_bits  *const bits     = callee->attr.mtd_attr.param_bits;
+	ir_known_range *const ranges   = callee->attr.mtd_attr.param_ranges;
+	size_t          const n_params = ARR_LEN(bits);
+	bool                  changed  = false;
+	for (size_t i = 0; i < n_params; ++i) {
+		/* mismatching calls can happen in obscure C programs */
+		if ((size_t)get_Call_n_params(call) != n_params) {
+			changed |= set_unknown(&bits[i]);
+			changed |= set_range_unknown(&ranges[i]);
+		} else {
+			ir_node const *const param = get_Call_param(call, i);
+			changed |= join_known_bits(&bits[i], param);
+			changed |= join_known_range(&ranges[i], param);
+		}
+	}
+	if (changed) {
+		DB((dbg, LEVEL_2, "%+F changes parameters of %+F\n", call, callee));
+		enqueue(env, callee_irg);
+	}
+}
+
+static bool update_return(ir_node *const ret)
+{
+	if (!is_reachable(ret))
+		return false;
+	ir_entity      *const ent     = get_irg_entity(get_irn_irg(ret));
+	ir_known_bits  *const bits    = ent->attr.mtd_attr.res_bits;
+	ir_known_range *const ranges  = ent->attr.mtd_attr.res_ranges;
+	size_t          const n_ress  = ARR_LEN(bits);
+	bool                  changed = false;
+	for (size_t i = 0; i < n_ress; ++i) {
+		if ((size_t)get_Return_n_ress(ret) != n_ress) {
+			changed |= set_unknown(&bits[i]);
+			changed |= set_range_unknown(&ranges[i]);
+		} else {
+			ir_node const *const res = get_Return_res(ret, i);
+			changed |= join_known_bits(&bits[i], res);
+			changed |= join_known_range(&ranges[i], res);
+		}
+	}
+	return changed;
+}
+
+typedef struct update_env_t {
+	ipa_env_t *env;
+	bool       results_changed;
+} update_env_t;
+
+static void update_walker(ir_node *const node, void *const data)
+{
+	update_env_t *const env = (update_env_t*)data;
+	if (is_Call(node))
+		update_call(env->env, node);
+	else if (is_Return(node))
+		env->results_changed |= update_return(node);
+}
+
+static void analyze_graph(ipa_env_t *const env, ir_graph *const irg)
+{
+	DB((dbg, LEVEL_2, "analyzing %+F\n", irg));
+	constbits_analyze(irg);
+	set_vrp_data(irg);
+	update_env_t update_env = { env, false };
+	irg_walk_graph(irg, NULL, update_walker, &update_env);
+	free_vrp_data(irg);
+	constbits_clear(irg);
+
+	if (!update_env.results_changed)
+		return;
+	DB((dbg, LEVEL_2, "results of %+F changed\n", irg));
+	ir_graph **const callers = pmap_get(ir_graph*, env->callers, irg);
+	if (callers != NULL) {
+		for (size_t i = 0, n = ARR_LEN(callers); i < n; ++i)
+			enqueue(env, callers[i]);
+	}
+}
+
+void compute_interprocedural_bits(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.ana.ipconstbits");
+
+	foreach_irp_irg(i, irg) {
+		init_known_bits(get_irg_entity(irg));
+	}
+
+	ipa_env_t env;
+	deq_init(&env.worklist);
+	pset_new_init(&env.queued);
+	env.callers = pmap_create();
+	foreach_irp_irg(i, irg) {
+		enqueue(&env, irg);
+	}
+	while (!deq_empty(&env.worklist)) {
+		ir_graph *const irg = deq_pop_pointer_left(ir_graph, &env.worklist);
+		pset_new_remove(&env.queued, irg);
+		analyze_graph(&env, irg);
+	}
+
+	foreach_pmap(env.callers, entry) {
+		DEL_ARR_F((ir_graph**)entry->value);
+	}
+	pmap_destroy(env.callers);
+	pset_new_destroy(&env.queued);
+	deq_free(&env.worklist);
+}
@@ -572,7 +572,8 @@ static void reset_backedges(ir_node *n)
 static void loop_reset_node(ir_node *n, void *env)
 {
 	(void)env;
-	set_irn_loop(n, NULL);
+	if (is_Block(n))
+		set_irn_loop(n, NULL);
 	reset_backedges(n);
 }
 
@@ -732,6 +732,7 @@ static void check_initializer_nodes(ir_initializer_t *initializer)
 	}
 	case IR_INITIALIZER_TARVAL:
 	case IR_INITIALIZER_NULL:
+	case IR_INITIALIZER_BLOB:
 		return;
 	case IR_INITIALIZER_COMPOUND:
 		for (size_t i = 0; i < initializer->compound.n_initializers; ++i) {
@@ -0,0 +1,685 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Memory SSA: per alias class versions of the memory graph.
+ */
+#include "irmemssa.h"
+
+#include "array.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irmemory.h"
+#include "irnode_t.h"
+#include "irop_t.h"
+#include "panic.h"
+#include "pmap.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <string.h>
+
+typedef enum memssa_access_t {
+	MEMSSA_NONE  = 0,
+	MEMSSA_READ  = 1U << 0,
+	MEMSSA_WRITE = 1U << 1,
+} memssa_access_t;
+ENUM_BITSET(memssa_access_t)
+
+typedef struct memssa_class_t {
+	ir_entity *entity;   /**< the entity, NULL for escaped memory */
+	bool       local;    /**< the entity is part of the stack frame */
+	ir_node  **accesses; /**< Loads, Stores and CopyBs of the class in
+	                          preorder */
+} memssa_class_t;
+
+typedef struct memssa_node_t {
+	ir_node     *parent;   /**< memory operation or merge above */
+	ir_node     *root;     /**< merge the memory tree hangs below */
+	ir_node     *nonlocal; /**< nearest operation at or above which may
+	                            touch all memory but the stack frame */
+	ir_node     *any;      /**< nearest operation at or above which may
+	                            read all memory */
+	ir_node     *prev;     /**< previous access of the class of the
+	                            address (CopyB: destination) above */
+	ir_node     *prev_src; /**< previous access of the class of the CopyB
+	                            source above */
+	ir_node     *child;    /**< first memory operation below */
+	ir_node     *sibling;  /**< next memory operation below the parent */
+	ir_node     *removed;  /**< memory replacing a removed node */
+	ir_node    **users;    /**< accesses defined by this node */
+	unsigned     pre;      /**< preorder number, 0 if not in a tree */
+	unsigned     post;     /**< largest preorder number below */
+	unsigned     first;    /**< preorder number of the tree top */
+	unsigned     cls;      /**< alias class of an address plus one,
+	                            0 if not computed yet */
+	ir_visited_t visited;  /**< visited flag for walks outside the trees */
+} memssa_node_t;
+
+typedef struct ir_memssa_t ir_memssa_t;
+struct ir_memssa_t {
+	memssa_node_t  *nodes;          /**< node info indexed by node index */
+	memssa_class_t *classes;        /**< all alias classes */
+	pmap           *entity_classes; /**< maps entities to alias classes */
+	ir_node       **tops;           /**< tree tops while numbering */
+	ir_node       **last;           /**< innermost access per class while
+	                                     numbering */
+	unsigned        n_pre;          /**< last preorder number */
+	ir_visited_t    visited;
+	bool            always_alias;   /**< all memory is one alias class */
+	bool            has_users;      /**< def-use links are computed */
+};
+
+static ir_memssa_t *get_memssa(ir_node const *node)
+{
+	ir_graph *const irg = get_irn_irg(node);
+	assert(irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA));
+	return irg->memssa;
+}
+
+/**
+ * Returns the info of @p node. The array grows for nodes created after the
+ * analysis, so the result is only valid until the next call.
+ */
+static memssa_node_t *get_node_info(ir_memssa_t *ms, ir_node const *node)
+{
+	unsigned const idx = get_irn_idx(node);
+	size_t   const len = ARR_LEN(ms->nodes);
+	if (idx >= len) {
+		unsigned const last_idx = get_irg_last_idx(get_irn_irg(node));
+		ARR_RESIZE(memssa_node_t, ms->nodes, last_idx);
+		memset(&ms->nodes[len], 0, (last_idx - len) * sizeof(*ms->nodes));
+	}
+	return &ms->nodes[idx];
+}
+
+/**
+ * Strips address arithmetic and compound member selection from @p ptr
+ * the same way the alias oracle does. Returns the entity if the remaining
+ * base address is a global or frame entity.
+ */
+static ir_entity *find_base_entity(ir_node *ptr, bool *local)
+{
+	for (;;) {
+		if (is_Add(ptr)) {
+			ir_node *const left = get_Add_left(ptr);
+			ptr = mode_is_reference(get_irn_mode(left)) ? left
+			                                            : get_Add_right(ptr);
+		} else if (is_Sub(ptr)) {
+			ptr = get_Sub_left(ptr);
+		} else {
+			break;
+		}
+	}
+	for (;;) {
+		if (is_Sel(ptr)) {
+			ptr = get_Sel_ptr(ptr);
+		} else if (is_Member(ptr)) {
+			ir_node *const pred = get_Member_ptr(ptr);
+			if (pred == get_irg_frame(get_irn_irg(ptr))) {
+				*local = true;
+				return get_Member_entity(ptr);
+			}
+			ptr = pred;
+		} else {
+			break;
+		}
+	}
+	if (is_Address(ptr)) {
+		*local = false;
+		return get_Address_entity(ptr);
+	}
+	return NULL;
+}
+
+static unsigned compute_class(ir_memssa_t *ms, ir_node *ptr)
+{
+	if (ms->always_alias)
+		return MEMSSA_CLASS_ESCAPED;
+
+	bool             local;
+	ir_entity *const entity = find_base_entity(ptr, &local);
+	if (entity == NULL)
+		return MEMSSA_CLASS_ESCAPED;
+
+	/* The entity usage may be recomputed while the analysis is in use, so
+	 * the class of an entity is fixed when it is first seen. */
+	pmap_entry const *const found = pmap_find(ms->entity_classes, entity);
+	if (found != NULL)
+		return PTR_TO_INT(found->value);
+	if (get_entity_usage(entity) & ir_usage_address_taken) {
+		pmap_insert(ms->entity_classes, entity,
+		            INT_TO_PTR(MEMSSA_CLASS_ESCAPED));
+		return MEMSSA_CLASS_ESCAPED;
+	}
+
+	unsigned const       cls  = ARR_LEN(ms->classes);
+	memssa_class_t const info = {
+		.entity   = entity,
+		.local    = local,
+		.accesses = NEW_ARR_F(ir_node*, 0),
+	};
+	ARR_APP1(memssa_class_t, ms->classes, info);
+	if (ms->last != NULL)
+		ARR_APP1(ir_node*, ms->last, NULL);
+	pmap_insert(ms->entity_classes, entity, INT_TO_PTR(cls));
+	return cls;
+}
+
+static unsigned get_class(ir_memssa_t *ms, ir_node *ptr)
+{
+	memssa_node_t *const info = get_node_info(ms, ptr);
+	if (info->cls == 0) {
+		unsigned const cls = compute_class(ms, ptr);
+		info->cls = cls + 1;
+		return cls;
+	}
+	return info->cls - 1;
+}
+
+static bool is_access(ir_node const *node)
+{
+	return is_Load(node) || is_Store(node) || is_CopyB(node);
+}
+
+/**
+ * Returns true if the memory operation @p node, which is no Load, Store or
+ * CopyB, may touch all memory except for the stack frame.
+ */
+static bool touches_nonlocal(ir_node const *node)
+{
+	return !is_irn_const_memory(node) || is_Call(node);
+}
+
+/**
+ * Returns true if the memory operation @p node, which is no Load, Store or
+ * CopyB, may read any memory because an exception handler may run after it.
+ */
+static bool touches_any(ir_node const *node)
+{
+	return is_fragile_op(node) && ir_throws_exception(node);
+}
+
+/**
+ * Determines how the memory operation @p node may touch memory of alias
+ * class @p cls.
+ */
+static memssa_access_t get_access(ir_memssa_t *ms, ir_node *node, unsigned cls)
+{
+	switch (get_irn_opcode(node)) {
+	case iro_Load:
+		return get_class(ms, get_Load_ptr(node)) == cls ? MEMSSA_READ
+		                                                : MEMSSA_NONE;
+	case iro_Store:
+		return get_class(ms, get_Store_ptr(node)) == cls ? MEMSSA_WRITE
+		                                                 : MEMSSA_NONE;
+	case iro_CopyB: {
+		memssa_access_t access = MEMSSA_NONE;
+		if (get_class(ms, get_CopyB_src(node)) == cls)
+			access |= MEMSSA_READ;
+		if (get_class(ms, get_CopyB_dst(node)) == cls)
+			access |= MEMSSA_WRITE;
+		return access;
+	}
+	default:
+		break;
+	}
+
+	/* Other operations only see entities whose address escapes or which
+	 * are global. */
+	memssa_access_t access = MEMSSA_NONE;
+	if (!ms->classes[cls].local && touches_nonlocal(node))
+		access = is_irn_const_memory(node) ? MEMSSA_READ
+		                                   : MEMSSA_READ | MEMSSA_WRITE;
+	if (touches_any(node))
+		access |= MEMSSA_READ;
+	return access;
+}
+
+/** Skips Id and Proj nodes of a memory value. */
+static ir_node *skip_mem_proj(ir_node *mem)
+{
+	mem = skip_Id(mem);
+	if (is_Proj(mem))
+		mem = skip_Id(get_Proj_pred(mem));
+	return mem;
+}
+
+static void link_memop(ir_node *node, void *env)
+{
+	ir_memssa_t *const ms = (ir_memssa_t*)env;
+	if (!is_memop(node))
+		return;
+
+	ir_node       *const parent = skip_mem_proj(get_memop_mem(node));
+	memssa_node_t *const info   = get_node_info(ms, node);
+	info->parent = parent;
+	if (is_memop(parent)) {
+		memssa_node_t *const pinfo = get_node_info(ms, parent);
+		info->sibling = pinfo->child;
+		pinfo->child  = node;
+	} else {
+		ARR_APP1(ir_node*, ms->tops, node);
+	}
+}
+
+static void push_access(ir_memssa_t *ms, ir_node *node, unsigned cls,
+                        ir_node **prev)
+{
+	*prev = ms->last[cls];
+	ms->last[cls] = node;
+	ARR_APP1(ir_node*, ms->classes[cls].accesses, node);
+}
+
+static void enter_node(ir_memssa_t *ms, ir_node *node, ir_node *root,
+                       unsigned first)
+{
+	memssa_node_t *const info   = get_node_info(ms, node);
+	ir_node       *const parent = info->parent;
+	if (is_memop(parent)) {
+		memssa_node_t const *const pinfo = get_node_info(ms, parent);
+		info->nonlocal = pinfo->nonlocal;
+		info->any      = pinfo->any;
+	}
+	info->pre   = ++ms->n_pre;
+	info->root  = root;
+	info->first = first;
+
+	switch (get_irn_opcode(node)) {
+	case iro_Load:
+		push_access(ms, node, get_class(ms, get_Load_ptr(node)), &info->prev);
+		break;
+	case iro_Store:
+		push_access(ms, node, get_class(ms, get_Store_ptr(node)), &info->prev);
+		break;
+	case iro_CopyB: {
+		unsigned const dst = get_class(ms, get_CopyB_dst(node));
+		unsigned const src = get_class(ms, get_CopyB_src(node));
+		push_access(ms, node, dst, &info->prev);
+		if (src != dst)
+			push_access(ms, node, src, &info->prev_src);
+		break;
+	}
+	default:
+		if (touches_nonlocal(node))
+			info->nonlocal = node;
+		if (touches_any(node))
+			info->any = node;
+		break;
+	}
+}
+
+static void leave_node(ir_memssa_t *ms, ir_node *node)
+{
+	memssa_node_t *const info = get_node_info(ms, node);
+	info->post = ms->n_pre;
+
+	switch (get_irn_opcode(node)) {
+	case iro_Load:
+		ms->last[get_class(ms, get_Load_ptr(node))] = info->prev;
+		break;
+	case iro_Store:
+		ms->last[get_class(ms, get_Store_ptr(node))] = info->prev;
+		break;
+	case iro_CopyB: {
+		unsigned const dst = get_class(ms, get_CopyB_dst(node));
+		unsigned const src = get_class(ms, get_CopyB_src(node));
+		ms->last[dst] = info->prev;
+		if (src != dst)
+			ms->last[src] = info->prev_src;
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+/** Numbers the memory tree starting at @p top in preorder. */
+static void number_tree(ir_memssa_t *ms, ir_node *top, ir_node ***stack)
+{
+	ir_node *const root  = get_node_info(ms, top)->parent;
+	unsigned const first = ms->n_pre + 1;
+	ARR_APP1(ir_node*, *stack, top);
+	while (ARR_LEN(*stack) > 0) {
+		ir_node *const node = (*stack)[ARR_LEN(*stack) - 1];
+		if (get_node_info(ms, node)->pre != 0) {
+			leave_node(ms, node);
+			ARR_SHRINKLEN(*stack, ARR_LEN(*stack) - 1);
+			continue;
+		}
+		enter_node(ms, node, root, first);
+		for (ir_node *child = get_node_info(ms, node)->child; child != NULL;
+		     child = get_node_info(ms, child)->sibling) {
+			ARR_APP1(ir_node*, *stack, child);
+		}
+	}
+}
+
+static ir_node *get_prev(ir_memssa_t *ms, ir_node *access, unsigned cls)
+{
+	if (is_CopyB(access) && get_class(ms, get_CopyB_dst(access)) != cls)
+		return get_node_info(ms, access)->prev_src;
+	return get_node_info(ms, access)->prev;
+}
+
+/**
+ * Finds the nearest access of alias class @p cls at or above the tree node
+ * with preorder number @p pre in the tree starting at @p first.
+ */
+static ir_node *find_class_access(ir_memssa_t *ms, unsigned cls, unsigned pre,
+                                  unsigned first)
+{
+	ir_node **const accesses = ms->classes[cls].accesses;
+	size_t          lo       = 0;
+	size_t          hi       = ARR_LEN(accesses);
+	while (lo < hi) {
+		size_t const mid = lo + (hi - lo) / 2;
+		if (get_node_info(ms, accesses[mid])->pre <= pre)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == 0)
+		return NULL;
+
+	/* The last access numbered before the node is either above it or in a
+	 * subtree to its left. In the latter case the wanted access is one of
+	 * the accesses above that one. */
+	for (ir_node *access = accesses[lo - 1]; access != NULL;
+	     access = get_prev(ms, access, cls)) {
+		memssa_node_t const *const info = get_node_info(ms, access);
+		if (info->pre < first)
+			return NULL;
+		if (info->post >= pre)
+			return access;
+	}
+	return NULL;
+}
+
+/** Returns the lower one of two memory operations on the same tree path. */
+static ir_node *get_lower(ir_memssa_t *ms, ir_node *a, ir_node *b)
+{
+	if (a == NULL)
+		return b;
+	if (b == NULL)
+		return a;
+	return get_node_info(ms, a)->pre > get_node_info(ms, b)->pre ? a : b;
+}
+
+static ir_node *get_version(ir_memssa_t *ms, ir_node *mem, unsigned cls)
+{
+	++ms->visited;
+	ir_node *node = skip_mem_proj(mem);
+	for (;;) {
+		ir_node *const removed = get_node_info(ms, node)->removed;
+		if (removed != NULL) {
+			node = removed;
+			continue;
+		}
+		if (!is_memop(node))
+			return node;
+
+		if (get_node_info(ms, node)->pre == 0) {
+			/* created after the analysis or part of a memory cycle in
+			 * unreachable code: walk the memory chain */
+			if (get_access(ms, node, cls) != MEMSSA_NONE)
+				return node;
+			memssa_node_t *const info = get_node_info(ms, node);
+			if (info->visited == ms->visited)
+				return node;
+			info->visited = ms->visited;
+			node = skip_mem_proj(get_memop_mem(node));
+			continue;
+		}
+
+		memssa_node_t const *const info = get_node_info(ms, node);
+		ir_node *const root     = info->root;
+		ir_node *const any      = info->any;
+		ir_node *const nonlocal = ms->classes[cls].local ? NULL
+		                                                 : info->nonlocal;
+		ir_node       *version  = find_class_access(ms, cls, info->pre,
+		                                            info->first);
+		version = get_lower(ms, get_lower(ms, version, nonlocal), any);
+		if (version == NULL) {
+			node = root;
+		} else if (get_node_info(ms, version)->removed != NULL) {
+			node = version;
+		} else {
+			return version;
+		}
+	}
+}
+
+unsigned memssa_get_class(ir_node *ptr)
+{
+	return get_class(get_memssa(ptr), ptr);
+}
+
+bool memssa_may_read(ir_node *node, unsigned cls)
+{
+	return get_access(get_memssa(node), node, cls) & MEMSSA_READ;
+}
+
+bool memssa_may_write(ir_node *node, unsigned cls)
+{
+	return get_access(get_memssa(node), node, cls) & MEMSSA_WRITE;
+}
+
+ir_node *memssa_get_version(ir_node *mem, unsigned cls)
+{
+	return get_version(get_memssa(mem), mem, cls);
+}
+
+static ir_node *get_access_ptr(ir_node const *access)
+{
+	switch (get_irn_opcode(access)) {
+	case iro_Load:  return get_Load_ptr(access);
+	case iro_Store: return get_Store_ptr(access);
+	case iro_CopyB: return get_CopyB_dst(access);
+	default:        panic("%+F is not a memory access", access);
+	}
+}
+
+static ir_node *get_def(ir_memssa_t *ms, ir_node *access)
+{
+	unsigned const cls = get_class(ms, get_access_ptr(access));
+	return get_version(ms, get_memop_mem(access), cls);
+}
+
+ir_node *memssa_get_def(ir_node *access)
+{
+	return get_def(get_memssa(access), access);
+}
+
+ir_node *memssa_get_clobber(ir_node *access)
+{
+	ir_memssa_t *const ms = get_memssa(access);
+	ir_node     *ptr;
+	ir_type     *type;
+	unsigned     size;
+	if (is_Load(access)) {
+		ptr  = get_Load_ptr(access);
+		type = get_Load_type(access);
+		size = get_mode_size_bytes(get_Load_mode(access));
+	} else {
+		ptr  = get_Store_ptr(access);
+		type = get_Store_type(access);
+		size = get_mode_size_bytes(get_irn_mode(get_Store_value(access)));
+	}
+
+	unsigned const cls  = get_class(ms, ptr);
+	ir_node       *node = get_version(ms, get_memop_mem(access), cls);
+	while (is_memop(node) && node != access) {
+		if (get_access(ms, node, cls) & MEMSSA_WRITE) {
+			ir_node *other_ptr;
+			ir_type *other_type;
+			unsigned other_size;
+			if (is_Store(node)) {
+				other_ptr  = get_Store_ptr(node);
+				other_type = get_Store_type(node);
+				other_size = get_mode_size_bytes(
+					get_irn_mode(get_Store_value(node)));
+			} else if (is_CopyB(node)) {
+				other_ptr  = get_CopyB_dst(node);
+				other_type = get_CopyB_type(node);
+				other_size = get_type_size(other_type);
+			} else {
+				break;
+			}
+			if (get_alias_relation(other_ptr, other_type, other_size,
+			                       ptr, type, size) != ir_no_alias)
+				break;
+		}
+		node = get_version(ms, get_memop_mem(node), cls);
+	}
+	return node;
+}
+
+static void add_user(ir_memssa_t *ms, ir_node *def, ir_node *access)
+{
+	memssa_node_t *const info = get_node_info(ms, def);
+	if (info->users == NULL)
+		info->users = NEW_ARR_F(ir_node*, 0);
+	ARR_APP1(ir_node*, info->users, access);
+}
+
+static void remove_user(ir_memssa_t *ms, ir_node *def, ir_node *access)
+{
+	ir_node **const users = get_node_info(ms, def)->users;
+	if (users == NULL)
+		return;
+	for (size_t i = 0, n = ARR_LEN(users); i < n; ++i) {
+		if (users[i] == access) {
+			users[i] = users[n - 1];
+			ARR_SHRINKLEN(users, n - 1);
+			return;
+		}
+	}
+}
+
+static void add_access_walker(ir_node *node, void *env)
+{
+	ir_memssa_t *const ms = (ir_memssa_t*)env;
+	if (is_access(node))
+		add_user(ms, get_def(ms, node), node);
+}
+
+static void assure_users(ir_memssa_t *ms, ir_graph *irg)
+{
+	if (ms->has_users)
+		return;
+	irg_walk_graph(irg, NULL, add_access_walker, ms);
+	ms->has_users = true;
+}
+
+size_t memssa_get_n_users(ir_node *def)
+{
+	ir_memssa_t *const ms = get_memssa(def);
+	assure_users(ms, get_irn_irg(def));
+	ir_node **const users = get_node_info(ms, def)->users;
+	return users != NULL ? ARR_LEN(users) : 0;
+}
+
+ir_node *memssa_get_user(ir_node *def, size_t pos)
+{
+	ir_memssa_t *const ms = get_memssa(def);
+	assure_users(ms, get_irn_irg(def));
+	ir_node **const users = get_node_info(ms, def)->users;
+	assert(pos < ARR_LEN(users));
+	return users[pos];
+}
+
+void memssa_add_access(ir_node *access)
+{
+	ir_memssa_t *const ms = get_memssa(access);
+	if (ms->has_users)
+		add_user(ms, get_def(ms, access), access);
+}
+
+void memssa_remove(ir_node *node, ir_node *mem)
+{
+	ir_graph *const irg = get_irn_irg(node);
+	if (!irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA))
+		return;
+
+	ir_memssa_t *const ms = irg->memssa;
+	if (ms->has_users && is_access(node))
+		remove_user(ms, get_def(ms, node), node);
+
+	/* memory Projs are killed when they are exchanged, so remember the
+	 * operation producing the memory */
+	memssa_node_t *const info  = get_node_info(ms, node);
+	ir_node      **const users = info->users;
+	info->removed = skip_mem_proj(mem);
+	info->users   = NULL;
+	if (users != NULL) {
+		/* the users are defined by whatever replaces the node now */
+		for (size_t i = 0, n = ARR_LEN(users); i < n; ++i) {
+			ir_node *const user = users[i];
+			add_user(ms, get_def(ms, user), user);
+		}
+		DEL_ARR_F(users);
+	}
+}
+
+void assure_irg_memssa(ir_graph *irg)
+{
+	if (irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA))
+		return;
+	free_irg_memssa(irg);
+
+	ir_memssa_t *const ms = XMALLOCZ(ir_memssa_t);
+	ms->always_alias
+		= get_irg_memory_disambiguator_options(irg) & aa_opt_always_alias;
+	if (!ms->always_alias) {
+		assure_irg_entity_usage_computed(irg);
+		assure_irp_globals_entity_usage_computed();
+	}
+
+	memssa_class_t const escaped = {
+		.entity   = NULL,
+		.local    = false,
+		.accesses = NEW_ARR_F(ir_node*, 0),
+	};
+	ms->nodes          = NEW_ARR_FZ(memssa_node_t, get_irg_last_idx(irg));
+	ms->classes        = NEW_ARR_F(memssa_class_t, 0);
+	ms->entity_classes = pmap_create();
+	ms->tops           = NEW_ARR_F(ir_node*, 0);
+	ms->last           = NEW_ARR_FZ(ir_node*, 1);
+	ARR_APP1(memssa_class_t, ms->classes, escaped);
+
+	irg_walk_graph(irg, NULL, link_memop, ms);
+	ir_node **stack = NEW_ARR_F(ir_node*, 0);
+	for (size_t i = 0, n = ARR_LEN(ms->tops); i < n; ++i)
+		number_tree(ms, ms->tops[i], &stack);
+	DEL_ARR_F(stack);
+	DEL_ARR_F(ms->tops);
+	DEL_ARR_F(ms->last);
+	ms->tops = NULL;
+	ms->last = NULL;
+
+	irg->memssa = ms;
+	add_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA);
+}
+
+void free_irg_memssa(ir_graph *irg)
+{
+	ir_memssa_t *const ms = irg->memssa;
+	if (ms == NULL)
+		return;
+
+	for (size_t i = 0, n = ARR_LEN(ms->nodes); i < n; ++i) {
+		if (ms->nodes[i].users != NULL)
+			DEL_ARR_F(ms->nodes[i].users);
+	}
+	for (size_t i = 0, n = ARR_LEN(ms->classes); i < n; ++i)
+		DEL_ARR_F(ms->classes[i].accesses);
+	DEL_ARR_F(ms->nodes);
+	DEL_ARR_F(ms->classes);
+	pmap_destroy(ms->entity_classes);
+	free(ms);
+	irg->memssa = NULL;
+	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA);
+}
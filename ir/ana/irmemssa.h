@@ -0,0 +1,121 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Memory SSA: per alias class versions of the memory graph.
+ *
+ * The memory of a graph is split into alias classes: one class for each
+ * entity whose address is never taken and one class for all remaining
+ * ("escaped") memory. Accesses to different classes never alias.
+ *
+ * The version of a class at a memory value is the nearest memory operation
+ * above it that may read or write the class. If there is none on the linear
+ * memory chain above the value, the version is the memory Phi, Sync or
+ * initial memory the chain starts at. Memory operations which cannot touch
+ * a class are skipped, so walking the versions of a class only visits the
+ * operations that matter for it.
+ *
+ * The memory operations form trees hanging below these merge points. The
+ * trees are numbered in preorder and every class keeps its accesses in that
+ * order, so the version of a class is found by a binary search instead of a
+ * walk along the memory chain.
+ *
+ * The analysis is kept as the graph property
+ * IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA. Passes which remove memory
+ * operations while using it report this with memssa_remove().
+ *
+ * ldstopt walks the versions of a class, opt_ldst and parallelize_mem use
+ * the alias classes. scalar_replace and the address mode matchers of the
+ * backends do not use it, as they never walk the memory chain:
+ * scalar_replace finds its candidates through the users of the frame entity
+ * addresses and rebuilds the values with SSA construction, and the matchers
+ * ask whether an operand depends on a Load through any edge, which the
+ * heights answer and the memory SSA does not.
+ */
+#ifndef FIRM_ANA_IRMEMSSA_H
+#define FIRM_ANA_IRMEMSSA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "firm_types.h"
+
+/** The alias class of all memory not attributed to a single entity. */
+#define MEMSSA_CLASS_ESCAPED 0
+
+/**
+ * Computes the memory SSA of @p irg, if it is not up to date.
+ */
+void assure_irg_memssa(ir_graph *irg);
+
+/**
+ * Frees the memory SSA of @p irg.
+ */
+void free_irg_memssa(ir_graph *irg);
+
+/**
+ * Returns the alias class of the memory addressed by @p ptr.
+ */
+unsigned memssa_get_class(ir_node *ptr);
+
+/**
+ * Returns true if the memory operation @p node may read memory of alias
+ * class @p cls.
+ */
+bool memssa_may_read(ir_node *node, unsigned cls);
+
+/**
+ * Returns true if the memory operation @p node may modify memory of alias
+ * class @p cls.
+ */
+bool memssa_may_write(ir_node *node, unsigned cls);
+
+/**
+ * Returns the version of alias class @p cls at the memory value @p mem.
+ */
+ir_node *memssa_get_version(ir_node *mem, unsigned cls);
+
+/**
+ * Returns the defining access of the Load, Store or CopyB @p access, i.e.
+ * the version of the alias class of its address at its memory input.
+ * For a CopyB the destination address is used.
+ */
+ir_node *memssa_get_def(ir_node *access);
+
+/**
+ * Returns the nearest memory operation above the Load or Store @p access
+ * that may modify the memory it accesses. The memory Phi, Sync or initial
+ * memory starting the memory chain is returned if there is none.
+ */
+ir_node *memssa_get_clobber(ir_node *access);
+
+/**
+ * Returns the number of Loads, Stores and CopyBs whose defining access is
+ * @p def.
+ */
+size_t memssa_get_n_users(ir_node *def);
+
+/**
+ * Returns the @p pos-th access whose defining access is @p def.
+ */
+ir_node *memssa_get_user(ir_node *def, size_t pos);
+
+/**
+ * Registers the Load, Store or CopyB @p access created after the memory
+ * SSA was computed. New accesses are not entered into the memory trees, so
+ * an access inserted into an existing memory chain must take the place of a
+ * node reported to memssa_remove().
+ */
+void memssa_add_access(ir_node *access);
+
+/**
+ * Notifies the memory SSA that @p node is removed from the memory graph
+ * and its users now use the memory value @p mem. Must be called before
+ * @p node is killed or exchanged.
+ */
+void memssa_remove(ir_node *node, ir_node *mem);
+
+#endif
@@ -0,0 +1,950 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Scalar evolution: loop variant values as add recurrences.
+ */
+#include "irscev.h"
+
+#include "array.h"
+#include "debug.h"
+#include "hashptr.h"
+#include "irdom.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irloop_t.h"
+#include "irnode_t.h"
+#include "panic.h"
+#include "pmap.h"
+#include "set.h"
+#include "tv.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <limits.h>
+#include <string.h>
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+typedef enum scev_state_t {
+	SCEV_STATE_NONE,      /**< not computed yet */
+	SCEV_STATE_COMPUTING, /**< being computed */
+	SCEV_STATE_PENDING,   /**< header Phi whose recurrence is computed */
+	SCEV_STATE_TENTATIVE, /**< depends on a pending Phi */
+	SCEV_STATE_DONE,      /**< computed */
+} scev_state_t;
+
+typedef struct scev_node_t {
+	scev_t const *scev;
+	scev_state_t  state;
+	unsigned      level; /**< pending: position on the Phi stack,
+	                          tentative: lowest pending Phi it depends on */
+} scev_node_t;
+
+typedef struct scev_loop_t {
+	ir_node      *header;      /**< the single block entered from outside */
+	bool          irreducible; /**< the loop has several entry blocks */
+	bool          counted;     /**< the exits have been analyzed */
+	ir_node     **exits;       /**< control flow leaving the loop */
+	scev_t const *count;       /**< back edge count or NULL */
+	ir_tarval    *max_count;   /**< constant bound for the count or NULL */
+	scev_t const *no_wrap;     /**< recurrence which cannot wrap */
+} scev_loop_t;
+
+typedef struct ir_scev_t ir_scev_t;
+struct ir_scev_t {
+	set          *exprs;     /**< unique expressions */
+	scev_node_t  *nodes;     /**< node info indexed by node index */
+	pmap         *loops;     /**< maps ir_loop to scev_loop_t */
+	ir_node     **pending;   /**< header Phis whose recurrence is computed */
+	size_t       *tentative; /**< indices of tentative results */
+	unsigned      min_hit;   /**< lowest pending Phi the current
+	                              computation depends on */
+};
+
+static ir_scev_t *get_scev_data(ir_graph *irg)
+{
+	assert(irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_SCEV));
+	return irg->scev;
+}
+
+static scev_node_t *get_node_info(ir_scev_t *sc, ir_node const *node)
+{
+	unsigned const idx = get_irn_idx(node);
+	size_t   const len = ARR_LEN(sc->nodes);
+	if (idx >= len) {
+		unsigned const last_idx = get_irg_last_idx(get_irn_irg(node));
+		ARR_RESIZE(scev_node_t, sc->nodes, last_idx);
+		memset(&sc->nodes[len], 0, (last_idx - len) * sizeof(*sc->nodes));
+	}
+	return &sc->nodes[idx];
+}
+
+/** Returns the innermost loop of @p block or NULL if it is in none. */
+static ir_loop *get_block_loop(ir_node const *block)
+{
+	ir_loop *const loop = get_irn_loop(block);
+	return loop != NULL && get_loop_depth(loop) > 0 ? loop : NULL;
+}
+
+/** Returns the loop surrounding @p loop or NULL if there is none. */
+static ir_loop *get_parent_loop(ir_loop const *loop)
+{
+	ir_loop *const outer = get_loop_outer_loop(loop);
+	return get_loop_depth(outer) > 0 ? outer : NULL;
+}
+
+/** Returns true if @p inner is @p outer or nested in it. */
+static bool loop_contains(ir_loop const *outer, ir_loop const *inner)
+{
+	if (inner == NULL)
+		return false;
+	unsigned const depth = get_loop_depth(outer);
+	while (get_loop_depth(inner) > depth)
+		inner = get_loop_outer_loop(inner);
+	return inner == outer;
+}
+
+static bool block_in_loop(ir_node const *block, ir_loop const *loop)
+{
+	return loop_contains(loop, get_block_loop(block));
+}
+
+static scev_loop_t *get_loop_info(ir_scev_t *sc, ir_loop *loop)
+{
+	scev_loop_t *info = pmap_get(scev_loop_t, sc->loops, loop);
+	if (info == NULL) {
+		info        = XMALLOCZ(scev_loop_t);
+		info->exits = NEW_ARR_F(ir_node*, 0);
+		pmap_insert(sc->loops, loop, info);
+	}
+	return info;
+}
+
+/**
+ * Records the loop headers and exits of all loops left or entered through
+ * the control flow predecessors of @p block.
+ */
+static void collect_loop_edges(ir_node *block, void *env)
+{
+	ir_scev_t *const sc         = (ir_scev_t*)env;
+	ir_loop   *const block_loop = get_block_loop(block);
+	for (int i = 0, n = get_Block_n_cfgpreds(block); i < n; ++i) {
+		ir_node *const pred_block = get_Block_cfgpred_block(block, i);
+		if (pred_block == NULL)
+			continue;
+		ir_loop *const pred_loop = get_block_loop(pred_block);
+
+		for (ir_loop *loop = pred_loop; loop != NULL
+		     && !loop_contains(loop, block_loop);
+		     loop = get_parent_loop(loop)) {
+			scev_loop_t *const info = get_loop_info(sc, loop);
+			ARR_APP1(ir_node*, info->exits, get_Block_cfgpred(block, i));
+		}
+		for (ir_loop *loop = block_loop; loop != NULL
+		     && !loop_contains(loop, pred_loop);
+		     loop = get_parent_loop(loop)) {
+			scev_loop_t *const info = get_loop_info(sc, loop);
+			if (info->header != NULL && info->header != block)
+				info->irreducible = true;
+			info->header = block;
+		}
+	}
+}
+
+static int cmp_scev(void const *elt, void const *key, size_t size)
+{
+	return memcmp(elt, key, size);
+}
+
+static unsigned hash_scev(scev_t const *scev)
+{
+	unsigned const hash = hash_combine(scev->kind, hash_ptr(scev->mode));
+	switch (scev->kind) {
+	case SCEV_CONST:
+		return hash_combine(hash, hash_ptr(scev->u.tv));
+	case SCEV_VALUE:
+		return hash_combine(hash, hash_ptr(scev->u.node));
+	case SCEV_CONV:
+		return hash_combine(hash, hash_ptr(scev->u.op));
+	case SCEV_ADD:
+	case SCEV_MUL:
+		return hash_combine(hash, hash_combine(hash_ptr(scev->u.bin.left),
+		                                       hash_ptr(scev->u.bin.right)));
+	case SCEV_ADDREC:
+		return hash_combine(hash_combine(hash, hash_ptr(scev->u.rec.loop)),
+		                    hash_combine(hash_ptr(scev->u.rec.start),
+		                                 hash_ptr(scev->u.rec.step)));
+	}
+	panic("invalid scev kind");
+}
+
+/** Returns the unique expression equal to @p key. */
+static scev_t const *unique_scev(ir_scev_t *sc, scev_t const *key)
+{
+	return set_insert(scev_t, sc->exprs, key, sizeof(*key), hash_scev(key));
+}
+
+static scev_t const *new_const(ir_scev_t *sc, ir_tarval *tv)
+{
+	if (tv == tarval_bad)
+		return NULL;
+	scev_t key;
+	memset(&key, 0, sizeof(key));
+	key.kind = SCEV_CONST;
+	key.mode = get_tarval_mode(tv);
+	key.u.tv = tv;
+	return unique_scev(sc, &key);
+}
+
+static scev_t const *new_value(ir_scev_t *sc, ir_node *node)
+{
+	scev_t key;
+	memset(&key, 0, sizeof(key));
+	key.kind   = SCEV_VALUE;
+	key.mode   = get_irn_mode(node);
+	key.u.node = node;
+	return unique_scev(sc, &key);
+}
+
+static scev_t const *new_bin(ir_scev_t *sc, scev_kind_t kind, ir_mode *mode,
+                             scev_t const *left, scev_t const *right)
+{
+	scev_t key;
+	memset(&key, 0, sizeof(key));
+	key.kind        = kind;
+	key.mode        = mode;
+	key.u.bin.left  = left;
+	key.u.bin.right = right;
+	return unique_scev(sc, &key);
+}
+
+static bool is_const_null(scev_t const *scev)
+{
+	return scev->kind == SCEV_CONST && tarval_is_null(scev->u.tv);
+}
+
+static scev_t const *new_rec(ir_scev_t *sc, ir_loop *loop,
+                             scev_t const *start, scev_t const *step)
+{
+	if (start == NULL || step == NULL)
+		return NULL;
+	if (is_const_null(step))
+		return start;
+	scev_t key;
+	memset(&key, 0, sizeof(key));
+	key.kind        = SCEV_ADDREC;
+	key.mode        = start->mode;
+	key.u.rec.loop  = loop;
+	key.u.rec.start = start;
+	key.u.rec.step  = step;
+	return unique_scev(sc, &key);
+}
+
+bool scev_is_invariant(scev_t const *scev, ir_loop const *loop)
+{
+	switch (scev->kind) {
+	case SCEV_CONST:
+		return true;
+	case SCEV_VALUE:
+		return !block_in_loop(get_nodes_block(scev->u.node), loop);
+	case SCEV_CONV:
+		return scev_is_invariant(scev->u.op, loop);
+	case SCEV_ADD:
+	case SCEV_MUL:
+		return scev_is_invariant(scev->u.bin.left, loop)
+		    && scev_is_invariant(scev->u.bin.right, loop);
+	case SCEV_ADDREC:
+		return !loop_contains(loop, scev->u.rec.loop)
+		    && scev_is_invariant(scev->u.rec.start, loop)
+		    && scev_is_invariant(scev->u.rec.step, loop);
+	}
+	panic("invalid scev kind");
+}
+
+/**
+ * Returns true if @p scev describes the value at the end of @p block, i.e.
+ * contains no recurrence over a loop already left there.
+ */
+static bool is_valid_in(scev_t const *scev, ir_node const *block)
+{
+	switch (scev->kind) {
+	case SCEV_CONST:
+	case SCEV_VALUE:
+		return true;
+	case SCEV_CONV:
+		return is_valid_in(scev->u.op, block);
+	case SCEV_ADD:
+	case SCEV_MUL:
+		return is_valid_in(scev->u.bin.left, block)
+		    && is_valid_in(scev->u.bin.right, block);
+	case SCEV_ADDREC:
+		return block_in_loop(block, scev->u.rec.loop)
+		    && is_valid_in(scev->u.rec.start, block)
+		    && is_valid_in(scev->u.rec.step, block);
+	}
+	panic("invalid scev kind");
+}
+
+static scev_t const *scev_mul(ir_scev_t *sc, ir_mode *mode,
+                              scev_t const *left, scev_t const *right);
+
+/** Returns the sum of @p left and @p right in @p mode. */
+static scev_t const *scev_add(ir_scev_t *sc, ir_mode *mode,
+                              scev_t const *left, scev_t const *right)
+{
+	if (left == NULL || right == NULL)
+		return NULL;
+	/* keep recurrences of inner loops left */
+	if (right->kind == SCEV_ADDREC && (left->kind != SCEV_ADDREC
+	    || get_loop_depth(right->u.rec.loop)
+	       > get_loop_depth(left->u.rec.loop))) {
+		scev_t const *const tmp = left;
+		left  = right;
+		right = tmp;
+	}
+
+	if (left->kind == SCEV_ADDREC) {
+		ir_loop      *const loop = left->u.rec.loop;
+		scev_t const *const step = left->u.rec.step;
+		if (right->kind == SCEV_ADDREC && right->u.rec.loop == loop) {
+			if (right->u.rec.step->mode != step->mode)
+				return NULL;
+			scev_t const *const start
+				= scev_add(sc, mode, left->u.rec.start, right->u.rec.start);
+			return new_rec(sc, loop, start,
+			               scev_add(sc, step->mode, step, right->u.rec.step));
+		}
+		if (!scev_is_invariant(right, loop))
+			return NULL;
+		return new_rec(sc, loop, scev_add(sc, mode, left->u.rec.start, right),
+		               step);
+	}
+
+	/* keep references left */
+	if (mode_is_reference(right->mode)) {
+		scev_t const *const tmp = left;
+		left  = right;
+		right = tmp;
+	}
+	if (left->kind == SCEV_CONST && right->kind == SCEV_CONST
+	    && mode_is_int(mode) && left->mode == right->mode)
+		return new_const(sc, tarval_add(left->u.tv, right->u.tv));
+	if (is_const_null(right) && left->mode == mode)
+		return left;
+	if (is_const_null(left) && right->mode == mode)
+		return right;
+
+	/* keep constants right */
+	if (left->kind == SCEV_CONST && left->mode == right->mode) {
+		scev_t const *const tmp = left;
+		left  = right;
+		right = tmp;
+	}
+	return new_bin(sc, SCEV_ADD, mode, left, right);
+}
+
+/** Returns the product of @p left and @p right in the integer @p mode. */
+static scev_t const *scev_mul(ir_scev_t *sc, ir_mode *mode,
+                              scev_t const *left, scev_t const *right)
+{
+	if (left == NULL || right == NULL)
+		return NULL;
+	if (left->mode != mode || right->mode != mode)
+		return NULL;
+	/* keep constants right and recurrences left */
+	if (left->kind == SCEV_CONST || right->kind == SCEV_ADDREC) {
+		scev_t const *const tmp = left;
+		left  = right;
+		right = tmp;
+	}
+
+	if (left->kind == SCEV_CONST)
+		return new_const(sc, tarval_mul(left->u.tv, right->u.tv));
+	if (right->kind == SCEV_CONST) {
+		if (tarval_is_null(right->u.tv))
+			return right;
+		if (tarval_is_one(right->u.tv))
+			return left;
+	}
+
+	if (left->kind == SCEV_ADDREC) {
+		ir_loop *const loop = left->u.rec.loop;
+		if (right->kind == SCEV_ADDREC || !scev_is_invariant(right, loop))
+			return NULL;
+		return new_rec(sc, loop, scev_mul(sc, mode, left->u.rec.start, right),
+		               scev_mul(sc, mode, left->u.rec.step, right));
+	}
+	return new_bin(sc, SCEV_MUL, mode, left, right);
+}
+
+static scev_t const *scev_neg(ir_scev_t *sc, scev_t const *scev)
+{
+	if (scev == NULL)
+		return NULL;
+	ir_mode *const mode = scev->mode;
+	return scev_mul(sc, mode, scev, new_const(sc, get_mode_all_one(mode)));
+}
+
+static bool rec_no_wrap(ir_scev_t *sc, scev_t const *rec);
+
+/** Returns @p scev converted to @p mode. */
+static scev_t const *scev_conv(ir_scev_t *sc, ir_mode *mode, scev_t const *scev)
+{
+	if (scev == NULL)
+		return NULL;
+	ir_mode *const src_mode = scev->mode;
+	if (src_mode == mode)
+		return scev;
+	bool const int_conv = mode_is_int(mode) && mode_is_int(src_mode);
+
+	if (scev->kind == SCEV_CONST && int_conv)
+		return new_const(sc, tarval_convert_to(scev->u.tv, mode));
+
+	if (scev->kind == SCEV_ADDREC) {
+		if (!int_conv)
+			return NULL;
+		ir_loop      *const loop = scev->u.rec.loop;
+		scev_t const *const step = scev->u.rec.step;
+		/* truncation commutes with the wrapping addition */
+		if (get_mode_size_bits(mode) <= get_mode_size_bits(src_mode)) {
+			return new_rec(sc, loop, scev_conv(sc, mode, scev->u.rec.start),
+			               scev_conv(sc, mode, step));
+		}
+		if (step->kind != SCEV_CONST || !rec_no_wrap(sc, scev))
+			return NULL;
+		ir_mode   *const signed_mode = find_signed_mode(src_mode);
+		ir_tarval *const signed_step
+			= tarval_convert_to(step->u.tv, signed_mode);
+		return new_rec(sc, loop, scev_conv(sc, mode, scev->u.rec.start),
+		               new_const(sc, tarval_convert_to(signed_step, mode)));
+	}
+
+	scev_t key;
+	memset(&key, 0, sizeof(key));
+	key.kind = SCEV_CONV;
+	key.mode = mode;
+	key.u.op = scev;
+	return unique_scev(sc, &key);
+}
+
+static scev_t const *get_scev(ir_scev_t *sc, ir_node *node);
+
+/**
+ * Returns the evolution of the operand @p op used at the end of @p block.
+ * Unknown values defined outside of the loop of @p block are represented by
+ * their node.
+ */
+static scev_t const *get_operand(ir_scev_t *sc, ir_node const *block,
+                                 ir_node *op)
+{
+	scev_t const *const res = get_scev(sc, op);
+	if (res != NULL && is_valid_in(res, block))
+		return res;
+	ir_loop *const loop = get_block_loop(block);
+	if (loop == NULL || !block_in_loop(get_nodes_block(op), loop))
+		return new_value(sc, op);
+	return NULL;
+}
+
+/**
+ * Splits the evolution @p scev of a back edge value of a loop header Phi into
+ * the Phi @p phi_value plus a step invariant in @p loop and returns the step.
+ */
+static scev_t const *split_step(ir_scev_t *sc, scev_t const *scev,
+                                scev_t const *phi_value, ir_loop const *loop)
+{
+	if (scev == NULL || scev->kind != SCEV_ADD)
+		return NULL;
+	scev_t const *rest = scev->u.bin.right;
+	scev_t const *part = scev->u.bin.left;
+	if (!scev_is_invariant(rest, loop)) {
+		rest = scev->u.bin.left;
+		part = scev->u.bin.right;
+		if (!scev_is_invariant(rest, loop))
+			return NULL;
+	}
+	if (part == phi_value)
+		return rest;
+	return scev_add(sc, rest->mode, split_step(sc, part, phi_value, loop),
+	                rest);
+}
+
+static scev_t const *compute_header_phi(ir_scev_t *sc, ir_node *phi,
+                                        ir_loop *loop)
+{
+	scev_t const *const phi_value = new_value(sc, phi);
+	scev_node_t  *const info      = get_node_info(sc, phi);
+	info->state = SCEV_STATE_PENDING;
+	info->level = ARR_LEN(sc->pending);
+	info->scev  = phi_value;
+	ARR_APP1(ir_node*, sc->pending, phi);
+
+	ir_node      *const block = get_nodes_block(phi);
+	scev_t const *      start = NULL;
+	scev_t const *      step  = NULL;
+	bool                valid = true;
+	for (int i = 0, n = get_Phi_n_preds(phi); i < n && valid; ++i) {
+		ir_node *const pred_block = get_Block_cfgpred_block(block, i);
+		if (pred_block == NULL)
+			continue;
+		scev_t const *const op
+			= get_operand(sc, pred_block, get_Phi_pred(phi, i));
+		if (!block_in_loop(pred_block, loop)) {
+			valid = op != NULL && (start == NULL || start == op);
+			start = op;
+		} else {
+			scev_t const *const cur = op == phi_value
+				? NULL : split_step(sc, op, phi_value, loop);
+			valid = cur != NULL && (step == NULL || step == cur);
+			step  = cur;
+		}
+	}
+	ARR_SHRINKLEN(sc->pending, ARR_LEN(sc->pending) - 1);
+
+	if (!valid || start == NULL)
+		return NULL;
+	/* a Phi only passing itself around is its start value */
+	if (step == NULL)
+		return start;
+	return new_rec(sc, loop, start, step);
+}
+
+static scev_t const *compute_phi(ir_scev_t *sc, ir_node *phi)
+{
+	ir_node     *const block = get_nodes_block(phi);
+	ir_loop     *const loop  = get_block_loop(block);
+	scev_loop_t *const info  = pmap_get(scev_loop_t, sc->loops, loop);
+	if (info != NULL && info->header == block && !info->irreducible)
+		return compute_header_phi(sc, phi, loop);
+
+	/* other Phis merge equal values */
+	scev_t const *res = NULL;
+	for (int i = 0, n = get_Phi_n_preds(phi); i < n; ++i) {
+		ir_node *const pred_block = get_Block_cfgpred_block(block, i);
+		if (pred_block == NULL)
+			continue;
+		scev_t const *const op
+			= get_operand(sc, pred_block, get_Phi_pred(phi, i));
+		if (op == NULL || (res != NULL && res != op))
+			return NULL;
+		res = op;
+	}
+	if (res == NULL || !is_valid_in(res, block))
+		return NULL;
+	return res;
+}
+
+static scev_t const *compute_member(ir_scev_t *sc, ir_node *member)
+{
+	ir_entity *const entity = get_Member_entity(member);
+	ir_type   *const owner  = get_entity_owner(entity);
+	if (get_type_state(owner) != layout_fixed
+	    || get_entity_bitfield_size(entity) != 0)
+		return NULL;
+	ir_node      *const block = get_nodes_block(member);
+	ir_mode      *const mode  = get_irn_mode(member);
+	ir_mode      *const omode = get_reference_offset_mode(mode);
+	scev_t const *const ptr   = get_operand(sc, block, get_Member_ptr(member));
+	scev_t const *const offset
+		= new_const(sc, new_tarval_from_long(get_entity_offset(entity), omode));
+	return scev_add(sc, mode, ptr, offset);
+}
+
+static scev_t const *compute_scev(ir_scev_t *sc, ir_node *node)
+{
+	ir_mode *const mode = get_irn_mode(node);
+	if (!mode_is_int(mode) && !mode_is_reference(mode))
+		return NULL;
+	if (is_Const(node))
+		return new_const(sc, get_Const_tarval(node));
+	ir_node *const block = get_nodes_block(node);
+	if (get_block_loop(block) == NULL)
+		return new_value(sc, node);
+
+	switch (get_irn_opcode(node)) {
+	case iro_Add:
+		return scev_add(sc, mode, get_operand(sc, block, get_Add_left(node)),
+		                get_operand(sc, block, get_Add_right(node)));
+	case iro_Sub: {
+		ir_node *const right = get_Sub_right(node);
+		if (!mode_is_int(get_irn_mode(right)))
+			return NULL;
+		scev_t const *const neg = scev_neg(sc, get_operand(sc, block, right));
+		return scev_add(sc, mode, get_operand(sc, block, get_Sub_left(node)),
+		                neg);
+	}
+	case iro_Minus:
+		return scev_neg(sc, get_operand(sc, block, get_Minus_op(node)));
+	case iro_Mul:
+		return scev_mul(sc, mode, get_operand(sc, block, get_Mul_left(node)),
+		                get_operand(sc, block, get_Mul_right(node)));
+	case iro_Shl: {
+		ir_node *const right = get_Shl_right(node);
+		if (!is_Const(right) || !mode_is_int(mode))
+			return NULL;
+		ir_tarval *const amount = get_Const_tarval(right);
+		if (!tarval_is_long(amount) || get_tarval_long(amount) < 0
+		    || get_tarval_long(amount) >= (long)get_mode_size_bits(mode))
+			return NULL;
+		ir_tarval *const factor
+			= tarval_shl_unsigned(get_mode_one(mode), get_tarval_long(amount));
+		return scev_mul(sc, mode, get_operand(sc, block, get_Shl_left(node)),
+		                new_const(sc, factor));
+	}
+	case iro_Conv:
+		return scev_conv(sc, mode, get_operand(sc, block, get_Conv_op(node)));
+	case iro_Confirm:
+		return get_operand(sc, block, get_Confirm_value(node));
+	case iro_Member:
+		return compute_member(sc, node);
+	case iro_Phi:
+		return compute_phi(sc, node);
+	default:
+		return NULL;
+	}
+}
+
+/**
+ * Returns the evolution of @p node.
+ *
+ * While the recurrence of a loop header Phi is computed, the Phi stands for
+ * itself. Results depending on such a pending Phi are only kept until the
+ * Phi is done and computed again afterwards.
+ */
+static scev_t const *get_scev(ir_scev_t *sc, ir_node *node)
+{
+	scev_node_t *info = get_node_info(sc, node);
+	switch (info->state) {
+	case SCEV_STATE_DONE:
+		return info->scev;
+	case SCEV_STATE_COMPUTING:
+		return NULL;
+	case SCEV_STATE_PENDING:
+	case SCEV_STATE_TENTATIVE:
+		sc->min_hit = MIN(sc->min_hit, info->level);
+		return info->scev;
+	case SCEV_STATE_NONE:
+		break;
+	}
+
+	unsigned const depth       = ARR_LEN(sc->pending);
+	unsigned const saved       = sc->min_hit;
+	size_t   const n_tentative = ARR_LEN(sc->tentative);
+	info->state = SCEV_STATE_COMPUTING;
+	sc->min_hit = UINT_MAX;
+	scev_t const *const res = compute_scev(sc, node);
+
+	info       = get_node_info(sc, node);
+	info->scev = res;
+	if (sc->min_hit < depth) {
+		info->state = SCEV_STATE_TENTATIVE;
+		info->level = sc->min_hit;
+		ARR_APP1(size_t, sc->tentative, get_irn_idx(node));
+	} else {
+		info->state = SCEV_STATE_DONE;
+		for (size_t i = n_tentative, n = ARR_LEN(sc->tentative); i < n; ++i)
+			sc->nodes[sc->tentative[i]].state = SCEV_STATE_NONE;
+		ARR_SHRINKLEN(sc->tentative, n_tentative);
+	}
+	sc->min_hit = MIN(saved, sc->min_hit);
+	return res;
+}
+
+/**
+ * Computes how often an exit test passes if the tested recurrence starts at
+ * @p start, advances by @p step and is compared to @p limit by the relation
+ * @p rel for staying in the loop. All values are constants of @p mode.
+ * Returns the count in the unsigned mode or tarval_bad if the recurrence
+ * wraps or the test always passes.
+ */
+static ir_tarval *count_const(ir_mode *mode, ir_relation rel,
+                              ir_tarval *start, ir_tarval *step,
+                              ir_tarval *limit)
+{
+	if (!(tarval_cmp(start, limit) & rel))
+		return get_mode_null(find_unsigned_mode(mode));
+	if (rel == ir_relation_equal)
+		return get_mode_one(find_unsigned_mode(mode));
+
+	ir_mode   *const umode   = find_unsigned_mode(mode);
+	ir_mode   *const smode   = find_signed_mode(mode);
+	ir_tarval *const sstep   = tarval_convert_to(step, smode);
+	bool       const up      = tarval_is_negative(sstep) == 0;
+	ir_tarval *const ustart  = tarval_convert_to(start, umode);
+	ir_tarval *const ulimit  = tarval_convert_to(limit, umode);
+	ir_tarval *const abs     = tarval_convert_to(up ? sstep : tarval_neg(sstep),
+	                                             umode);
+	ir_tarval *      dist;
+	ir_tarval *      room;
+	if (up) {
+		if (rel != ir_relation_less && rel != ir_relation_less_equal
+		    && rel != ir_relation_less_greater)
+			return tarval_bad;
+		dist = tarval_sub(ulimit, ustart);
+		room = tarval_sub(tarval_convert_to(get_mode_max(mode), umode), ustart);
+	} else {
+		if (rel != ir_relation_greater && rel != ir_relation_greater_equal
+		    && rel != ir_relation_less_greater)
+			return tarval_bad;
+		dist = tarval_sub(ustart, ulimit);
+		room = tarval_sub(ustart, tarval_convert_to(get_mode_min(mode), umode));
+	}
+
+	int const  wrap = tarval_get_wrap_on_overflow();
+	tarval_set_wrap_on_overflow(false);
+	ir_tarval *count;
+	switch (rel) {
+	case ir_relation_less:
+	case ir_relation_greater:
+		count = tarval_add(tarval_div(tarval_sub(dist, get_mode_one(umode)),
+		                              abs),
+		                   get_mode_one(umode));
+		break;
+	case ir_relation_less_equal:
+	case ir_relation_greater_equal:
+		count = tarval_add(tarval_div(dist, abs), get_mode_one(umode));
+		break;
+	default:
+		/* the limit is hit exactly or the recurrence wraps */
+		if (tarval_is_null(tarval_mod(dist, abs))
+		    && (tarval_cmp(start, limit) & (up ? ir_relation_less
+		                                       : ir_relation_greater)))
+			count = tarval_div(dist, abs);
+		else
+			count = tarval_bad;
+		break;
+	}
+	/* the value leaving the loop must not wrap around */
+	if (count != tarval_bad) {
+		ir_tarval *const advance = tarval_mul(count, abs);
+		if (advance == tarval_bad
+		    || (tarval_cmp(advance, room) & ir_relation_greater))
+			count = tarval_bad;
+	}
+	tarval_set_wrap_on_overflow(wrap);
+	return count;
+}
+
+/**
+ * Analyzes the exit @p exit of @p loop. Sets @p count to the number of
+ * times the exit test passes and @p max to a constant bound for it, or to
+ * NULL if they are unknown.
+ */
+static void count_exit(ir_scev_t *sc, ir_loop *loop, scev_loop_t *info,
+                       ir_node **latches, ir_node *exit,
+                       scev_t const **count, ir_tarval **max)
+{
+	*count = NULL;
+	*max   = NULL;
+	if (!is_Proj(exit))
+		return;
+	ir_node *const cond = get_Proj_pred(exit);
+	if (!is_Cond(cond) || !is_Cmp(get_Cond_selector(cond)))
+		return;
+	/* the test must run in every iteration taking a back edge */
+	ir_node *const block = get_nodes_block(cond);
+	if (get_block_loop(block) != loop)
+		return;
+	for (size_t i = 0, n = ARR_LEN(latches); i < n; ++i) {
+		if (!block_dominates(block, latches[i]))
+			return;
+	}
+
+	ir_node *const cmp  = get_Cond_selector(cond);
+	ir_node *const left = get_Cmp_left(cmp);
+	ir_mode *const mode = get_irn_mode(left);
+	if (!mode_is_int(mode))
+		return;
+	ir_relation rel = get_Cmp_relation(cmp);
+	if (get_Proj_num(exit) == pn_Cond_true)
+		rel = get_negated_relation(rel);
+	rel &= ~ir_relation_unordered;
+
+	scev_t const *rec   = get_operand(sc, block, left);
+	scev_t const *limit = get_operand(sc, block, get_Cmp_right(cmp));
+	if (rec == NULL || limit == NULL)
+		return;
+	if (rec->kind != SCEV_ADDREC || rec->u.rec.loop != loop) {
+		scev_t const *const tmp = rec;
+		rec   = limit;
+		limit = tmp;
+		rel   = get_inversed_relation(rel);
+	}
+	if (rec->kind != SCEV_ADDREC || rec->u.rec.loop != loop
+	    || !scev_is_invariant(limit, loop)
+	    || rec->u.rec.step->kind != SCEV_CONST)
+		return;
+
+	scev_t const *const start = rec->u.rec.start;
+	ir_tarval    *const step  = rec->u.rec.step->u.tv;
+	bool const one       = tarval_is_one(step);
+	bool const minus_one = tarval_is_all_one(step);
+	/* a recurrence counting by one to a strict bound cannot wrap, neither
+	 * can one counting to a constant inclusive bound before the mode ends */
+	bool const fixed = limit->kind == SCEV_CONST;
+	bool const up    = one && (rel == ir_relation_less
+		|| (rel == ir_relation_less_equal && fixed
+		    && limit->u.tv != get_mode_max(mode)));
+	bool const down  = minus_one && (rel == ir_relation_greater
+		|| (rel == ir_relation_greater_equal && fixed
+		    && limit->u.tv != get_mode_min(mode)));
+	if (info->no_wrap == NULL && (up || down))
+		info->no_wrap = rec;
+
+	ir_mode *const umode = find_unsigned_mode(mode);
+	if (start->kind == SCEV_CONST && limit->kind == SCEV_CONST) {
+		ir_tarval *const tv
+			= count_const(mode, rel, start->u.tv, step, limit->u.tv);
+		if (tv != tarval_bad) {
+			*count = new_const(sc, tv);
+			*max   = tv;
+		}
+		return;
+	}
+
+	/* the count assuming that the loop is entered */
+	if ((one && (rel == ir_relation_less || rel == ir_relation_less_greater))) {
+		*count = scev_add(sc, umode, scev_conv(sc, umode, limit),
+		                  scev_neg(sc, scev_conv(sc, umode, start)));
+	} else if (minus_one && (rel == ir_relation_greater
+	                         || rel == ir_relation_less_greater)) {
+		*count = scev_add(sc, umode, scev_conv(sc, umode, start),
+		                  scev_neg(sc, scev_conv(sc, umode, limit)));
+	}
+}
+
+static void count_loop(ir_scev_t *sc, ir_loop *loop, scev_loop_t *info)
+{
+	info->counted = true;
+	ir_node *const header = info->header;
+	if (header == NULL || info->irreducible)
+		return;
+
+	ir_node **latches = NEW_ARR_F(ir_node*, 0);
+	for (int i = 0, n = get_Block_n_cfgpreds(header); i < n; ++i) {
+		ir_node *const pred_block = get_Block_cfgpred_block(header, i);
+		if (pred_block != NULL && block_in_loop(pred_block, loop))
+			ARR_APP1(ir_node*, latches, pred_block);
+	}
+
+	size_t const n_exits = ARR_LEN(info->exits);
+	for (size_t i = 0; i < n_exits; ++i) {
+		scev_t const *count;
+		ir_tarval    *max;
+		count_exit(sc, loop, info, latches, info->exits[i], &count, &max);
+		if (n_exits == 1)
+			info->count = count;
+		/* every back edge passes the exit test, so each bounds the loop */
+		if (max != NULL && (info->max_count == NULL
+		    || tarval_cmp(max, info->max_count) == ir_relation_less))
+			info->max_count = max;
+	}
+	DEL_ARR_F(latches);
+	DB((dbg, LEVEL_2, "%+F: %zu exits, count %s\n", header, n_exits,
+	    info->count != NULL ? "known" : "unknown"));
+}
+
+static scev_loop_t *get_counted_loop(ir_scev_t *sc, ir_loop *loop)
+{
+	scev_loop_t *const info = pmap_get(scev_loop_t, sc->loops, loop);
+	if (info != NULL && !info->counted)
+		count_loop(sc, loop, info);
+	return info;
+}
+
+/**
+ * Returns true if the recurrence @p rec does not wrap around while its loop
+ * iterates. Besides the recurrence bounded by the exit test, this holds for
+ * recurrences with the same step starting no further in its direction.
+ */
+static bool rec_no_wrap(ir_scev_t *sc, scev_t const *rec)
+{
+	scev_loop_t const *const info = get_counted_loop(sc, rec->u.rec.loop);
+	if (info == NULL || info->no_wrap == NULL)
+		return false;
+	scev_t const *const bounded = info->no_wrap;
+	if (bounded == rec)
+		return true;
+	scev_t const *const start = rec->u.rec.start;
+	scev_t const *const limit = bounded->u.rec.start;
+	if (rec->u.rec.step != bounded->u.rec.step || rec->mode != bounded->mode
+	    || start->kind != SCEV_CONST || limit->kind != SCEV_CONST)
+		return false;
+	ir_relation const behind = tarval_is_one(rec->u.rec.step->u.tv)
+		? ir_relation_less_equal : ir_relation_greater_equal;
+	return (tarval_cmp(start->u.tv, limit->u.tv) & behind) != 0;
+}
+
+scev_t const *scev_get(ir_node *node)
+{
+	ir_scev_t *const sc = get_scev_data(get_irn_irg(node));
+	return get_scev(sc, node);
+}
+
+static ir_scev_t *get_loop_scev_data(ir_loop const *loop)
+{
+	loop_element const element = get_loop_element(loop, 0);
+	if (*element.kind == k_ir_loop)
+		return get_loop_scev_data(element.son);
+	return get_scev_data(get_irn_irg(element.node));
+}
+
+scev_t const *scev_get_backedge_count(ir_loop *loop)
+{
+	ir_scev_t   *const sc   = get_loop_scev_data(loop);
+	scev_loop_t *const info = get_counted_loop(sc, loop);
+	return info != NULL ? info->count : NULL;
+}
+
+ir_tarval *scev_get_max_backedge_count(ir_loop *loop)
+{
+	ir_scev_t   *const sc   = get_loop_scev_data(loop);
+	scev_loop_t *const info = get_counted_loop(sc, loop);
+	return info != NULL ? info->max_count : NULL;
+}
+
+void assure_irg_scev(ir_graph *irg)
+{
+	if (irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_SCEV))
+		return;
+	free_irg_scev(irg);
+	FIRM_DBG_REGISTER(dbg, "firm.ana.scev");
+
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO
+		| IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+
+	ir_scev_t *const sc = XMALLOCZ(ir_scev_t);
+	sc->exprs     = new_set(cmp_scev, 64);
+	sc->nodes     = NEW_ARR_FZ(scev_node_t, get_irg_last_idx(irg));
+	sc->loops     = pmap_create();
+	sc->pending   = NEW_ARR_F(ir_node*, 0);
+	sc->tentative = NEW_ARR_F(size_t, 0);
+	irg_block_walk_graph(irg, collect_loop_edges, NULL, sc);
+
+	irg->scev = sc;
+	add_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_SCEV);
+}
+
+void free_irg_scev(ir_graph *irg)
+{
+	ir_scev_t *const sc = irg->scev;
+	if (sc == NULL)
+		return;
+
+	foreach_pmap(sc->loops, entry) {
+		scev_loop_t *const info = (scev_loop_t*)entry->value;
+		DEL_ARR_F(info->exits);
+		free(info);
+	}
+	pmap_destroy(sc->loops);
+	del_set(sc->exprs);
+	DEL_ARR_F(sc->nodes);
+	DEL_ARR_F(sc->pending);
+	DEL_ARR_F(sc->tentative);
+	free(sc);
+	irg->scev = NULL;
+	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_SCEV);
+}
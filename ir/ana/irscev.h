@@ -0,0 +1,100 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Scalar evolution: loop variant values as add recurrences.
+ *
+ * The scalar evolution of an integer or reference value describes how it
+ * changes over the iterations of the loops it is defined in. Values which
+ * advance by a loop invariant step each iteration of a loop are represented
+ * as add recurrences {start,+,step} over that loop, where start may itself
+ * be a recurrence over an outer loop. Values defined outside of a loop are
+ * invariant in it and represented by their node, constants by their tarval.
+ *
+ * Expressions are unique, so equal expressions are the same object.
+ *
+ * Based on the exit conditions the analysis computes how often the back
+ * edges of a loop are taken. The arithmetic of firm wraps around, so a
+ * count is only given if the counting recurrence provably cannot wrap
+ * before the exit is taken.
+ *
+ * The analysis is kept as the graph property
+ * IR_GRAPH_PROPERTY_CONSISTENT_SCEV.
+ */
+#ifndef FIRM_ANA_IRSCEV_H
+#define FIRM_ANA_IRSCEV_H
+
+#include <stdbool.h>
+
+#include "firm_types.h"
+
+typedef enum scev_kind_t {
+	SCEV_CONST,  /**< a constant */
+	SCEV_VALUE,  /**< the value of a node */
+	SCEV_ADD,    /**< the sum of two expressions */
+	SCEV_MUL,    /**< the product of two expressions */
+	SCEV_CONV,   /**< an expression converted to another mode */
+	SCEV_ADDREC, /**< an add recurrence over a loop */
+} scev_kind_t;
+
+typedef struct scev_t scev_t;
+struct scev_t {
+	scev_kind_t  kind;
+	ir_mode     *mode;
+	union {
+		ir_tarval *tv;       /**< SCEV_CONST */
+		ir_node   *node;     /**< SCEV_VALUE */
+		scev_t const *op;    /**< SCEV_CONV */
+		struct {
+			scev_t const *left;
+			scev_t const *right;
+		} bin;               /**< SCEV_ADD, SCEV_MUL */
+		struct {
+			ir_loop      *loop;
+			scev_t const *start; /**< value in the first iteration */
+			scev_t const *step;  /**< increment per iteration */
+		} rec;               /**< SCEV_ADDREC */
+	} u;
+};
+
+/**
+ * Computes the scalar evolution analysis of @p irg, if it is not up to
+ * date.
+ */
+void assure_irg_scev(ir_graph *irg);
+
+/**
+ * Frees the scalar evolution analysis of @p irg.
+ */
+void free_irg_scev(ir_graph *irg);
+
+/**
+ * Returns the scalar evolution of @p node or NULL if it is unknown.
+ */
+scev_t const *scev_get(ir_node *node);
+
+/**
+ * Returns true if the value of @p scev does not change while @p loop
+ * iterates.
+ */
+bool scev_is_invariant(scev_t const *scev, ir_loop const *loop);
+
+/**
+ * Returns the number of times a back edge of @p loop is taken after the
+ * loop is entered or NULL if it is unknown. The result is invariant in the
+ * loop and has the unsigned mode of the counting value. A constant count is
+ * exact. A symbolic count assumes that the exit is not taken at the first
+ * test of the exit condition.
+ */
+scev_t const *scev_get_backedge_count(ir_loop *loop);
+
+/**
+ * Returns a constant upper bound for the number of times a back edge of
+ * @p loop is taken after the loop is entered or NULL if none is known.
+ */
+ir_tarval *scev_get_max_backedge_count(ir_loop *loop);
+
+#endif
@@ -11,6 +11,7 @@
 #include "vrp.h"
 
 #include "bitset.h"
+#include "constbits.h"
 #include "debug.h"
 #include "iredges_t.h"
 #include "irgopt.h"
@@ -340,6 +341,39 @@ static int vrp_update_node(ir_vrp_info *info, ir_node *node)
 
 		break;
 	}
+	case iro_Proj: {
+		ir_tarval *z;
+		ir_tarval *o;
+		/* bottom (some bit both zero and one) is not representable here */
+		if (get_interprocedural_bits(node, &z, &o)
+		    && tarval_is_null(tarval_andnot(o, z))) {
+			new_bits_set     = o;
+			new_bits_not_set = z;
+			/* with a known sign bit the bits bound the value */
+			ir_mode *const mode = get_irn_mode(node);
+			if (!mode_is_signed(mode) || tarval_is_negative(o)
+			    || !tarval_is_negative(z)) {
+				new_range_bottom = o;
+				new_range_top    = z;
+				new_range_type   = VRP_RANGE;
+			}
+		}
+
+		/* intersect with the joined ranges of the arguments or Returns */
+		ir_tarval *bottom;
+		ir_tarval *top;
+		if (!get_interprocedural_range(node, &bottom, &top))
+			break;
+		if (new_range_type != VRP_RANGE
+		    || tarval_cmp(bottom, new_range_bottom) == ir_relation_greater)
+			new_range_bottom = bottom;
+		if (new_range_type != VRP_RANGE
+		    || tarval_cmp(top, new_range_top) == ir_relation_less)
+			new_range_top = top;
+		new_range_type = VRP_RANGE;
+		break;
+	}
+
 	default:
 		/* unhandled, therefore never updated */
 		break;
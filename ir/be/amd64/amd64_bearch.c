@@ -27,6 +27,7 @@
 #include "gen_amd64_regalloc_if.h"
 #include "irarch.h"
 #include "ircons.h"
+#include "irdom.h"
 #include "iredges_t.h"
 #include "irgmod.h"
 #include "irgopt.h"
@@ -424,6 +425,9 @@ static void amd64_select_instructions(ir_graph *irg)
 
 static void introduce_epilogue(ir_node *ret, bool omit_fp)
 {
+	/* tail calls have their memory and stack inputs at the same positions */
+	assert(n_amd64_tail_call_mem == n_amd64_ret_mem
+	    && n_amd64_tail_call_stack == n_amd64_ret_stack);
 	ir_graph *irg      = get_irn_irg(ret);
 	ir_node  *block    = get_nodes_block(ret);
 	ir_node  *first_sp = get_irn_n(ret, n_amd64_ret_stack);
@@ -459,12 +463,12 @@ static void introduce_epilogue(ir_node *ret, bool omit_fp)
 	}
 }
 
-static void introduce_prologue(ir_graph *const irg, bool omit_fp)
+static void introduce_prologue(ir_graph *const irg, ir_node *const block,
+                               bool omit_fp)
 {
 	const arch_register_t *sp         = &amd64_registers[REG_RSP];
 	const arch_register_t *bp         = &amd64_registers[REG_RBP];
-	ir_node               *start      = get_irg_start(irg);
-	ir_node               *block      = get_nodes_block(start);
+	ir_node               *first      = be_move_after_schedule_first(block);
 	ir_type               *frame_type = get_irg_frame_type(irg);
 	unsigned               frame_size = get_type_size(frame_type);
 	ir_node               *initial_sp = be_get_Start_proj(irg, sp);
@@ -474,40 +478,51 @@ static void introduce_prologue(ir_graph *const irg, bool omit_fp)
 		ir_node *const mem        = get_irg_initial_mem(irg);
 		ir_node *const initial_bp = be_get_Start_proj(irg, bp);
 		ir_node *const push       = new_bd_amd64_push_reg(NULL, block, initial_sp, mem, initial_bp, X86_SIZE_64);
-		sched_add_after(start, push);
+		sched_add_after(first, push);
 		ir_node *const curr_mem   = be_new_Proj(push, pn_amd64_push_reg_M);
-		edges_reroute_except(mem, curr_mem, push);
+		be_reroute_dominated_users(mem, curr_mem, block, push);
 		ir_node *const curr_sp    = be_new_Proj_reg(push, pn_amd64_push_reg_stack, sp);
 
 		/* move rsp to rbp */
 		ir_node *const curr_bp = be_new_Copy(block, curr_sp);
 		sched_add_after(push, curr_bp);
 		arch_copy_irn_out_info(curr_bp, 0, initial_bp);
-		edges_reroute_except(initial_bp, curr_bp, push);
+		be_reroute_dominated_users(initial_bp, curr_bp, block, push);
 
 		ir_node *incsp = amd64_new_IncSP(block, curr_sp, frame_size, false);
 		sched_add_after(curr_bp, incsp);
-		edges_reroute_except(initial_sp, incsp, push);
+		be_reroute_dominated_users(initial_sp, incsp, block, push);
 
 		/* make sure the initial IncSP is really used by someone */
 		be_keep_if_unused(incsp);
 	} else {
 		ir_node *const incsp = amd64_new_IncSP(block, initial_sp,
 		                                       frame_size, false);
-		sched_add_after(start, incsp);
-		edges_reroute_except(initial_sp, incsp, incsp);
+		sched_add_after(first, incsp);
+		be_reroute_dominated_users(initial_sp, incsp, block, incsp);
 	}
 }
 
+/**
+ * Put the prologue code into the block determined by shrink-wrapping and
+ * epilogue code before each return dominated by it.
+ */
 static void introduce_prologue_epilogue(ir_graph *irg, bool omit_fp)
 {
+	amd64_irg_data_t *const irg_data = amd64_get_irg_data(irg);
+	ir_node          *const block    = be_get_prologue_block(irg,
+		&amd64_registers[REG_RSP], omit_fp ? NULL : &amd64_registers[REG_RBP],
+		&amd64_reg_classes[CLASS_amd64_flags]);
+	irg_data->prologue_block = block;
+
 	/* introduce epilogue for every return node */
 	foreach_irn_in(get_irg_end_block(irg), i, ret) {
-		assert(is_amd64_ret(ret));
-		introduce_epilogue(ret, omit_fp);
+		assert(is_amd64_ret(ret) || is_amd64_tail_call(ret));
+		if (block_dominates(block, get_nodes_block(ret)))
+			introduce_epilogue(ret, omit_fp);
 	}
 
-	introduce_prologue(irg, omit_fp);
+	introduce_prologue(irg, block, omit_fp);
 }
 
 static bool node_has_sp_base(ir_node const *const node,
@@ -744,13 +759,14 @@ static void amd64_lower_for_target(void)
 		be_after_transform(irg, "lower-copyb");
 	}
 
-	ir_builtin_kind supported[6];
+	ir_builtin_kind supported[7];
 	size_t  s = 0;
 	supported[s++] = ir_bk_ffs;
 	supported[s++] = ir_bk_clz;
 	supported[s++] = ir_bk_ctz;
 	supported[s++] = ir_bk_compare_swap;
 	supported[s++] = ir_bk_saturating_increment;
+	supported[s++] = ir_bk_prefetch;
 	supported[s++] = ir_bk_va_start;
 
 	assert(s <= ARRAY_SIZE(supported));
@@ -834,6 +850,7 @@ void be_init_arch_amd64(void)
 {
 	static const lc_opt_table_entry_t options[] = {
 		LC_OPT_ENT_BOOL("no-red-zone", "gcc compatibility",                &amd64_use_red_zone),
+		LC_OPT_ENT_BOOL("fma",         "use FMA3 instructions (needs AVX)", &amd64_use_fma),
 		LC_OPT_LAST
 	};
 	lc_opt_entry_t *be_grp    = lc_opt_get_grp(firm_opt_get_root(), "be");
@@ -15,7 +15,8 @@
 #include "../ia32/x86_x87.h"
 
 typedef struct amd64_irg_data_t {
-	bool omit_fp;
+	bool     omit_fp;
+	ir_node *prologue_block; /**< block containing the prologue */
 } amd64_irg_data_t;
 
 extern pmap *amd64_constants; /**< A map of entities that store const tarvals */
@@ -23,6 +24,7 @@ extern pmap *amd64_constants; /**< A map of entities that store const tarvals */
 extern ir_mode *amd64_mode_xmm;
 
 extern bool amd64_use_red_zone;
+extern bool amd64_use_fma;
 
 #define AMD64_REGISTER_SIZE   8
 /** power of two stack alignment on calls */
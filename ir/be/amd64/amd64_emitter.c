@@ -24,14 +24,16 @@
 #include "besched.h"
 #include "gen_amd64_emitter.h"
 #include "gen_amd64_regalloc_if.h"
+#include "irdom.h"
 #include "iredges_t.h"
 #include "irgwalk.h"
 #include "panic.h"
 #include "platform_t.h"
 #include <inttypes.h>
 
-static bool omit_fp;
-static int  frame_type_size;
+static bool     omit_fp;
+static int      frame_type_size;
+static ir_node *prologue_block;
 static int  callframe_offset;
 
 static char get_gp_size_suffix(x86_insn_size_t const size)
@@ -814,10 +816,9 @@ static void amd64_gen_block(ir_node *block)
 	be_gas_begin_block(block);
 
 	if (omit_fp) {
-		ir_graph *irg = get_irn_irg(block);
 		callframe_offset = 8; /* 8 bytes for the return address */
 		/* RSP guessing, TODO perform a real RSP simulation */
-		if (block != get_irg_start_block(irg)) {
+		if (block != prologue_block && block_dominates(prologue_block, block)) {
 			callframe_offset += frame_type_size;
 		}
 		be_dwarf_callframe_offset(callframe_offset);
@@ -858,6 +859,8 @@ void amd64_emit_function(ir_graph *irg)
 	if (omit_fp) {
 		ir_type *frame_type = get_irg_frame_type(irg);
 		frame_type_size = get_type_size(frame_type);
+		prologue_block  = irg_data->prologue_block;
+		assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 		be_dwarf_callframe_register(&amd64_registers[REG_RSP]);
 	} else {
 		/* well not entirely correct here, we should emit this after the
@@ -868,8 +871,11 @@ void amd64_emit_function(ir_graph *irg)
 		be_dwarf_callframe_spilloffset(&amd64_registers[REG_RBP], -16);
 	}
 
+	ir_node *const first_cold = be_birg_from_irg(irg)->first_cold_block;
 	for (size_t i = 0, n = ARR_LEN(blk_sched); i < n; ++i) {
 		ir_node *block = blk_sched[i];
+		if (block == first_cold)
+			be_gas_emit_function_cold_part(entity);
 		amd64_gen_block(block);
 	}
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
@@ -233,6 +233,30 @@ my $binopx_commutative = {
 	emit      => "{name}%MX %AM",
 };
 
+my $fmaop = {
+	irn_flags => [ "rematerializable" ],
+	state     => "exc_pinned",
+	in_reqs   => "...",
+	out_reqs  => [ "xmm", "none", "mem" ],
+	outs      => [ "res", "none", "M" ],
+	attr_type => "amd64_addr_attr_t",
+	attr      => "x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr",
+	emit      => "{name}%MX %AM, %S1, %D0",
+};
+
+my $prefetchop = {
+	op_flags  => [ "uses_memory" ],
+	state     => "exc_pinned",
+	in_reqs   => "...",
+	out_reqs  => [ "mem" ],
+	outs      => [ "M" ],
+	attr_type => "amd64_addr_attr_t",
+	attr      => "x86_addr_t addr",
+	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_ADDR;\n"
+	            ."x86_insn_size_t size    = X86_SIZE_8;\n",
+	emit      => "{name} %AM",
+};
+
 my $cvtop2x = {
 	state     => "exc_pinned",
 	in_reqs   => "...",
@@ -520,6 +544,14 @@ jcc => {
 	fixed     => "x86_insn_size_t size = X86_SIZE_64;",
 },
 
+prefetcht0  => { template => $prefetchop },
+
+prefetcht1  => { template => $prefetchop },
+
+prefetcht2  => { template => $prefetchop },
+
+prefetchnta => { template => $prefetchop },
+
 mov_store => {
 	op_flags  => [ "uses_memory" ],
 	state     => "exc_pinned",
@@ -562,6 +594,18 @@ ret => {
 	emit     => "ret",
 },
 
+tail_call => {
+	state     => "pinned",
+	op_flags  => [ "cfopcode" ],
+	in_reqs   => "...",
+	out_reqs  => [ "exec" ],
+	ins       => [ "mem", "stack" ],
+	attr_type => "amd64_addr_attr_t",
+	attr      => "amd64_op_mode_t op_mode, x86_addr_t addr",
+	fixed     => "x86_insn_size_t size = X86_SIZE_64;\n",
+	emit      => "jmp %*AM",
+},
+
 bsf => { template => $unop_out },
 
 bsr => { template => $unop_out },
@@ -622,6 +666,13 @@ xorp_0 => {
 
 xorp => { template => $binopx_commutative },
 
+# FMA3 (VEX encoded), input 0 is the accumulator, 1 and 2 the factors
+vfmadd231s => { template => $fmaop },
+
+vfmsub231s => { template => $fmaop },
+
+vfnmadd231s => { template => $fmaop },
+
 movd_xmm_gp => {
 	state     => "exc_pinned",
 	ins       => [ "operand" ],
@@ -15,6 +15,7 @@
 #include "amd64_new_nodes.h"
 #include "amd64_nodes_attr.h"
 #include "amd64_varargs.h"
+#include "be_t.h"
 #include "beirg.h"
 #include "benode.h"
 #include "besched.h"
@@ -29,6 +30,7 @@
 #include "irmode_t.h"
 #include "irnode_t.h"
 #include "iropt_t.h"
+#include "iroptimize.h"
 #include "irprog_t.h"
 #include "panic.h"
 #include "platform_t.h"
@@ -37,6 +39,8 @@
 
 DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
 
+bool amd64_use_fma = false;
+
 static x86_cconv_t    *current_cconv = NULL;
 static be_stack_env_t  stack_env;
 
@@ -109,6 +113,13 @@ static const arch_register_req_t amd64_requirement_xmm_same_0_not_1 = {
 	.width             = 1,
 };
 
+static const arch_register_req_t amd64_requirement_xmm_same_0_not_1_2 = {
+	.cls               = &amd64_reg_classes[CLASS_amd64_xmm],
+	.should_be_same    = BIT(0),
+	.must_be_different = BIT(1) | BIT(2),
+	.width             = 1,
+};
+
 static const arch_register_req_t amd64_requirement_x87killed = {
 	.cls         = &amd64_reg_classes[CLASS_amd64_x87],
 	.width       = 1,
@@ -183,6 +194,27 @@ static const arch_register_req_t *xmm_reg_reg_mem_reqs[] = {
 	&arch_memory_requirement,
 };
 
+static const arch_register_req_t *xmm_xmm_mem_reqs[] = {
+	&amd64_class_reg_req_xmm,
+	&amd64_class_reg_req_xmm,
+	&arch_memory_requirement,
+};
+
+static const arch_register_req_t *xmm_xmm_reg_mem_reqs[] = {
+	&amd64_class_reg_req_xmm,
+	&amd64_class_reg_req_xmm,
+	&amd64_class_reg_req_gp,
+	&arch_memory_requirement,
+};
+
+static const arch_register_req_t *xmm_xmm_reg_reg_mem_reqs[] = {
+	&amd64_class_reg_req_xmm,
+	&amd64_class_reg_req_xmm,
+	&amd64_class_reg_req_gp,
+	&amd64_class_reg_req_gp,
+	&arch_memory_requirement,
+};
+
 static const arch_register_req_t *x87K_reg_reg_mem_reqs[] = {
 	&amd64_requirement_x87killed,
 	&amd64_class_reg_req_gp,
@@ -251,6 +283,12 @@ arch_register_req_t const *amd64_xmm_xmm_reqs[] = {
 	&amd64_class_reg_req_xmm,
 };
 
+static arch_register_req_t const *xmm_xmm_xmm_reqs[] = {
+	&amd64_class_reg_req_xmm,
+	&amd64_class_reg_req_xmm,
+	&amd64_class_reg_req_xmm,
+};
+
 arch_register_req_t const **const gp_am_reqs[] = {
 	mem_reqs,
 	reg_mem_reqs,
@@ -265,6 +303,13 @@ static arch_register_req_t const **const xmm_am_reqs[] = {
 	xmm_reg_reg_mem_reqs,
 };
 
+/* indexed by arity - 2, the first two inputs are accumulator and factor */
+static arch_register_req_t const **const xmm_xmm_am_reqs[] = {
+	xmm_xmm_mem_reqs,
+	xmm_xmm_reg_mem_reqs,
+	xmm_xmm_reg_reg_mem_reqs,
+};
+
 static arch_register_req_t const **const x87K_am_reqs[] = {
 	mem_reqs,
 	x87K_mem_reqs,
@@ -985,6 +1030,89 @@ static x86_insn_size_t get_size_32_64_from_mode(ir_mode *const mode)
 	return get_mode_size_bits(mode) <= 32 ? X86_SIZE_32 : X86_SIZE_64;
 }
 
+typedef ir_node *(*construct_fma_func)(dbg_info *dbgi, ir_node *block,
+		int arity, ir_node *const *in, arch_register_req_t const **in_reqs,
+		x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr);
+
+/**
+ * Checks whether @p node is a multiplication which can be contracted into
+ * a fused multiply-add computing the result of @p user.
+ */
+static bool is_contractable_Mul(ir_node const *const node,
+                                ir_node const *const user)
+{
+	return is_Mul(node) && get_nodes_block(node) == get_nodes_block(user)
+	    && get_irn_n_edges(node) == 1;
+}
+
+static bool use_fma(ir_mode *const mode)
+{
+	/* contraction skips the rounding of the product */
+	return amd64_use_fma && mode != x86_mode_E
+	    && ir_imprecise_float_transforms_allowed();
+}
+
+/**
+ * Creates an FMA3 node for @p node with the accumulator @p acc and the
+ * product @p mul.  The 231 forms overwrite the accumulator, one factor may
+ * be folded as memory operand.
+ */
+static ir_node *gen_fma(ir_node *const node, ir_node *const acc,
+                        ir_node *const mul, construct_fma_func cons)
+{
+	ir_node *const block = get_nodes_block(node);
+	ir_mode *const mode  = get_irn_mode(node);
+	ir_node *const op1   = get_Mul_left(mul);
+	ir_node *const op2   = get_Mul_right(mul);
+
+	ir_node                    *in[5];
+	int                         arity    = 0;
+	x86_addr_t                  addr;
+	amd64_op_mode_t             op_mode;
+	arch_register_req_t const **reqs;
+	arch_register_req_t const  *out_req;
+	ir_node                    *mem_proj = NULL;
+	memset(&addr, 0, sizeof(addr));
+	in[arity++] = be_transform_node(acc);
+
+	ir_node *load;
+	ir_node *op;
+	if (use_address_matching(mode, match_am | match_commutative, block, op1,
+	                         op2, &load, &op)
+	    && !input_depends_on_load(load, acc)) {
+		in[arity++] = be_transform_node(op);
+		perform_address_matching(get_Load_ptr(load), &arity, in, &addr);
+		reqs = xmm_xmm_am_reqs[arity - 2];
+
+		int const mem_input = arity++;
+		in[mem_input]  = be_transform_node(get_Load_mem(load));
+		addr.mem_input = mem_input;
+		mem_proj       = get_Proj_for_pn(load, pn_Load_M);
+		op_mode        = AMD64_OP_ADDR;
+		out_req        = &amd64_requirement_xmm_same_0_not_1;
+	} else {
+		in[arity++] = be_transform_node(op1);
+		int const input2 = arity++;
+		in[input2]      = be_transform_node(op2);
+		addr.base_input = input2;
+		addr.variant    = X86_ADDR_REG;
+		op_mode         = AMD64_OP_REG;
+		reqs            = xmm_xmm_xmm_reqs;
+		out_req         = &amd64_requirement_xmm_same_0_not_1_2;
+	}
+
+	dbg_info *const dbgi      = get_irn_dbg_info(node);
+	ir_node  *const new_block = be_transform_node(block);
+	x86_insn_size_t const size = x86_size_from_mode(mode);
+	ir_node  *const new_node
+		= cons(dbgi, new_block, arity, in, reqs, size, op_mode, addr);
+
+	fix_node_mem_proj(new_node, mem_proj);
+
+	arch_set_irn_register_req_out(new_node, 0, out_req);
+	return be_new_Proj(new_node, pn_amd64_vfmadd231s_res);
+}
+
 static ir_node *gen_Add(ir_node *const node)
 {
 	ir_node *const op1   = get_Add_left(node);
@@ -995,6 +1123,12 @@ static ir_node *gen_Add(ir_node *const node)
 	if (mode_is_float(mode)) {
 		if (mode == x86_mode_E)
 			return gen_binop_x87(node, op1, op2, new_bd_amd64_fadd);
+		if (use_fma(mode)) {
+			if (is_contractable_Mul(op2, node))
+				return gen_fma(node, op1, op2, new_bd_amd64_vfmadd231s);
+			if (is_contractable_Mul(op1, node))
+				return gen_fma(node, op2, op1, new_bd_amd64_vfmadd231s);
+		}
 		return gen_binop_am(node, op1, op2, new_bd_amd64_adds,
 		                    pn_amd64_adds_res, match_commutative | match_am);
 	}
@@ -1035,6 +1169,12 @@ static ir_node *gen_Sub(ir_node *const node)
 	if (mode_is_float(mode)) {
 		if (mode == x86_mode_E)
 			return gen_binop_x87(node, op1, op2, new_bd_amd64_fsub);
+		if (use_fma(mode)) {
+			if (is_contractable_Mul(op2, node))
+				return gen_fma(node, op1, op2, new_bd_amd64_vfnmadd231s);
+			if (is_contractable_Mul(op1, node))
+				return gen_fma(node, op2, op1, new_bd_amd64_vfmsub231s);
+		}
 		return gen_binop_am(node, op1, op2, new_bd_amd64_subs,
 		                    pn_amd64_subs_res, match_am);
 	} else {
@@ -1676,8 +1816,100 @@ static ir_node *gen_Proj_Start(ir_node *const node)
 	panic("unexpected Start Proj: %u", pn);
 }
 
+/**
+ * Implements the Call @p call, whose results are returned by @p node, as a
+ * jump after the epilogue. Returns NULL if the callee receives arguments on
+ * the stack, as these would overwrite the incoming arguments still in use.
+ */
+static ir_node *gen_tail_call(ir_node *const node, ir_node *const call)
+{
+	ir_type     *const type  = get_Call_type(call);
+	x86_cconv_t *const cconv = amd64_decide_calling_convention(type, NULL);
+	if (cconv->param_stacksize != 0) {
+		x86_free_calling_convention(cconv);
+		return NULL;
+	}
+
+	ir_graph          *const irg            = get_irn_irg(node);
+	ir_node           *const new_block      = be_transform_nodes_block(node);
+	dbg_info          *const dbgi           = get_irn_dbg_info(call);
+	size_t             const n_params       = get_Call_n_params(call);
+	x86_cconv_t const *const own_cconv      = current_cconv;
+	size_t             const n_callee_saves = rbitset_popcount(own_cconv->callee_saves, N_AMD64_REGISTERS);
+	/* mem + stackpointer + callee + n_sse_regs + params + callee saves */
+	size_t             const max_ins        = 4 + n_params + n_callee_saves;
+
+	arch_register_req_t const **const reqs = be_allocate_in_reqs(irg, max_ins);
+	ir_node                   **const in   = ALLOCAN(ir_node*, max_ins);
+	int                               p    = n_amd64_tail_call_stack + 1;
+
+	in[n_amd64_tail_call_mem]     = be_transform_node(get_Call_mem(call));
+	reqs[n_amd64_tail_call_mem]   = arch_memory_req;
+	in[n_amd64_tail_call_stack]   = get_initial_sp(irg);
+	reqs[n_amd64_tail_call_stack] = &amd64_single_reg_req_gp_rsp;
+
+	/* match callee, memory operands are not possible as the frame is gone */
+	x86_addr_t addr;
+	memset(&addr, 0, sizeof(addr));
+	amd64_op_mode_t op_mode;
+	ir_node *const callee = get_Call_ptr(call);
+	if (match_immediate_32(&addr.immediate, callee, true)) {
+		op_mode = AMD64_OP_IMM32;
+	} else {
+		addr.variant    = X86_ADDR_REG;
+		addr.base_input = p;
+		in[p]           = be_transform_node(callee);
+		reqs[p]         = &amd64_class_reg_req_gp;
+		op_mode         = AMD64_OP_REG;
+		++p;
+	}
+
+	/* vararg calls need the number of SSE registers used */
+	if (is_method_variadic(type)) {
+		in[p]   = make_const(dbgi, new_block, cconv->n_xmm_regs);
+		reqs[p] = &amd64_single_reg_req_gp_rax;
+		++p;
+	}
+
+	/* parameters */
+	for (size_t i = 0; i < n_params; ++i) {
+		reg_or_stackslot_t const *const param = &cconv->parameters[i];
+		assert(param->reg != NULL);
+		in[p]   = be_transform_node(get_Call_param(call, i));
+		reqs[p] = param->reg->single_req;
+		++p;
+	}
+
+	/* callee saves */
+	for (size_t i = 0; i < N_AMD64_REGISTERS; ++i) {
+		if (!rbitset_is_set(own_cconv->callee_saves, i))
+			continue;
+		arch_register_t const *const reg = &amd64_registers[i];
+		in[p]   = be_get_Start_proj(irg, reg);
+		reqs[p] = reg->single_req;
+		++p;
+	}
+	assert(p <= (int)max_ins);
+
+	ir_node *const jump = new_bd_amd64_tail_call(dbgi, new_block, p, in, reqs,
+	                                             op_mode, addr);
+	be_stack_record_chain(&stack_env, jump, n_amd64_tail_call_stack, NULL);
+	x86_free_calling_convention(cconv);
+	return jump;
+}
+
 static ir_node *gen_Return(ir_node *const node)
 {
+	ir_node *const ret_mem = get_Return_mem(node);
+	if (be_options.tail_calls && is_Proj(ret_mem)) {
+		ir_node *const call = get_Proj_pred(ret_mem);
+		if (is_Call(call) && get_Call_tail_call(call)) {
+			ir_node *const jump = gen_tail_call(node, call);
+			if (jump != NULL)
+				return jump;
+		}
+	}
+
 	ir_graph          *const irg       = get_irn_irg(node);
 	ir_node           *const new_block = be_transform_nodes_block(node);
 	dbg_info          *const dbgi      = get_irn_dbg_info(node);
@@ -3122,6 +3354,45 @@ static ir_node *gen_saturating_increment(ir_node *const node)
 	return sbb;
 }
 
+static ir_node *gen_prefetch(ir_node *const node)
+{
+	dbg_info *const dbgi     = get_irn_dbg_info(node);
+	ir_node  *const block    = be_transform_nodes_block(node);
+	ir_node  *const ptr      = get_Builtin_param(node, 0);
+	ir_node  *const mem      = get_Builtin_mem(node);
+	size_t    const n_params = get_Builtin_n_params(node);
+	/* the write hint needs PREFETCHW which is not part of the base ISA, so it
+	 * is ignored */
+	long      const locality = n_params > 2 ? get_Const_long(get_Builtin_param(node, 2)) : 3;
+
+	ir_node *in[3];
+	int arity = 0;
+	x86_addr_t addr;
+	perform_address_matching(ptr, &arity, in, &addr);
+	arch_register_req_t const **const reqs = gp_am_reqs[arity];
+	int const mem_input = arity++;
+	in[mem_input]  = be_transform_node(mem);
+	addr.mem_input = mem_input;
+
+	ir_node *new_node;
+	switch (locality) {
+	case 0:
+		new_node = new_bd_amd64_prefetchnta(dbgi, block, arity, in, reqs, addr);
+		break;
+	case 1:
+		new_node = new_bd_amd64_prefetcht2(dbgi, block, arity, in, reqs, addr);
+		break;
+	case 2:
+		new_node = new_bd_amd64_prefetcht1(dbgi, block, arity, in, reqs, addr);
+		break;
+	default:
+		new_node = new_bd_amd64_prefetcht0(dbgi, block, arity, in, reqs, addr);
+		break;
+	}
+	set_irn_pinned(new_node, get_irn_pinned(node));
+	return new_node;
+}
+
 static ir_node *gen_va_start(ir_node *const node)
 {
 	ir_graph *const irg   = get_irn_irg(node);
@@ -3148,6 +3419,8 @@ static ir_node *gen_Builtin(ir_node *const node)
 		return gen_compare_swap(node);
 	case ir_bk_saturating_increment:
 		return gen_saturating_increment(node);
+	case ir_bk_prefetch:
+		return gen_prefetch(node);
 	case ir_bk_va_start:
 		return gen_va_start(node);
 	default:
@@ -3178,6 +3451,7 @@ static ir_node *gen_Proj_Builtin(ir_node *const proj)
 		}
 	case ir_bk_saturating_increment:
 		return be_new_Proj(new_node, pn_amd64_sbb_res);
+	case ir_bk_prefetch:
 	case ir_bk_va_start:
 		assert(get_Proj_num(proj) == pn_Builtin_M);
 		return new_node;
@@ -3309,6 +3583,8 @@ void amd64_transform_graph(ir_graph *irg)
 	be_stack_init(&stack_env);
 	ir_entity *entity = get_irg_entity(irg);
 	ir_type   *mtp    = get_entity_type(entity);
+	if (be_options.tail_calls)
+		mark_tail_calls(irg);
 	current_cconv = amd64_decide_calling_convention(mtp, irg);
 	bool const is_variadic = is_method_variadic(mtp);
 	if (is_variadic)
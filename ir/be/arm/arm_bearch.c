@@ -242,9 +242,12 @@ static void arm_lower_for_target(void)
 		be_after_irp_transform("lower-fp");
 	}
 
-	ir_builtin_kind supported[1];
+	ir_builtin_kind supported[2];
 	size_t s = 0;
 	supported[s++] = ir_bk_clz;
+	/* pld needs ARMv5TE, which is not selectable, ARMv5T lacks it */
+	if (arm_cg_config.variant >= ARM_VARIANT_6)
+		supported[s++] = ir_bk_prefetch;
 	assert(s <= ARRAY_SIZE(supported));
 	lower_builtins(s, supported, NULL);
 	be_after_irp_transform("lower-builtins");
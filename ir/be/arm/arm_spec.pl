@@ -463,6 +463,16 @@ Ldr => {
 	attr      => "ir_mode *ls_mode, ir_entity *entity, int entity_sign, long offset, bool is_frame_entity",
 },
 
+Pld => {
+	op_flags  => [ "uses_memory" ],
+	state     => "exc_pinned",
+	ins       => [ "ptr", "mem" ],
+	outs      => [ "M" ],
+	in_reqs   => [ "gp", "mem" ],
+	out_reqs  => [ "mem" ],
+	emit      => 'pld [%S0]',
+},
+
 Str => {
 	state     => "exc_pinned",
 	ins       => [ "ptr", "val", "mem" ],
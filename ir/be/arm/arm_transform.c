@@ -1379,6 +1379,20 @@ static ir_node *gen_clz(ir_node *node)
 	return new_bd_arm_Clz(dbg, block, new_op);
 }
 
+/**
+ * Transform builtin prefetch.
+ */
+static ir_node *gen_prefetch(ir_node *node)
+{
+	ir_node  *block   = be_transform_nodes_block(node);
+	dbg_info *dbg     = get_irn_dbg_info(node);
+	ir_node  *ptr     = be_transform_node(get_Builtin_param(node, 0));
+	ir_node  *mem     = be_transform_node(get_Builtin_mem(node));
+	ir_node  *new_pld = new_bd_arm_Pld(dbg, block, ptr, mem);
+	set_irn_pinned(new_pld, get_irn_pinned(node));
+	return new_pld;
+}
+
 /**
  * Transform Builtin node.
  */
@@ -1390,9 +1404,10 @@ static ir_node *gen_Builtin(ir_node *node)
 	case ir_bk_debugbreak:
 	case ir_bk_return_address:
 	case ir_bk_frame_address:
-	case ir_bk_prefetch:
 	case ir_bk_ffs:
 		break;
+	case ir_bk_prefetch:
+		return gen_prefetch(node);
 	case ir_bk_clz:
 		return gen_clz(node);
 	case ir_bk_ctz:
@@ -41,6 +41,8 @@ struct be_options_t {
 	bool do_verify;            /**< backend verify option */
 	char ilp_solver[128];      /**< the ilp solver name */
 	bool verbose_asm;          /**< dump verbose assembler */
+	bool tail_calls;           /**< implement sibling calls as jumps */
+	bool shrink_wrap;          /**< move the prologue off early exit paths */
 };
 extern be_options_t be_options;
 
@@ -295,6 +295,30 @@ struct arch_isa_if_t {
 
 	void (*emit_function)(char *buffer, ir_jit_function_t *function);
 
+	/**
+	 * Size of a lazy compilation stub in bytes, 0 if lazy compilation is not
+	 * supported.
+	 */
+	unsigned jit_stub_size;
+
+	/**
+	 * Writes a lazy compilation stub to @p buffer. The stub starts with a
+	 * pointer sized slot followed by code jumping to the address in the slot.
+	 * The slot is initialized with the address of code jumping to
+	 * @p resolver with @p data.
+	 */
+	void (*emit_jit_stub)(char *buffer, void *data, char const *resolver);
+
+	/** Size of the code written by emit_jit_resolver in bytes. */
+	unsigned jit_resolver_size;
+
+	/**
+	 * Writes code to @p buffer which calls @p resolve with the data passed
+	 * by a stub and continues at the returned address. The arguments of the
+	 * call to the stub are preserved.
+	 */
+	void (*emit_jit_resolver)(char *buffer, void const *(*resolve)(void *data));
+
 	/**
 	 * lowers current program for target. See the documentation for
 	 * be_lower_for_target() for details.
@@ -18,6 +18,13 @@
  * to change as many edges to fallthroughs as possible, this is done by setting
  * a next and prev pointers on blocks. The greedy algorithm sorts the edges by
  * execution frequencies and tries to transform them to fallthroughs in this order
+ *
+ * The ext-TSP algorithm additionally considers the distance of jumps. It
+ * merges chains of blocks such that the ext-TSP score grows the most, see
+ * Newell and Pupyrev, "Improved Basic Block Reordering", 2020.
+ *
+ * Optionally rarely executed blocks are moved to the end of the schedule,
+ * from where the emitter may move them to a separate section.
  */
 #include "beblocksched.h"
 
@@ -31,11 +38,24 @@
 #include "irgmod.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
+#include "irtools.h"
+#include "lc_opts.h"
+#include "lc_opts_enum.h"
 #include "pdeq.h"
 #include "util.h"
 
 DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
 
+typedef enum blocksched_algo_t {
+	BLOCKSCHED_GREEDY,
+	BLOCKSCHED_EXTTSP,
+} blocksched_algo_t;
+
+static int    algo      = BLOCKSCHED_GREEDY;
+/** blocks executed less often than this fraction of the start block are
+ * moved to the cold part, 0 disables splitting */
+static double cold_freq = 0.0;
+
 static bool blocks_removed;
 
 /**
@@ -532,7 +552,467 @@ static ir_node **create_blocksched_array(blocksched_env_t *const env)
 	return block_list;
 }
 
-ir_node **be_create_block_schedule(ir_graph *irg)
+#define EXTTSP_FORWARD_DISTANCE  1024
+#define EXTTSP_BACKWARD_DISTANCE 640
+#define EXTTSP_JUMP_WEIGHT       0.1
+/** chains longer than this are not split when merging */
+#define EXTTSP_SPLIT_LIMIT       128
+/** estimated code size of a node in bytes */
+#define EXTTSP_NODE_SIZE         4
+
+typedef struct tsp_jump_t {
+	unsigned src;
+	unsigned dst;
+	double   freq;
+} tsp_jump_t;
+
+typedef struct tsp_chain_t tsp_chain_t;
+
+typedef struct tsp_block_t {
+	ir_node     *block;
+	unsigned     size;  /**< estimated code size */
+	double       freq;
+	tsp_chain_t *chain;
+	unsigned     pos;   /**< position in the chain */
+	unsigned     addr;  /**< address in the sequence currently scored */
+} tsp_block_t;
+
+/**
+ * Ways to merge chains X and Y, X1 and X2 are the parts of X when it is
+ * split.
+ */
+typedef enum tsp_merge_t {
+	MERGE_X_Y,
+	MERGE_X1_Y_X2,
+	MERGE_Y_X2_X1,
+	MERGE_X2_Y_X1,
+} tsp_merge_t;
+
+/** Two chains connected by jumps and the best way to merge them. */
+typedef struct tsp_pair_t {
+	tsp_chain_t *chains[2];
+	tsp_jump_t  *jumps;     /**< jumps between both chains */
+	bool         valid;     /**< the merge fields are up to date */
+	double       gain;
+	bool         x_is_1;    /**< chains[1] plays the role of X */
+	tsp_merge_t  merge;
+	unsigned     split;     /**< size of X1 */
+} tsp_pair_t;
+
+struct tsp_chain_t {
+	unsigned    *blocks; /**< block indices in layout order */
+	tsp_jump_t  *jumps;  /**< jumps within the chain */
+	tsp_pair_t **pairs;  /**< pairs with adjacent chains */
+	double       score;
+	double       freq;
+	unsigned     size;
+};
+
+typedef struct tsp_env_t {
+	struct obstack obst;
+	tsp_block_t   *blocks; /**< the start block comes first */
+	tsp_pair_t   **pairs;
+} tsp_env_t;
+
+/** A sequence of blocks formed by up to three chain slices. */
+typedef struct tsp_seq_t {
+	unsigned const *parts[3];
+	unsigned        lens[3];
+} tsp_seq_t;
+
+static void collect_tsp_block(ir_node *const block, void *const data)
+{
+	ir_node ***const blocks = (ir_node***)data;
+	ir_graph  *const irg    = get_irn_irg(block);
+	if (block != get_irg_start_block(irg) && block != get_irg_end_block(irg))
+		ARR_APP1(ir_node*, *blocks, block);
+}
+
+static double jump_score(tsp_env_t const *const env,
+                         tsp_jump_t const *const jump)
+{
+	tsp_block_t const *const src     = &env->blocks[jump->src];
+	tsp_block_t const *const dst     = &env->blocks[jump->dst];
+	unsigned           const src_end = src->addr + src->size;
+	if (dst->addr == src_end)
+		return jump->freq;
+	if (dst->addr > src_end) {
+		unsigned const dist = dst->addr - src_end;
+		if (dist < EXTTSP_FORWARD_DISTANCE)
+			return jump->freq * EXTTSP_JUMP_WEIGHT
+			     * (1.0 - (double)dist / EXTTSP_FORWARD_DISTANCE);
+	} else {
+		unsigned const dist = src_end - dst->addr;
+		if (dist < EXTTSP_BACKWARD_DISTANCE)
+			return jump->freq * EXTTSP_JUMP_WEIGHT
+			     * (1.0 - (double)dist / EXTTSP_BACKWARD_DISTANCE);
+	}
+	return 0.0;
+}
+
+static double jumps_score(tsp_env_t const *const env,
+                          tsp_jump_t const *const jumps)
+{
+	double score = 0.0;
+	for (size_t i = 0, n = ARR_LEN(jumps); i < n; ++i)
+		score += jump_score(env, &jumps[i]);
+	return score;
+}
+
+/** Assigns addresses to the blocks of @p seq. */
+static void layout_seq(tsp_env_t *const env, tsp_seq_t const *const seq)
+{
+	unsigned addr = 0;
+	for (unsigned p = 0; p < ARRAY_SIZE(seq->parts); ++p) {
+		for (unsigned i = 0; i < seq->lens[p]; ++i) {
+			tsp_block_t *const block = &env->blocks[seq->parts[p][i]];
+			block->addr = addr;
+			addr       += block->size;
+		}
+	}
+}
+
+static tsp_seq_t make_seq(tsp_chain_t const *const x,
+                          tsp_chain_t const *const y, tsp_merge_t const merge,
+                          unsigned const split)
+{
+	unsigned const *const xb    = x->blocks;
+	unsigned        const x_len = ARR_LEN(xb);
+	unsigned const *const yb    = y->blocks;
+	unsigned        const y_len = ARR_LEN(yb);
+	switch (merge) {
+	case MERGE_X_Y:
+		return (tsp_seq_t) { { xb, yb, NULL }, { x_len, y_len, 0 } };
+	case MERGE_X1_Y_X2:
+		return (tsp_seq_t) {
+			{ xb, yb, xb + split }, { split, y_len, x_len - split }
+		};
+	case MERGE_Y_X2_X1:
+		return (tsp_seq_t) {
+			{ yb, xb + split, xb }, { y_len, x_len - split, split }
+		};
+	case MERGE_X2_Y_X1:
+		return (tsp_seq_t) {
+			{ xb + split, yb, xb }, { x_len - split, y_len, split }
+		};
+	}
+	panic("invalid merge");
+}
+
+static unsigned seq_first(tsp_seq_t const *const seq)
+{
+	return seq->lens[0] > 0 ? seq->parts[0][0] : seq->parts[1][0];
+}
+
+/** Computes the score gain of merging the chains of @p pair in one way. */
+static void try_merge(tsp_env_t *const env, tsp_pair_t *const pair,
+                      bool const x_is_1, tsp_merge_t const merge,
+                      unsigned const split)
+{
+	tsp_chain_t const *const x   = pair->chains[x_is_1];
+	tsp_chain_t const *const y   = pair->chains[!x_is_1];
+	tsp_seq_t          const seq = make_seq(x, y, merge, split);
+	/* the start block has to stay in front */
+	bool const has_start = x->blocks[0] == 0 || y->blocks[0] == 0;
+	if (has_start && seq_first(&seq) != 0)
+		return;
+
+	layout_seq(env, &seq);
+	double const gain = jumps_score(env, x->jumps) + jumps_score(env, y->jumps)
+	                  + jumps_score(env, pair->jumps) - x->score - y->score;
+	if (gain > pair->gain) {
+		pair->gain   = gain;
+		pair->x_is_1 = x_is_1;
+		pair->merge  = merge;
+		pair->split  = split;
+	}
+}
+
+static void mark_split(tsp_env_t const *const env, tsp_chain_t const *const x,
+                       unsigned const block, bool *const splits)
+{
+	tsp_block_t const *const b = &env->blocks[block];
+	if (b->chain != x)
+		return;
+	splits[b->pos]     = true;
+	splits[b->pos + 1] = true;
+}
+
+static void compute_merge_gain(tsp_env_t *const env, tsp_pair_t *const pair)
+{
+	pair->gain  = 0.0;
+	pair->split = 0;
+	pair->valid = true;
+	for (unsigned x_is_1 = 0; x_is_1 < 2; ++x_is_1) {
+		try_merge(env, pair, x_is_1, MERGE_X_Y, 0);
+
+		tsp_chain_t const *const x     = pair->chains[x_is_1];
+		unsigned           const x_len = ARR_LEN(x->blocks);
+		if (x_len > EXTTSP_SPLIT_LIMIT)
+			continue;
+		/* only split X next to a block connected to Y */
+		bool splits[EXTTSP_SPLIT_LIMIT + 1];
+		memset(splits, 0, sizeof(splits));
+		for (size_t i = 0, n = ARR_LEN(pair->jumps); i < n; ++i) {
+			mark_split(env, x, pair->jumps[i].src, splits);
+			mark_split(env, x, pair->jumps[i].dst, splits);
+		}
+		for (unsigned split = 1; split < x_len; ++split) {
+			if (!splits[split])
+				continue;
+			try_merge(env, pair, x_is_1, MERGE_X1_Y_X2, split);
+			try_merge(env, pair, x_is_1, MERGE_Y_X2_X1, split);
+			try_merge(env, pair, x_is_1, MERGE_X2_Y_X1, split);
+		}
+	}
+}
+
+static tsp_chain_t *get_other_chain(tsp_pair_t const *const pair,
+                                    tsp_chain_t const *const chain)
+{
+	return pair->chains[pair->chains[0] == chain];
+}
+
+static tsp_pair_t *find_pair(tsp_chain_t const *const chain,
+                             tsp_chain_t const *const other)
+{
+	for (size_t i = 0, n = ARR_LEN(chain->pairs); i < n; ++i) {
+		tsp_pair_t *const pair = chain->pairs[i];
+		if (get_other_chain(pair, chain) == other)
+			return pair;
+	}
+	return NULL;
+}
+
+static void remove_pair(tsp_chain_t *const chain, tsp_pair_t const *const pair)
+{
+	for (size_t i = 0, n = ARR_LEN(chain->pairs); i < n; ++i) {
+		if (chain->pairs[i] == pair) {
+			chain->pairs[i] = chain->pairs[n - 1];
+			ARR_SHRINKLEN(chain->pairs, n - 1);
+			return;
+		}
+	}
+	panic("pair not found");
+}
+
+static void add_jump(tsp_env_t *const env, tsp_jump_t const *const jump)
+{
+	tsp_chain_t *const src = env->blocks[jump->src].chain;
+	tsp_chain_t *const dst = env->blocks[jump->dst].chain;
+	if (src == dst) {
+		ARR_APP1(tsp_jump_t, src->jumps, *jump);
+		return;
+	}
+	tsp_pair_t *pair = find_pair(src, dst);
+	if (pair == NULL) {
+		pair = OALLOCZ(&env->obst, tsp_pair_t);
+		pair->chains[0] = src;
+		pair->chains[1] = dst;
+		pair->jumps     = NEW_ARR_F(tsp_jump_t, 0);
+		ARR_APP1(tsp_pair_t*, src->pairs, pair);
+		ARR_APP1(tsp_pair_t*, dst->pairs, pair);
+		ARR_APP1(tsp_pair_t*, env->pairs, pair);
+	}
+	ARR_APP1(tsp_jump_t, pair->jumps, *jump);
+}
+
+static void append_jumps(tsp_jump_t **const dst, tsp_jump_t const *const src)
+{
+	for (size_t i = 0, n = ARR_LEN(src); i < n; ++i)
+		ARR_APP1(tsp_jump_t, *dst, src[i]);
+}
+
+/** Merges the chains of @p pair in the best way found. */
+static void merge_chains(tsp_env_t *const env, tsp_pair_t *const pair)
+{
+	tsp_chain_t *const x = pair->chains[pair->x_is_1];
+	tsp_chain_t *const y = pair->chains[!pair->x_is_1];
+	DB((dbg, LEVEL_2, "Merge %+F.. and %+F.. (gain %.3g)\n",
+	    env->blocks[x->blocks[0]].block, env->blocks[y->blocks[0]].block,
+	    pair->gain));
+
+	tsp_seq_t const seq    = make_seq(x, y, pair->merge, pair->split);
+	unsigned       *blocks = NEW_ARR_F(unsigned, 0);
+	for (unsigned p = 0; p < ARRAY_SIZE(seq.parts); ++p) {
+		for (unsigned i = 0; i < seq.lens[p]; ++i)
+			ARR_APP1(unsigned, blocks, seq.parts[p][i]);
+	}
+	for (size_t i = 0, n = ARR_LEN(blocks); i < n; ++i) {
+		tsp_block_t *const block = &env->blocks[blocks[i]];
+		block->chain = x;
+		block->pos   = i;
+	}
+	DEL_ARR_F(x->blocks);
+	DEL_ARR_F(y->blocks);
+	x->blocks = blocks;
+
+	append_jumps(&x->jumps, y->jumps);
+	append_jumps(&x->jumps, pair->jumps);
+	DEL_ARR_F(y->jumps);
+	DEL_ARR_F(pair->jumps);
+	x->freq += y->freq;
+	x->size += y->size;
+	layout_seq(env, &(tsp_seq_t) { { x->blocks }, { ARR_LEN(x->blocks) } });
+	x->score = jumps_score(env, x->jumps);
+
+	remove_pair(x, pair);
+	remove_pair(y, pair);
+	pair->chains[0] = NULL;
+
+	/* move the pairs of y to x */
+	for (size_t i = 0, n = ARR_LEN(y->pairs); i < n; ++i) {
+		tsp_pair_t  *const other_pair = y->pairs[i];
+		tsp_chain_t *const other      = get_other_chain(other_pair, y);
+		tsp_pair_t  *const existing   = find_pair(x, other);
+		if (existing != NULL) {
+			append_jumps(&existing->jumps, other_pair->jumps);
+			DEL_ARR_F(other_pair->jumps);
+			remove_pair(other, other_pair);
+			other_pair->chains[0] = NULL;
+		} else {
+			other_pair->chains[other_pair->chains[0] != y] = x;
+			ARR_APP1(tsp_pair_t*, x->pairs, other_pair);
+		}
+	}
+	DEL_ARR_F(y->pairs);
+	for (size_t i = 0, n = ARR_LEN(x->pairs); i < n; ++i)
+		x->pairs[i]->valid = false;
+}
+
+static int cmp_chain_density(void const *const p0, void const *const p1)
+{
+	tsp_chain_t const *const c0 = *(tsp_chain_t const**)p0;
+	tsp_chain_t const *const c1 = *(tsp_chain_t const**)p1;
+	/* the chain with the start block comes first */
+	if (c0->blocks[0] == 0 || c1->blocks[0] == 0)
+		return (c1->blocks[0] == 0) - (c0->blocks[0] == 0);
+	double const d0 = c0->freq / c0->size;
+	double const d1 = c1->freq / c1->size;
+	if (d0 != d1)
+		return d0 < d1 ? 1 : -1;
+	return QSORT_CMP(c0->blocks[0], c1->blocks[0]);
+}
+
+static ir_node **create_exttsp_schedule(ir_graph *const irg)
+{
+	remove_empty_blocks(irg);
+
+	ir_node **nodes = NEW_ARR_F(ir_node*, 1);
+	nodes[0] = get_irg_start_block(irg);
+	irg_block_walk_graph(irg, collect_tsp_block, NULL, &nodes);
+
+	size_t const n_blocks = ARR_LEN(nodes);
+	tsp_env_t    env;
+	obstack_init(&env.obst);
+	env.blocks = NEW_ARR_FZ(tsp_block_t, n_blocks);
+	env.pairs  = NEW_ARR_F(tsp_pair_t*, 0);
+	for (size_t i = 0; i < n_blocks; ++i) {
+		tsp_block_t *const block = &env.blocks[i];
+		unsigned n_nodes = 0;
+		sched_foreach(nodes[i], node) {
+			if (!is_Phi(node))
+				++n_nodes;
+		}
+		tsp_chain_t *const chain = OALLOCZ(&env.obst, tsp_chain_t);
+		block->block = nodes[i];
+		block->size  = MAX(n_nodes * EXTTSP_NODE_SIZE, 1);
+		block->freq  = get_block_execfreq(nodes[i]);
+		block->chain = chain;
+		chain->blocks    = NEW_ARR_F(unsigned, 1);
+		chain->blocks[0] = i;
+		chain->jumps     = NEW_ARR_F(tsp_jump_t, 0);
+		chain->pairs     = NEW_ARR_F(tsp_pair_t*, 0);
+		chain->freq      = block->freq;
+		chain->size      = block->size;
+		set_irn_link(nodes[i], block);
+	}
+
+	/* collect jumps, edge frequencies are approximated like for the greedy
+	 * algorithm, which is exact if critical edges are split */
+	ir_node *const end_block = get_irg_end_block(irg);
+	for (size_t i = 0; i < n_blocks; ++i) {
+		ir_node *const block   = nodes[i];
+		int      const n_preds = get_Block_n_cfgpreds(block);
+		for (int p = 0; p < n_preds; ++p) {
+			ir_node *const pred = get_Block_cfgpred(block, p);
+			if (is_Bad(pred))
+				continue;
+			ir_node *const pred_block = get_nodes_block(pred);
+			if (pred_block == end_block)
+				continue;
+			tsp_block_t const *const src = (tsp_block_t*)get_irn_link(pred_block);
+			tsp_jump_t const jump = {
+				.src  = src - env.blocks,
+				.dst  = i,
+				.freq = n_preds == 1 ? env.blocks[i].freq : src->freq,
+			};
+			add_jump(&env, &jump);
+		}
+	}
+	for (size_t i = 0; i < n_blocks; ++i) {
+		tsp_chain_t *const chain = env.blocks[i].chain;
+		layout_seq(&env, &(tsp_seq_t) { { chain->blocks }, { 1 } });
+		chain->score = jumps_score(&env, chain->jumps);
+	}
+
+	/* greedily perform the merge with the largest gain */
+	for (;;) {
+		tsp_pair_t *best  = NULL;
+		size_t      n_new = 0;
+		for (size_t i = 0, n = ARR_LEN(env.pairs); i < n; ++i) {
+			tsp_pair_t *const pair = env.pairs[i];
+			if (pair->chains[0] == NULL)
+				continue;
+			env.pairs[n_new++] = pair;
+			if (!pair->valid)
+				compute_merge_gain(&env, pair);
+			if (pair->gain > 1e-9 && (best == NULL || pair->gain > best->gain))
+				best = pair;
+		}
+		ARR_SHRINKLEN(env.pairs, n_new);
+		if (best == NULL)
+			break;
+		merge_chains(&env, best);
+	}
+
+	/* order the remaining chains by density */
+	tsp_chain_t **chains = NEW_ARR_F(tsp_chain_t*, 0);
+	for (size_t i = 0; i < n_blocks; ++i) {
+		tsp_chain_t *const chain = env.blocks[i].chain;
+		if (chain->blocks[0] == i)
+			ARR_APP1(tsp_chain_t*, chains, chain);
+	}
+	QSORT_ARR(chains, cmp_chain_density);
+
+	struct obstack *const obst       = be_get_be_obst(irg);
+	ir_node       **const block_list = NEW_ARR_D(ir_node*, obst, n_blocks);
+	size_t                n          = 0;
+	DB((dbg, LEVEL_1, "Blockschedule:\n"));
+	for (size_t c = 0, n_chains = ARR_LEN(chains); c < n_chains; ++c) {
+		tsp_chain_t *const chain = chains[c];
+		for (size_t i = 0, n_chain = ARR_LEN(chain->blocks); i < n_chain; ++i) {
+			ir_node *const block = env.blocks[chain->blocks[i]].block;
+			block_list[n++] = block;
+			DB((dbg, LEVEL_1, "\t%+F\n", block));
+		}
+		DEL_ARR_F(chain->blocks);
+		DEL_ARR_F(chain->jumps);
+		DEL_ARR_F(chain->pairs);
+	}
+	assert(n == n_blocks);
+
+	for (size_t i = 0, n_pairs = ARR_LEN(env.pairs); i < n_pairs; ++i)
+		DEL_ARR_F(env.pairs[i]->jumps);
+	DEL_ARR_F(chains);
+	DEL_ARR_F(env.pairs);
+	DEL_ARR_F(env.blocks);
+	DEL_ARR_F(nodes);
+	obstack_free(&env.obst, NULL);
+	return block_list;
+}
+
+static ir_node **create_greedy_schedule(ir_graph *const irg)
 {
 	blocksched_env_t env = {
 		.irg        = irg,
@@ -541,10 +1021,7 @@ ir_node **be_create_block_schedule(ir_graph *irg)
 	};
 	obstack_init(&env.obst);
 
-	assure_loopinfo(irg);
-
 	// collect edge execution frequencies
-	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
 	irg_block_walk_graph(irg, collect_egde_frequency, NULL, &env);
 
 	remove_empty_blocks(irg);
@@ -552,7 +1029,6 @@ ir_node **be_create_block_schedule(ir_graph *irg)
 	coalesce_blocks(&env);
 
 	ir_node **const block_list = create_blocksched_array(&env);
-	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
 
 	DEL_ARR_F(env.edges);
 	obstack_free(&env.obst, NULL);
@@ -560,8 +1036,65 @@ ir_node **be_create_block_schedule(ir_graph *irg)
 	return block_list;
 }
 
+/**
+ * Moves rarely executed blocks to the end of the schedule keeping the
+ * relative order of the blocks otherwise.
+ */
+static void split_cold_blocks(ir_graph *const irg, ir_node **const block_list)
+{
+	be_irg_t *const birg      = be_birg_from_irg(irg);
+	double    const threshold
+		= cold_freq * get_block_execfreq(get_irg_start_block(irg));
+	ir_node       **cold      = NEW_ARR_F(ir_node*, 0);
+	size_t          n_hot     = 0;
+	for (size_t i = 0, n = ARR_LEN(block_list); i < n; ++i) {
+		ir_node *const block = block_list[i];
+		if (i > 0 && get_block_execfreq(block) < threshold)
+			ARR_APP1(ir_node*, cold, block);
+		else
+			block_list[n_hot++] = block;
+	}
+	MEMCPY(block_list + n_hot, cold, ARR_LEN(cold));
+	birg->first_cold_block = ARR_LEN(cold) > 0 ? cold[0] : NULL;
+	DB((dbg, LEVEL_1, "%zu cold blocks in %+F\n", ARR_LEN(cold), irg));
+	DEL_ARR_F(cold);
+}
+
+ir_node **be_create_block_schedule(ir_graph *irg)
+{
+	assure_loopinfo(irg);
+
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
+	ir_node **const block_list = algo == BLOCKSCHED_EXTTSP
+		? create_exttsp_schedule(irg) : create_greedy_schedule(irg);
+	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
+
+	be_birg_from_irg(irg)->first_cold_block = NULL;
+	if (cold_freq > 0.0)
+		split_cold_blocks(irg, block_list);
+
+	return block_list;
+}
+
 BE_REGISTER_MODULE_CONSTRUCTOR(be_init_blocksched)
 void be_init_blocksched(void)
 {
+	static const lc_opt_enum_int_items_t algo_items[] = {
+		{ "greedy", BLOCKSCHED_GREEDY },
+		{ "exttsp", BLOCKSCHED_EXTTSP },
+		{ NULL,     0 },
+	};
+	static lc_opt_enum_int_var_t algo_var = {
+		&algo, algo_items
+	};
+	static const lc_opt_table_entry_t options[] = {
+		LC_OPT_ENT_ENUM_INT("algo",     "block scheduling algorithm", &algo_var),
+		LC_OPT_ENT_DBL     ("coldfreq", "move blocks executed less often than this fraction of the function entry to a cold section", &cold_freq),
+		LC_OPT_LAST
+	};
+	lc_opt_entry_t *const be_grp    = lc_opt_get_grp(firm_opt_get_root(), "be");
+	lc_opt_entry_t *const sched_grp = lc_opt_get_grp(be_grp, "blocksched");
+	lc_opt_add_table(sched_grp, options);
+
 	FIRM_DBG_REGISTER(dbg, "firm.be.blocksched");
 }
@@ -303,6 +303,16 @@ static void emit_pubnames(void)
 	emit_label("pubnames_end");
 }
 
+bool be_dwarf_is_enabled(void)
+{
+	return debug_level > LEVEL_NONE;
+}
+
+bool be_dwarf_has_callframe_info(void)
+{
+	return debug_level >= LEVEL_FRAMEINFO;
+}
+
 void be_dwarf_location(dbg_info *dbgi)
 {
 	if (debug_level < LEVEL_LOCATIONS)
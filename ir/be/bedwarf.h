@@ -11,6 +11,7 @@
 #ifndef FIRM_BE_BEDWARF_H
 #define FIRM_BE_BEDWARF_H
 
+#include <stdbool.h>
 #include "be_types.h"
 
 typedef struct parameter_dbg_info_t {
@@ -30,6 +31,12 @@ void be_dwarf_unit_begin(const char *filename);
 /** end compilation unit */
 void be_dwarf_unit_end(void);
 
+/** returns true if debug info is emitted */
+bool be_dwarf_is_enabled(void);
+
+/** returns true if call frame information is emitted */
+bool be_dwarf_has_callframe_info(void);
+
 /** output debug info necessary right before defining a function */
 void be_dwarf_function_before(const ir_entity *ent,
                               const parameter_dbg_info_t *infos);
@@ -15,6 +15,7 @@
 #include "bedwarf.h"
 #include "beemitter.h"
 #include "begnuas.h"
+#include "beirg.h"
 #include "benode.h"
 #include "dbginfo.h"
 #include "debug.h"
@@ -66,9 +67,15 @@ void be_emit_pad_comment(void)
 
 void be_emit_init_cf_links(ir_node **const block_schedule)
 {
+	ir_node *const first_cold = ARR_LEN(block_schedule) > 0
+		? be_birg_from_irg(get_irn_irg(block_schedule[0]))->first_cold_block
+		: NULL;
 	ir_node *prev = NULL;
 	for (size_t i = 0, n = ARR_LEN(block_schedule); i < n; ++i) {
 		ir_node *const block = block_schedule[i];
+		/* the cold part may be placed in another section */
+		if (block == first_cold)
+			prev = NULL;
 
 		/* Initialize cfop link */
 		for (unsigned n = get_Block_n_cfgpreds(block); n-- > 0; ) {
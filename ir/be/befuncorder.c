@@ -0,0 +1,371 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Call graph driven function ordering.
+ *
+ * The functions are clustered with the C3 heuristic, see Ottoni and Maher,
+ * "Optimizing Function Placement for Large-Scale Data-Center Applications",
+ * 2017: Functions are visited in order of decreasing hotness and the cluster
+ * of each function is appended to the cluster of its most frequent caller.
+ * The clusters are emitted in order of decreasing density.
+ *
+ * Call counts are taken from the profile if there is one, otherwise they are
+ * estimated by propagating the block execution frequencies along the calls.
+ * With profile data the functions covering most of the execution are
+ * additionally marked hot and functions never executed are marked cold.
+ */
+#include "befuncorder.h"
+
+#include "bemodule.h"
+#include "debug.h"
+#include "entity_t.h"
+#include "execfreq.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "irprofile.h"
+#include "irprog_t.h"
+#include "irtools.h"
+#include "lc_opts.h"
+#include "lc_opts_enum.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <stdlib.h>
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+typedef enum funcorder_algo_t {
+	FUNCORDER_NONE,
+	FUNCORDER_C3,
+} funcorder_algo_t;
+
+static int      algo                    = FUNCORDER_NONE;
+static double   hot_cover               = 0.99;
+static int      hot_p2align             = 0;
+unsigned        be_hot_function_p2align = 0;
+
+/** Estimated code size of a node in bytes. */
+#define NODE_SIZE           4
+/** Clusters are not merged beyond this size in bytes. */
+#define CLUSTER_SIZE_LIMIT  (1u << 20)
+/** A merge may not reduce the density of the caller cluster more. */
+#define DENSITY_DEGRADATION 8
+/** Number of rounds when estimating the call counts. */
+#define ESTIMATE_ROUNDS     8
+/** Upper bound of estimated call counts. */
+#define MAX_COUNT           1e9
+
+typedef struct cluster_t cluster_t;
+typedef struct func_t    func_t;
+
+struct func_t {
+	ir_graph  *irg;
+	size_t     pos;      /**< position in the original order */
+	double     weight;   /**< executed nodes per call */
+	double     count;    /**< number of calls */
+	double     samples;  /**< executed nodes */
+	unsigned   size;     /**< estimated code size in bytes */
+	cluster_t *cluster;
+	func_t    *best_caller; /**< caller with the most calls */
+};
+
+struct cluster_t {
+	func_t **members;
+	double   samples;
+	unsigned size;
+	size_t   pos;      /**< smallest position of the members */
+};
+
+typedef struct call_edge_t {
+	func_t *caller;
+	func_t *callee;
+	double  freq;      /**< calls per call of the caller */
+} call_edge_t;
+
+typedef struct funcorder_env_t {
+	func_t      **by_idx;  /**< functions indexed by irg index */
+	call_edge_t  *edges;
+	func_t       *cur;
+} funcorder_env_t;
+
+static void collect_calls(ir_node *const node, void *const data)
+{
+	funcorder_env_t *const env = (funcorder_env_t*)data;
+	func_t          *const cur = env->cur;
+	if (is_Block(node))
+		return;
+
+	double const freq = get_block_execfreq(get_nodes_block(node));
+	cur->weight += freq;
+	cur->size   += NODE_SIZE;
+	if (!is_Call(node))
+		return;
+
+	ir_entity *const callee_entity = get_Call_callee(node);
+	if (callee_entity == NULL)
+		return;
+	ir_graph *const callee_irg = get_entity_linktime_irg(callee_entity);
+	if (callee_irg == NULL || callee_irg == cur->irg)
+		return;
+	call_edge_t const edge = {
+		.caller = cur,
+		.callee = env->by_idx[get_irg_idx(callee_irg)],
+		.freq   = freq,
+	};
+	ARR_APP1(call_edge_t, env->edges, edge);
+}
+
+/** Estimates call counts by propagating frequencies along the call edges. */
+static void estimate_counts(func_t *const funcs, size_t const n_funcs,
+                            call_edge_t const *const edges)
+{
+	double *const next = XMALLOCN(double, n_funcs);
+	for (size_t i = 0; i < n_funcs; ++i)
+		funcs[i].count = 1.0;
+	for (unsigned r = 0; r < ESTIMATE_ROUNDS; ++r) {
+		for (size_t i = 0; i < n_funcs; ++i)
+			next[i] = 1.0;
+		for (size_t i = 0, n = ARR_LEN(edges); i < n; ++i) {
+			call_edge_t const *const edge = &edges[i];
+			next[edge->callee->pos] += edge->caller->count * edge->freq;
+		}
+		for (size_t i = 0; i < n_funcs; ++i)
+			funcs[i].count = MIN(next[i], MAX_COUNT);
+	}
+	free(next);
+}
+
+static int cmp_func_hotness(void const *const p1, void const *const p2)
+{
+	func_t const *const f1 = *(func_t const*const*)p1;
+	func_t const *const f2 = *(func_t const*const*)p2;
+	if (f1->samples != f2->samples)
+		return f1->samples < f2->samples ? 1 : -1;
+	return f1->pos < f2->pos ? -1 : f1->pos > f2->pos;
+}
+
+static int cmp_edge_callee(void const *const p1, void const *const p2)
+{
+	call_edge_t const *const e1 = (call_edge_t const*)p1;
+	call_edge_t const *const e2 = (call_edge_t const*)p2;
+	if (e1->callee != e2->callee)
+		return e1->callee->pos < e2->callee->pos ? -1 : 1;
+	return e1->caller->pos < e2->caller->pos ? -1 : e1->caller->pos > e2->caller->pos;
+}
+
+static double get_density(cluster_t const *const cluster)
+{
+	return cluster->samples / MAX(cluster->size, 1u);
+}
+
+static int cmp_cluster_density(void const *const p1, void const *const p2)
+{
+	cluster_t const *const c1 = *(cluster_t const*const*)p1;
+	cluster_t const *const c2 = *(cluster_t const*const*)p2;
+	double const d1 = get_density(c1);
+	double const d2 = get_density(c2);
+	if (d1 != d2)
+		return d1 < d2 ? 1 : -1;
+	return c1->pos < c2->pos ? -1 : c1->pos > c2->pos;
+}
+
+/**
+ * Determines the most frequent caller of each function.
+ * The edges must be sorted by callee and caller.
+ */
+static void find_best_callers(call_edge_t const *const edges,
+                              size_t const n_edges)
+{
+	for (size_t i = 0; i < n_edges;) {
+		func_t *const callee      = edges[i].callee;
+		func_t       *best        = NULL;
+		double        best_weight = 0.0;
+		while (i < n_edges && edges[i].callee == callee) {
+			func_t *const caller = edges[i].caller;
+			double        weight = 0.0;
+			for (; i < n_edges && edges[i].callee == callee
+			       && edges[i].caller == caller; ++i) {
+				weight += caller->count * edges[i].freq;
+			}
+			if (weight > best_weight) {
+				best        = caller;
+				best_weight = weight;
+			}
+		}
+		callee->best_caller = best;
+	}
+}
+
+static void merge_clusters(cluster_t *const into, cluster_t *const from)
+{
+	for (size_t i = 0, n = ARR_LEN(from->members); i < n; ++i) {
+		func_t *const member = from->members[i];
+		member->cluster = into;
+		ARR_APP1(func_t*, into->members, member);
+	}
+	into->samples += from->samples;
+	into->size    += from->size;
+	into->pos      = MIN(into->pos, from->pos);
+	DEL_ARR_F(from->members);
+	from->members = NULL;
+}
+
+/**
+ * Marks the hottest functions covering a fraction of all samples as hot and
+ * the functions never executed as cold. Functions annotated by the user are
+ * kept as they are.
+ */
+static void mark_hot_cold(func_t **const by_hotness, size_t const n_funcs)
+{
+	double total = 0.0;
+	for (size_t i = 0; i < n_funcs; ++i)
+		total += by_hotness[i]->samples;
+
+	mtp_additional_properties const hot_cold
+		= mtp_property_hot | mtp_property_cold;
+	double covered = 0.0;
+	for (size_t i = 0; i < n_funcs; ++i) {
+		func_t    *const func   = by_hotness[i];
+		ir_entity *const entity = get_irg_entity(func->irg);
+		bool       const is_hot = covered < hot_cover * total;
+		covered += func->samples;
+		if (get_entity_additional_properties(entity) & hot_cold)
+			continue;
+		if (func->count == 0) {
+			add_entity_additional_properties(entity, mtp_property_cold);
+			DB((dbg, LEVEL_2, "%+F is cold\n", entity));
+		} else if (is_hot) {
+			add_entity_additional_properties(entity, mtp_property_hot);
+			DB((dbg, LEVEL_2, "%+F is hot\n", entity));
+		}
+	}
+}
+
+void be_order_functions(bool const have_profile)
+{
+	be_hot_function_p2align = hot_p2align;
+	if (algo == FUNCORDER_NONE)
+		return;
+
+	size_t   const n_funcs = get_irp_n_irgs();
+	func_t  *const funcs   = XMALLOCNZ(func_t, n_funcs);
+	funcorder_env_t env = {
+		.by_idx = XMALLOCNZ(func_t*, get_irp_last_idx()),
+		.edges  = NEW_ARR_F(call_edge_t, 0),
+	};
+	foreach_irp_irg(i, irg) {
+		funcs[i].irg = irg;
+		funcs[i].pos = i;
+		env.by_idx[get_irg_idx(irg)] = &funcs[i];
+	}
+	for (size_t i = 0; i < n_funcs; ++i) {
+		env.cur = &funcs[i];
+		irg_walk_graph(funcs[i].irg, NULL, collect_calls, &env);
+	}
+	call_edge_t *const edges   = env.edges;
+	size_t       const n_edges = ARR_LEN(edges);
+
+	if (have_profile) {
+		for (size_t i = 0; i < n_funcs; ++i) {
+			ir_node *const start_block = get_irg_start_block(funcs[i].irg);
+			funcs[i].count = ir_profile_get_block_execcount(start_block);
+		}
+	} else {
+		estimate_counts(funcs, n_funcs, edges);
+	}
+
+	func_t   **const by_hotness = XMALLOCN(func_t*, n_funcs);
+	cluster_t *const clusters   = XMALLOCNZ(cluster_t, n_funcs);
+	for (size_t i = 0; i < n_funcs; ++i) {
+		func_t    *const func    = &funcs[i];
+		cluster_t *const cluster = &clusters[i];
+		func->samples     = func->count * func->weight;
+		func->cluster     = cluster;
+		cluster->members  = NEW_ARR_F(func_t*, 1);
+		cluster->members[0] = func;
+		cluster->samples  = func->samples;
+		cluster->size     = func->size;
+		cluster->pos      = i;
+		by_hotness[i]     = func;
+	}
+	QSORT(by_hotness, n_funcs, cmp_func_hotness);
+	QSORT(edges, n_edges, cmp_edge_callee);
+	find_best_callers(edges, n_edges);
+
+	/* C3: append each function to the cluster of its most frequent caller */
+	for (size_t i = 0; i < n_funcs; ++i) {
+		func_t *const func   = by_hotness[i];
+		func_t *const caller = func->best_caller;
+		if (caller == NULL)
+			continue;
+		cluster_t *const into = caller->cluster;
+		cluster_t *const from = func->cluster;
+		if (into == from || into->size + from->size > CLUSTER_SIZE_LIMIT)
+			continue;
+		double const merged_density = (into->samples + from->samples)
+		                            / MAX(into->size + from->size, 1u);
+		if (merged_density * DENSITY_DEGRADATION < get_density(into))
+			continue;
+		DB((dbg, LEVEL_3, "append cluster of %+F to %+F\n", func->irg,
+		    caller->irg));
+		merge_clusters(into, from);
+	}
+
+	cluster_t **order = NEW_ARR_F(cluster_t*, 0);
+	for (size_t i = 0; i < n_funcs; ++i) {
+		if (clusters[i].members != NULL)
+			ARR_APP1(cluster_t*, order, &clusters[i]);
+	}
+	QSORT_ARR(order, cmp_cluster_density);
+
+	size_t pos = 0;
+	for (size_t i = 0, n = ARR_LEN(order); i < n; ++i) {
+		cluster_t *const cluster = order[i];
+		for (size_t m = 0, n_members = ARR_LEN(cluster->members);
+		     m < n_members; ++m) {
+			func_t *const func = cluster->members[m];
+			DB((dbg, LEVEL_1, "%zu: %+F (samples %.1f)\n", pos, func->irg,
+			    func->samples));
+			set_irp_irg(pos++, func->irg);
+		}
+		DEL_ARR_F(cluster->members);
+	}
+	assert(pos == n_funcs);
+
+	if (have_profile)
+		mark_hot_cold(by_hotness, n_funcs);
+
+	DEL_ARR_F(order);
+	free(clusters);
+	free(by_hotness);
+	DEL_ARR_F(edges);
+	free(env.by_idx);
+	free(funcs);
+}
+
+BE_REGISTER_MODULE_CONSTRUCTOR(be_init_funcorder)
+void be_init_funcorder(void)
+{
+	static const lc_opt_enum_int_items_t algo_items[] = {
+		{ "none", FUNCORDER_NONE },
+		{ "c3",   FUNCORDER_C3 },
+		{ NULL,   0 },
+	};
+	static lc_opt_enum_int_var_t algo_var = {
+		&algo, algo_items
+	};
+	static const lc_opt_table_entry_t options[] = {
+		LC_OPT_ENT_ENUM_INT("algo",     "function ordering algorithm", &algo_var),
+		LC_OPT_ENT_DBL     ("hotcover", "with profile data mark the hottest functions covering this fraction of the execution as hot", &hot_cover),
+		LC_OPT_ENT_INT     ("hotalign", "log2 of the alignment of hot functions", &hot_p2align),
+		LC_OPT_LAST
+	};
+	lc_opt_entry_t *const be_grp   = lc_opt_get_grp(firm_opt_get_root(), "be");
+	lc_opt_entry_t *const func_grp = lc_opt_get_grp(be_grp, "funcorder");
+	lc_opt_add_table(func_grp, options);
+
+	FIRM_DBG_REGISTER(dbg, "firm.be.funcorder");
+}
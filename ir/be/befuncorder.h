@@ -0,0 +1,30 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Call graph driven function ordering.
+ */
+#ifndef FIRM_BE_BEFUNCORDER_H
+#define FIRM_BE_BEFUNCORDER_H
+
+#include <stdbool.h>
+
+/** Log2 of the alignment of hot function entries, 0 to keep the default. */
+extern unsigned be_hot_function_p2align;
+
+/**
+ * Reorders the graphs of the program so that functions calling each other
+ * frequently are emitted next to each other. With profile data functions are
+ * additionally marked as hot or cold.
+ *
+ * Must be called while the profile data is still loaded and after the
+ * execution frequencies have been computed.
+ *
+ * @param have_profile  true if the execution frequencies come from a profile
+ */
+void be_order_functions(bool have_profile);
+
+#endif
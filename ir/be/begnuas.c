@@ -15,6 +15,7 @@
 #include "bearch.h"
 #include "beemithlp.h"
 #include "beemitter.h"
+#include "befuncorder.h"
 #include "bemodule.h"
 #include "betranshlp.h"
 #include "dbginfo.h"
@@ -38,6 +39,11 @@ char                   be_gas_elf_type_char = '@';
 static be_gas_section_t current_section = (be_gas_section_t) -1;
 static pmap            *block_numbers;
 static unsigned         next_block_nr;
+/** function whose cold part is emitted currently */
+static ir_entity const *cold_part_entity;
+/** section of the code emitted currently and its comdat entity */
+static be_gas_section_t text_section = GAS_SECTION_TEXT;
+static ir_entity const *text_entity;
 
 static bool is_macho(void)
 {
@@ -86,6 +92,7 @@ static void emit_section_macho(be_gas_section_t const section)
 		[GAS_SECTION_DEBUG_LINE]      = { "__DWARF,__debug_line",     "regular,debug" },
 		[GAS_SECTION_DEBUG_PUBNAMES]  = { "__DWARF,__debug_pubnames", "regular,debug" },
 		[GAS_SECTION_DEBUG_FRAME]     = { "__DWARF,__debug_frame",    "regular,debug" },
+		[GAS_SECTION_TEXT_UNLIKELY]   = { "__TEXT,__text_cold",       "regular,pure_instructions" },
 	};
 	static const macho_sectioninfo_t macho_sectioninfos_coalesce[] = {
 		[GAS_SECTION_TEXT]    = { "__TEXT,__textcoal_nt", "coalesced,pure_instructions" },
@@ -137,6 +144,8 @@ static const elf_sectioninfo_t elf_sectioninfos[] = {
 	[GAS_SECTION_DEBUG_LINE]     = { "debug_line",        "progbits", ""   },
 	[GAS_SECTION_DEBUG_PUBNAMES] = { "debug_pubnames",    "progbits", ""   },
 	[GAS_SECTION_DEBUG_FRAME]    = { "debug_frame",       "progbits", ""   },
+	[GAS_SECTION_TEXT_UNLIKELY]  = { "text.unlikely",     "progbits", "ax" },
+	[GAS_SECTION_TEXT_HOT]       = { "text.hot",          "progbits", "ax" },
 };
 
 static void emit_section_sparc(be_gas_section_t section,
@@ -166,14 +175,17 @@ static void emit_section_sparc(be_gas_section_t section,
 	be_emit_char('"');
 
 	/* for the simple sections we're done here */
-	if (flags != 0) {
+	if (flags != 0 || base == GAS_SECTION_TEXT_UNLIKELY
+	 || base == GAS_SECTION_TEXT_HOT) {
 		be_emit_cstring(",#alloc");
 
 		switch (base) {
-		case GAS_SECTION_TEXT: be_emit_cstring(",#execinstr"); break;
+		case GAS_SECTION_TEXT:
+		case GAS_SECTION_TEXT_UNLIKELY:
+		case GAS_SECTION_TEXT_HOT:      be_emit_cstring(",#execinstr"); break;
 		case GAS_SECTION_DATA:
-		case GAS_SECTION_BSS:  be_emit_cstring(",#write"); break;
-		default:               /* nothing */ break;
+		case GAS_SECTION_BSS:           be_emit_cstring(",#write");     break;
+		default:                        /* nothing */                   break;
 		}
 		if (flags & GAS_SECTION_FLAG_TLS)
 			be_emit_cstring(",#tls");
@@ -344,6 +356,15 @@ static bool initializer_is_null(const ir_initializer_t *initializer)
 		}
 		return true;
 	}
+	case IR_INITIALIZER_BLOB: {
+		unsigned char const *const data = get_initializer_blob_data(initializer);
+		for (size_t i = 0, n = get_initializer_blob_size(initializer); i < n;
+		     ++i) {
+			if (data[i] != 0)
+				return false;
+		}
+		return true;
+	}
 	}
 	panic("invalid initializer in initializer_is_null");
 }
@@ -434,6 +455,7 @@ static reloc_class_t classify_initializer_relocs(
 	switch (get_initializer_kind(init)) {
 	case IR_INITIALIZER_NULL:
 	case IR_INITIALIZER_TARVAL:
+	case IR_INITIALIZER_BLOB:
 		return NO_RELOCATIONS;
 	case IR_INITIALIZER_CONST:
 		return classify_expr_relocs(get_initializer_const_value(init));
@@ -451,10 +473,25 @@ static reloc_class_t classify_initializer_relocs(
 	panic("invalid initializer");
 }
 
+static be_gas_section_t determine_text_section(const ir_entity *entity)
+{
+	/* only the ELF linkers group hot and unlikely code */
+	if (is_method_entity(entity)
+	 && ir_platform.object_format == OBJECT_FORMAT_ELF) {
+		mtp_additional_properties const props
+			= get_entity_additional_properties(entity);
+		if (props & mtp_property_hot)
+			return GAS_SECTION_TEXT_HOT;
+		if (props & mtp_property_cold)
+			return GAS_SECTION_TEXT_UNLIKELY;
+	}
+	return GAS_SECTION_TEXT;
+}
+
 static be_gas_section_t determine_basic_section(const ir_entity *entity)
 {
 	if (is_method_entity(entity) || is_alias_entity(entity))
-		return GAS_SECTION_TEXT;
+		return determine_text_section(entity);
 
 	if (get_entity_linkage(entity) & IR_LINKAGE_CONSTANT) {
 		/* mach-o is the only one with a cstring section */
@@ -599,6 +636,8 @@ void be_gas_emit_function_prolog(const ir_entity *entity, unsigned po2alignment,
 
 	be_gas_section_t const section = determine_section(NULL, entity);
 	emit_section(section, entity);
+	text_section = section;
+	text_entity  = entity;
 
 	/* write the begin line (makes the life easier for scripts parsing the
 	 * assembler) */
@@ -609,6 +648,8 @@ void be_gas_emit_function_prolog(const ir_entity *entity, unsigned po2alignment,
 		be_emit_write_line();
 	}
 
+	if (get_entity_additional_properties(entity) & mtp_property_hot)
+		po2alignment = MAX(po2alignment, be_hot_function_p2align);
 	if (po2alignment > 0) {
 		/* gcc fills space between function with 0x90... */
 		char const *const fill_byte    = is_macho() ? "0x90" : "";
@@ -644,10 +685,53 @@ void be_gas_emit_function_prolog(const ir_entity *entity, unsigned po2alignment,
 	be_dwarf_function_begin();
 }
 
+static void emit_cold_part_name(ir_entity const *const entity)
+{
+	be_gas_emit_entity(entity);
+	be_emit_cstring(".cold");
+}
+
+void be_gas_emit_function_cold_part(ir_entity const *const entity)
+{
+	/* debug info and call frame information describe a single range */
+	be_gas_section_t const section = determine_section(NULL, entity);
+	if (ir_platform.object_format != OBJECT_FORMAT_ELF
+	 || (section != GAS_SECTION_TEXT && section != GAS_SECTION_TEXT_HOT)
+	 || be_dwarf_is_enabled())
+		return;
+
+	emit_section(GAS_SECTION_TEXT_UNLIKELY, NULL);
+	text_section = GAS_SECTION_TEXT_UNLIKELY;
+	text_entity  = NULL;
+	be_emit_cstring("\t.type\t");
+	emit_cold_part_name(entity);
+	be_emit_irprintf(", %cfunction\n", be_gas_elf_type_char);
+	be_emit_write_line();
+	emit_cold_part_name(entity);
+	be_emit_cstring(":\n");
+	be_emit_write_line();
+	cold_part_entity = entity;
+}
+
 void be_gas_emit_function_epilog(ir_entity const *const entity)
 {
 	be_dwarf_function_end();
 
+	if (cold_part_entity != NULL) {
+		assert(cold_part_entity == entity);
+		be_emit_cstring("\t.size\t");
+		emit_cold_part_name(entity);
+		be_emit_cstring(", .-");
+		emit_cold_part_name(entity);
+		be_emit_char('\n');
+		be_emit_write_line();
+		/* the size of the hot part is measured in its own section */
+		text_section = determine_section(NULL, entity);
+		text_entity  = entity;
+		emit_section(text_section, text_entity);
+		cold_part_entity = NULL;
+	}
+
 	if (ir_platform.object_format == OBJECT_FORMAT_ELF) {
 		be_emit_cstring("\t.size\t");
 		be_gas_emit_entity(entity);
@@ -819,6 +903,49 @@ static size_t emit_string_initializer(const ir_initializer_t *initializer)
 	return initializer->compound.n_initializers;
 }
 
+/** Number of bytes per line of blob data. */
+#define BLOB_LINE_BYTES 64
+/** Minimum number of zero bytes in blob data emitted as a gap. */
+#define BLOB_MIN_GAP    16
+
+/** Returns the number of zero bytes at @p i if they form a gap, 0 otherwise. */
+static size_t get_blob_gap(unsigned char const *const data, size_t const i,
+                           size_t const size)
+{
+	size_t zeros = 0;
+	while (i + zeros < size && data[i + zeros] == 0)
+		++zeros;
+	return zeros >= BLOB_MIN_GAP || i + zeros == size ? zeros : 0;
+}
+
+/**
+ * Emits the bytes of a blob initializer as string directives and long runs
+ * of zeros as gaps.
+ */
+static size_t emit_blob_initializer(const ir_initializer_t *initializer)
+{
+	unsigned char const *const data = get_initializer_blob_data(initializer);
+	size_t               const size = get_initializer_blob_size(initializer);
+	for (size_t i = 0; i < size;) {
+		size_t const gap = get_blob_gap(data, i, size);
+		if (gap > 0) {
+			be_emit_irprintf("\t.space\t%zu, 0\n", gap);
+			be_emit_write_line();
+			i += gap;
+			continue;
+		}
+
+		be_emit_cstring("\t.ascii \"");
+		size_t const end = MIN(size, i + BLOB_LINE_BYTES);
+		do {
+			emit_string_char(data[i++]);
+		} while (i < end && (data[i] != 0 || get_blob_gap(data, i, size) == 0));
+		be_emit_cstring("\"\n");
+		be_emit_write_line();
+	}
+	return size;
+}
+
 void be_gas_emit_string_literal(const char *string)
 {
 	be_emit_char('"');
@@ -840,6 +967,7 @@ typedef enum normal_or_bitfield_kind {
 	NORMAL = 0,
 	TARVAL,
 	STRING,
+	BLOB,
 	BITFIELD
 } normal_or_bitfield_kind;
 
@@ -851,6 +979,7 @@ typedef struct {
 		ir_tarval              *tarval;
 		unsigned char           bf_val;
 		const ir_initializer_t *string;
+		const ir_initializer_t *blob;
 	} v;
 } normal_or_bitfield;
 
@@ -864,6 +993,9 @@ static size_t get_initializer_size(const ir_initializer_t *initializer,
 	case IR_INITIALIZER_CONST:
 	case IR_INITIALIZER_NULL:
 		return get_type_size(type);
+	case IR_INITIALIZER_BLOB:
+		/* may be larger for arrays of flexible size */
+		return MAX(get_type_size(type), get_initializer_blob_size(initializer));
 	case IR_INITIALIZER_COMPOUND:
 		if (is_Array_type(type)) {
 			if (get_array_size(type) == 0) {
@@ -940,6 +1072,8 @@ static void emit_bitfield(normal_or_bitfield *vals, unsigned offset_bits,
 	}
 	case IR_INITIALIZER_COMPOUND:
 		panic("bitfield initializer is compound");
+	case IR_INITIALIZER_BLOB:
+		panic("bitfield initializer is blob");
 	}
 	if (!tv || tv == tarval_bad)
 		panic("couldn't get numeric value for bitfield initializer");
@@ -1018,6 +1152,15 @@ static void emit_ir_initializer(normal_or_bitfield *vals,
 		}
 		return;
 
+	case IR_INITIALIZER_BLOB:
+		assert(vals->kind != BITFIELD);
+		if (get_initializer_blob_size(initializer) == 0)
+			return;
+		vals->kind   = BLOB;
+		vals->type   = type;
+		vals->v.blob = initializer;
+		return;
+
 	case IR_INITIALIZER_COMPOUND:
 		if (is_Array_type(type)) {
 			ir_type *element_type = get_array_element_type(type);
@@ -1128,6 +1271,16 @@ static void emit_initializer(ir_entity const *const entity,
 
 	assert(size > 0);
 
+	/* blobs need no per byte bookkeeping */
+	if (get_initializer_kind(initializer) == IR_INITIALIZER_BLOB) {
+		size_t const blob_size = emit_blob_initializer(initializer);
+		if (blob_size < size) {
+			be_emit_irprintf("\t.space\t%lu, 0\n", size - blob_size);
+			be_emit_write_line();
+		}
+		return;
+	}
+
 	/* In the worst case, every initializer allocates one byte.
 	 * Moreover, initializer might be big, do not allocate on stack. */
 	normal_or_bitfield *const vals = XMALLOCNZ(normal_or_bitfield, size);
@@ -1159,6 +1312,9 @@ static void emit_initializer(ir_entity const *const entity,
 		case STRING:
 			elem_size = emit_string_initializer(vals[k].v.string);
 			break;
+		case BLOB:
+			elem_size = emit_blob_initializer(vals[k].v.blob);
+			break;
 		case BITFIELD:
 			be_emit_irprintf("\t.byte\t%d\n", vals[k].v.bf_val);
 			be_emit_write_line();
@@ -1625,8 +1781,9 @@ void be_emit_jump_table(ir_node const *const node, be_switch_attr_t const *const
 		be_emit_write_line();
 	}
 
+	/* continue in the section of the function or its cold part */
 	if (entity && !is_macho())
-		be_gas_emit_switch_section(GAS_SECTION_TEXT);
+		emit_section(text_section, text_entity);
 
 	free(labels);
 	free(targets);
@@ -35,6 +35,8 @@ typedef enum {
 	GAS_SECTION_DEBUG_LINE,      /**< dwarf debug line */
 	GAS_SECTION_DEBUG_PUBNAMES,  /**< dwarf pub names */
 	GAS_SECTION_DEBUG_FRAME,     /**< dwarf callframe infos */
+	GAS_SECTION_TEXT_UNLIKELY,   /**< rarely executed program code */
+	GAS_SECTION_TEXT_HOT,        /**< frequently executed program code */
 	GAS_SECTION_TYPE_MASK    = 0xFF,
 
 	GAS_SECTION_FLAG_TLS     = 1 << 8,  /**< thread local flag */
@@ -72,6 +74,13 @@ void be_gas_emit_function_prolog(const ir_entity *entity,
 
 void be_gas_emit_function_epilog(const ir_entity *entity);
 
+/**
+ * Emit assembler instructions necessary before the cold part of a function,
+ * which is moved to a separate section if possible. Branches between the hot
+ * and the cold part must not rely on fallthrough.
+ */
+void be_gas_emit_function_cold_part(const ir_entity *entity);
+
 char const *be_gas_get_private_prefix(void);
 
 /**
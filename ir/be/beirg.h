@@ -55,6 +55,9 @@ typedef struct be_irg_t {
 	/** Architecture specific per-graph data */
 	void             *isa_link;
 	bool              has_returns_twice_call;
+	/** first block of the rarely executed part at the end of the block
+	 * schedule, NULL if there is none */
+	ir_node          *first_cold_block;
 } be_irg_t;
 
 static inline be_irg_t *be_birg_from_irg(const ir_graph *irg)
@@ -240,6 +240,20 @@ void be_emit_reloc_entity(unsigned const len, uint8_t be_kind,
 	be_emit_relocation(len, &relocation);
 }
 
+void be_jit_walk_entities(ir_jit_function_t const *const function,
+                          void (*const func)(ir_entity *entity, void *data),
+                          void *const data)
+{
+	for (unsigned i = 0, n = function->n_fragments; i < n; ++i) {
+		fragment_info_t const *const fragment = function->fragment_infos[i];
+		for (unsigned r = 0, n_r = fragment->n_relocations; r < n_r; ++r) {
+			relocation_t const *const relocation = &fragment->relocations[r];
+			if (relocation->dest_kind == RELOC_DEST_ENTITY)
+				func(relocation->dest.entity, data);
+		}
+	}
+}
+
 static int32_t resolve_relocation_code(ir_jit_function_t const *const function,
                                        relocation_t const *const relocation,
                                        unsigned const relocation_address)
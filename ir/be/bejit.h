@@ -35,6 +35,14 @@ void be_jit_emit_memory(char *buffer, ir_jit_function_t *function,
 
 void be_jit_emit_as_asm(ir_jit_function_t *function, emit_relocation_func emit);
 
+/**
+ * Calls @p func for every entity referenced by a relocation of @p function.
+ * Entities referenced several times are visited several times.
+ */
+void be_jit_walk_entities(ir_jit_function_t const *function,
+                          void (*func)(ir_entity *entity, void *data),
+                          void *data);
+
 void be_jit_begin_function(ir_jit_segment_t *segment);
 ir_jit_function_t *be_jit_finish_function(void);
 
@@ -0,0 +1,214 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Lazy just in time compilation.
+ *
+ * Every registered function gets a stub which jumps through a pointer sized
+ * slot. The slot initially leads to a resolver compiling the function, it is
+ * patched to the compiled code afterwards.
+ */
+#include "array.h"
+#include "bearch.h"
+#include "execfreq.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "jit.h"
+#include "obst.h"
+#include "panic.h"
+#include "pmap.h"
+#include "pqueue.h"
+#include "target_t.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <limits.h>
+
+/** Number of stubs allocated at once. */
+#define STUBS_PER_CHUNK 256
+
+typedef struct lazy_function_t {
+	ir_jit_lazy_t *lazy;
+	ir_entity     *entity;
+	ir_graph      *irg;
+	char          *stub;
+	void const    *code;   /**< compiled code, NULL if not compiled yet */
+	bool           queued;
+} lazy_function_t;
+
+struct ir_jit_lazy_t {
+	ir_jit_segment_t        *segment;
+	ir_jit_lazy_callbacks_t  callbacks;
+	char                    *resolver;
+	char                    *stubs;   /**< unused stubs of the last chunk */
+	unsigned                 n_stubs; /**< number of unused stubs */
+	pmap                    *functions;
+	pqueue_t                *queue;
+	struct obstack           obst;
+};
+
+static void const *resolve(void *data);
+
+ir_jit_lazy_t *be_new_jit_lazy(ir_jit_segment_t *const segment,
+                               ir_jit_lazy_callbacks_t const *const callbacks)
+{
+	arch_isa_if_t const *const isa = ir_target.isa;
+	if (isa->jit_stub_size == 0)
+		return NULL;
+
+	ir_jit_lazy_t *const lazy = XMALLOCZ(ir_jit_lazy_t);
+	lazy->segment   = segment;
+	lazy->callbacks = *callbacks;
+	lazy->functions = pmap_create();
+	lazy->queue     = new_pqueue();
+	obstack_init(&lazy->obst);
+
+	lazy->resolver = (char*)callbacks->alloc_code(callbacks->data,
+	                                              isa->jit_resolver_size);
+	isa->emit_jit_resolver(lazy->resolver, resolve);
+	return lazy;
+}
+
+void be_destroy_jit_lazy(ir_jit_lazy_t *const lazy)
+{
+	obstack_free(&lazy->obst, NULL);
+	del_pqueue(lazy->queue);
+	pmap_destroy(lazy->functions);
+	free(lazy);
+}
+
+static char *new_stub(ir_jit_lazy_t *const lazy)
+{
+	unsigned const stub_size
+		= round_up2(ir_target.isa->jit_stub_size, sizeof(void*));
+	if (lazy->n_stubs == 0) {
+		ir_jit_lazy_callbacks_t const *const cb = &lazy->callbacks;
+		lazy->stubs   = (char*)cb->alloc_code(cb->data,
+		                                      stub_size * STUBS_PER_CHUNK);
+		lazy->n_stubs = STUBS_PER_CHUNK;
+	}
+	char *const stub = lazy->stubs;
+	lazy->stubs += stub_size;
+	--lazy->n_stubs;
+	return stub;
+}
+
+void const *be_jit_lazy_add(ir_jit_lazy_t *const lazy, ir_graph *const irg)
+{
+	ir_entity       *const entity = get_irg_entity(irg);
+	lazy_function_t *const fun    = OALLOCZ(&lazy->obst, lazy_function_t);
+	fun->lazy   = lazy;
+	fun->entity = entity;
+	fun->irg    = irg;
+	fun->stub   = new_stub(lazy);
+	ir_target.isa->emit_jit_stub(fun->stub, fun, lazy->resolver);
+	pmap_insert(lazy->functions, entity, fun);
+
+	void const *const entry = fun->stub + sizeof(void*);
+	be_jit_set_entity_addr(entity, entry);
+	return entry;
+}
+
+static void collect_calls(ir_node *const node, void *const data)
+{
+	ir_node ***const calls = (ir_node***)data;
+	if (is_Call(node))
+		ARR_APP1(ir_node*, *calls, node);
+}
+
+/**
+ * Puts the registered functions called by @p irg into the compile queue,
+ * prioritized by the estimated execution frequency of the call.
+ */
+static void queue_callees(ir_jit_lazy_t *const lazy, ir_graph *const irg)
+{
+	ir_estimate_execfreq(irg);
+	ir_node **calls = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_calls, &calls);
+	for (size_t i = 0, n = ARR_LEN(calls); i < n; ++i) {
+		ir_node   *const call   = calls[i];
+		ir_entity *const callee = get_Call_callee(call);
+		if (callee == NULL)
+			continue;
+		lazy_function_t *const fun
+			= pmap_get(lazy_function_t, lazy->functions, callee);
+		if (fun == NULL || fun->code != NULL || fun->queued)
+			continue;
+		double const freq     = get_block_execfreq(get_nodes_block(call));
+		int    const priority = freq * 1000 < INT_MAX ? (int)(freq * 1000)
+		                                              : INT_MAX;
+		pqueue_put(lazy->queue, fun, priority);
+		fun->queued = true;
+	}
+	DEL_ARR_F(calls);
+}
+
+static void const *compile(lazy_function_t *const fun)
+{
+	if (fun->code != NULL)
+		return fun->code;
+
+	ir_jit_lazy_t *const lazy = fun->lazy;
+	ir_graph      *const irg  = fun->irg;
+	queue_callees(lazy, irg);
+
+	ir_jit_function_t *const function = be_jit_compile(lazy->segment, irg);
+	if (function == NULL)
+		panic("could not compile %+F", fun->entity);
+	ir_jit_lazy_callbacks_t const *const cb = &lazy->callbacks;
+	unsigned const size = be_get_function_size(function);
+	char    *const code = (char*)cb->alloc_code(cb->data, size);
+	be_emit_function(code, function);
+
+	fun->code = code;
+	be_jit_set_entity_addr(fun->entity, code);
+	/* threads may be executing the stub right now */
+	void const **const slot = (void const**)fun->stub;
+#ifdef __GNUC__
+	__atomic_store_n(slot, (void const*)code, __ATOMIC_RELEASE);
+#else
+	*(void const *volatile*)slot = code;
+#endif
+	return code;
+}
+
+/** Called by the stub of a function which is not compiled yet. */
+static void const *resolve(void *const data)
+{
+	lazy_function_t         *const fun = (lazy_function_t*)data;
+	ir_jit_lazy_callbacks_t *const cb  = &fun->lazy->callbacks;
+	if (cb->lock != NULL)
+		cb->lock(cb->data);
+	void const *const code = compile(fun);
+	if (cb->unlock != NULL)
+		cb->unlock(cb->data);
+	return code;
+}
+
+void const *be_jit_lazy_compile(ir_jit_lazy_t *const lazy,
+                                ir_entity *const entity)
+{
+	lazy_function_t *const fun
+		= pmap_get(lazy_function_t, lazy->functions, entity);
+	if (fun == NULL)
+		panic("%+F is not registered for lazy compilation", entity);
+	return compile(fun);
+}
+
+unsigned be_jit_lazy_compile_queued(ir_jit_lazy_t *const lazy,
+                                    unsigned const max)
+{
+	unsigned n_compiled = 0;
+	while (n_compiled < max && !pqueue_empty(lazy->queue)) {
+		lazy_function_t *const fun
+			= (lazy_function_t*)pqueue_pop_front(lazy->queue);
+		/* the function may have been called in the meantime */
+		if (fun->code != NULL)
+			continue;
+		compile(fun);
+		++n_compiled;
+	}
+	return n_compiled;
+}
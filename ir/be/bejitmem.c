@@ -0,0 +1,497 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Executable memory for just in time compiled code.
+ *
+ * Memory is mapped in aligned slabs. Every slab is split into blocks of a
+ * single power of two size, freed blocks are kept per slab and reused.
+ * Blocks larger than the largest size class get a mapping of their own.
+ *
+ * No page is writable and executable at the same time. Every slab consists of
+ * an executable prefix and a writable rest. Slabs written to are collected
+ * and be_jit_memory_protect() extends their executable prefix up to the page
+ * holding the end of the last allocated block, so emitting a batch of
+ * functions costs a single protection change per slab. Fresh blocks behind
+ * the prefix stay usable, so a JIT protecting every function on its own
+ * fills its slabs instead of starting new ones. The cost is the rest of the
+ * last page of each protected slab, whose blocks are not written again until
+ * the slab is empty. Only then the prefix is made writable again, so code
+ * which may be running never becomes writable.
+ */
+#include "array.h"
+#include "bejit.h"
+#include "bitfiddle.h"
+#include "entity_t.h"
+#include "irnode_t.h"
+#include "jit.h"
+#include "panic.h"
+#include "pmap.h"
+#include "tv.h"
+#include "typerep.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/** Size and alignment of a slab. */
+#define SLAB_SIZE       ((size_t)64 * 1024)
+/** log2 of the smallest block size. */
+#define MIN_BLOCK_LOG   4
+/** log2 of the largest block carved from a slab. */
+#define MAX_BLOCK_LOG   14
+#define N_BINS          (MAX_BLOCK_LOG - MIN_BLOCK_LOG + 1)
+
+typedef struct slab_t {
+	char     *base;
+	size_t    size;       /**< size of the mapping */
+	size_t    block_size; /**< equals size for blocks with their own mapping */
+	size_t    exec_size;  /**< size of the executable prefix */
+	unsigned  n_fresh;    /**< number of never used blocks at the end */
+	unsigned  n_used;     /**< number of allocated blocks */
+	char    **free;       /**< freed blocks */
+	bool      written;    /**< written to since the last protection */
+} slab_t;
+
+typedef struct bin_t {
+	slab_t **slabs; /**< slabs of this size class */
+} bin_t;
+
+struct ir_jit_memory_t {
+	bin_t    bins[N_BINS];
+	pmap    *slabs;    /**< maps slab base to slab_t */
+	pmap    *large;    /**< maps blocks with their own mapping to slab_t */
+	slab_t **written;  /**< slabs to protect in be_jit_memory_protect() */
+	size_t   page_size;
+};
+
+#ifdef _WIN32
+static char *map_memory(size_t const size)
+{
+	/* the allocation granularity is 64KiB, which aligns slabs */
+	char *const res = (char*)VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT,
+	                                      PAGE_READWRITE);
+	if (res == NULL)
+		panic("could not map %zu bytes of code memory", size);
+	return res;
+}
+
+static void unmap_memory(char *const base, size_t const size)
+{
+	(void)size;
+	VirtualFree(base, 0, MEM_RELEASE);
+}
+
+static size_t get_page_size(void)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+}
+
+static void protect_memory(char *const base, size_t const size,
+                           bool const executable)
+{
+	DWORD old;
+	if (!VirtualProtect(base, size,
+	                    executable ? PAGE_EXECUTE_READ : PAGE_READWRITE, &old))
+		panic("could not change protection of code memory");
+	if (executable)
+		FlushInstructionCache(GetCurrentProcess(), base, size);
+}
+#else
+static char *map_memory(size_t const size)
+{
+	/* map twice the size and trim, so the mapping is aligned to SLAB_SIZE */
+	size_t const map_size = size + SLAB_SIZE;
+	char  *const raw      = (char*)mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+	                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (raw == MAP_FAILED)
+		panic("could not map %zu bytes of code memory", size);
+	uintptr_t const mask = SLAB_SIZE - 1;
+	char     *const base = (char*)(((uintptr_t)raw + mask) & ~mask);
+	size_t    const head = base - raw;
+	if (head > 0)
+		munmap(raw, head);
+	if (map_size - head > size)
+		munmap(base + size, map_size - head - size);
+	return base;
+}
+
+static void unmap_memory(char *const base, size_t const size)
+{
+	munmap(base, size);
+}
+
+static size_t get_page_size(void)
+{
+	return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+static void protect_memory(char *const base, size_t const size,
+                           bool const executable)
+{
+	int const prot = executable ? PROT_READ | PROT_EXEC : PROT_READ | PROT_WRITE;
+	if (mprotect(base, size, prot) != 0)
+		panic("could not change protection of code memory");
+#ifdef __GNUC__
+	if (executable)
+		__builtin___clear_cache(base, base + size);
+#endif
+}
+#endif
+
+ir_jit_memory_t *be_new_jit_memory(void)
+{
+	ir_jit_memory_t *const memory = XMALLOCZ(ir_jit_memory_t);
+	for (unsigned i = 0; i < N_BINS; ++i)
+		memory->bins[i].slabs = NEW_ARR_F(slab_t*, 0);
+	memory->slabs    = pmap_create();
+	memory->large    = pmap_create();
+	memory->written   = NEW_ARR_F(slab_t*, 0);
+	memory->page_size = get_page_size();
+	return memory;
+}
+
+static void destroy_slabs(pmap *const slabs)
+{
+	foreach_pmap(slabs, entry) {
+		slab_t *const slab = (slab_t*)entry->value;
+		if (slab == NULL)
+			continue; /* freed block with its own mapping */
+		unmap_memory(slab->base, slab->size);
+		DEL_ARR_F(slab->free);
+		free(slab);
+	}
+	pmap_destroy(slabs);
+}
+
+void be_destroy_jit_memory(ir_jit_memory_t *const memory)
+{
+	DEL_ARR_F(memory->written);
+	destroy_slabs(memory->large);
+	destroy_slabs(memory->slabs);
+	for (unsigned i = 0; i < N_BINS; ++i)
+		DEL_ARR_F(memory->bins[i].slabs);
+	free(memory);
+}
+
+static slab_t *new_slab(ir_jit_memory_t *const memory, size_t const size,
+                        size_t const block_size)
+{
+	slab_t *const slab = XMALLOCZ(slab_t);
+	slab->base       = map_memory(size);
+	slab->size       = size;
+	slab->block_size = block_size;
+	slab->n_fresh    = size / block_size;
+	slab->free       = NEW_ARR_F(char*, 0);
+	return slab;
+}
+
+/** Returns whether block @p block of @p slab lies in the writable rest. */
+static bool is_writable(slab_t const *const slab, char const *const block)
+{
+	return block >= slab->base + slab->exec_size;
+}
+
+/**
+ * Returns whether @p slab has a block which may be written without changing
+ * any protection.
+ */
+static bool has_writable_block(slab_t const *const slab)
+{
+	size_t const n_free = ARR_LEN(slab->free);
+	return slab->n_fresh > 0
+	    || (n_free > 0 && is_writable(slab, slab->free[n_free - 1]));
+}
+
+/**
+ * Prepares writing a block of @p slab. If the writable rest has no free block,
+ * the slab is empty and its executable prefix is made writable again, no code
+ * in it may be running.
+ */
+static void prepare_write(ir_jit_memory_t *const memory, slab_t *const slab)
+{
+	if (!has_writable_block(slab)) {
+		assert(slab->n_used == 0);
+		protect_memory(slab->base, slab->exec_size, false);
+		slab->exec_size = 0;
+	}
+	if (!slab->written) {
+		slab->written = true;
+		ARR_APP1(slab_t*, memory->written, slab);
+	}
+}
+
+/** Returns the slab containing block @p code. */
+static slab_t *get_slab(ir_jit_memory_t const *const memory,
+                        void const *const code)
+{
+	slab_t *slab = pmap_get(slab_t, memory->large, code);
+	if (slab == NULL) {
+		void const *const base
+			= (void const*)((uintptr_t)code & ~(uintptr_t)(SLAB_SIZE - 1));
+		slab = pmap_get(slab_t, memory->slabs, base);
+	}
+	if (slab == NULL)
+		panic("%p is not managed by this code memory", code);
+	return slab;
+}
+
+/**
+ * Returns a slab of @p bin with a free block which may be written: a block in
+ * the writable rest of a slab or any block of a slab without allocated blocks.
+ */
+static slab_t *find_slab(bin_t const *const bin)
+{
+	slab_t *res = NULL;
+	/* prefer recently created slabs, they likely have fresh blocks */
+	for (size_t i = ARR_LEN(bin->slabs); i-- > 0;) {
+		slab_t *const slab = bin->slabs[i];
+		if (has_writable_block(slab))
+			return slab;
+		if (slab->n_used == 0 && ARR_LEN(slab->free) > 0 && res == NULL)
+			res = slab;
+	}
+	return res;
+}
+
+void *be_jit_memory_alloc(ir_jit_memory_t *const memory, size_t const size)
+{
+	unsigned const size_log = size <= (1u << MIN_BLOCK_LOG) ? MIN_BLOCK_LOG
+		: 32 - nlz((unsigned)size - 1);
+	if (size > (1u << MAX_BLOCK_LOG)) {
+		size_t  const map_size = (size + SLAB_SIZE - 1) & ~(SLAB_SIZE - 1);
+		slab_t *const slab     = new_slab(memory, map_size, map_size);
+		pmap_insert(memory->large, slab->base, slab);
+		prepare_write(memory, slab);
+		slab->n_fresh = 0;
+		slab->n_used  = 1;
+		return slab->base;
+	}
+
+	bin_t  *const bin  = &memory->bins[size_log - MIN_BLOCK_LOG];
+	slab_t       *slab = find_slab(bin);
+	if (slab == NULL) {
+		slab = new_slab(memory, SLAB_SIZE, (size_t)1 << size_log);
+		pmap_insert(memory->slabs, slab->base, slab);
+		ARR_APP1(slab_t*, bin->slabs, slab);
+	}
+	prepare_write(memory, slab);
+	++slab->n_used;
+
+	size_t const n_free = ARR_LEN(slab->free);
+	if (n_free > 0 && is_writable(slab, slab->free[n_free - 1])) {
+		/* reuse the most recently freed block, it is likely still cached */
+		char *const block = slab->free[n_free - 1];
+		ARR_SHRINKLEN(slab->free, n_free - 1);
+		return block;
+	}
+	char *const block = slab->base + slab->size - slab->n_fresh * slab->block_size;
+	--slab->n_fresh;
+	return block;
+}
+
+void be_jit_memory_free(ir_jit_memory_t *const memory, void const *const code)
+{
+	slab_t *const slab = get_slab(memory, code);
+	if (slab->block_size != slab->size) {
+		assert(slab->n_used > 0);
+		--slab->n_used;
+		ARR_APP1(char*, slab->free, (char*)code);
+		return;
+	}
+
+	/* pmap has no removal, a NULL value marks the block as unmapped */
+	pmap_insert(memory->large, code, NULL);
+	for (size_t i = 0, n = ARR_LEN(memory->written); i < n; ++i) {
+		if (memory->written[i] == slab) {
+			memory->written[i] = memory->written[n - 1];
+			ARR_SHRINKLEN(memory->written, n - 1);
+			break;
+		}
+	}
+	unmap_memory(slab->base, slab->size);
+	DEL_ARR_F(slab->free);
+	free(slab);
+}
+
+void be_jit_memory_protect(ir_jit_memory_t *const memory)
+{
+	for (size_t i = 0, n = ARR_LEN(memory->written); i < n; ++i) {
+		slab_t *const slab = memory->written[i];
+		slab->written = false;
+
+		/* extend the executable prefix to the page holding the last block */
+		size_t const block_size = slab->block_size;
+		size_t const used_end   = slab->size - slab->n_fresh * block_size;
+		size_t const exec_end   = MIN(round_up2(used_end, memory->page_size),
+		                              slab->size);
+		if (exec_end > slab->exec_size) {
+			protect_memory(slab->base + slab->exec_size,
+			               exec_end - slab->exec_size, true);
+			slab->exec_size = exec_end;
+		}
+
+		/* fresh blocks in the last page wait for the slab to become empty */
+		unsigned const n_fresh = (slab->size - exec_end) / block_size;
+		for (unsigned f = slab->n_fresh; f-- > n_fresh;) {
+			char *const block = slab->base + slab->size - (f + 1) * block_size;
+			ARR_APP1(char*, slab->free, block);
+		}
+		slab->n_fresh = n_fresh;
+	}
+	ARR_SHRINKLEN(memory->written, 0);
+}
+
+/**
+ * Writes the value of @p initializer for an object of type @p type to
+ * @p buffer, which is cleared already. Returns false if the value is not
+ * known at compile time.
+ */
+static bool write_initializer(char *const buffer, ir_type *const type,
+                              ir_initializer_t const *const initializer)
+{
+	switch (get_initializer_kind(initializer)) {
+	case IR_INITIALIZER_NULL:
+		return true;
+
+	case IR_INITIALIZER_CONST: {
+		ir_node *const value = get_initializer_const_value(initializer);
+		if (!is_Const(value))
+			return false;
+		tarval_to_bytes((unsigned char*)buffer, get_Const_tarval(value));
+		return true;
+	}
+
+	case IR_INITIALIZER_TARVAL:
+		tarval_to_bytes((unsigned char*)buffer,
+		                get_initializer_tarval_value(initializer));
+		return true;
+
+	case IR_INITIALIZER_BLOB: {
+		size_t const size = get_initializer_blob_size(initializer);
+		if (size > get_type_size(type))
+			return false;
+		memcpy(buffer, get_initializer_blob_data(initializer), size);
+		return true;
+	}
+
+	case IR_INITIALIZER_COMPOUND: {
+		size_t const n = get_initializer_compound_n_entries(initializer);
+		if (is_Array_type(type)) {
+			ir_type *const element      = get_array_element_type(type);
+			unsigned const element_size = get_type_size(element);
+			for (size_t i = 0; i < n; ++i) {
+				ir_initializer_t const *const sub
+					= get_initializer_compound_value(initializer, i);
+				if (!write_initializer(buffer + i * element_size, element, sub))
+					return false;
+			}
+			return true;
+		}
+		if (!is_compound_type(type) || n > get_compound_n_members(type))
+			return false;
+		for (size_t i = 0; i < n; ++i) {
+			ir_entity *const member = get_compound_member(type, i);
+			if (get_entity_bitfield_size(member) != 0)
+				return false;
+			ir_initializer_t const *const sub
+				= get_initializer_compound_value(initializer, i);
+			if (!write_initializer(buffer + get_entity_offset(member),
+			                       get_entity_type(member), sub))
+				return false;
+		}
+		return true;
+	}
+	}
+	panic("invalid initializer");
+}
+
+/** Private constants referenced by a function, placed behind its code. */
+typedef struct literal_pool_t {
+	ir_entity **entities;
+	unsigned    size; /**< size of the code and the literals */
+} literal_pool_t;
+
+static bool is_literal(ir_entity const *const entity)
+{
+	return be_jit_get_entity_addr(entity) == (void const*)-1
+	    && !is_method_entity(entity)
+	    && get_entity_visibility(entity) == ir_visibility_private
+	    && (get_entity_linkage(entity) & IR_LINKAGE_CONSTANT)
+	    && get_entity_initializer(entity) != NULL;
+}
+
+static void collect_literal(ir_entity *const entity, void *const data)
+{
+	literal_pool_t *const pool = (literal_pool_t*)data;
+	if (!is_literal(entity))
+		return;
+	for (size_t i = 0, n = ARR_LEN(pool->entities); i < n; ++i) {
+		if (pool->entities[i] == entity)
+			return;
+	}
+	ARR_APP1(ir_entity*, pool->entities, entity);
+
+	ir_type *const type  = get_entity_type(entity);
+	unsigned const align = MAX(get_type_alignment(type), 1);
+	/* blocks are aligned to their size, which is at least this */
+	assert(align <= 1u << MIN_BLOCK_LOG);
+	pool->size = round_up2(pool->size, align) + MAX(get_type_size(type), 1);
+}
+
+/**
+ * Copies the literals of @p pool behind the code in @p code and sets their
+ * addresses.
+ */
+static void place_literals(literal_pool_t const *const pool, char *const code,
+                           unsigned const code_size)
+{
+	unsigned offset = code_size;
+	for (size_t i = 0, n = ARR_LEN(pool->entities); i < n; ++i) {
+		ir_entity *const entity = pool->entities[i];
+		ir_type   *const type   = get_entity_type(entity);
+		unsigned   const size   = MAX(get_type_size(type), 1);
+		offset = round_up2(offset, MAX(get_type_alignment(type), 1));
+		char *const literal = code + offset;
+		offset += size;
+		memset(literal, 0, size);
+		if (write_initializer(literal, type, get_entity_initializer(entity)))
+			be_jit_set_entity_addr(entity, literal);
+	}
+}
+
+void const *be_jit_memory_emit(ir_jit_memory_t *const memory,
+                               ir_jit_function_t *const function,
+                               void const *const replace)
+{
+	unsigned const code_size = be_get_function_size(function);
+	literal_pool_t pool = {
+		.entities = NEW_ARR_F(ir_entity*, 0),
+		.size     = code_size,
+	};
+	be_jit_walk_entities(function, collect_literal, &pool);
+
+	char *const code = (char*)be_jit_memory_alloc(memory, pool.size);
+	place_literals(&pool, code, code_size);
+	be_emit_function(code, function);
+
+	/* the literals belong to this code only */
+	for (size_t i = 0, n = ARR_LEN(pool.entities); i < n; ++i)
+		be_jit_set_entity_addr(pool.entities[i], (void const*)-1);
+	DEL_ARR_F(pool.entities);
+
+	if (replace != NULL)
+		be_jit_memory_free(memory, replace);
+	return code;
+}
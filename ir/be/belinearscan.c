@@ -0,0 +1,755 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Linear scan register allocator.
+ *
+ * A register allocator aimed at short compile times. The schedule is
+ * numbered linearly with blocks in reverse postorder and a lifetime interval
+ * is built for every value from the liveness information. The intervals are
+ * then assigned registers in order of their start position.
+ *
+ * Because the graph is in SSA form and the spiller reduced the register
+ * pressure, a register which is free at the definition of a value stays free
+ * during its whole lifetime: All values interfering with it are live at its
+ * definition. So no interval has to be split. Constrained instructions get a
+ * Perm over all live values in front of them (like the chordal allocator
+ * does), registers at these points are determined by a bipartite matching
+ * which prefers to leave values in their current register. Phi permutations
+ * are resolved by SSA destruction afterwards.
+ */
+#include "bechordal_t.h"
+#include "beirg.h"
+#include "belive.h"
+#include "belower.h"
+#include "bemodule.h"
+#include "benode.h"
+#include "bera.h"
+#include "besched.h"
+#include "bespill.h"
+#include "bespillutil.h"
+#include "bessadestr.h"
+#include "beutil.h"
+#include "beverify.h"
+#include "debug.h"
+#include "hungarian.h"
+#include "irdom.h"
+#include "iredges_t.h"
+#include "irgopt.h"
+#include "irgraph_t.h"
+#include "irnode_t.h"
+#include "obst.h"
+#include "panic.h"
+#include "pmap.h"
+#include "raw_bitset.h"
+#include "statev_t.h"
+#include "target_t.h"
+#include "util.h"
+
+#include <limits.h>
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+typedef struct range_t range_t;
+struct range_t {
+	unsigned  from; /**< first position covered */
+	unsigned  to;   /**< last position covered */
+	range_t  *next;
+};
+
+typedef struct interval_t {
+	ir_node  *value;
+	range_t  *ranges;  /**< list of ranges sorted by position */
+	range_t  *current; /**< first range not ending before the scan position */
+} interval_t;
+
+/** Operand of a constrained instruction, a definition and/or a use. */
+typedef struct operand_t {
+	ir_node        *def;
+	ir_node        *use;
+	unsigned const *regs;     /**< allowed registers */
+	int             pref;     /**< preferred register or -1 */
+	bool            paired;   /**< use was merged into a definition */
+} operand_t;
+
+static struct obstack               obst;
+static ir_graph                    *irg;
+static arch_register_class_t const *cls;
+static unsigned                     n_regs;
+static unsigned                    *allocatable_regs;
+static be_lv_t                     *lv;
+static interval_t                 **intervals;    /**< interval by node index */
+static unsigned                    *positions;    /**< position by node index */
+static ir_node                    **constrained;  /**< constrained instructions */
+static pmap                        *perms;        /**< Perm in front of them */
+static bitset_t                    *unhandled_constraints;
+
+static bool has_constraints(ir_node *const node)
+{
+	if (is_Phi(node))
+		return false;
+	be_foreach_definition(node, cls, value, req,
+		if (req->limited != NULL || req->width > 1)
+			return true;
+	);
+	be_foreach_use(node, cls, in_req, value, value_req,
+		if (in_req->limited != NULL)
+			return true;
+	);
+	return false;
+}
+
+/**
+ * Places a Perm over all live values in front of every constrained
+ * instruction, so the values can be moved into the required registers.
+ */
+static void insert_constraint_perms(ir_node *const block)
+{
+	sched_foreach_safe(block, node) {
+		if (!has_constraints(node))
+			continue;
+		ir_node *const perm = insert_Perm_before(irg, cls, node);
+		pmap_insert(perms, node, perm);
+		ARR_APP1(ir_node*, constrained, node);
+	}
+}
+
+static interval_t *get_interval(ir_node *const value)
+{
+	interval_t *iv = intervals[get_irn_idx(value)];
+	if (iv == NULL) {
+		iv        = OALLOCZ(&obst, interval_t);
+		iv->value = value;
+		intervals[get_irn_idx(value)] = iv;
+	}
+	return iv;
+}
+
+/**
+ * Adds a range to @p value. Ranges are added backwards, so @p from is never
+ * larger than the start of the already existing ranges.
+ */
+static void add_range(ir_node *const value, unsigned const from,
+                      unsigned const to)
+{
+	interval_t *const iv    = get_interval(value);
+	range_t    *const first = iv->ranges;
+	if (first != NULL && first->from <= to + 1) {
+		first->from = from;
+		if (to > first->to)
+			first->to = to;
+		return;
+	}
+	range_t *const range = OALLOC(&obst, range_t);
+	range->from = from;
+	range->to   = to;
+	range->next = first;
+	iv->ranges  = range;
+}
+
+/** Shortens the range of @p value at the start of its block to its def. */
+static void add_def(ir_node *const value, unsigned const block_from,
+                    unsigned const pos)
+{
+	interval_t *const iv    = get_interval(value);
+	range_t    *const first = iv->ranges;
+	if (first != NULL && first->from == block_from && first->to >= pos) {
+		first->from = pos;
+	} else {
+		/* the value is never used */
+		add_range(value, pos, pos);
+	}
+}
+
+/**
+ * Numbers the schedule and builds the lifetime intervals. Every instruction
+ * has two positions: its uses are at the first, its definitions at the second
+ * one. Phis are defined at the block start.
+ */
+static void build_intervals(ir_node **const blocks, size_t const n_blocks)
+{
+	unsigned *const block_from = ALLOCAN(unsigned, n_blocks + 1);
+	unsigned        pos        = 0;
+	for (size_t b = 0; b < n_blocks; ++b) {
+		block_from[b] = pos;
+		pos += 2;
+		sched_foreach_non_phi(blocks[b], node) {
+			positions[get_irn_idx(node)] = pos;
+			pos += 2;
+		}
+	}
+	block_from[n_blocks] = pos;
+
+	for (size_t b = n_blocks; b-- > 0;) {
+		ir_node *const block = blocks[b];
+		unsigned const from  = block_from[b];
+		unsigned const to    = block_from[b + 1] - 1;
+
+		be_lv_foreach_cls(lv, block, be_lv_state_end, cls, value) {
+			add_range(value, from, to);
+		}
+
+		sched_foreach_reverse(block, node) {
+			if (is_Phi(node)) {
+				if (arch_irn_consider_in_reg_alloc(cls, node))
+					add_def(node, from, from);
+				continue;
+			}
+			unsigned const node_pos = positions[get_irn_idx(node)];
+			be_foreach_definition(node, cls, value, req,
+				add_def(value, from, node_pos + 1);
+			);
+			be_foreach_use(node, cls, in_req, value, value_req,
+				add_range(value, from, node_pos);
+			);
+		}
+	}
+}
+
+static bool is_free(unsigned const *const occupied, unsigned const *const allowed,
+                    unsigned const reg, unsigned const width)
+{
+	if (reg % width != 0 || reg + width > n_regs)
+		return false;
+	for (unsigned r = reg; r < reg + width; ++r) {
+		if (!rbitset_is_set(allowed, r) || rbitset_is_set(occupied, r))
+			return false;
+	}
+	return true;
+}
+
+static int get_reg_idx(ir_node const *const node)
+{
+	arch_register_t const *const reg = arch_get_irn_register(node);
+	return reg != NULL && reg->cls == cls ? (int)reg->index : -1;
+}
+
+/** Sets the register of @p node in @p regs if it has one. */
+static void add_reg(unsigned *const regs, ir_node const *const node)
+{
+	int const r = get_reg_idx(node);
+	if (r >= 0)
+		rbitset_set(regs, r);
+}
+
+/**
+ * Collects the registers of already assigned values @p value should share a
+ * register with in @p hints.
+ */
+static void get_hints(ir_node *const value, unsigned *const hints)
+{
+	arch_register_req_t const *const req = arch_get_irn_register_req(value);
+	if (req->should_be_same != 0) {
+		ir_node *const insn = skip_Proj(value);
+		foreach_irn_in(insn, i, in) {
+			if (rbitset_is_set(&req->should_be_same, i))
+				add_reg(hints, in);
+		}
+	}
+	if (is_Phi(value) || be_is_Copy(value)) {
+		foreach_irn_in(value, i, in) {
+			add_reg(hints, in);
+		}
+	}
+	/* Phis on loop back edges are assigned before their arguments */
+	foreach_out_edge(value, edge) {
+		ir_node *const user = get_edge_src_irn(edge);
+		if (is_Phi(user))
+			add_reg(hints, user);
+	}
+}
+
+/**
+ * Looks at the next constrained instructions @p value reaches. Collects the
+ * registers it is required in there in @p wanted and the registers it has
+ * to leave when it lives through the instruction in @p avoid.
+ */
+static void get_constraint_prefs(ir_node *const value, unsigned *const wanted,
+                                 unsigned *const avoid)
+{
+	foreach_out_edge(value, edge) {
+		ir_node *const perm = get_edge_src_irn(edge);
+		if (!be_is_Perm(perm))
+			continue;
+		ir_node *const insn = sched_next(perm);
+		if (is_Block(insn) || pmap_get(ir_node, perms, insn) != perm)
+			continue;
+
+		int  const pos  = get_edge_src_pos(edge);
+		bool       used = false;
+		foreach_irn_in(insn, i, in) {
+			if (!is_Proj(in) || get_Proj_pred(in) != perm
+			    || get_Proj_num(in) != (unsigned)pos)
+				continue;
+			arch_register_req_t const *const req
+				= arch_get_irn_register_req_in(insn, i);
+			if (req->limited != NULL)
+				rbitset_or(wanted, req->limited, n_regs);
+			used = true;
+		}
+		if (!used) {
+			be_foreach_definition(insn, cls, def, req,
+				if (req->limited != NULL)
+					rbitset_or(avoid, req->limited, n_regs);
+			);
+		}
+	}
+}
+
+static void assign_register(ir_node *const value,
+                            unsigned const *const occupied)
+{
+	arch_register_req_t const *const req     = arch_get_irn_register_req(value);
+	unsigned            const *const allowed
+		= req->limited != NULL ? req->limited : allocatable_regs;
+	unsigned                   const width   = req->width;
+
+	unsigned *const hints  = rbitset_alloca(n_regs);
+	unsigned *const wanted = rbitset_alloca(n_regs);
+	unsigned *const avoid  = rbitset_alloca(n_regs);
+	get_hints(value, hints);
+	get_constraint_prefs(value, wanted, avoid);
+
+	/* sharing a register with a related value saves a copy for sure, a
+	 * register clobbered by the next constrained instruction costs a copy
+	 * there */
+	int reg        = -1;
+	int best_score = INT_MIN;
+	for (unsigned r = 0; r < n_regs; ++r) {
+		if (!is_free(occupied, allowed, r, width))
+			continue;
+		int const score = 4 * rbitset_is_set(hints, r)
+		                + 2 * rbitset_is_set(wanted, r)
+		                - 3 * rbitset_is_set(avoid, r);
+		if (score > best_score) {
+			reg        = r;
+			best_score = score;
+		}
+	}
+	if (reg < 0) {
+		/* the common reason to hit this panic is when 1 of your nodes is not
+		 * register pressure faithful */
+		panic("no register left for %+F", value);
+	}
+	DB((dbg, LEVEL_2, "Assign %+F -> %s\n", value,
+	    arch_register_for_index(cls, reg)->name));
+	arch_set_irn_register_idx(value, reg);
+}
+
+static operand_t *find_use(operand_t *const ops, size_t const n_ops,
+                           ir_node const *const value)
+{
+	for (size_t i = 0; i < n_ops; ++i) {
+		if (ops[i].use == value && ops[i].def == NULL)
+			return &ops[i];
+	}
+	return NULL;
+}
+
+static unsigned const *restrict_regs(unsigned const *const regs,
+                                     unsigned const *const limited)
+{
+	if (regs == limited)
+		return regs;
+	unsigned *const res = rbitset_obstack_alloc(&obst, n_regs);
+	rbitset_copy(res, regs, n_regs);
+	rbitset_and(res, limited, n_regs);
+	return res;
+}
+
+static unsigned const *single_reg(unsigned const reg)
+{
+	unsigned *const res = rbitset_obstack_alloc(&obst, n_regs);
+	rbitset_set(res, reg);
+	return res;
+}
+
+static void add_def_operand(operand_t **const ops, ir_node *const value,
+                            arch_register_req_t const *const req)
+{
+	operand_t op = { value, NULL, allocatable_regs, -1, false };
+	if (req->limited != NULL)
+		op.regs = req->limited;
+	int const r = get_reg_idx(value);
+	if (r >= 0)
+		op.regs = single_reg(r);
+	ARR_APP1(operand_t, *ops, op);
+}
+
+static void add_use_operand(operand_t **const ops, ir_node *const value,
+                            arch_register_req_t const *const req)
+{
+	unsigned const *const limited
+		= req->limited != NULL ? req->limited : allocatable_regs;
+	operand_t *const op = find_use(*ops, ARR_LEN(*ops), value);
+	if (op != NULL) {
+		op->regs = restrict_regs(op->regs, limited);
+	} else {
+		operand_t new_op = { NULL, value, limited, -1, false };
+		ARR_APP1(operand_t, *ops, new_op);
+	}
+}
+
+/** Merges the use @p use into the definition @p def if possible. */
+static bool can_pair(operand_t const *const def, operand_t const *const use,
+                     ir_node const *const insn)
+{
+	return !use->paired && use->def == NULL
+	    && rbitsets_have_common(def->regs, use->regs, n_regs)
+	    && !be_value_live_after(use->use, insn);
+}
+
+static void pair(operand_t *const def, operand_t *const use)
+{
+	def->use    = use->use;
+	def->regs   = restrict_regs(def->regs, use->regs);
+	def->pref   = use->pref;
+	use->paired = true;
+}
+
+/**
+ * Assigns registers to the Projs of the Perm in front of the constrained
+ * instruction @p insn and to the values defined by @p insn.
+ */
+static void handle_constraints(ir_node *const insn)
+{
+	if (!bitset_is_set(unhandled_constraints, get_irn_idx(insn)))
+		return;
+	bitset_clear(unhandled_constraints, get_irn_idx(insn));
+
+	ir_node   *const perm = pmap_get(ir_node, perms, insn);
+	operand_t       *ops  = NEW_ARR_F(operand_t, 0);
+
+	/* definitions */
+	be_foreach_definition(insn, cls, value, req,
+		add_def_operand(&ops, value, req);
+	);
+	size_t const n_defs = ARR_LEN(ops);
+
+	/* uses and values living through the instruction */
+	be_foreach_use(insn, cls, in_req, value, value_req,
+		add_use_operand(&ops, value, in_req);
+	);
+	if (perm != NULL) {
+		foreach_out_edge(perm, edge) {
+			ir_node *const proj = get_edge_src_irn(edge);
+			if (find_use(ops, ARR_LEN(ops), proj) != NULL)
+				continue;
+			operand_t op = { NULL, proj, allocatable_regs, -1, false };
+			ARR_APP1(operand_t, ops, op);
+		}
+	}
+	for (size_t i = n_defs, n = ARR_LEN(ops); i < n; ++i) {
+		operand_t *const op = &ops[i];
+		ir_node   *const value = op->use;
+		if (is_Proj(value) && get_Proj_pred(value) == perm) {
+			op->pref = get_reg_idx(get_irn_n(perm, get_Proj_num(value)));
+		} else {
+			/* value was not permuted (e.g. it lives in an ignore register) */
+			int const r = get_reg_idx(value);
+			assert(r >= 0);
+			op->regs = single_reg(r);
+			op->pref = r;
+		}
+	}
+
+	/* let definitions share the register of dying uses, prefer
+	 * should_be_same inputs */
+	for (size_t i = 0; i < n_defs; ++i) {
+		operand_t                 *const def = &ops[i];
+		arch_register_req_t const *const req = arch_get_irn_register_req(def->def);
+		foreach_irn_in(insn, p, in) {
+			if (!rbitset_is_set(&req->should_be_same, p))
+				continue;
+			operand_t *const use = find_use(ops, ARR_LEN(ops), in);
+			if (use != NULL && can_pair(def, use, insn)) {
+				pair(def, use);
+				break;
+			}
+		}
+	}
+	/* then pair the most constrained definitions with the most constrained
+	 * uses */
+	bool *const tried = ALLOCANZ(bool, n_defs);
+	for (;;) {
+		operand_t *def      = NULL;
+		size_t     def_regs = n_regs + 1;
+		for (size_t i = 0; i < n_defs; ++i) {
+			size_t const n = rbitset_popcount(ops[i].regs, n_regs);
+			if (!tried[i] && ops[i].use == NULL && n < def_regs) {
+				def      = &ops[i];
+				def_regs = n;
+			}
+		}
+		if (def == NULL)
+			break;
+		tried[def - ops] = true;
+
+		operand_t *use      = NULL;
+		size_t     use_regs = n_regs + 1;
+		for (size_t i = n_defs, n_ops = ARR_LEN(ops); i < n_ops; ++i) {
+			size_t const n = rbitset_popcount(ops[i].regs, n_regs);
+			if (n < use_regs && can_pair(def, &ops[i], insn)) {
+				use      = &ops[i];
+				use_regs = n;
+			}
+		}
+		if (use != NULL)
+			pair(def, use);
+	}
+
+	/* find a register for each operand */
+	size_t const n_ops  = ARR_LEN(ops);
+	size_t       n_rows = 0;
+	for (size_t i = 0; i < n_ops; ++i) {
+		if (!ops[i].paired)
+			++n_rows;
+	}
+	hungarian_problem_t *const bp
+		= hungarian_new(n_rows, n_regs, HUNGARIAN_MATCH_PERFECT);
+	/* every allowed register weighs more than all preferences together, so
+	 * the matching assigns all operands first */
+	unsigned const weight = n_rows + 1;
+	unsigned       row    = 0;
+	for (size_t i = 0; i < n_ops; ++i) {
+		operand_t const *const op = &ops[i];
+		if (op->paired)
+			continue;
+		rbitset_foreach(op->regs, n_regs, r) {
+			hungarian_add(bp, row, r, weight + ((int)r == op->pref));
+		}
+		++row;
+	}
+	hungarian_prepare_cost_matrix(bp, HUNGARIAN_MODE_MAXIMIZE_UTIL);
+	unsigned *const assignment = ALLOCAN(unsigned, MAX(n_rows, n_regs));
+	int       const res        = hungarian_solve(bp, assignment, NULL, 0);
+	if (res != 0)
+		panic("no valid register assignment for %+F", insn);
+	hungarian_free(bp);
+
+	row = 0;
+	for (size_t i = 0; i < n_ops; ++i) {
+		operand_t const *const op = &ops[i];
+		if (op->paired)
+			continue;
+		unsigned const r = assignment[row++];
+		if (!rbitset_is_set(op->regs, r))
+			panic("no valid register assignment for %+F", insn);
+		if (op->def != NULL)
+			arch_set_irn_register_idx(op->def, r);
+		if (op->use != NULL && get_reg_idx(op->use) < 0)
+			arch_set_irn_register_idx(op->use, r);
+		DB((dbg, LEVEL_2, "Constraint %+F/%+F -> %s\n", op->def, op->use,
+		    arch_register_for_index(cls, r)->name));
+	}
+	DEL_ARR_F(ops);
+}
+
+/** Returns the constrained instruction the definition of @p value belongs to. */
+static ir_node *get_constrained_insn(ir_node *const value)
+{
+	ir_node *const insn = skip_Proj(value);
+	if (bitset_is_set(unhandled_constraints, get_irn_idx(insn)))
+		return insn;
+	if (be_is_Perm(insn)) {
+		ir_node *const next = sched_next(insn);
+		if (!is_Block(next)
+		    && bitset_is_set(unhandled_constraints, get_irn_idx(next))
+		    && pmap_get(ir_node, perms, next) == insn)
+			return next;
+	}
+	return NULL;
+}
+
+static int cmp_interval(void const *const a, void const *const b)
+{
+	interval_t const *const i0 = *(interval_t const**)a;
+	interval_t const *const i1 = *(interval_t const**)b;
+	unsigned const f0 = i0->ranges->from;
+	unsigned const f1 = i1->ranges->from;
+	if (f0 != f1)
+		return f0 < f1 ? -1 : 1;
+	unsigned const n0 = get_irn_idx(i0->value);
+	unsigned const n1 = get_irn_idx(i1->value);
+	return (n0 > n1) - (n0 < n1);
+}
+
+static void linear_scan(interval_t **const sorted)
+{
+	interval_t **active   = NEW_ARR_F(interval_t*, 0);
+	unsigned    *occupied = rbitset_alloca(n_regs);
+
+	for (size_t i = 0, n = ARR_LEN(sorted); i < n; ++i) {
+		interval_t *const iv  = sorted[i];
+		unsigned    const pos = iv->ranges->from;
+
+		/* drop finished intervals, collect registers of live ones */
+		rbitset_clear_all(occupied, n_regs);
+		size_t n_active = 0;
+		for (size_t a = 0, n_a = ARR_LEN(active); a < n_a; ++a) {
+			interval_t *const other = active[a];
+			range_t          *range = other->current;
+			while (range != NULL && range->to < pos)
+				range = range->next;
+			other->current = range;
+			if (range == NULL)
+				continue;
+			active[n_active++] = other;
+			if (range->from > pos)
+				continue;
+			arch_register_req_t const *const req
+				= arch_get_irn_register_req(other->value);
+			unsigned const r = arch_get_irn_register(other->value)->index;
+			rbitset_set_range(occupied, r, r + req->width, true);
+		}
+		ARR_SHRINKLEN(active, n_active);
+
+		ir_node *const value = iv->value;
+		ir_node *const insn  = get_constrained_insn(value);
+		if (insn != NULL)
+			handle_constraints(insn);
+		if (get_reg_idx(value) < 0) {
+			assign_register(value, occupied);
+		} else {
+			assert(!rbitset_is_set(occupied, get_reg_idx(value)));
+		}
+
+		iv->current = iv->ranges;
+		ARR_APP1(interval_t*, active, iv);
+	}
+	DEL_ARR_F(active);
+}
+
+static void allocate_cls(ir_node **const blocks, size_t const n_blocks)
+{
+	be_assure_live_sets(irg);
+	lv = be_get_irg_liveness(irg);
+
+	be_timer_push(T_CONSTR);
+	constrained = NEW_ARR_F(ir_node*, 0);
+	perms       = pmap_create();
+	for (size_t b = 0; b < n_blocks; ++b)
+		insert_constraint_perms(blocks[b]);
+	be_timer_pop(T_CONSTR);
+
+	unsigned const n_idx = get_irg_last_idx(irg);
+	intervals             = XMALLOCNZ(interval_t*, n_idx);
+	positions             = XMALLOCNZ(unsigned, n_idx);
+	unhandled_constraints = bitset_malloc(n_idx);
+	for (size_t i = 0, n = ARR_LEN(constrained); i < n; ++i)
+		bitset_set(unhandled_constraints, get_irn_idx(constrained[i]));
+
+	build_intervals(blocks, n_blocks);
+
+	interval_t **sorted = NEW_ARR_F(interval_t*, 0);
+	for (unsigned i = 0; i < n_idx; ++i) {
+		if (intervals[i] != NULL)
+			ARR_APP1(interval_t*, sorted, intervals[i]);
+	}
+	QSORT_ARR(sorted, cmp_interval);
+	linear_scan(sorted);
+	DEL_ARR_F(sorted);
+
+	free(unhandled_constraints);
+	free(positions);
+	free(intervals);
+	DEL_ARR_F(constrained);
+	obstack_free(&obst, NULL);
+	pmap_destroy(perms);
+	obstack_init(&obst);
+
+	be_timer_push(T_RA_SSA);
+	be_ssa_destruction(irg, cls);
+	be_timer_pop(T_RA_SSA);
+}
+
+static void spill(const regalloc_if_t *regif)
+{
+	be_timer_push(T_RA_SPILL);
+	be_do_spill(irg, cls, regif);
+	be_timer_pop(T_RA_SPILL);
+
+	be_timer_push(T_RA_SPILL_APPLY);
+	check_for_memory_operands(irg, regif);
+	be_timer_pop(T_RA_SPILL_APPLY);
+}
+
+/**
+ * The linear scan register allocator for a whole procedure.
+ */
+static void be_linear_scan_alloc(ir_graph *new_irg, const regalloc_if_t *regif)
+{
+	/* disable optimization callbacks as we cannot deal with same-input phis
+	 * getting optimized away. */
+	int last_opt_state = get_optimize();
+	set_optimize(0);
+
+	irg = new_irg;
+	obstack_init(&obst);
+
+	be_spill_prepare_for_constraints(irg);
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+
+	/* number blocks in reverse postorder, so definitions come before their
+	 * uses (except for Phi arguments on back edges) */
+	ir_node **const blocks   = be_get_cfgpostorder(irg);
+	size_t    const n_blocks = ARR_LEN(blocks);
+	for (size_t i = 0, j = n_blocks; i < --j; ++i) {
+		ir_node *const tmp = blocks[i];
+		blocks[i] = blocks[j];
+		blocks[j] = tmp;
+	}
+
+	arch_register_class_t const *const reg_classes
+		= ir_target.isa->register_classes;
+	for (int c = 0, n_cls = ir_target.isa->n_register_classes; c < n_cls; ++c) {
+		cls = &reg_classes[c];
+		if (cls->manual_ra)
+			continue;
+
+		stat_ev_ctx_push_str("regcls", cls->name);
+
+		n_regs           = cls->n_regs;
+		allocatable_regs = rbitset_malloc(n_regs);
+		be_get_allocatable_regs(irg, cls, allocatable_regs);
+
+		spill(regif);
+
+		/* verify schedule and register pressure */
+		if (be_options.do_verify) {
+			be_timer_push(T_VERIFY);
+			bool check_schedule = be_verify_schedule(irg);
+			be_check_verify_result(check_schedule, irg);
+			bool check_pressure = be_verify_register_pressure(irg, cls);
+			be_check_verify_result(check_pressure, irg);
+			be_timer_pop(T_VERIFY);
+		}
+
+		be_timer_push(T_RA_COLOR);
+		allocate_cls(blocks, n_blocks);
+		be_timer_pop(T_RA_COLOR);
+
+		free(allocatable_regs);
+
+		stat_ev_ctx_pop("regcls");
+	}
+	DEL_ARR_F(blocks);
+
+	be_timer_push(T_RA_EPILOG);
+	lower_nodes_after_ra(irg, true);
+	be_invalidate_live_sets(irg);
+	be_timer_pop(T_RA_EPILOG);
+
+	obstack_free(&obst, NULL);
+	set_optimize(last_opt_state);
+}
+
+BE_REGISTER_MODULE_CONSTRUCTOR(be_init_linear_scan)
+void be_init_linear_scan(void)
+{
+	be_register_allocator("linear", be_linear_scan_alloc);
+	FIRM_DBG_REGISTER(dbg, "firm.be.linearscan");
+}
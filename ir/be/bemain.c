@@ -14,6 +14,7 @@
 #include "bechordal_t.h"
 #include "bediagnostic.h"
 #include "beemitter.h"
+#include "befuncorder.h"
 #include "begnuas.h"
 #include "beifg.h"
 #include "beirg.h"
@@ -64,6 +65,8 @@ be_options_t be_options = {
 	.do_verify            = true,
 	.ilp_solver           = "",
 	.verbose_asm          = true,
+	.tail_calls           = true,
+	.shrink_wrap          = true,
 };
 
 /* possible dumping options */
@@ -91,6 +94,8 @@ static const lc_opt_table_entry_t be_main_options[] = {
 	LC_OPT_ENT_BOOL     ("profilegenerate", "instrument the code for execution count profiling", &be_options.opt_profile_generate),
 	LC_OPT_ENT_BOOL     ("profileuse",      "use existing profile data",                         &be_options.opt_profile_use),
 	LC_OPT_ENT_BOOL     ("verboseasm", "enable verbose assembler output",                        &be_options.verbose_asm),
+	LC_OPT_ENT_BOOL     ("tailcalls",  "implement calls in tail position as jumps",              &be_options.tail_calls),
+	LC_OPT_ENT_BOOL     ("shrinkwrap", "place the prologue after early exits",                   &be_options.shrink_wrap),
 
 	LC_OPT_ENT_STR("ilp.solver", "the ilp solver name", &be_options.ilp_solver),
 	LC_OPT_LAST
@@ -294,7 +299,6 @@ static ir_graph *be_prepare_profile(const char *const cup_name)
 			be_warningf(NULL, "could not read profile data '%s'", prof_filename);
 		} else {
 			ir_create_execfreqs_from_profile();
-			ir_profile_free();
 			have_profile = true;
 		}
 	}
@@ -310,6 +314,11 @@ static ir_graph *be_prepare_profile(const char *const cup_name)
 		}
 		be_timer_pop(T_EXECFREQ);
 	}
+
+	/* function ordering needs the absolute execution counts */
+	be_order_functions(have_profile);
+	if (have_profile)
+		ir_profile_free();
 	return prof_init_irg;
 }
 
@@ -39,9 +39,12 @@ void be_init_copynone(void);
 void be_init_copyopt(void);
 void be_init_daemelspill(void);
 void be_init_dwarf(void);
+void be_init_funcorder(void);
+void be_init_linear_scan(void);
 void be_init_listsched(void);
 void be_init_live(void);
 void be_init_loopana(void);
+void be_init_loopspill(void);
 void be_init_pbqp(void);
 void be_init_pbqp_coloring(void);
 void be_init_peephole(void);
@@ -77,6 +80,7 @@ void be_init_modules(void)
 	be_init_chordal_common();
 	be_init_copyopt();
 	be_init_dwarf();
+	be_init_funcorder();
 	be_init_live();
 	be_init_loopana();
 	be_init_peephole();
@@ -103,12 +107,14 @@ void be_init_modules(void)
 
 	be_init_chordal_main();
 	be_init_pref_alloc();
+	be_init_linear_scan();
 
 	be_init_chordal();
 	be_init_pbqp_coloring();
 
 	be_init_spillbelady();
 	be_init_daemelspill();
+	be_init_loopspill();
 
 	be_init_copyheur4();
 	be_init_copyilp2();
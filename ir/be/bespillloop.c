@@ -0,0 +1,834 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Loop aware spilling algorithm
+ * @brief
+ *   This spiller decides like the daemel spiller which values to spill by
+ *   walking the schedule backwards and spilling the cheapest values where the
+ *   register pressure is too high, but it uses a global cost model and places
+ *   spills and reloads with respect to the loop structure:
+ *
+ *   - Blocks are processed by decreasing execution frequency, so the values
+ *     spilled in hot loops are chosen first.
+ *   - The costs of a value are the execution frequency weighted costs of its
+ *     spill and its reloads (or rematerializations). The reload of a value
+ *     used in a loop which contains neither its definition nor the point of
+ *     high register pressure is estimated at the loop entry.
+ *   - After all spill decisions are made, the register pressure of every
+ *     block is known. A value which is loop invariant in a loop with free
+ *     registers is reloaded once on the loop entry edges instead of before
+ *     every use in the loop. A value defined in a loop with free registers
+ *     stays in its register throughout the loop and is spilled on the loop
+ *     exits. Uses in the same block share a reload while there is room to
+ *     keep the reloaded value.
+ */
+#include "array.h"
+#include "be_t.h"
+#include "bearch.h"
+#include "beirg.h"
+#include "belive.h"
+#include "bemodule.h"
+#include "benode.h"
+#include "besched.h"
+#include "bespill.h"
+#include "bespillutil.h"
+#include "debug.h"
+#include "execfreq.h"
+#include "iredges_t.h"
+#include "irgwalk.h"
+#include "irloop.h"
+#include "irnodeset.h"
+#include "panic.h"
+#include "pmap.h"
+#include "statev_t.h"
+#include "util.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+/** Information about a loop of the control flow graph. */
+typedef struct loop_info_t {
+	ir_node **blocks;     /**< blocks of the loop, including inner loops */
+	double    entry_freq; /**< execution frequency of the loop entries */
+	double    exit_freq;  /**< execution frequency of the loop exits */
+} loop_info_t;
+
+typedef struct spill_candidate_t {
+	double   costs;
+	ir_node *node;
+} spill_candidate_t;
+
+static spill_env_t                 *spill_env;
+static unsigned                     n_regs;
+static const arch_register_class_t *cls;
+static const be_lv_t               *lv;
+static ir_graph                    *irg;
+static bitset_t                    *spilled_nodes;
+static bitset_t                    *spilled_phis;
+static ir_node                    **spilled_values;
+/* Register pressure remaining after the spill decisions and registers
+ * reserved for values kept in registers or reloaded early. Nodes and
+ * blocks share the arrays indexed by node index. The block pressure is the
+ * maximum over the block including the reservations at its nodes, the block
+ * reservations apply to all nodes of the block. */
+static unsigned                    *pressure;
+static unsigned                    *reserved;
+static pmap                        *loop_infos;
+static struct obstack               obst;
+static unsigned                     n_hoisted_reloads;
+static unsigned                     n_sunk_spills;
+static unsigned                     n_shared_reloads;
+
+static int compare_spill_candidates(const void *d1, const void *d2)
+{
+	const spill_candidate_t *c1 = (const spill_candidate_t*)d1;
+	const spill_candidate_t *c2 = (const spill_candidate_t*)d2;
+	return (c1->costs > c2->costs) - (c1->costs < c2->costs);
+}
+
+static unsigned get_value_width(const ir_node *node)
+{
+	const arch_register_req_t *req = arch_get_irn_register_req(node);
+	return req->width;
+}
+
+static ir_loop *get_block_loop(const ir_node *block)
+{
+	ir_loop *const loop = get_irn_loop(block);
+	return loop != NULL && get_loop_depth(loop) > 0 ? loop : NULL;
+}
+
+static bool loop_contains_block(const ir_loop *loop, const ir_node *block)
+{
+	for (ir_loop *l = get_block_loop(block); l != NULL;
+	     l = get_loop_outer_loop(l)) {
+		if (l == loop)
+			return true;
+		if (get_loop_depth(l) <= get_loop_depth(loop))
+			return false;
+	}
+	return false;
+}
+
+static loop_info_t *get_loop_info(ir_loop *loop)
+{
+	loop_info_t *info = pmap_get(loop_info_t, loop_infos, loop);
+	if (info == NULL) {
+		info = OALLOCZ(&obst, loop_info_t);
+		info->blocks = NEW_ARR_F(ir_node*, 0);
+		pmap_insert(loop_infos, loop, info);
+	}
+	return info;
+}
+
+static void collect_loop_blocks(ir_node *block, void *data)
+{
+	(void)data;
+	for (ir_loop *l = get_block_loop(block); l != NULL;
+	     l = get_loop_outer_loop(l)) {
+		if (get_loop_depth(l) == 0)
+			break;
+		loop_info_t *const info = get_loop_info(l);
+		ARR_APP1(ir_node*, info->blocks, block);
+	}
+}
+
+/**
+ * Computes the blocks and the entry and exit frequencies of all loops.
+ */
+static void compute_loop_infos(void)
+{
+	irg_block_walk_graph(irg, collect_loop_blocks, NULL, NULL);
+
+	foreach_pmap(loop_infos, entry) {
+		ir_loop     *const loop = (ir_loop*)entry->key;
+		loop_info_t *const info = (loop_info_t*)entry->value;
+		for (size_t b = 0, n = ARR_LEN(info->blocks); b < n; ++b) {
+			ir_node *const block = info->blocks[b];
+			for (int i = 0, arity = get_Block_n_cfgpreds(block); i < arity;
+			     ++i) {
+				ir_node *const pred = get_Block_cfgpred_block(block, i);
+				if (pred != NULL && !loop_contains_block(loop, pred))
+					info->entry_freq += get_block_execfreq(pred);
+			}
+			foreach_block_succ(block, edge) {
+				ir_node *const succ = get_edge_src_irn(edge);
+				if (!loop_contains_block(loop, succ))
+					info->exit_freq += get_block_execfreq(succ);
+			}
+		}
+	}
+}
+
+static void free_loop_infos(void)
+{
+	foreach_pmap(loop_infos, entry) {
+		loop_info_t *const info = (loop_info_t*)entry->value;
+		DEL_ARR_F(info->blocks);
+	}
+	pmap_destroy(loop_infos);
+}
+
+/**
+ * Returns the outermost loop containing @p block but neither @p def_block nor
+ * @p avoid_block (may be NULL), which is where a reload for a use in @p block
+ * could be hoisted to.
+ */
+static ir_loop *get_hoist_loop(const ir_node *block, const ir_node *def_block,
+                               const ir_node *avoid_block)
+{
+	ir_loop *res = NULL;
+	for (ir_loop *l = get_block_loop(block); l != NULL;
+	     l = get_loop_outer_loop(l)) {
+		if (get_loop_depth(l) == 0 || loop_contains_block(l, def_block))
+			break;
+		if (avoid_block != NULL && loop_contains_block(l, avoid_block))
+			break;
+		res = l;
+	}
+	return res;
+}
+
+/**
+ * Returns the block a value is used in. For Phi uses this is the block at the
+ * end of which the value has to be available.
+ */
+static ir_node *get_use_block(const ir_edge_t *edge)
+{
+	ir_node *const use = get_edge_src_irn(edge);
+	if (is_Phi(use))
+		return get_Block_cfgpred_block(get_nodes_block(use),
+		                               get_edge_src_pos(edge));
+	return get_nodes_block(use);
+}
+
+static bool is_reloaded_use(const ir_edge_t *edge)
+{
+	ir_node *const use = get_edge_src_irn(edge);
+	if (is_Anchor(use) || be_is_Keep(use))
+		return false;
+	/* Ignore CopyKeeps, except for the operand to copy. */
+	if (be_is_CopyKeep(use) && get_edge_src_pos(edge) != n_be_CopyKeep_op)
+		return false;
+	return true;
+}
+
+/**
+ * Estimates the costs of spilling @p node at a point in @p block: The costs of
+ * the spill and of all reloads. Reloads in loops which contain neither the
+ * definition nor @p block may get hoisted to the loop entries later, so they
+ * are estimated with the loop entry frequency.
+ */
+static double get_spill_costs(ir_node *node, const ir_node *block)
+{
+	ir_node *const insn      = skip_Proj(node);
+	ir_node *const def_block = get_nodes_block(insn);
+	double         costs     = be_get_spill_costs(spill_env, node, insn);
+
+	foreach_out_edge(node, edge) {
+		if (!is_reloaded_use(edge))
+			continue;
+
+		ir_node *const use = get_edge_src_irn(edge);
+		double         use_costs;
+		if (is_Phi(use)) {
+			int      in        = get_edge_src_pos(edge);
+			ir_node *use_block = get_nodes_block(use);
+			use_costs = be_get_reload_costs_on_edge(spill_env, node, use_block,
+			                                        in);
+		} else {
+			use_costs = be_get_reload_costs(spill_env, node, use);
+		}
+
+		ir_node *const use_block = get_use_block(edge);
+		ir_loop *const loop      = get_hoist_loop(use_block, def_block, block);
+		if (loop != NULL) {
+			double const use_freq   = get_block_execfreq(use_block);
+			double const entry_freq = get_loop_info(loop)->entry_freq;
+			if (use_freq > 0 && entry_freq < use_freq)
+				use_costs *= entry_freq / use_freq;
+		}
+		costs += use_costs;
+	}
+
+	return costs;
+}
+
+/**
+ * Estimates how much spilling @p value at @p node helps: Spilling frees the
+ * register between the previous use (or the definition) of the value and
+ * @p node, so values that have not been used for a long time are preferred.
+ */
+static double get_spill_benefit(const ir_node *value, const ir_node *node)
+{
+	ir_node const   *const block = get_nodes_block(node);
+	sched_timestep_t const time  = sched_get_time_step(node);
+	sched_timestep_t       prev  = 0;
+	ir_node const   *const insn  = skip_Proj_const(value);
+	if (get_nodes_block(insn) == block && !is_Phi(insn))
+		prev = sched_get_time_step(insn);
+	foreach_out_edge(value, edge) {
+		ir_node *const use = get_edge_src_irn(edge);
+		if (is_Phi(use) || get_nodes_block(use) != block
+		 || !sched_is_scheduled(use))
+			continue;
+		sched_timestep_t const use_time = sched_get_time_step(use);
+		if (use_time < time && use_time > prev)
+			prev = use_time;
+	}
+	return 1.0 + (double)(time - prev);
+}
+
+static void spill_node(ir_node *node)
+{
+	DBG((dbg, LEVEL_3, "\tspilling %+F\n", node));
+	bitset_set(spilled_nodes, get_irn_idx(node));
+	ARR_APP1(ir_node*, spilled_values, node);
+}
+
+/**
+ * Spills values from @p live_nodes until @p node can be executed.
+ * @returns the register pressure at @p node after spilling
+ */
+static unsigned do_spilling(ir_nodeset_t *live_nodes, ir_node *node,
+                            const ir_node *block)
+{
+	size_t values_defined = 0;
+	be_foreach_definition(node, cls, value, req,
+		(void)value;
+		assert(req->width >= 1);
+		values_defined += req->width;
+	);
+
+	/* we need registers for the non-live argument values */
+	size_t free_regs_needed = 0;
+	be_foreach_use(node, cls, in_req_, use, pred_req_,
+		if (!ir_nodeset_contains(live_nodes, use)) {
+			free_regs_needed += get_value_width(use);
+		}
+	);
+
+	/* we may need additional free registers */
+	be_add_pressure_t const add_pressure = arch_get_additional_pressure(node, cls);
+	free_regs_needed += MAX( add_pressure, 0);
+	values_defined   += MAX(-add_pressure, 0);
+
+	/* we can reuse all reloaded values for the defined values, but we might
+	 * need even more registers */
+	free_regs_needed = MAX(free_regs_needed, values_defined);
+
+	size_t n_live_nodes  = ir_nodeset_size(live_nodes);
+	int    spills_needed = (n_live_nodes + free_regs_needed) - n_regs;
+	if (spills_needed <= 0)
+		return n_live_nodes + free_regs_needed;
+	DBG((dbg, LEVEL_2, "\tspills needed after %+F: %d\n", node, spills_needed));
+
+	spill_candidate_t *candidates = ALLOCAN(spill_candidate_t, n_live_nodes);
+
+	/* construct array with spill candidates and calculate their costs */
+	size_t c = 0;
+	foreach_ir_nodeset(live_nodes, n, iter) {
+		assert(!bitset_is_set(spilled_nodes, get_irn_idx(n)));
+
+		spill_candidate_t *candidate = &candidates[c++];
+		candidate->node  = n;
+		candidate->costs = get_spill_costs(n, block)
+		                 / get_spill_benefit(n, node);
+	}
+	assert(c == n_live_nodes);
+
+	QSORT(candidates, n_live_nodes, compare_spill_candidates);
+
+	/* spill cheapest ones */
+	size_t cand_idx = 0;
+	while (spills_needed > 0) {
+		if (cand_idx >= n_live_nodes)
+			panic("can't spill enough values for node %+F", node);
+
+		spill_candidate_t *candidate = &candidates[cand_idx];
+		ir_node           *cand_node = candidate->node;
+		++cand_idx;
+
+		if (arch_irn_is(skip_Proj_const(cand_node), dont_spill))
+			continue;
+
+		/* make sure the node is not an argument of the instruction */
+		bool is_use = false;
+		foreach_irn_in(node, i, in) {
+			if (in == cand_node) {
+				is_use = true;
+				break;
+			}
+		}
+		if (is_use)
+			continue;
+
+		spill_node(cand_node);
+		ir_nodeset_remove(live_nodes, cand_node);
+		spills_needed -= get_value_width(cand_node);
+	}
+
+	return ir_nodeset_size(live_nodes) + free_regs_needed;
+}
+
+static void remove_defs(ir_node *node, ir_nodeset_t *nodeset)
+{
+	assert(!is_Phi(node));
+	be_foreach_definition(node, cls, value, req,
+		ir_nodeset_remove(nodeset, value);
+	);
+}
+
+static void add_uses(ir_node *node, ir_nodeset_t *nodeset)
+{
+	foreach_irn_in(node, i, op) {
+		if (arch_irn_consider_in_reg_alloc(cls, op)
+		    && !bitset_is_set(spilled_nodes, get_irn_idx(op)))
+			ir_nodeset_insert(nodeset, op);
+	}
+}
+
+/**
+ * Makes sure register pressure in a block is always equal or below the
+ * number of available registers and records the maximum pressure remaining.
+ */
+static void spill_block(ir_node *block)
+{
+	DBG((dbg, LEVEL_1, "spilling block %+F (freq %f)\n", block,
+	     get_block_execfreq(block)));
+
+	ir_nodeset_t live_nodes;
+	ir_nodeset_init(&live_nodes);
+	be_liveness_end_of_block(lv, cls, block, &live_nodes);
+
+	foreach_ir_nodeset(&live_nodes, node, iter) {
+		if (bitset_is_set(spilled_nodes, get_irn_idx(node)))
+			ir_nodeset_remove_iterator(&live_nodes, &iter);
+	}
+
+	unsigned max_pressure = ir_nodeset_size(&live_nodes);
+	sched_foreach_non_phi_reverse(block, node) {
+		remove_defs(node, &live_nodes);
+		unsigned const node_pressure = do_spilling(&live_nodes, node, block);
+		pressure[get_irn_idx(node)] = node_pressure;
+		max_pressure = MAX(max_pressure, node_pressure);
+		add_uses(node, &live_nodes);
+	}
+
+	/* the phis still occupy registers even if their values are spilled */
+	int n_phi_values_spilled = 0;
+	sched_foreach_phi(block, node) {
+		if (bitset_is_set(spilled_nodes, get_irn_idx(node)))
+			n_phi_values_spilled += get_value_width(node);
+	}
+
+	int live_nodes_pressure = 0;
+	foreach_ir_nodeset(&live_nodes, node, iter) {
+		live_nodes_pressure += get_value_width(node);
+	}
+
+	int regpressure       = live_nodes_pressure + n_phi_values_spilled;
+	int phi_spills_needed = regpressure - n_regs;
+	sched_foreach_phi(block, node) {
+		if (phi_spills_needed <= 0)
+			break;
+		if (!bitset_is_set(spilled_nodes, get_irn_idx(node)))
+			continue;
+
+		be_spill_phi(spill_env, node);
+		bitset_set(spilled_phis, get_irn_idx(node));
+		phi_spills_needed -= get_value_width(node);
+	}
+	assert(phi_spills_needed <= 0);
+
+	max_pressure = MAX(max_pressure, (unsigned)MIN(regpressure, (int)n_regs));
+	pressure[get_irn_idx(block)] = max_pressure;
+
+	ir_nodeset_destroy(&live_nodes);
+}
+
+static int compare_block_freqs(const void *d1, const void *d2)
+{
+	ir_node *const b1 = *(ir_node *const*)d1;
+	ir_node *const b2 = *(ir_node *const*)d2;
+	double   const f1 = get_block_execfreq(b1);
+	double   const f2 = get_block_execfreq(b2);
+	if (f1 != f2)
+		return f1 < f2 ? 1 : -1;
+	/* keep the order deterministic */
+	return (get_irn_idx(b1) > get_irn_idx(b2))
+	     - (get_irn_idx(b1) < get_irn_idx(b2));
+}
+
+static void collect_block(ir_node *block, void *data)
+{
+	ir_node ***const blocks = (ir_node***)data;
+	ARR_APP1(ir_node*, *blocks, block);
+}
+
+/**
+ * Tests whether a value of width @p width can be kept in a register in all
+ * @p blocks and in @p extra_block (may be NULL).
+ */
+static bool fits_in_blocks(ir_node *const *blocks, ir_node *extra_block,
+                           unsigned width)
+{
+	for (size_t i = 0, n = ARR_LEN(blocks); i < n; ++i) {
+		unsigned const idx = get_irn_idx(blocks[i]);
+		if (pressure[idx] + reserved[idx] + width > n_regs)
+			return false;
+	}
+	if (extra_block != NULL) {
+		unsigned const idx = get_irn_idx(extra_block);
+		if (pressure[idx] + reserved[idx] + width > n_regs)
+			return false;
+	}
+	return true;
+}
+
+static void reserve_in_blocks(ir_node *const *blocks, unsigned width)
+{
+	for (size_t i = 0, n = ARR_LEN(blocks); i < n; ++i)
+		reserved[get_irn_idx(blocks[i])] += width;
+}
+
+/**
+ * Tries to keep @p value in a register in a loop containing its definition
+ * and to spill it on the loop exits instead.
+ * @returns the loop in which the value stays in its register or NULL
+ */
+static ir_loop *sink_spill(ir_node *value)
+{
+	ir_node *const insn      = skip_Proj(value);
+	ir_node *const def_block = get_nodes_block(insn);
+	ir_loop *const def_loop  = get_block_loop(def_block);
+	/* spills of Phi arguments must dominate the Phi */
+	if (def_loop == NULL || is_Phi(value))
+		return NULL;
+	foreach_out_edge(value, edge) {
+		ir_node *const use = get_edge_src_irn(edge);
+		if (is_Phi(use) && bitset_is_set(spilled_phis, get_irn_idx(use)))
+			return NULL;
+	}
+
+	unsigned const width = get_value_width(value);
+	ir_loop       *res   = NULL;
+	for (ir_loop *l = def_loop; l != NULL && get_loop_depth(l) > 0;
+	     l = get_loop_outer_loop(l)) {
+		loop_info_t *const info = get_loop_info(l);
+		if (info->exit_freq >= get_block_execfreq(def_block))
+			break;
+
+		/* we need a place for the spill on every exit the value is live on */
+		bool fits = fits_in_blocks(info->blocks, NULL, width);
+		for (size_t b = 0, n = ARR_LEN(info->blocks); fits && b < n; ++b) {
+			foreach_block_succ(info->blocks[b], edge) {
+				ir_node *const succ = get_edge_src_irn(edge);
+				if (loop_contains_block(l, succ)
+				 || !be_is_live_in(lv, succ, value))
+					continue;
+				if (get_Block_n_cfgpreds(succ) != 1
+				 || !fits_in_blocks(info->blocks, succ, width)) {
+					fits = false;
+					break;
+				}
+			}
+		}
+		if (!fits)
+			break;
+		res = l;
+	}
+	if (res == NULL)
+		return NULL;
+
+	loop_info_t *const info = get_loop_info(res);
+	for (size_t b = 0, n = ARR_LEN(info->blocks); b < n; ++b) {
+		foreach_block_succ(info->blocks[b], edge) {
+			ir_node *const succ = get_edge_src_irn(edge);
+			if (loop_contains_block(res, succ)
+			 || !be_is_live_in(lv, succ, value))
+				continue;
+			DB((dbg, LEVEL_2, "\tspill %+F on loop exit %+F\n", value, succ));
+			be_add_spill(spill_env, value, succ);
+			reserved[get_irn_idx(succ)] += width;
+			++n_sunk_spills;
+		}
+	}
+	reserve_in_blocks(info->blocks, width);
+	return res;
+}
+
+/**
+ * Tries to reload @p value once on the entries of @p loop instead of before
+ * every use inside the loop.
+ * @returns true if the reloads have been placed
+ */
+static bool hoist_reloads(ir_node *value, ir_loop *loop, double use_freq)
+{
+	loop_info_t *const info  = get_loop_info(loop);
+	unsigned     const width = get_value_width(value);
+	if (info->entry_freq >= use_freq)
+		return false;
+	if (!fits_in_blocks(info->blocks, NULL, width))
+		return false;
+
+	for (size_t b = 0, n = ARR_LEN(info->blocks); b < n; ++b) {
+		ir_node *const block = info->blocks[b];
+		for (int i = 0, arity = get_Block_n_cfgpreds(block); i < arity; ++i) {
+			ir_node *const pred = get_Block_cfgpred_block(block, i);
+			if (pred == NULL || loop_contains_block(loop, pred))
+				continue;
+			if (get_Block_n_cfgpreds(block) == 1
+			 || !fits_in_blocks(info->blocks, pred, width))
+				return false;
+		}
+	}
+
+	for (size_t b = 0, n = ARR_LEN(info->blocks); b < n; ++b) {
+		ir_node *const block = info->blocks[b];
+		for (int i = 0, arity = get_Block_n_cfgpreds(block); i < arity; ++i) {
+			ir_node *const pred = get_Block_cfgpred_block(block, i);
+			if (pred == NULL || loop_contains_block(loop, pred))
+				continue;
+			DB((dbg, LEVEL_2, "\treload %+F on entry %+F,%d\n", value, block,
+			    i));
+			be_add_reload_on_edge(spill_env, value, block, i);
+			reserved[get_irn_idx(pred)] += width;
+		}
+	}
+	reserve_in_blocks(info->blocks, width);
+	return true;
+}
+
+static int compare_sched_order(const void *d1, const void *d2)
+{
+	ir_node *const n1 = *(ir_node *const*)d1;
+	ir_node *const n2 = *(ir_node *const*)d2;
+	sched_timestep_t const t1 = sched_get_time_step(n1);
+	sched_timestep_t const t2 = sched_get_time_step(n2);
+	return (t1 > t2) - (t1 < t2);
+}
+
+/**
+ * Tests whether @p value can stay in a register from its use @p from up to
+ * the node @p to of the same block and reserves the register if it can.
+ * The pressure at @p from assumed that the register of the value is free for
+ * the results of @p from, so @p from needs the register as well.
+ */
+static bool reserve_between(ir_node *value, ir_node *from, ir_node *to)
+{
+	unsigned const width     = get_value_width(value);
+	ir_node *const block     = get_nodes_block(from);
+	unsigned const block_idx = get_irn_idx(block);
+	for (ir_node *node = from; node != to; node = sched_next(node)) {
+		unsigned const idx = get_irn_idx(node);
+		if (pressure[idx] + reserved[idx] + reserved[block_idx] + width
+		    > n_regs)
+			return false;
+	}
+	for (ir_node *node = from; node != to; node = sched_next(node)) {
+		unsigned const idx = get_irn_idx(node);
+		reserved[idx] += width;
+		pressure[block_idx] = MAX(pressure[block_idx],
+		                          pressure[idx] + reserved[idx]);
+	}
+	return true;
+}
+
+/**
+ * Places the reloads of @p value for its @p uses in one block: A reload
+ * before a use is reused by the following uses as long as the block has room
+ * to keep the value.
+ */
+static void place_block_reloads(ir_node *value, ir_node **uses)
+{
+	QSORT_ARR(uses, compare_sched_order);
+	ir_node *prev = NULL;
+	for (size_t i = 0, n = ARR_LEN(uses); i < n; ++i) {
+		ir_node *const use = uses[i];
+		if (use == prev)
+			continue;
+		if (prev == NULL || !reserve_between(value, prev, use)) {
+			be_add_reload(spill_env, value, use);
+		} else {
+			++n_shared_reloads;
+		}
+		prev = use;
+	}
+}
+
+/**
+ * Places the spill and the reloads of a spilled value.
+ */
+static void place_spill_and_reloads(ir_node *value)
+{
+	DB((dbg, LEVEL_2, "placing reloads of %+F\n", value));
+	ir_node *const def_block = get_nodes_block(skip_Proj(value));
+	ir_loop *const reg_loop  = sink_spill(value);
+
+	/* sum up the frequencies of the uses per loop reloads could be hoisted to
+	 * and decide for each loop */
+	pmap *const use_freqs = pmap_create();
+	foreach_out_edge(value, edge) {
+		if (!is_reloaded_use(edge))
+			continue;
+		ir_node *const use_block = get_use_block(edge);
+		if (reg_loop != NULL && loop_contains_block(reg_loop, use_block))
+			continue;
+		ir_loop *const loop = get_hoist_loop(use_block, def_block, NULL);
+		if (loop == NULL)
+			continue;
+		double *freq = pmap_get(double, use_freqs, loop);
+		if (freq == NULL) {
+			freq = OALLOCZ(&obst, double);
+			pmap_insert(use_freqs, loop, freq);
+		}
+		*freq += get_block_execfreq(use_block);
+	}
+	pmap *const hoisted = pmap_create();
+	foreach_pmap(use_freqs, entry) {
+		ir_loop *const loop = (ir_loop*)entry->key;
+		if (hoist_reloads(value, loop, *(double*)entry->value))
+			pmap_insert(hoisted, loop, loop);
+	}
+
+	/* remaining uses need a reload in their block */
+	pmap *const block_uses = pmap_create();
+	foreach_out_edge(value, edge) {
+		if (!is_reloaded_use(edge))
+			continue;
+		ir_node *const use_block = get_use_block(edge);
+		if (reg_loop != NULL && loop_contains_block(reg_loop, use_block))
+			continue;
+		ir_loop *const loop = get_hoist_loop(use_block, def_block, NULL);
+		if (loop != NULL && pmap_contains(hoisted, loop)) {
+			++n_hoisted_reloads;
+			continue;
+		}
+
+		ir_node *const use = get_edge_src_irn(edge);
+		if (is_Phi(use)) {
+			be_add_reload_on_edge(spill_env, value, get_nodes_block(use),
+			                      get_edge_src_pos(edge));
+			continue;
+		}
+
+		ir_node **uses = pmap_get(ir_node*, block_uses, use_block);
+		if (uses == NULL)
+			uses = NEW_ARR_F(ir_node*, 0);
+		ARR_APP1(ir_node*, uses, use);
+		pmap_insert(block_uses, use_block, uses);
+	}
+
+	foreach_pmap(block_uses, entry) {
+		ir_node **const uses = (ir_node**)entry->value;
+		place_block_reloads(value, uses);
+		DEL_ARR_F(uses);
+	}
+
+	pmap_destroy(block_uses);
+	pmap_destroy(hoisted);
+	pmap_destroy(use_freqs);
+}
+
+typedef struct spilled_value_t {
+	ir_node *node;
+	double   use_freq; /**< sum of the execution frequencies of all uses */
+} spilled_value_t;
+
+static int compare_spilled_values(const void *d1, const void *d2)
+{
+	const spilled_value_t *v1 = (const spilled_value_t*)d1;
+	const spilled_value_t *v2 = (const spilled_value_t*)d2;
+	if (v1->use_freq != v2->use_freq)
+		return v1->use_freq < v2->use_freq ? 1 : -1;
+	return (get_irn_idx(v1->node) > get_irn_idx(v2->node))
+	     - (get_irn_idx(v1->node) < get_irn_idx(v2->node));
+}
+
+/**
+ * Places spills and reloads of all spilled values, values with hot uses first
+ * as they profit most from the free registers in loops.
+ */
+static void place_spills_and_reloads(void)
+{
+	size_t           const n      = ARR_LEN(spilled_values);
+	spilled_value_t *const values = XMALLOCN(spilled_value_t, n);
+	for (size_t i = 0; i < n; ++i) {
+		ir_node *const node = spilled_values[i];
+		double         freq = 0;
+		foreach_out_edge(node, edge) {
+			freq += get_block_execfreq(get_use_block(edge));
+		}
+		values[i].node     = node;
+		values[i].use_freq = freq;
+	}
+	QSORT(values, n, compare_spilled_values);
+	for (size_t i = 0; i < n; ++i)
+		place_spill_and_reloads(values[i].node);
+	free(values);
+}
+
+static void be_spill_loop(ir_graph *new_irg, const arch_register_class_t *new_cls,
+                          const regalloc_if_t *regif)
+{
+	be_assure_live_sets(new_irg);
+	assure_loopinfo(new_irg);
+
+	irg               = new_irg;
+	cls               = new_cls;
+	n_regs            = be_get_n_allocatable_regs(irg, cls);
+	lv                = be_get_irg_liveness(irg);
+	spill_env         = be_new_spill_env(irg, regif);
+	n_hoisted_reloads = 0;
+	n_sunk_spills     = 0;
+	n_shared_reloads  = 0;
+
+	unsigned const n_idx = get_irg_last_idx(irg);
+	spilled_nodes  = bitset_malloc(n_idx);
+	spilled_phis   = bitset_malloc(n_idx);
+	spilled_values = NEW_ARR_F(ir_node*, 0);
+	pressure       = XMALLOCNZ(unsigned, n_idx);
+	reserved       = XMALLOCNZ(unsigned, n_idx);
+	loop_infos     = pmap_create();
+	obstack_init(&obst);
+
+	DBG((dbg, LEVEL_1, "*** RegClass %s\n", cls->name));
+
+	compute_loop_infos();
+
+	/* decide which values to spill, hottest blocks first */
+	ir_node **blocks = NEW_ARR_F(ir_node*, 0);
+	irg_block_walk_graph(irg, collect_block, NULL, &blocks);
+	QSORT_ARR(blocks, compare_block_freqs);
+	for (size_t i = 0, n = ARR_LEN(blocks); i < n; ++i)
+		spill_block(blocks[i]);
+	DEL_ARR_F(blocks);
+
+	place_spills_and_reloads();
+
+	stat_ev_dbl("spill_loop_hoisted_reloads", n_hoisted_reloads);
+	stat_ev_dbl("spill_loop_sunk_spills", n_sunk_spills);
+	stat_ev_dbl("spill_loop_shared_reloads", n_shared_reloads);
+
+	free_loop_infos();
+	obstack_free(&obst, NULL);
+	free(reserved);
+	free(pressure);
+	DEL_ARR_F(spilled_values);
+	free(spilled_phis);
+	free(spilled_nodes);
+
+	be_insert_spills_reloads(spill_env);
+	be_delete_spill_env(spill_env);
+}
+
+BE_REGISTER_MODULE_CONSTRUCTOR(be_init_loopspill)
+void be_init_loopspill(void)
+{
+	be_register_spiller("loop", be_spill_loop);
+	FIRM_DBG_REGISTER(dbg, "firm.be.spill.loop");
+}
@@ -17,16 +17,21 @@
  */
 #include "bestack.h"
 
+#include "be_t.h"
+#include "bedwarf.h"
 #include "beirg.h"
 #include "benode.h"
 #include "besched.h"
 #include "bessaconstr.h"
+#include "execfreq.h"
 #include "ircons_t.h"
+#include "irdom.h"
 #include "iredges_t.h"
 #include "irgmod.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "util.h"
+#include "xmalloc.h"
 
 static unsigned round_up2_misaligned(unsigned const offset,
                                      unsigned const alignment,
@@ -245,3 +250,201 @@ void be_layout_frame_type(ir_type *const frame, int const begin,
 	set_type_size(frame, -(offset-begin));
 	set_type_state(frame, layout_fixed);
 }
+
+typedef struct shrink_wrap_env_t {
+	arch_register_t const *sp;
+	arch_register_t const *bp;
+	ir_node               *end_block;
+	ir_node              **blocks;
+	ir_node               *frame_block; /**< dominates all users of the frame */
+} shrink_wrap_env_t;
+
+static bool is_return(ir_node const *const node, ir_node const *const end_block)
+{
+	if (get_irn_mode(node) != mode_X)
+		return false;
+	foreach_out_edge(node, edge) {
+		if (get_edge_src_irn(edge) == end_block)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Checks whether @p node needs the stack frame, i.e. it uses the stack
+ * pointer or the frame pointer. The epilogue is constructed in front of the
+ * returns, so they do not count.
+ */
+static bool uses_frame(ir_node const *const node,
+                       shrink_wrap_env_t const *const env)
+{
+	if (is_Phi(node) || be_is_Keep(node) || is_return(node, env->end_block))
+		return false;
+	foreach_irn_in(node, i, in) {
+		arch_register_t const *const reg = arch_get_irn_register(in);
+		if (reg != NULL && (reg == env->sp || reg == env->bp))
+			return true;
+	}
+	return false;
+}
+
+static void find_frame_users(ir_node *const block, void *const data)
+{
+	shrink_wrap_env_t *const env = (shrink_wrap_env_t*)data;
+	ARR_APP1(ir_node*, env->blocks, block);
+	sched_foreach(block, node) {
+		if (uses_frame(node, env)) {
+			env->frame_block = env->frame_block == NULL ? block
+				: ir_deepest_common_dominator(env->frame_block, block);
+			return;
+		}
+	}
+}
+
+/**
+ * Returns the index of the first block in the dominator chain @p chain which
+ * dominates @p block, or @p n if there is none.
+ */
+static size_t first_dominating(ir_node *const *const chain, size_t const n,
+                               ir_node const *const block)
+{
+	size_t lo = 0;
+	size_t hi = n;
+	while (lo < hi) {
+		size_t const mid = lo + (hi - lo) / 2;
+		if (block_dominates(chain[mid], block))
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
+
+/**
+ * The prologue modifies the flags, so they must not be live at the beginning
+ * of its block.
+ */
+static bool has_flags_live_in(ir_node *const block,
+                              arch_register_class_t const *const flags_cls)
+{
+	sched_foreach(block, node) {
+		if (is_Phi(node)) {
+			if (arch_get_irn_register_req(node)->cls == flags_cls)
+				return true;
+			continue;
+		}
+		foreach_irn_in(node, i, in) {
+			if (get_nodes_block(in) != block
+			 && arch_get_irn_register_req(in)->cls == flags_cls)
+				return true;
+		}
+	}
+	return false;
+}
+
+ir_node *be_get_prologue_block(ir_graph *const irg,
+                               arch_register_t const *const sp,
+                               arch_register_t const *const bp,
+                               arch_register_class_t const *const flags_cls)
+{
+	ir_node *const start_block = get_irg_start_block(irg);
+	if (!be_options.shrink_wrap)
+		return start_block;
+	/* The call frame information of functions with a frame pointer describes
+	 * the frame set up by the prologue for the whole function. */
+	if (bp != NULL && be_dwarf_has_callframe_info())
+		return start_block;
+
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE
+	                         | IR_GRAPH_PROPERTY_CONSISTENT_POSTDOMINANCE);
+
+	shrink_wrap_env_t env = {
+		.sp          = sp,
+		.bp          = bp,
+		.end_block   = get_irg_end_block(irg),
+		.blocks      = NEW_ARR_F(ir_node*, 0),
+		.frame_block = NULL,
+	};
+	irg_block_walk_graph(irg, NULL, find_frame_users, &env);
+
+	ir_node *res = start_block;
+	if (env.frame_block == NULL || env.frame_block == start_block)
+		goto end;
+
+	/* Candidates are the dominators of all frame users. A candidate is only
+	 * valid if it is not part of a loop and control flow cannot leave the
+	 * blocks it dominates except by returning, so every return either has
+	 * seen the whole prologue or nothing of it. */
+	ir_node **chain = NEW_ARR_F(ir_node*, 0);
+	for (ir_node *b = env.frame_block; b != start_block; b = get_Block_idom(b))
+		ARR_APP1(ir_node*, chain, b);
+	size_t const n       = ARR_LEN(chain);
+	int   *const invalid = XMALLOCNZ(int, n + 1);
+	for (size_t i = 0, n_blocks = ARR_LEN(env.blocks); i < n_blocks; ++i) {
+		ir_node *const block = env.blocks[i];
+		size_t   const from  = first_dominating(chain, n, block);
+		foreach_block_succ(block, edge) {
+			ir_node *const succ = get_edge_src_irn(edge);
+			if (succ == env.end_block)
+				continue;
+			/* leaves the dominance region of chain[from] to chain[to - 1] */
+			size_t const to = first_dominating(chain, n, succ);
+			if (from < to) {
+				++invalid[from];
+				--invalid[to];
+			}
+			/* back edge to a candidate */
+			if (to < n && chain[to] == succ && block_dominates(succ, block)) {
+				++invalid[to];
+				--invalid[to + 1];
+			}
+		}
+	}
+
+	/* choose the least frequently executed candidate, prefer the one closest
+	 * to the start block for equal frequencies */
+	ir_node *best      = NULL;
+	double   best_freq = 0;
+	int      n_invalid = 0;
+	for (size_t i = 0; i < n; ++i) {
+		n_invalid += invalid[i];
+		ir_node *const block = chain[i];
+		if (n_invalid > 0 || has_flags_live_in(block, flags_cls))
+			continue;
+		double const freq = get_block_execfreq(block);
+		if (best == NULL || freq <= best_freq) {
+			best      = block;
+			best_freq = freq;
+		}
+	}
+	free(invalid);
+	DEL_ARR_F(chain);
+
+	/* nothing is gained if all paths pass the prologue anyway */
+	if (best != NULL && !block_postdominates(best, start_block)
+	 && best_freq < get_block_execfreq(start_block))
+		res = best;
+
+end:
+	DEL_ARR_F(env.blocks);
+	return res;
+}
+
+void be_reroute_dominated_users(ir_node *const from, ir_node *const to,
+                                ir_node const *const block,
+                                ir_node const *const exception)
+{
+	ir_node *const start_block = get_irg_start_block(get_irn_irg(from));
+	foreach_out_edge_safe(from, edge) {
+		ir_node *const src = get_edge_src_irn(edge);
+		if (src == exception)
+			continue;
+		int      const pos = get_edge_src_pos(edge);
+		ir_node *const use_block
+			= is_Anchor(src) ? start_block
+			: is_Phi(src)    ? get_Block_cfgpred_block(get_nodes_block(src), pos)
+			: get_nodes_block(src);
+		if (block_dominates(block, use_block))
+			set_irn_n(src, pos, to);
+	}
+}
@@ -54,4 +54,27 @@ void be_layout_frame_type(ir_type *frame, int begin, unsigned misalign);
 
 void be_sort_frame_entities(ir_type *const frame, bool spillslots_first);
 
+/**
+ * Determines the block for the prologue (shrink-wrapping). The result
+ * dominates all nodes using the stack pointer @p sp or the frame pointer
+ * @p bp (NULL if there is none), is not part of a loop and every block it
+ * dominates can only be left by returning. Returns which are not dominated by
+ * the result need no epilogue. The start block is returned if moving the
+ * prologue does not pay off or if @p bp is used and call frame information
+ * is emitted.
+ *
+ * @param flags_cls  register class of the flags clobbered by the prologue
+ */
+ir_node *be_get_prologue_block(ir_graph *irg, arch_register_t const *sp,
+                               arch_register_t const *bp,
+                               arch_register_class_t const *flags_cls);
+
+/**
+ * Like edges_reroute_except(), but only reroutes users in blocks dominated by
+ * @p block.
+ */
+void be_reroute_dominated_users(ir_node *from, ir_node *to,
+                                ir_node const *block,
+                                ir_node const *exception);
+
 #endif
@@ -24,6 +24,7 @@
 #include "irnode_t.h"
 #include "obst.h"
 #include "pmap.h"
+#include "set.h"
 #include "util.h"
 #include <limits.h>
 #include <stdlib.h>
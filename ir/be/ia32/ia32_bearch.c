@@ -30,6 +30,7 @@
 #include "ident_t.h"
 #include "instrument.h"
 #include "ircons.h"
+#include "irdom.h"
 #include "iredges_t.h"
 #include "irgmod.h"
 #include "irgopt.h"
@@ -949,6 +950,9 @@ request_entity:;
 
 static void introduce_epilogue(ir_node *const ret, bool const omit_fp)
 {
+	/* tail calls have their memory and stack inputs at the same positions */
+	assert(n_ia32_TailCall_mem == n_ia32_Ret_mem
+	    && n_ia32_TailCall_stack == n_ia32_Ret_stack);
 	ir_node        *curr_sp;
 	ir_node  *const first_sp = get_irn_n(ret, n_ia32_Ret_stack);
 	ir_node  *const block    = get_nodes_block(ret);
@@ -997,12 +1001,12 @@ static void introduce_epilogue(ir_node *const ret, bool const omit_fp)
 		kill_node(first_sp);
 }
 
-static void introduce_prologue(ir_graph *const irg, bool omit_fp)
+static void introduce_prologue(ir_graph *const irg, ir_node *const block,
+                               bool omit_fp)
 {
 	const arch_register_t *sp         = &ia32_registers[REG_ESP];
 	const arch_register_t *bp         = &ia32_registers[REG_EBP];
-	ir_node               *start      = get_irg_start(irg);
-	ir_node               *block      = get_nodes_block(start);
+	ir_node               *first      = be_move_after_schedule_first(block);
 	ir_type               *frame_type = get_irg_frame_type(irg);
 	unsigned               frame_size = get_type_size(frame_type);
 	ir_node               *initial_sp = be_get_Start_proj(irg, sp);
@@ -1013,19 +1017,19 @@ static void introduce_prologue(ir_graph *const irg, bool omit_fp)
 		ir_node *const noreg      = ia32_new_NoReg_gp(irg);
 		ir_node *const initial_bp = be_get_Start_proj(irg, bp);
 		ir_node *const push       = new_bd_ia32_Push(NULL, block, noreg, noreg, mem, initial_bp, initial_sp, X86_SIZE_32);
-		sched_add_after(start, push);
+		sched_add_after(first, push);
 		ir_node *const curr_mem   = be_new_Proj(push, pn_ia32_Push_M);
-		edges_reroute_except(mem, curr_mem, push);
+		be_reroute_dominated_users(mem, curr_mem, block, push);
 		ir_node *const curr_sp    = be_new_Proj_reg(push, pn_ia32_Push_stack, sp);
 
 		/* move esp to ebp */
 		ir_node *const curr_bp = be_new_Copy(block, curr_sp);
 		sched_add_after(push, curr_bp);
 		arch_copy_irn_out_info(curr_bp, 0, initial_bp);
-		edges_reroute_except(initial_bp, curr_bp, push);
+		be_reroute_dominated_users(initial_bp, curr_bp, block, push);
 
 		ir_node *incsp = ia32_new_IncSP(block, curr_sp, frame_size, false);
-		edges_reroute_except(initial_sp, incsp, push);
+		be_reroute_dominated_users(initial_sp, incsp, block, push);
 		sched_add_after(curr_bp, incsp);
 
 		/* make sure the initial IncSP is really used by someone */
@@ -1033,23 +1037,31 @@ static void introduce_prologue(ir_graph *const irg, bool omit_fp)
 	} else {
 		ir_node *const incsp = ia32_new_IncSP(block, initial_sp, frame_size,
 		                                      false);
-		edges_reroute_except(initial_sp, incsp, incsp);
-		sched_add_after(start, incsp);
+		be_reroute_dominated_users(initial_sp, incsp, block, incsp);
+		sched_add_after(first, incsp);
 	}
 }
 
 /**
- * Put the prologue code at the beginning, epilogue code before each return
+ * Put the prologue code into the block determined by shrink-wrapping and
+ * epilogue code before each return dominated by it.
  */
 static void introduce_prologue_epilogue(ir_graph *const irg, bool omit_fp)
 {
+	ia32_irg_data_t *const irg_data = ia32_get_irg_data(irg);
+	ir_node         *const block    = be_get_prologue_block(irg,
+		&ia32_registers[REG_ESP], omit_fp ? NULL : &ia32_registers[REG_EBP],
+		&ia32_reg_classes[CLASS_ia32_flags]);
+	irg_data->prologue_block = block;
+
 	/* introduce epilogue for every return node */
 	foreach_irn_in(get_irg_end_block(irg), i, ret) {
-		assert(is_ia32_Ret(ret));
-		introduce_epilogue(ret, omit_fp);
+		assert(is_ia32_Ret(ret) || is_ia32_TailCall(ret));
+		if (block_dominates(block, get_nodes_block(ret)))
+			introduce_epilogue(ret, omit_fp);
 	}
 
-	introduce_prologue(irg, omit_fp);
+	introduce_prologue(irg, block, omit_fp);
 }
 
 static x87_attr_t *ia32_get_x87_attr(ir_node *const node)
@@ -1669,6 +1681,10 @@ arch_isa_if_t const ia32_isa_if = {
 	.generate_code         = ia32_generate_code,
 	.jit_compile           = ia32_jit_compile,
 	.emit_function         = ia32_emit_jit_function,
+	.jit_stub_size         = IA32_JIT_STUB_SIZE,
+	.emit_jit_stub         = ia32_emit_jit_stub,
+	.jit_resolver_size     = IA32_JIT_RESOLVER_SIZE,
+	.emit_jit_resolver     = ia32_emit_jit_resolver,
 	.lower_for_target      = ia32_lower_for_target,
 	.additional_reg_names  = ia32_additional_reg_names,
 	.get_op_estimated_cost = ia32_get_op_estimated_cost,
@@ -46,6 +46,7 @@
 #include "ia32_bearch_t.h"
 #include "ia32_encode.h"
 #include "ia32_new_nodes.h"
+#include "irdom.h"
 #include "irgwalk.h"
 #include "irnodehashmap.h"
 #include "irtools.h"
@@ -64,6 +65,7 @@ static bool       mark_spill_reload;
 static bool       omit_fp;
 static int        frame_type_size;
 static int        callframe_offset;
+static ir_node   *prologue_block;
 static ir_entity *thunks[N_ia32_gp_REGS];
 static ir_type   *thunk_type;
 
@@ -1301,10 +1303,9 @@ static void ia32_gen_block(ir_node *block)
 	ia32_emit_block_header(block);
 
 	if (omit_fp) {
-		ir_graph *irg = get_irn_irg(block);
 		callframe_offset = 4; /* 4 bytes for the return address */
 		/* ESP guessing, TODO perform a real ESP simulation */
-		if (block != get_irg_start_block(irg)) {
+		if (block != prologue_block && block_dominates(prologue_block, block)) {
 			callframe_offset += frame_type_size;
 		}
 		be_dwarf_callframe_offset(callframe_offset);
@@ -1393,8 +1394,11 @@ static void emit_function_text(ir_graph *const irg, exc_entry **const exc_list)
 
 	be_emit_init_cf_links(blk_sched);
 
+	ir_node *const first_cold = be_birg_from_irg(irg)->first_cold_block;
 	for (size_t i = 0, n = ARR_LEN(blk_sched); i < n; ++i) {
 		ir_node *const block = blk_sched[i];
+		if (block == first_cold)
+			be_gas_emit_function_cold_part(get_irg_entity(irg));
 		ia32_gen_block(block);
 	}
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
@@ -1459,6 +1463,8 @@ void ia32_emit_function(ir_graph *const irg)
 	if (omit_fp) {
 		ir_type *frame_type = get_irg_frame_type(irg);
 		frame_type_size = get_type_size(frame_type);
+		prologue_block  = ia32_get_irg_data(irg)->prologue_block;
+		assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 		be_dwarf_callframe_register(&ia32_registers[REG_ESP]);
 	} else {
 		/* well not entirely correct here, we should emit this after the
@@ -911,6 +911,27 @@ static void enc_call(ir_node const *const node)
 	}
 }
 
+static void enc_tail_call(ir_node const *const node)
+{
+	ir_node *const callee = get_irn_n(node, n_ia32_TailCall_callee);
+	if (is_ia32_Immediate(callee)) {
+		x86_imm32_t const *const imm
+			= &get_ia32_immediate_attr_const(callee)->imm;
+		assert(imm->kind == X86_IMM_PCREL);
+		/* no machine code cheat here, see gen_tail_call() */
+		assert(!ia32_cg_config.emit_machcode);
+		be_emit8(0xE9);
+		x86_imm32_t const jmp_imm = {
+			.kind   = X86_IMM_PCREL,
+			.entity = imm->entity,
+			.offset = imm->offset - 4,
+		};
+		enc_relocation(&jmp_imm);
+	} else {
+		ia32_enc_unop(node, 0xFF, 4, n_ia32_TailCall_callee);
+	}
+}
+
 static void enc_jmp(ir_node const *const cfop)
 {
 	be_emit8(0xE9);
@@ -1280,11 +1301,13 @@ static void ia32_register_binary_emitters(void)
 	be_set_emitter(op_be_IncSP,           enc_incsp);
 	be_set_emitter(op_be_Perm,            enc_perm);
 	be_set_emitter(op_ia32_Ret,           enc_return);
+	be_set_emitter(op_ia32_TailCall,      enc_tail_call);
 	be_set_emitter(op_ia32_Bswap,         enc_bswap);
 	be_set_emitter(op_ia32_Bt,            enc_bt);
 	be_set_emitter(op_ia32_CMovcc,        enc_cmovcc);
 	be_set_emitter(op_ia32_Call,          enc_call);
 	be_set_emitter(op_ia32_Const,         enc_mov_const);
+	be_set_emitter(op_ia32_CopyEbpEsp,    enc_copy);
 	be_set_emitter(op_ia32_Conv_I2I,      enc_conv_i2i);
 	be_set_emitter(op_ia32_CopyB_i,       enc_copybi);
 	be_set_emitter(op_ia32_Dec,           enc_dec);
@@ -1438,7 +1461,10 @@ static unsigned enc_relocation_callback(char *const buffer,
 		if (be_kind == X86_IMM_PCREL)
 			addr -= (intptr_t)buffer;
 		value = (uint32_t)addr;
-		if ((intptr_t)value != addr)
+		/* pc relative displacements are signed */
+		bool const fits = be_kind == X86_IMM_PCREL
+			? (intptr_t)(int32_t)value == addr : (intptr_t)value == addr;
+		if (!fits)
 			panic("Overflow in relocation");
 	}
 
@@ -1454,3 +1480,67 @@ void ia32_emit_jit_function(char *buffer, ir_jit_function_t *const function)
 	};
 	be_jit_emit_memory(buffer, function, &jit_emit_interface);
 }
+
+static char *enc_u32(char *const buffer, uint32_t const value)
+{
+	memcpy(buffer, &value, 4);
+	return buffer + 4;
+}
+
+static char *enc_rel32(char *const buffer, void const *const dest)
+{
+	return enc_u32(buffer, (uint32_t)((intptr_t)dest - (intptr_t)(buffer + 4)));
+}
+
+void ia32_emit_jit_stub(char *const buffer, void *const data,
+                        char const *const resolver)
+{
+	char *const slot = buffer;
+	char       *b    = buffer + sizeof(void*);
+	/* jmp *slot */
+	*b++ = 0xFF;
+	*b++ = 0x25;
+	b    = enc_u32(b, (uint32_t)(uintptr_t)slot);
+	char *const lazy = b;
+	/* push data; jmp resolver */
+	*b++ = 0x68;
+	b    = enc_u32(b, (uint32_t)(uintptr_t)data);
+	*b++ = 0xE9;
+	b    = enc_rel32(b, resolver);
+	assert(b <= buffer + IA32_JIT_STUB_SIZE);
+
+	void const *const lazy_addr = lazy;
+	memcpy(slot, &lazy_addr, sizeof(lazy_addr));
+}
+
+void ia32_emit_jit_resolver(char *const buffer,
+                            void const *(*const resolve)(void *data))
+{
+	/* The stub pushed the data. Preserve the registers which may hold
+	 * arguments, keep the stack 16 byte aligned for the call and return to
+	 * the resolved address. */
+	static uint8_t const prologue[] = {
+		0x50,                   /* push eax */
+		0x51,                   /* push ecx */
+		0x52,                   /* push edx */
+		0x83, 0xEC, 0x08,       /* sub esp, 8 */
+		0xFF, 0x74, 0x24, 0x14, /* push dword [esp+20] */
+	};
+	static uint8_t const epilogue[] = {
+		0x83, 0xC4, 0x0C,       /* add esp, 12 */
+		0x89, 0x44, 0x24, 0x0C, /* mov [esp+12], eax */
+		0x5A,                   /* pop edx */
+		0x59,                   /* pop ecx */
+		0x58,                   /* pop eax */
+		0xC3,                   /* ret */
+	};
+	char *b = buffer;
+	memcpy(b, prologue, sizeof(prologue));
+	b   += sizeof(prologue);
+	*b++ = 0xE8; /* call resolve */
+	b    = enc_rel32(b, (void const*)(intptr_t)resolve);
+	memcpy(b, epilogue, sizeof(epilogue));
+	b   += sizeof(epilogue);
+	assert(b == buffer + IA32_JIT_RESOLVER_SIZE);
+	(void)b;
+}
@@ -23,6 +23,13 @@ ir_jit_function_t *ia32_emit_jit(ir_jit_segment_t *segment, ir_graph *irg);
 
 void ia32_emit_jit_function(char *buffer, ir_jit_function_t *function);
 
+#define IA32_JIT_STUB_SIZE     (sizeof(void*) + 16)
+#define IA32_JIT_RESOLVER_SIZE 26
+
+void ia32_emit_jit_stub(char *buffer, void *data, char const *resolver);
+
+void ia32_emit_jit_resolver(char *buffer, void const *(*resolve)(void *data));
+
 void ia32_enc_simple(uint8_t opcode);
 
 void ia32_enc_binop(ir_node const *node, unsigned code);
@@ -1264,6 +1264,17 @@ Ret => {
 	fixed     => "x86_insn_size_t const size = X86_SIZE_32;",
 },
 
+TailCall => {
+	state     => "pinned",
+	op_flags  => [ "cfopcode" ],
+	in_reqs   => "...",
+	out_reqs  => [ "exec" ],
+	ins       => [ "mem", "stack", "callee" ],
+	fixed     => "x86_insn_size_t const size = X86_SIZE_32;",
+	emit      => "jmp %*S2",
+	latency   => 1,
+},
+
 Call => {
 	op_flags  => [ "uses_memory" ],
 	irn_flags => [ "modify_flags" ],
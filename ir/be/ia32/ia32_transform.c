@@ -12,6 +12,7 @@
 #include "ia32_transform.h"
 
 #include "array.h"
+#include "be_t.h"
 #include "bediagnostic.h"
 #include "benode.h"
 #include "betranshlp.h"
@@ -35,6 +36,7 @@
 #include "irop_t.h"
 #include "iropt.h"
 #include "iropt_t.h"
+#include "iroptimize.h"
 #include "irouts.h"
 #include "irprintf.h"
 #include "irprog_t.h"
@@ -4047,8 +4049,105 @@ static ir_node *gen_Proj_Proj_Start(ir_node *node)
 	return be_get_Start_proj(irg, param->reg);
 }
 
+static void adjust_pc_relative_relocation(ir_node *node)
+{
+	if (!is_ia32_Immediate(node))
+		return;
+	ia32_immediate_attr_t *attr = get_ia32_immediate_attr(node);
+	if (attr->imm.kind == X86_IMM_ADDR)
+		attr->imm.kind = X86_IMM_PCREL;
+}
+
+static bool callee_is_plt(ir_node *callee)
+{
+	return be_is_Relocation(callee)
+	    && be_get_Relocation_kind(callee) == X86_IMM_PLT;
+}
+
+/**
+ * Implements the Call @p call, whose results are returned by @p node, as a
+ * jump after the epilogue. Returns NULL if the callee receives arguments on
+ * the stack, as these would overwrite the incoming arguments still in use, or
+ * if it pops a different amount of stack than the current function.
+ */
+static ir_node *gen_tail_call(ir_node *const node, ir_node *const call)
+{
+	ir_type     *const type   = get_Call_type(call);
+	ir_node     *const callee = get_Call_ptr(call);
+	x86_cconv_t *const cconv  = ia32_decide_calling_convention(type, NULL);
+	/* PLT calls need the GOT address in the callee save ebx */
+	if (cconv->param_stacksize != 0 || cconv->sp_delta != current_cconv->sp_delta
+	 || callee_is_plt(callee)) {
+		x86_free_calling_convention(cconv);
+		return NULL;
+	}
+
+	ir_graph *const irg            = get_irn_irg(node);
+	ir_node  *const new_block      = be_transform_nodes_block(node);
+	dbg_info *const dbgi           = get_irn_dbg_info(call);
+	unsigned  const n_params       = get_Call_n_params(call);
+	unsigned  const n_callee_saves = rbitset_popcount(current_cconv->callee_saves, N_IA32_REGISTERS);
+	unsigned  const n_ins          = n_ia32_TailCall_callee + 1 + n_params + n_callee_saves;
+
+	arch_register_req_t const **const reqs = be_allocate_in_reqs(irg, n_ins);
+	ir_node                   **const in   = ALLOCAN(ir_node*, n_ins);
+
+	in[n_ia32_TailCall_mem]     = be_transform_node(get_Call_mem(call));
+	reqs[n_ia32_TailCall_mem]   = arch_memory_req;
+	in[n_ia32_TailCall_stack]   = get_initial_sp(irg);
+	reqs[n_ia32_TailCall_stack] = &ia32_single_reg_req_gp_esp;
+
+	/* Memory operands are not possible as the frame is gone. The machine code
+	 * emitter only knows how to relocate direct calls. */
+	ir_node *new_callee = ia32_cg_config.emit_machcode ? NULL
+	                    : try_create_Immediate(callee, 'i');
+	if (new_callee != NULL)
+		adjust_pc_relative_relocation(new_callee);
+	else
+		new_callee = be_transform_node(callee);
+	in[n_ia32_TailCall_callee]   = new_callee;
+	reqs[n_ia32_TailCall_callee] = &ia32_class_reg_req_gp;
+
+	unsigned p = n_ia32_TailCall_callee + 1;
+
+	/* parameters */
+	for (unsigned i = 0; i < n_params; ++i) {
+		reg_or_stackslot_t const *const param = &cconv->parameters[i];
+		assert(param->reg != NULL);
+		in[p]   = be_transform_node(get_Call_param(call, i));
+		reqs[p] = param->reg->single_req;
+		++p;
+	}
+
+	/* callee saves */
+	for (unsigned i = 0; i < N_IA32_REGISTERS; ++i) {
+		if (!rbitset_is_set(current_cconv->callee_saves, i))
+			continue;
+		arch_register_t const *const reg = &ia32_registers[i];
+		in[p]   = be_get_Start_proj(irg, reg);
+		reqs[p] = reg->single_req;
+		++p;
+	}
+	assert(p == n_ins);
+
+	ir_node *const jump = new_bd_ia32_TailCall(dbgi, new_block, n_ins, in, reqs);
+	be_stack_record_chain(&stack_env, jump, n_ia32_TailCall_stack, NULL);
+	x86_free_calling_convention(cconv);
+	return jump;
+}
+
 static ir_node *gen_Return(ir_node *node)
 {
+	ir_node *const ret_mem = get_Return_mem(node);
+	if (be_options.tail_calls && is_Proj(ret_mem)) {
+		ir_node *const call = get_Proj_pred(ret_mem);
+		if (is_Call(call) && get_Call_tail_call(call)) {
+			ir_node *const jump = gen_tail_call(node, call);
+			if (jump != NULL)
+				return jump;
+		}
+	}
+
 	ir_graph *irg       = get_irn_irg(node);
 	ir_node  *new_block = be_transform_nodes_block(node);
 	dbg_info *dbgi      = get_irn_dbg_info(node);
@@ -4156,15 +4255,6 @@ static ir_node *gen_Jmp(ir_node *node)
 	return new_bd_ia32_Jmp(dbgi, new_block);
 }
 
-static void adjust_pc_relative_relocation(ir_node *node)
-{
-	if (!is_ia32_Immediate(node))
-		return;
-	ia32_immediate_attr_t *attr = get_ia32_immediate_attr(node);
-	if (attr->imm.kind == X86_IMM_ADDR)
-		attr->imm.kind = X86_IMM_PCREL;
-}
-
 /**
  * Transform IJmp
  */
@@ -4564,12 +4654,6 @@ static ir_node *gen_CopyB(ir_node *node)
 	return projm;
 }
 
-static bool callee_is_plt(ir_node *callee)
-{
-	return be_is_Relocation(callee)
-	    && be_get_Relocation_kind(callee) == X86_IMM_PLT;
-}
-
 static ir_node *gen_Call(ir_node *node)
 {
 	/* Construct arguments. */
@@ -5425,6 +5509,8 @@ void ia32_transform_graph(ir_graph *irg)
 	be_stack_init(&stack_env);
 	ir_entity *entity = get_irg_entity(irg);
 	ir_type   *mtp    = get_entity_type(entity);
+	if (be_options.tail_calls)
+		mark_tail_calls(irg);
 	current_cconv = ia32_decide_calling_convention(mtp, irg);
 	x86_layout_param_entities(irg, current_cconv, IA32_REGISTER_SIZE);
 	be_add_parameter_entity_stores(irg);
@@ -14,6 +14,21 @@
 
 target_info_t ir_target;
 
+/**
+ * Folds @p str into the target fingerprint, which identifies the target
+ * configuration for caches of compilation results.
+ */
+static void add_to_fingerprint(char const *const str)
+{
+	uint64_t hash = ir_target.fingerprint ^ UINT64_C(0xcbf29ce484222325);
+	for (char const *c = str; *c != '\0'; ++c) {
+		hash ^= (unsigned char)*c;
+		hash *= UINT64_C(0x100000001b3);
+	}
+	/* separate consecutive strings */
+	ir_target.fingerprint = hash * UINT64_C(0x100000001b3);
+}
+
 int ir_target_set_triple(ir_machine_triple_t const *machine)
 {
 	memset(&ir_target, 0, sizeof(ir_target));
@@ -45,6 +60,9 @@ int ir_target_set_triple(ir_machine_triple_t const *machine)
 		return false;
 	}
 	ir_target.isa = isa;
+	add_to_fingerprint(cpu);
+	add_to_fingerprint(manufacturer);
+	add_to_fingerprint(ir_triple_get_operating_system(machine));
 
 	if (arch != NULL) {
 		bool res = be_set_arch(arch);
@@ -115,12 +133,15 @@ int ir_target_option(const char *arg)
 	 * has been initialized */
 	assert(!ir_target.isa_initialized && "Target already initiazed");
 	int res = lc_opt_from_single_arg(be_grp, arg);
+	if (!res) {
+		/* Try passing the option along to the target */
+		lc_opt_entry_t *target_grp
+			= lc_opt_get_grp(be_grp, ir_target.isa->name);
+		res = lc_opt_from_single_arg(target_grp, arg);
+	}
 	if (res)
-		return res;
-
-	/* Try passing the option along to the target */
-	lc_opt_entry_t *target_grp = lc_opt_get_grp(be_grp, ir_target.isa->name);
-	return lc_opt_from_single_arg(target_grp, arg);
+		add_to_fingerprint(arg);
+	return res;
 }
 
 int (ir_target_big_endian)(void)
@@ -13,6 +13,7 @@
 #include "iroptimize.h"
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #define ir_target_big_endian()   ir_target_big_endian_()
 
@@ -21,6 +22,7 @@ typedef struct target_info_t {
 	char const            *experimental;
 	arch_allow_ifconv_func allow_ifconv;
 	ir_mode               *mode_float_arithmetic;
+	uint64_t               fingerprint; /**< hash of triple and options */
 	bool isa_initialized          : 1;
 	bool fast_unaligned_memaccess : 1;
 	ENUMBF(float_int_conversion_overflow_style_t) float_int_overflow : 2;
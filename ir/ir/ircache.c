@@ -0,0 +1,373 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Content addressed cache for per-function compilation results.
+ *
+ * Every entry is a file named after its key. The file "index" in the cache
+ * directory records size and last use of every entry, one entry per line.
+ */
+#include "ircache.h"
+
+#include "array.h"
+#include "entity_t.h"
+#include "hashptr.h"
+#include "irgwalk.h"
+#include "irio.h"
+#include "irnode_t.h"
+#include "pmap.h"
+#include "set.h"
+#include "target_t.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INDEX_NAME "index"
+
+typedef struct cache_entry_t {
+	char          key[IR_CACHE_KEY_SIZE];
+	size_t        size;
+	unsigned long last_use; /**< 0 marks evicted entries */
+} cache_entry_t;
+
+struct ir_cache_t {
+	char          *directory;
+	char          *fingerprint;
+	size_t         max_size;
+	size_t         total_size;
+	unsigned long  clock;   /**< last used timestamp */
+	set           *entries; /**< set of cache_entry_t */
+};
+
+/** A 128bit hash built from two differently seeded 64bit FNV-1a hashes. */
+typedef struct content_hash_t {
+	uint64_t h0;
+	uint64_t h1;
+} content_hash_t;
+
+static void content_hash_bytes(content_hash_t *hash, void const *data,
+                               size_t size)
+{
+	uint64_t const prime = UINT64_C(0x100000001b3);
+	unsigned char const *bytes = (unsigned char const*)data;
+	for (size_t i = 0; i < size; ++i) {
+		hash->h0 = (hash->h0 ^ bytes[i]) * prime;
+		hash->h1 = (hash->h1 ^ bytes[i]) * prime;
+		hash->h1 ^= hash->h1 >> 29;
+	}
+}
+
+static void content_hash_str(content_hash_t *hash, char const *str)
+{
+	/* include the terminating 0 to separate consecutive strings */
+	content_hash_bytes(hash, str, strlen(str) + 1);
+}
+
+static int cmp_entry(void const *elt, void const *key, size_t size)
+{
+	(void)size;
+	cache_entry_t const *const e1 = (cache_entry_t const*)elt;
+	cache_entry_t const *const e2 = (cache_entry_t const*)key;
+	return strcmp(e1->key, e2->key);
+}
+
+static bool is_valid_key(char const *const key)
+{
+	size_t len = 0;
+	for (char const *c = key; *c != '\0'; ++c, ++len) {
+		if (!((*c >= '0' && *c <= '9') || (*c >= 'a' && *c <= 'f')))
+			return false;
+	}
+	return len == IR_CACHE_KEY_SIZE - 1;
+}
+
+static char *get_path(ir_cache_t const *const cache, char const *const name)
+{
+	size_t const dir_len  = strlen(cache->directory);
+	size_t const name_len = strlen(name);
+	char  *const path     = XMALLOCN(char, dir_len + name_len + 2);
+	memcpy(path, cache->directory, dir_len);
+	path[dir_len] = '/';
+	memcpy(path + dir_len + 1, name, name_len + 1);
+	return path;
+}
+
+static cache_entry_t *find_entry(ir_cache_t *const cache, char const *const key)
+{
+	cache_entry_t templ;
+	memset(&templ, 0, sizeof(templ));
+	strncpy(templ.key, key, IR_CACHE_KEY_SIZE - 1);
+	cache_entry_t *const entry = set_find(cache_entry_t, cache->entries,
+	                                      &templ, sizeof(templ),
+	                                      hash_str(key));
+	return entry != NULL && entry->last_use != 0 ? entry : NULL;
+}
+
+static cache_entry_t *insert_entry(ir_cache_t *const cache,
+                                   char const *const key)
+{
+	cache_entry_t templ;
+	memset(&templ, 0, sizeof(templ));
+	strncpy(templ.key, key, IR_CACHE_KEY_SIZE - 1);
+	return set_insert(cache_entry_t, cache->entries, &templ, sizeof(templ),
+	                  hash_str(key));
+}
+
+static void remove_entry(ir_cache_t *const cache, cache_entry_t *const entry)
+{
+	char *const path = get_path(cache, entry->key);
+	remove(path);
+	free(path);
+	cache->total_size -= entry->size;
+	entry->size     = 0;
+	entry->last_use = 0;
+}
+
+static void read_index(ir_cache_t *const cache)
+{
+	char *const path = get_path(cache, INDEX_NAME);
+	FILE *const f    = fopen(path, "r");
+	free(path);
+	if (f == NULL)
+		return;
+
+	char          key[IR_CACHE_KEY_SIZE];
+	size_t        size;
+	unsigned long last_use;
+	while (fscanf(f, "%32s %zu %lu", key, &size, &last_use) == 3) {
+		if (!is_valid_key(key) || last_use == 0)
+			continue;
+		cache_entry_t *const entry = insert_entry(cache, key);
+		cache->total_size -= entry->size;
+		entry->size        = size;
+		entry->last_use    = last_use;
+		cache->total_size += size;
+		if (last_use > cache->clock)
+			cache->clock = last_use;
+	}
+	fclose(f);
+}
+
+static int cmp_last_use(void const *const p0, void const *const p1)
+{
+	cache_entry_t const *const e0 = *(cache_entry_t const**)p0;
+	cache_entry_t const *const e1 = *(cache_entry_t const**)p1;
+	return (e0->last_use > e1->last_use) - (e0->last_use < e1->last_use);
+}
+
+/** Removes the least recently used entries until the size limit is met. */
+static void evict(ir_cache_t *const cache)
+{
+	if (cache->total_size <= cache->max_size)
+		return;
+
+	cache_entry_t **entries = NEW_ARR_F(cache_entry_t*, 0);
+	foreach_set(cache->entries, cache_entry_t, entry) {
+		if (entry->last_use != 0)
+			ARR_APP1(cache_entry_t*, entries, entry);
+	}
+	QSORT_ARR(entries, cmp_last_use);
+	for (size_t i = 0, n = ARR_LEN(entries);
+	     i < n && cache->total_size > cache->max_size; ++i) {
+		remove_entry(cache, entries[i]);
+	}
+	DEL_ARR_F(entries);
+}
+
+ir_cache_t *ir_cache_open(char const *const directory, size_t const max_size,
+                          char const *const fingerprint)
+{
+	ir_cache_t *const cache = XMALLOCZ(ir_cache_t);
+	cache->directory   = xstrdup(directory);
+	cache->fingerprint = xstrdup(fingerprint != NULL ? fingerprint : "");
+	cache->max_size    = max_size;
+	cache->entries     = new_set(cmp_entry, 64);
+	read_index(cache);
+	evict(cache);
+	return cache;
+}
+
+int ir_cache_close(ir_cache_t *const cache)
+{
+	/* write to a temporary file first, so concurrent readers never see a
+	 * partial index */
+	char *const path     = get_path(cache, INDEX_NAME);
+	char *const tmp_path = get_path(cache, INDEX_NAME ".tmp");
+	FILE *const f        = fopen(tmp_path, "w");
+	int         res      = 1;
+	if (f != NULL) {
+		foreach_set(cache->entries, cache_entry_t, entry) {
+			if (entry->last_use != 0)
+				fprintf(f, "%s %zu %lu\n", entry->key, entry->size,
+				        entry->last_use);
+		}
+		res = ferror(f);
+		res |= fclose(f);
+		if (res == 0)
+			res = rename(tmp_path, path);
+	}
+	free(tmp_path);
+	free(path);
+
+	del_set(cache->entries);
+	free(cache->fingerprint);
+	free(cache->directory);
+	free(cache);
+	return res;
+}
+
+typedef struct callee_env_t {
+	ir_graph **irgs; /**< graphs to hash in the order they were found */
+	pmap      *seen;
+} callee_env_t;
+
+static void collect_callee(ir_node *const node, void *const data)
+{
+	if (!is_Address(node))
+		return;
+	ir_entity *const entity = get_Address_entity(node);
+	if (!is_method_entity(entity))
+		return;
+	ir_graph     *const callee = get_entity_irg(entity);
+	callee_env_t *const env    = (callee_env_t*)data;
+	if (callee == NULL || pmap_contains(env->seen, callee))
+		return;
+	pmap_insert(env->seen, callee, callee);
+	ARR_APP1(ir_graph*, env->irgs, callee);
+}
+
+int ir_cache_key(ir_cache_t const *const cache, ir_graph *const irg,
+                 char *const key)
+{
+	FILE *const f = tmpfile();
+	if (f == NULL)
+		return 1;
+
+	/* inlining and interprocedural optimizations copy from the functions
+	 * reachable from irg, so their graphs are part of the key */
+	callee_env_t env = {
+		.irgs = NEW_ARR_F(ir_graph*, 1),
+		.seen = pmap_create(),
+	};
+	env.irgs[0] = irg;
+	pmap_insert(env.seen, irg, irg);
+	for (size_t i = 0; i < ARR_LEN(env.irgs); ++i) {
+		ir_export_irg_canonical(f, env.irgs[i]);
+		irg_walk_graph(env.irgs[i], NULL, collect_callee, &env);
+	}
+	pmap_destroy(env.seen);
+	DEL_ARR_F(env.irgs);
+	int res = ferror(f);
+
+	content_hash_t hash = {
+		UINT64_C(0xcbf29ce484222325), UINT64_C(0x84222325cbf29ce4)
+	};
+	content_hash_str(&hash, cache->fingerprint);
+	uint64_t const target = ir_target.isa != NULL ? ir_target.fingerprint : 0;
+	content_hash_bytes(&hash, &target, sizeof(target));
+
+	rewind(f);
+	char   buf[4096];
+	size_t len;
+	while ((len = fread(buf, 1, sizeof(buf), f)) > 0)
+		content_hash_bytes(&hash, buf, len);
+	res |= ferror(f);
+	fclose(f);
+
+	snprintf(key, IR_CACHE_KEY_SIZE, "%016" PRIx64 "%016" PRIx64,
+	         hash.h0, hash.h1);
+	return res;
+}
+
+FILE *ir_cache_lookup(ir_cache_t *const cache, char const *const key)
+{
+	if (!is_valid_key(key))
+		return NULL;
+	cache_entry_t *const entry = find_entry(cache, key);
+	if (entry == NULL)
+		return NULL;
+
+	char *const path = get_path(cache, key);
+	FILE *const f    = fopen(path, "rb");
+	free(path);
+	if (f == NULL) {
+		/* entry was removed behind our back */
+		cache->total_size -= entry->size;
+		entry->size     = 0;
+		entry->last_use = 0;
+		return NULL;
+	}
+	entry->last_use = ++cache->clock;
+	return f;
+}
+
+/** Copies @p data to a new entry file, @p data is either a FILE or NULL. */
+static int store(ir_cache_t *const cache, char const *const key,
+                 void const *const buffer, size_t const buffer_size,
+                 FILE *const data)
+{
+	if (!is_valid_key(key))
+		return 1;
+
+	cache_entry_t *const old = find_entry(cache, key);
+	if (old != NULL)
+		remove_entry(cache, old);
+
+	char *const path = get_path(cache, key);
+	FILE *const f    = fopen(path, "wb");
+	if (f == NULL) {
+		free(path);
+		return 1;
+	}
+
+	size_t size = 0;
+	int    res  = 0;
+	if (data == NULL) {
+		size = fwrite(buffer, 1, buffer_size, f);
+		res  = size != buffer_size;
+	} else {
+		char   buf[4096];
+		size_t len;
+		while ((len = fread(buf, 1, sizeof(buf), data)) > 0) {
+			if (fwrite(buf, 1, len, f) != len) {
+				res = 1;
+				break;
+			}
+			size += len;
+		}
+		res |= ferror(data);
+	}
+	res |= ferror(f);
+	res |= fclose(f);
+	if (res != 0) {
+		remove(path);
+		free(path);
+		return res;
+	}
+	free(path);
+
+	cache_entry_t *const entry = insert_entry(cache, key);
+	entry->size        = size;
+	entry->last_use    = ++cache->clock;
+	cache->total_size += size;
+	evict(cache);
+	return 0;
+}
+
+int ir_cache_store(ir_cache_t *const cache, char const *const key,
+                   void const *const data, size_t const size)
+{
+	return store(cache, key, data, size, NULL);
+}
+
+int ir_cache_store_file(ir_cache_t *const cache, char const *const key,
+                        FILE *const data)
+{
+	return store(cache, key, NULL, 0, data);
+}
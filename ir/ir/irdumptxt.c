@@ -51,6 +51,8 @@ static const bitflag_name_t mtp_property_names[] = {
 	{ mtp_property_noinline,           "noinline"           },
 	{ mtp_property_inline_recommended, "inline_recommended" },
 	{ mtp_temporary,                   "temporary"          },
+	{ mtp_property_hot,                "hot"                },
+	{ mtp_property_cold,               "cold"               },
 	{ 0,                               NULL                 },
 };
 static const bitflag_name_t cc_names[] = {
@@ -167,7 +169,8 @@ void dump_irnode_to_file(FILE *const F, const ir_node *const n)
 	}
 
 	/* Loop node.   Someone else please tell me what's wrong ... */
-	if (irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO)) {
+	if (is_Block(n)
+	    && irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO)) {
 		const ir_loop *loop = get_irn_loop(n);
 		if (loop != NULL) {
 			fprintf(F, "  in loop %ld with depth %u\n",
@@ -421,6 +424,9 @@ static void dump_ir_initializers_to_file(FILE *const F, const char *const prefix
 		ir_fprintf(F, "\t = %F", value);
 		break;
 	}
+	case IR_INITIALIZER_BLOB:
+		fprintf(F, "\t = <BLOB>%zu bytes", get_initializer_blob_size(initializer));
+		break;
 	case IR_INITIALIZER_COMPOUND:
 		if (is_Array_type(type)) {
 			size_t const n = get_initializer_compound_n_entries(initializer);
@@ -14,45 +14,18 @@
  */
 #include "iredges_t.h"
 
+#include "bitfiddle.h"
 #include "bitset.h"
 #include "debug.h"
-#include "hashptr.h"
 #include "irdump_t.h"
 #include "iredgekinds.h"
-#include "iredgeset.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "irnodemap.h"
 #include "iropt_t.h"
 #include "irprintf.h"
-#include "set.h"
-
-#define DO_REHASH
-#define SCALAR_RETURN
-#define HashSet                   ir_edgeset_t
-#define HashSetIterator           ir_edgeset_iterator_t
-#define ValueType                 ir_edge_t*
-#define NullValue                 NULL
-#define DeletedValue              ((ir_edge_t*)-1)
-#define Hash(this,key)            (hash_ptr(key->src) ^ (key->pos * 40013))
-#define KeysEqual(this,key1,key2) ((key1->src) == (key2->src) && (key1->pos == key2->pos))
-#define SetRangeEmpty(ptr,size)   memset(ptr, 0, (size) * sizeof((ptr)[0]))
-
-#define hashset_init            ir_edgeset_init
-void ir_edgeset_init_size(ir_edgeset_t *self, size_t size);
-#define hashset_init_size       ir_edgeset_init_size
-#define hashset_destroy         ir_edgeset_destroy
-#define hashset_insert          ir_edgeset_insert
-#define hashset_remove          ir_edgeset_remove
-ir_edge_t *ir_edgeset_find(const ir_edgeset_t *self, const ir_edge_t* key);
-#define hashset_find            ir_edgeset_find
-size_t ir_edgeset_size(const ir_edgeset_t *self);
-#define hashset_size            ir_edgeset_size
-#define hashset_iterator_init   ir_edgeset_iterator_init
-#define hashset_iterator_next   ir_edgeset_iterator_next
-#define hashset_remove_iterator ir_edgeset_remove_iterator
-
-#include "hashset.c.h"
+#include "util.h"
+#include <limits.h>
 
 /**
  * A function that allows for setting an edge.
@@ -127,70 +100,183 @@ DEBUG_ONLY(static firm_dbg_module_t *dbg;)
  */
 static int edges_dbg = 0;
 
-/**
- * Returns an ID for the given edge.
- */
-static inline long edge_get_id(const ir_edge_t *e)
-{
-	return (long)e;
-}
-
 void edges_init_graph_kind(ir_graph *irg, ir_edge_kind_t kind)
 {
 	if (edges_activated_kind(irg, kind)) {
-		irg_edge_info_t *info   = get_irg_edge_info(irg, kind);
-		size_t           amount = get_irg_last_idx(irg) * 5 / 4;
+		irg_edge_info_t *info = get_irg_edge_info(irg, kind);
 
-		if (info->allocated) {
-			amount = ir_edgeset_size(&info->edges);
-			ir_edgeset_destroy(&info->edges);
+		if (info->allocated)
 			obstack_free(&info->edges_obst, NULL);
-		}
 		obstack_init(&info->edges_obst);
-		INIT_LIST_HEAD(&info->free_edges);
-		ir_edgeset_init_size(&info->edges, amount);
+		memset(info->free_arrays, 0, sizeof(info->free_arrays));
 		info->allocated = 1;
 	}
 }
 
 /**
- * Change the out count
- *
- * @param info  the edge info
- * @param ofs   amount to change the edge count
+ * Reset the out edges of a node to the empty inline vector.
+ */
+static void init_irn_edge_info(irn_edge_info_t *const info)
+{
+	info->outs      = &info->inline_out;
+	info->in_idx    = NULL;
+	info->out_count = 0;
+	info->out_log   = 0;
+	info->in_log    = 0;
+}
+
+/**
+ * Allocate an array of 2^@p log bytes in the edge arena.  Arrays are
+ * recycled via per size free lists.
  */
-static inline void edge_change_cnt(irn_edge_info_t *const info, int const ofs)
+static void *alloc_array(irg_edge_info_t *const irg_info, unsigned const log)
 {
-	assert((unsigned)info->out_count + ofs < 1U << 31);
-	info->out_count += ofs;
+	void **const free_list = &irg_info->free_arrays[log];
+	void  *const res       = *free_list;
+	if (res != NULL) {
+		*free_list = *(void**)res;
+		return res;
+	}
+	assert(1U << log >= sizeof(void*));
+	return obstack_alloc(&irg_info->edges_obst, 1U << log);
+}
+
+/**
+ * Put an array of 2^@p log bytes on the free list of its size.
+ */
+static void free_array(irg_edge_info_t *const irg_info, void *const array,
+                       unsigned const log)
+{
+	*(void**)array             = irg_info->free_arrays[log];
+	irg_info->free_arrays[log] = array;
+}
+
+/**
+ * Make room for the index of input @p pos at @p src.
+ */
+static void grow_in_idx(irg_edge_info_t *const irg_info,
+                        irn_edge_info_t *const info, ir_node const *const src,
+                        int const pos, ir_edge_kind_t const kind)
+{
+	unsigned const old_capacity = get_irn_in_capacity(info);
+	unsigned       needed       = pos + 2;
+	if (old_capacity == 0) {
+		/* allocate for all current inputs at once */
+		unsigned const arity = edge_kind_info[kind].get_arity(src) + 1;
+		needed = MAX(needed, arity);
+	}
+	unsigned const log      = log2_ceil(MAX(needed, 2U));
+	unsigned *const in_idx  = (unsigned*)alloc_array(irg_info, log + 2);
+	if (old_capacity != 0) {
+		MEMCPY(in_idx, info->in_idx, old_capacity);
+		free_array(irg_info, info->in_idx, info->in_log + 2);
+	}
+	info->in_idx = in_idx;
+	info->in_log = log;
+}
+
+/**
+ * Append the edge (@p src, @p pos) to the out edges of a node and record its
+ * index at the source.
+ */
+static void push_edge(irg_edge_info_t *const irg_info,
+                      irn_edge_info_t *const tgt_info, ir_node *const src,
+                      int const pos, ir_edge_kind_t const kind)
+{
+	irn_edge_info_t *const src_info = get_irn_edge_info(src, kind);
+	unsigned         const in       = pos + 1;
+	if (in >= get_irn_in_capacity(src_info))
+		grow_in_idx(irg_info, src_info, src, pos, kind);
+
+	unsigned const count = tgt_info->out_count;
+	if (count == get_irn_out_capacity(tgt_info)) {
+		/* The old vector is not recycled, so an edge pointer held by a safe
+		 * iteration stays readable after the vector moved. */
+		unsigned   const log  = tgt_info->out_log + 1;
+		assert(log + 4 < ARRAY_SIZE(irg_info->free_arrays) && "too many out edges");
+		ir_edge_t *const outs = (ir_edge_t*)alloc_array(irg_info, log + 4);
+		MEMCPY(outs, tgt_info->outs, count);
+		tgt_info->outs    = outs;
+		tgt_info->out_log = log;
+	}
+	tgt_info->outs[count] = (ir_edge_t){ .src = src, .pos = pos };
+	tgt_info->out_count   = count + 1;
+	src_info->in_idx[in]  = count;
 }
 
 /**
- * Verify the edge list of a node, i.e. ensure it's a loop:
- * head -> e_1 -> ... -> e_n -> head
+ * Find the index of the edge (@p src, @p pos) in the out edges of @p tgt.
+ * @return the index or -1 if the edge is not recorded at @p tgt
  */
-static inline void verify_list_head(ir_node *irn, ir_edge_kind_t kind)
-{
-	int                     num    = 0;
-	pset                   *lh_set = pset_new_ptr(16);
-	const struct list_head *head   = &get_irn_edge_info(irn, kind)->outs_head;
-	const struct list_head *pos;
-
-	list_for_each(pos, head) {
-		if (pset_find_ptr(lh_set, pos)) {
-			const ir_edge_t *edge = list_entry(pos, ir_edge_t, list);
-
-			ir_fprintf(stderr, "EDGE Verifier: edge list broken (self loop not to head) for %+F:\n", irn);
-			fprintf(stderr, "- at list entry %d\n", num);
-			if (edge->src)
-				ir_fprintf(stderr, "- edge(%ld) %+F(%d)\n", edge_get_id(edge), edge->src, edge->pos);
-			break;
+static int find_edge(irn_edge_info_t const *const tgt_info,
+                     ir_node const *const src, int const pos,
+                     ir_edge_kind_t const kind)
+{
+	irn_edge_info_t const *const src_info = get_irn_edge_info_const(src, kind);
+	unsigned               const in       = pos + 1;
+	if (in >= get_irn_in_capacity(src_info))
+		return -1;
+	unsigned const idx = src_info->in_idx[in];
+	if (idx >= tgt_info->out_count)
+		return -1;
+	ir_edge_t const *const edge = &tgt_info->outs[idx];
+	if (edge->src != src || edge->pos != pos)
+		return -1;
+	return (int)idx;
+}
+
+/**
+ * Remove the edge at index @p idx from the out edges of a node by moving the
+ * last edge into its place.
+ */
+static void pop_edge(irn_edge_info_t *const tgt_info, unsigned const idx,
+                     ir_edge_kind_t const kind)
+{
+	unsigned const last = tgt_info->out_count - 1;
+	if (idx != last) {
+		ir_edge_t const moved = tgt_info->outs[last];
+		tgt_info->outs[idx] = moved;
+		irn_edge_info_t *const moved_info = get_irn_edge_info(moved.src, kind);
+		unsigned         const in         = moved.pos + 1;
+		if (in < get_irn_in_capacity(moved_info))
+			moved_info->in_idx[in] = idx;
+	}
+	tgt_info->out_count = last;
+}
+
+/**
+ * Verify the out edge vector of a node, i.e. ensure every edge in it is
+ * found via the index recorded at its source.
+ */
+static bool verify_out_vector(ir_node *irn, ir_edge_kind_t kind)
+{
+	irn_edge_info_t const *const info = get_irn_edge_info(irn, kind);
+	bool                         fine = true;
+
+	if (info->out_count > get_irn_out_capacity(info)) {
+		ir_fprintf(stderr, "EDGE Verifier: %+F has %u out edges, but capacity for %u\n",
+		           irn, info->out_count, get_irn_out_capacity(info));
+		return false;
+	}
+	for (unsigned i = 0; i < info->out_count; ++i) {
+		ir_edge_t const *const edge = &info->outs[i];
+		if (find_edge(info, edge->src, edge->pos, kind) != (int)i) {
+			ir_fprintf(stderr, "EDGE Verifier: edge %+F,%d at %u of %+F not indexed\n",
+			           edge->src, edge->pos, i, irn);
+			fine = false;
 		}
-		num++;
-		pset_insert_ptr(lh_set, pos);
 	}
+	return fine;
+}
 
-	del_pset(lh_set);
+static void dump_edges_walker(ir_node *irn, void *data)
+{
+	ir_edge_kind_t const kind = *(ir_edge_kind_t const*)data;
+	if (kind == EDGE_KIND_BLOCK && !is_Block(irn))
+		return;
+	foreach_out_edge_kind(irn, e, kind) {
+		ir_printf("%+F %d\n", e->src, e->pos);
+	}
 }
 
 void edges_dump_kind(ir_graph *irg, ir_edge_kind_t kind)
@@ -198,13 +284,7 @@ void edges_dump_kind(ir_graph *irg, ir_edge_kind_t kind)
 	if (!edges_activated_kind(irg, kind))
 		return;
 
-	irg_edge_info_t       *info  = get_irg_edge_info(irg, kind);
-	ir_edgeset_t          *edges = &info->edges;
-	ir_edge_t             *e;
-	ir_edgeset_iterator_t  iter;
-	foreach_ir_edgeset(edges, e, iter) {
-		ir_printf("%+F %d\n", e->src, e->pos);
-	}
+	irg_walk_graph(irg, dump_edges_walker, NULL, &kind);
 }
 
 static void add_edge(ir_node *src, int pos, ir_node *tgt, ir_edge_kind_t kind,
@@ -213,34 +293,12 @@ static void add_edge(ir_node *src, int pos, ir_node *tgt, ir_edge_kind_t kind,
 	if (tgt == NULL)
 		return;
 	assert(edges_activated_kind(irg, kind));
-	irg_edge_info_t *info  = get_irg_edge_info(irg, kind);
-	ir_edgeset_t    *edges = &info->edges;
-
-	irn_edge_info_t  *tgt_info = get_irn_edge_info(tgt, kind);
-	struct list_head *head     = &tgt_info->outs_head;
-	assert(head->next && head->prev &&
-	       "target list head must have been initialized");
+	irg_edge_info_t *info     = get_irg_edge_info(irg, kind);
+	irn_edge_info_t *tgt_info = get_irn_edge_info(tgt, kind);
+	assert(tgt_info->outs != NULL && "target edges must have been initialized");
 
 	/* The old target was NULL, thus, the edge is newly created. */
-	ir_edge_t *edge;
-	if (list_empty(&info->free_edges)) {
-		edge = OALLOC(&info->edges_obst, ir_edge_t);
-	} else {
-		edge = list_entry(info->free_edges.next, ir_edge_t, list);
-		list_del(&edge->list);
-	}
-
-	edge->src     = src;
-	edge->pos     = pos;
-#ifdef DEBUG_libfirm
-	edge->present = false;
-#endif
-
-	ir_edge_t *new_edge = ir_edgeset_insert(edges, edge);
-	assert(new_edge == edge);
-
-	list_add(&new_edge->list, head);
-	edge_change_cnt(tgt_info, +1);
+	push_edge(info, tgt_info, src, pos, kind);
 }
 
 static void delete_edge(ir_node *src, int pos, ir_node *old_tgt,
@@ -249,29 +307,14 @@ static void delete_edge(ir_node *src, int pos, ir_node *old_tgt,
 	if (old_tgt == NULL)
 		return;
 	assert(edges_activated_kind(irg, kind));
+	(void)irg;
 
-	irg_edge_info_t *info  = get_irg_edge_info(irg, kind);
-	ir_edgeset_t    *edges = &info->edges;
-
-	/* Initialize the edge template to search in the set. */
-	ir_edge_t templ;
-	templ.src = src;
-	templ.pos = pos;
-
-	/* search the edge in the set. */
-	ir_edge_t *edge = ir_edgeset_find(edges, &templ);
-
-	/* mark the edge invalid if it was found */
-	if (edge == NULL)
+	irn_edge_info_t *old_tgt_info = get_irn_edge_info(old_tgt, kind);
+	int const        idx          = find_edge(old_tgt_info, src, pos, kind);
+	if (idx < 0)
 		return;
 
-	list_del(&edge->list);
-	ir_edgeset_remove(edges, edge);
-	list_add(&edge->list, &info->free_edges);
-	edge->pos = -2;
-	edge->src = NULL;
-	irn_edge_info_t *old_tgt_info = get_irn_edge_info(old_tgt, kind);
-	edge_change_cnt(old_tgt_info, -1);
+	pop_edge(old_tgt_info, idx, kind);
 }
 
 static void edges_notify_edge_kind(ir_node *src, int pos, ir_node *tgt, ir_node *old_tgt, ir_edge_kind_t kind, ir_graph *irg)
@@ -289,38 +332,24 @@ static void edges_notify_edge_kind(ir_node *src, int pos, ir_node *tgt, ir_node
 	if (tgt == old_tgt)
 		return;
 
-	irg_edge_info_t *info  = get_irg_edge_info(irg, kind);
-	ir_edgeset_t    *edges = &info->edges;
-
 	/* The target is not NULL and the old target differs
 	 * from the new target, the edge shall be moved (if the
 	 * old target was != NULL) or added (if the old target was
 	 * NULL). */
-	irn_edge_info_t  *tgt_info = get_irn_edge_info(tgt, kind);
-	struct list_head *head     = &tgt_info->outs_head;
-	assert(head->next && head->prev &&
-	       "target list head must have been initialized");
-
-	/* Initialize the edge template to search in the set. */
-	ir_edge_t templ;
-	templ.src = src;
-	templ.pos = pos;
-
-	ir_edge_t *edge = ir_edgeset_find(edges, &templ);
-	assert(edge && "edge to redirect not found!");
-
-	list_move(&edge->list, head);
 	irn_edge_info_t *old_tgt_info = get_irn_edge_info(old_tgt, kind);
-	edge_change_cnt(old_tgt_info, -1);
-	edge_change_cnt(tgt_info,     +1);
+	int const        idx          = find_edge(old_tgt_info, src, pos, kind);
+	assert(idx >= 0 && "edge to redirect not found!");
+	pop_edge(old_tgt_info, idx, kind);
+
+	irg_edge_info_t *info     = get_irg_edge_info(irg, kind);
+	irn_edge_info_t *tgt_info = get_irn_edge_info(tgt, kind);
+	push_edge(info, tgt_info, src, pos, kind);
 
 #ifndef DEBUG_libfirm
-	/* verify list heads */
+	/* verify out vectors */
 	if (edges_dbg) {
-		if (tgt)
-			verify_list_head(tgt, kind);
-		if (old_tgt)
-			verify_list_head(old_tgt, kind);
+		verify_out_vector(tgt, kind);
+		verify_out_vector(old_tgt, kind);
 	}
 #endif
 }
@@ -386,6 +415,19 @@ static void edges_node_deleted_kind(ir_node *old, ir_edge_kind_t kind)
 		ir_node *old_tgt = get_n(old, i, kind);
 		delete_edge(old, i, old_tgt, kind, irg);
 	}
+
+	/* recycle the edge arrays of the node */
+	irg_edge_info_t *irg_info = get_irg_edge_info(irg, kind);
+	irn_edge_info_t *info     = get_irn_edge_info(old, kind);
+	if (info->in_idx != NULL) {
+		free_array(irg_info, info->in_idx, info->in_log + 2);
+		info->in_idx = NULL;
+	}
+	if (info->out_count == 0 && info->outs != &info->inline_out) {
+		free_array(irg_info, info->outs, info->out_log + 4);
+		info->outs    = &info->inline_out;
+		info->out_log = 0;
+	}
 }
 
 /**
@@ -438,17 +480,17 @@ static void build_edges_walker(ir_node *irn, void *data)
 }
 
 /**
- * Pre-Walker: initializes the list-heads and set the out-count
- * of all nodes to 0.
+ * Pre-Walker: initializes the out edge vectors of all nodes to be empty.
  */
 static void init_lh_walker(ir_node *irn, void *data)
 {
 	build_walker   *w    = (build_walker*)data;
 	ir_edge_kind_t  kind = w->kind;
-	list_head      *head = &get_irn_edge_info(irn, kind)->outs_head;
-	INIT_LIST_HEAD(head);
-	get_irn_edge_info(irn, kind)->edges_built = 0;
-	get_irn_edge_info(irn, kind)->out_count   = 0;
+	if (kind == EDGE_KIND_BLOCK && !is_Block(irn))
+		return;
+	irn_edge_info_t *info = get_irn_edge_info(irn, kind);
+	init_irn_edge_info(info);
+	info->edges_built = 0;
 }
 
 void edges_activate_kind(ir_graph *irg, ir_edge_kind_t kind)
@@ -498,7 +540,6 @@ void edges_deactivate_kind(ir_graph *irg, ir_edge_kind_t kind)
 	info->activated = 0;
 	if (info->allocated) {
 		obstack_free(&info->edges_obst, NULL);
-		ir_edgeset_destroy(&info->edges);
 		info->allocated = 0;
 	}
 	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
@@ -520,14 +561,14 @@ void edges_reroute_kind(ir_node *from, ir_node *to, ir_edge_kind_t kind)
 	set_edge_func_t *set_edge = edge_kind_info[kind].set_edge;
 
 	if (set_edge && edges_activated_kind(irg, kind)) {
-		struct list_head *head = &get_irn_edge_info(from, kind)->outs_head;
+		irn_edge_info_t const *const info = get_irn_edge_info(from, kind);
 
 		DBG((dbg, LEVEL_5, "reroute from %+F to %+F\n", from, to));
 
-		while (head != head->next) {
-			ir_edge_t *edge = list_entry(head->next, ir_edge_t, list);
-			assert(edge->pos >= -1);
-			set_edge(edge->src, edge->pos, to);
+		while (info->out_count != 0) {
+			ir_edge_t const edge = info->outs[info->out_count - 1];
+			assert(edge.pos >= -1);
+			set_edge(edge.src, edge.pos, to);
 		}
 	}
 }
@@ -549,21 +590,16 @@ void edges_reroute_except(ir_node *from, ir_node *to, ir_node *exception)
 
 static void verify_set_presence(ir_node *irn, void *data)
 {
-	build_walker *w     = (build_walker*)data;
-	ir_graph     *irg   = get_irn_irg(irn);
-	ir_edgeset_t *edges = &get_irg_edge_info(irg, w->kind)->edges;
+	build_walker *w = (build_walker*)data;
+
+	if (w->kind == EDGE_KIND_BLOCK && !is_Block(irn))
+		return;
 
 	foreach_tgt(irn, i, n, w->kind) {
-		ir_edge_t  templ = { .src = irn, .pos = i };
-		ir_edge_t *e     = ir_edgeset_find(edges, &templ);
-		ir_node   *dst   = get_n(irn, i, w->kind);
+		ir_node *dst = get_n(irn, i, w->kind);
 		if (dst == NULL)
 			continue;
-		if (e != NULL) {
-#ifdef DEBUG_libfirm
-			e->present = true;
-#endif
-		} else {
+		if (find_edge(get_irn_edge_info(dst, w->kind), irn, i, w->kind) < 0) {
 			w->fine = false;
 			ir_fprintf(stderr, "Edge Verifier: %+F,%d is missing\n",
 			           irn, i);
@@ -575,10 +611,14 @@ static void verify_list_presence(ir_node *irn, void *data)
 {
 	build_walker *w = (build_walker*)data;
 
+	if (w->kind == EDGE_KIND_BLOCK && !is_Block(irn))
+		return;
+
 	bitset_set(w->reachable, get_irn_idx(irn));
 
-	/* check list heads */
-	verify_list_head(irn, w->kind);
+	/* check the out vector */
+	if (!verify_out_vector(irn, w->kind))
+		w->fine = false;
 
 	foreach_out_edge_kind(irn, e, w->kind) {
 		if (w->kind == EDGE_KIND_NORMAL && get_irn_arity(e->src) <= e->pos) {
@@ -599,36 +639,12 @@ static void verify_list_presence(ir_node *irn, void *data)
 
 int edges_verify_kind(ir_graph *irg, ir_edge_kind_t kind)
 {
-	struct build_walker    w     = { .kind      = kind,
-	                                 .reachable = bitset_alloca(get_irg_last_idx(irg)),
-	                                 .fine      = true };
-
-#ifdef DEBUG_libfirm
-	ir_edgeset_t          *edges = &get_irg_edge_info(irg, kind)->edges;
-	ir_edge_t             *e;
-	ir_edgeset_iterator_t iter;
-	/* Clear the present bit in all edges available. */
-	foreach_ir_edgeset(edges, e, iter) {
-		e->present = false;
-	}
-#endif
+	struct build_walker w = { .kind      = kind,
+	                          .reachable = bitset_alloca(get_irg_last_idx(irg)),
+	                          .fine      = true };
 
 	irg_walk_graph(irg, verify_set_presence, verify_list_presence, &w);
 
-#ifdef DEBUG_libfirm
-	/*
-	 * Dump all edges which are not invalid and not present.
-	 * These edges are superfluous and their presence in the
-	 * edge set is wrong.
-	 */
-	foreach_ir_edgeset(edges, e, iter) {
-		if (! e->present && bitset_is_set(w.reachable, get_irn_idx(e->src))) {
-			w.fine = false;
-			ir_fprintf(stderr, "Edge Verifier: edge(%ld) %+F,%d is superfluous\n", edge_get_id(e), e->src, e->pos);
-		}
-	}
-#endif
-
 	return w.fine;
 }
 
@@ -674,12 +690,9 @@ static void verify_edge_counter(ir_node *irn, void *env)
 	bitset_t *bs       = ir_nodemap_get(bitset_t, &usermap, irn);
 	int       list_cnt = 0;
 	int       edge_cnt = get_irn_edge_info(irn, EDGE_KIND_NORMAL)->out_count;
-	const struct list_head *head
-		= &get_irn_edge_info(irn, EDGE_KIND_NORMAL)->outs_head;
 
-	/* We can iterate safely here, list heads have already been verified. */
-	const struct list_head *pos;
-	list_for_each(pos, head) {
+	/* We can iterate safely here, out vectors have already been verified. */
+	foreach_out_edge(irn, edge) {
 		++list_cnt;
 	}
 
@@ -822,6 +835,22 @@ int (get_irn_n_edges)(const ir_node *irn)
 	return get_irn_n_edges_kind_(irn, EDGE_KIND_NORMAL);
 }
 
+/**
+ * Returns the source of the out edge of @p node below index @p *i and lowers
+ * @p *i, or NULL if there is none.
+ * The walker callbacks may change arbitrary edges, which the contract of
+ * foreach_out_edge_safe() does not allow, so the walkers hold an index
+ * instead of an edge: an edge moved by a removal is at worst visited twice,
+ * which the visited flags absorb.
+ */
+static ir_node *get_walk_succ(ir_node const *const node,
+                              ir_edge_kind_t const kind, unsigned *const i)
+{
+	irn_edge_info_t const *const info = get_irn_edge_info_const(node, kind);
+	*i = MIN(*i, info->out_count);
+	return *i == 0 ? NULL : info->outs[--*i].src;
+}
+
 static void irg_walk_edges2(ir_node *node, irg_walk_func *pre,
                             irg_walk_func *post, void *env)
 {
@@ -831,11 +860,10 @@ static void irg_walk_edges2(ir_node *node, irg_walk_func *pre,
 	if (pre != NULL)
 		pre(node, env);
 
-	foreach_out_edge_safe(node, edge) {
-		/* find the corresponding successor block. */
-		ir_node *pred = get_edge_src_irn(edge);
-		assert(pred != NULL && "edge deleted while iterating?");
-		irg_walk_edges2(pred, pre, post, env);
+	ir_node *succ;
+	for (unsigned i = UINT_MAX;
+	     (succ = get_walk_succ(node, EDGE_KIND_NORMAL, &i)) != NULL;) {
+		irg_walk_edges2(succ, pre, post, env);
 	}
 
 	if (post != NULL)
@@ -867,10 +895,10 @@ static void irg_block_edges_walk2(ir_node *bl, irg_walk_func *pre,
 		if (pre)
 			pre(bl, env);
 
-		foreach_block_succ_safe(bl, edge) {
-			/* find the corresponding successor block. */
-			ir_node *pred = get_edge_src_irn(edge);
-			irg_block_edges_walk2(pred, pre, post, env);
+		ir_node *succ;
+		for (unsigned i = UINT_MAX;
+		     (succ = get_walk_succ(bl, EDGE_KIND_BLOCK, &i)) != NULL;) {
+			irg_block_edges_walk2(succ, pre, post, env);
 		}
 
 		if (post)
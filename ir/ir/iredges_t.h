@@ -13,9 +13,7 @@
 #define FIRM_IR_EDGES_T_H
 
 #include <stdbool.h>
-
-#include "set.h"
-#include "list.h"
+#include <stdint.h>
 
 #include "irnode_t.h"
 #include "irgraph_t.h"
@@ -33,30 +31,41 @@
 #define get_block_succ_next(irn, last)    get_irn_out_edge_next_(irn, last, EDGE_KIND_BLOCK)
 
 /**
- * An edge.
+ * Accessor for private irn info. Only blocks have control flow edges, so their
+ * info is stored in the block attributes.
  */
-struct ir_edge_t {
-	ir_node *src;         /**< The source node of the edge. */
-	int      pos;         /**< The position of the edge at @p src. */
-#ifdef DEBUG_libfirm
-	bool     present : 1; /**< Used by the verifier. */
-#endif
-	struct list_head list;  /**< The list head to queue all out edges at a node. */
-};
-
-/** Accessor for private irn info. */
 static inline irn_edge_info_t *get_irn_edge_info(ir_node *node,
                                                  ir_edge_kind_t kind)
 {
 	assert(edges_activated_kind(get_irn_irg(node), kind));
-	return &node->edge_info[kind];
+	if (kind == EDGE_KIND_BLOCK) {
+		assert(is_Block(node));
+		return &node->attr.block.succ_edges;
+	}
+	return &node->edge_info;
 }
 
 static inline const irn_edge_info_t *get_irn_edge_info_const(
 		const ir_node *node, ir_edge_kind_t kind)
 {
 	assert(edges_activated_kind(get_irn_irg(node), kind));
-	return &node->edge_info[kind];
+	if (kind == EDGE_KIND_BLOCK) {
+		assert(is_Block(node));
+		return &node->attr.block.succ_edges;
+	}
+	return &node->edge_info;
+}
+
+/** Returns the number of out edges fitting into the vector of a node. */
+static inline unsigned get_irn_out_capacity(irn_edge_info_t const *const info)
+{
+	return 1U << info->out_log;
+}
+
+/** Returns the number of inputs a node has an edge index for. */
+static inline unsigned get_irn_in_capacity(irn_edge_info_t const *const info)
+{
+	return info->in_idx != NULL ? 1U << info->in_log : 0;
 }
 
 /** Accessor for private irg info. */
@@ -82,22 +91,41 @@ static inline const irg_edge_info_t *get_irg_edge_info_const(
  */
 static inline const ir_edge_t *get_irn_out_edge_first_kind_(const ir_node *irn, ir_edge_kind_t kind)
 {
-	struct list_head const *const head = &get_irn_edge_info_const(irn, kind)->outs_head;
-	return list_empty(head) ? NULL : list_entry(head->next, ir_edge_t, list);
+	irn_edge_info_t const *const info = get_irn_edge_info_const(irn, kind);
+	return info->out_count == 0 ? NULL : &info->outs[info->out_count - 1];
 }
 
 /**
  * Get the next edge in the out list of some node.
+ * The edges are visited from the back of the vector, so removing the current
+ * edge (which moves the last edge into its slot) does not disturb the
+ * iteration.  If the vector was reallocated since @p last was handed out, its
+ * position is recovered via the index recorded at the source node, which
+ * requires that @p last was not changed since (see foreach_out_edge_safe()).
  * @param irn The node.
  * @param last The last out edge you have seen.
  * @return The next out edge in @p irn 's out list after @p last.
  */
 static inline const ir_edge_t *get_irn_out_edge_next_(const ir_node *irn, const ir_edge_t *last, ir_edge_kind_t kind)
 {
-	struct list_head *next = last->list.next;
-	const struct list_head *head
-		= &get_irn_edge_info_const(irn, kind)->outs_head;
-	return next == head ? NULL : list_entry(next, ir_edge_t, list);
+	irn_edge_info_t const *const info = get_irn_edge_info_const(irn, kind);
+	uintptr_t              const ofs  = (uintptr_t)last - (uintptr_t)info->outs;
+	size_t                       idx;
+	if (ofs < get_irn_out_capacity(info) * sizeof(*last)) {
+		idx = ofs / sizeof(*last);
+	} else {
+		irn_edge_info_t const *const src_info
+			= get_irn_edge_info_const(last->src, kind);
+		unsigned const in = last->pos + 1;
+		idx = in < get_irn_in_capacity(src_info) ? src_info->in_idx[in] : 0;
+		/* only valid if the edge was neither removed nor redirected */
+		assert(idx < info->out_count && info->outs[idx].src == last->src
+		       && info->outs[idx].pos == last->pos
+		       && "unvisited out edge changed while iterating");
+	}
+	if (idx > info->out_count)
+		idx = info->out_count;
+	return idx == 0 ? NULL : &info->outs[idx - 1];
 }
 
 /**
@@ -20,11 +20,13 @@
 #include "irgwalk.h"
 #include "irhooks.h"
 #include "irmemory.h"
+#include "irmemssa.h"
 #include "irnode_t.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
 #include "irouts.h"
 #include "irprog_t.h"
+#include "irscev.h"
 #include "irtools.h"
 #include "type_t.h"
 #include "util.h"
@@ -595,6 +597,8 @@ void assure_irg_properties(ir_graph *irg, ir_graph_properties_t props)
 		{ IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO,      assure_loopinfo },
 		{ IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE,  assure_irg_entity_usage_computed },
 		{ IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE_FRONTIERS, ir_compute_dominance_frontiers },
+		{ IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA,        assure_irg_memssa },
+		{ IR_GRAPH_PROPERTY_CONSISTENT_SCEV,          assure_irg_scev },
 	};
 	for (size_t i = 0; i < ARRAY_SIZE(property_functions); ++i) {
 		ir_graph_properties_t missing = props & ~irg->properties;
@@ -616,4 +620,8 @@ void confirm_irg_properties(ir_graph *irg, ir_graph_properties_t props)
 		set_irp_globals_entity_usage_state(ir_entity_usage_not_computed);
 	if (!(props & IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE_FRONTIERS))
 		ir_free_dominance_frontiers(irg);
+	if (!(props & IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA))
+		free_irg_memssa(irg);
+	if (!(props & IR_GRAPH_PROPERTY_CONSISTENT_SCEV))
+		free_irg_scev(irg);
 }
@@ -16,7 +16,6 @@
 #include "entity_t.h"
 #include "firm_types.h"
 #include "iredgekinds.h"
-#include "iredgeset.h"
 #include "irloop.h"
 #include "irnodemap.h"
 #include "irprog.h"
@@ -73,11 +72,10 @@
  * Edge info to put into an irg.
  */
 typedef struct irg_edge_info_t {
-	ir_edgeset_t     edges;          /**< A set containing all edges of the current graph. */
-	struct list_head free_edges;     /**< list of all free edges. */
-	struct obstack   edges_obst;     /**< Obstack, where edges are allocated on. */
-	unsigned         allocated : 1;  /**< Set if edges are allocated on the obstack. */
-	unsigned         activated : 1;  /**< Set if edges are activated for the graph. */
+	struct obstack   edges_obst;      /**< Arena for the edge vectors. */
+	void            *free_arrays[32]; /**< Free edge arrays by log2 of their size. */
+	unsigned         allocated : 1;   /**< Set if edges are allocated on the obstack. */
+	unsigned         activated : 1;   /**< Set if edges are activated for the graph. */
 } irg_edge_info_t;
 
 typedef irg_edge_info_t irg_edges_info_t[EDGE_KIND_LAST+1];
@@ -153,6 +151,10 @@ struct ir_graph {
 	unsigned           *callee_isbe; /**< Callgraph: bitset if backedge info is
 	                                      calculated. */
 	ir_loop            *l;           /**< For callgraph analysis. */
+	struct inline_summary_t *inline_summary; /**< Inliner: cached graph summary,
+	                                              see opt_inline.c. */
+	struct ir_memssa_t *memssa;  /**< memory SSA, see irmemssa.h */
+	struct ir_scev_t   *scev;    /**< scalar evolutions, see irscev.h */
 
 #ifdef DEBUG_libfirm
 	/** Unique graph number for each graph to make output readable. */
@@ -250,6 +250,7 @@ static void symtbl_init(void)
 	INSERTENUM(tt_initializer, IR_INITIALIZER_TARVAL);
 	INSERTENUM(tt_initializer, IR_INITIALIZER_NULL);
 	INSERTENUM(tt_initializer, IR_INITIALIZER_COMPOUND);
+	INSERTENUM(tt_initializer, IR_INITIALIZER_BLOB);
 
 	INSERT(tt_mode_arithmetic, "none",               irma_none);
 	INSERT(tt_mode_arithmetic, "twos_complement",    irma_twos_complement);
@@ -344,13 +345,24 @@ void write_symbol(write_env_t *env, const char *symbol)
 	fputc(' ', env->file);
 }
 
+static void write_type_signature(write_env_t *env, ir_type *type);
+static void write_entity_signature(write_env_t *env, ir_entity *entity);
+
 void write_entity_ref(write_env_t *env, ir_entity *entity)
 {
+	if (env->canonical_nrs != NULL) {
+		write_entity_signature(env, entity);
+		return;
+	}
 	write_long(env, get_entity_nr(entity));
 }
 
 void write_type_ref(write_env_t *env, ir_type *type)
 {
+	if (env->canonical_nrs != NULL) {
+		write_type_signature(env, type);
+		return;
+	}
 	switch (get_type_opcode(type)) {
 	case tpo_unknown:
 		write_symbol(env, "unknown");
@@ -468,9 +480,44 @@ static void write_scope_end(write_env_t *env)
 	fputs("}\n\n", env->file);
 }
 
+/**
+ * Returns the canonical number of @p elem. Elements are numbered in the order
+ * they are first referenced, which only depends on the graph structure and
+ * not on the order the elements were created in.
+ */
+static long get_canonical_nr(write_env_t *env, void const *elem)
+{
+	void *const nr = pmap_get(void, env->canonical_nrs, elem);
+	if (nr != NULL)
+		return PTR_TO_INT(nr);
+	long const new_nr = ++env->next_canonical_nr;
+	pmap_insert(env->canonical_nrs, elem, INT_TO_PTR(new_nr));
+	return new_nr;
+}
+
+static long get_node_write_nr(write_env_t *env, const ir_node *node)
+{
+	if (env->canonical_nrs != NULL)
+		return get_canonical_nr(env, node);
+	return get_irn_node_nr(node);
+}
+
 void write_node_ref(write_env_t *env, const ir_node *node)
 {
-	write_long(env, get_irn_node_nr(node));
+	write_long(env, get_node_write_nr(env, node));
+}
+
+/** Writes the bytes of a blob initializer as size and a word of hex digits. */
+static void write_blob(write_env_t *env, ir_initializer_t const *ini)
+{
+	size_t const n = get_initializer_blob_size(ini);
+	write_size_t(env, n);
+	if (n == 0)
+		return;
+	unsigned char const *const data = get_initializer_blob_data(ini);
+	for (size_t i = 0; i < n; ++i)
+		fprintf(env->file, "%02x", data[i]);
+	fputc(' ', env->file);
 }
 
 void write_initializer(write_env_t *const env,
@@ -501,6 +548,10 @@ void write_initializer(write_env_t *const env,
 			write_initializer(env, get_initializer_compound_value(ini, i));
 		return;
 	}
+
+	case IR_INITIALIZER_BLOB:
+		write_blob(env, ini);
+		return;
 	}
 	panic("unknown initializer kind");
 }
@@ -665,6 +716,167 @@ static void write_type(write_env_t *env, ir_type *tp)
 	panic("can't write invalid type %+F", tp);
 }
 
+/**
+ * Writes a description of @p type which only depends on its structure and
+ * name. Compound types are described by name and layout only, which keeps
+ * the description finite for recursive types.
+ */
+static void write_type_signature(write_env_t *env, ir_type *type)
+{
+	tp_opcode const opcode = get_type_opcode(type);
+	write_symbol(env, get_type_opcode_name(opcode));
+	switch (opcode) {
+	case tpo_unknown:
+	case tpo_code:
+	case tpo_uninitialized:
+		return;
+
+	case tpo_primitive:
+		write_mode_ref(env, get_type_mode(type));
+		return;
+
+	case tpo_pointer:
+		write_type_signature(env, get_pointer_points_to_type(type));
+		return;
+
+	case tpo_array:
+		write_unsigned(env, get_array_size(type));
+		write_type_signature(env, get_array_element_type(type));
+		return;
+
+	case tpo_method: {
+		size_t const n_params  = get_method_n_params(type);
+		size_t const n_results = get_method_n_ress(type);
+		write_unsigned(env, get_method_calling_convention(type));
+		write_unsigned(env, get_method_additional_properties(type));
+		write_unsigned(env, is_method_variadic(type));
+		write_size_t(env, n_params);
+		for (size_t i = 0; i < n_params; ++i)
+			write_type_signature(env, get_method_param_type(type, i));
+		write_size_t(env, n_results);
+		for (size_t i = 0; i < n_results; ++i)
+			write_type_signature(env, get_method_res_type(type, i));
+		return;
+	}
+
+	case tpo_struct:
+	case tpo_union:
+	case tpo_class:
+	case tpo_segment:
+		if (!is_frame_type(type))
+			write_ident_null(env, get_compound_ident(type));
+		write_unsigned(env, get_type_size(type));
+		write_unsigned(env, get_type_alignment(type));
+		return;
+	}
+	panic("can't write invalid type %+F", type);
+}
+
+/**
+ * Writes a description of the value of a constant initializer. Only the
+ * shape of the initializer and the values it is built from are written.
+ */
+static void write_initializer_signature(write_env_t *env,
+                                        ir_initializer_t const *ini)
+{
+	ir_initializer_kind_t const kind = get_initializer_kind(ini);
+	write_symbol(env, get_initializer_kind_name(kind));
+	switch (kind) {
+	case IR_INITIALIZER_CONST: {
+		ir_node *const value = get_initializer_const_value(ini);
+		write_symbol(env, get_irn_opname(value));
+		write_mode_ref(env, get_irn_mode(value));
+		if (is_Const(value))
+			write_tarval_ref(env, get_Const_tarval(value));
+		else if (is_Address(value))
+			write_entity_signature(env, get_Address_entity(value));
+		return;
+	}
+	case IR_INITIALIZER_TARVAL:
+		write_tarval_ref(env, get_initializer_tarval_value(ini));
+		return;
+	case IR_INITIALIZER_NULL:
+		return;
+	case IR_INITIALIZER_COMPOUND: {
+		size_t const n = get_initializer_compound_n_entries(ini);
+		write_size_t(env, n);
+		for (size_t i = 0; i < n; ++i)
+			write_initializer_signature(env,
+				get_initializer_compound_value(ini, i));
+		return;
+	}
+	case IR_INITIALIZER_BLOB:
+		write_blob(env, ini);
+		return;
+	}
+	panic("unknown initializer kind");
+}
+
+/**
+ * Writes a description of @p entity which identifies it independently of
+ * entity numbers: global entities by linker name, members by owner, name and
+ * offset, parameters by number and labels and frame entities by the order in
+ * which they are first referenced.
+ */
+static void write_entity_signature(write_env_t *env, ir_entity *entity)
+{
+	switch (get_entity_kind(entity)) {
+	case IR_ENTITY_LABEL:
+		write_symbol(env, "label");
+		write_long(env, get_canonical_nr(env, entity));
+		return;
+	case IR_ENTITY_UNKNOWN:
+		write_symbol(env, "unknown");
+		return;
+	case IR_ENTITY_PARAMETER: {
+		write_symbol(env, "parameter");
+		size_t const num = get_entity_parameter_number(entity);
+		if (num == IR_VA_START_PARAMETER_NUMBER)
+			write_symbol(env, "va_start");
+		else
+			write_size_t(env, num);
+		break;
+	}
+	case IR_ENTITY_COMPOUND_MEMBER: {
+		ir_type *const owner = get_entity_owner(entity);
+		if (is_frame_type(owner)) {
+			/* locals of different scopes may share their name and have no
+			 * offset before the frame is laid out */
+			write_symbol(env, "frame");
+			write_long(env, get_canonical_nr(env, entity));
+		} else {
+			write_symbol(env, "compound_member");
+			write_type_signature(env, owner);
+		}
+		write_ident_null(env, get_entity_ident(entity));
+		write_long(env, get_entity_offset(entity));
+		write_unsigned(env, get_entity_bitfield_offset(entity));
+		write_unsigned(env, get_entity_bitfield_size(entity));
+		break;
+	}
+	case IR_ENTITY_ALIAS:
+	case IR_ENTITY_METHOD:
+	case IR_ENTITY_NORMAL:
+		write_symbol(env, "global");
+		write_ident_null(env, get_entity_ld_ident(entity));
+		write_visibility(env, get_entity_visibility(entity));
+		write_unsigned(env, get_entity_linkage(entity));
+		break;
+	case IR_ENTITY_SPILLSLOT:
+		panic("Unexpected entity %+F", entity);
+	}
+	write_volatility(env, get_entity_volatility(entity));
+	write_type_signature(env, get_entity_type(entity));
+
+	/* the contents of constants may have been folded into the graph */
+	if (get_entity_kind(entity) == IR_ENTITY_NORMAL
+	 && (get_entity_linkage(entity) & IR_LINKAGE_CONSTANT)) {
+		ir_initializer_t const *const init = get_entity_initializer(entity);
+		if (init != NULL)
+			write_initializer_signature(env, init);
+	}
+}
+
 static void write_entity(write_env_t *env, ir_entity *ent)
 {
 	ir_type       *type       = get_entity_type(ent);
@@ -802,7 +1014,7 @@ void write_pred_refs(write_env_t *env, const ir_node *node, int from)
 
 void write_node_nr(write_env_t *env, const ir_node *node)
 {
-	write_long(env, get_irn_node_nr(node));
+	write_long(env, get_node_write_nr(env, node));
 }
 
 static void write_ASM(write_env_t *env, const ir_node *node)
@@ -1104,6 +1316,23 @@ void ir_export_file(FILE *file)
 	deq_free(&env->write_queue);
 }
 
+void ir_export_irg_canonical(FILE *file, ir_graph *irg)
+{
+	write_env_t env;
+	memset(&env, 0, sizeof(env));
+	env.file          = file;
+	env.canonical_nrs = pmap_create();
+	deq_init(&env.write_queue);
+	deq_init(&env.entity_queue);
+
+	writers_init();
+	write_irg(&env, irg);
+
+	deq_free(&env.entity_queue);
+	deq_free(&env.write_queue);
+	pmap_destroy(env.canonical_nrs);
+}
+
 
 
 static void read_c(read_env_t *env)
@@ -1567,6 +1796,39 @@ ir_switch_table *read_switch_table_ref(read_env_t *env)
 	return table;
 }
 
+static int read_hex_digit(read_env_t *env, char c)
+{
+	if ('0' <= c && c <= '9')
+		return c - '0';
+	if ('a' <= c && c <= 'f')
+		return c - 'a' + 10;
+	parse_error(env, "Expected hex digit, got '%c'\n", c);
+	return 0;
+}
+
+static ir_initializer_t *read_blob(read_env_t *env)
+{
+	size_t n = read_size_t(env);
+	if (n == 0)
+		return create_initializer_blob_ref(NULL, 0);
+
+	/* decode the hex digits in place */
+	char *str = read_word(env);
+	if (strlen(str) != 2 * n) {
+		parse_error(env, "Expected %zu bytes of blob data\n", n);
+		obstack_free(&env->obst, str);
+		return get_initializer_null();
+	}
+	unsigned char *data = (unsigned char*)str;
+	for (size_t i = 0; i < n; ++i) {
+		data[i] = read_hex_digit(env, str[2 * i]) << 4
+		        | read_hex_digit(env, str[2 * i + 1]);
+	}
+	ir_initializer_t *ini = create_initializer_blob(data, n);
+	obstack_free(&env->obst, str);
+	return ini;
+}
+
 static ir_initializer_t *read_initializer(read_env_t *env)
 {
 	ir_initializer_kind_t ini_kind = read_initializer_kind(env);
@@ -1600,6 +1862,9 @@ static ir_initializer_t *read_initializer(read_env_t *env)
 		}
 		return ini;
 	}
+
+	case IR_INITIALIZER_BLOB:
+		return read_blob(env);
 	}
 
 	panic("unknown initializer kind");
@@ -6,6 +6,7 @@
 #include "irnode_t.h"
 #include "obst.h"
 #include "pdeq.h"
+#include "pmap.h"
 #include "set.h"
 #include "type_t.h"
 #include "typerep.h"
@@ -43,6 +44,9 @@ typedef struct write_env_t {
 	FILE *file;
 	deq_t write_queue;
 	deq_t entity_queue;
+	pmap *canonical_nrs;     /**< node numbers in walk order, only set when
+	                              writing the canonical form of a graph */
+	long  next_canonical_nr;
 } write_env_t;
 
 void write_align(write_env_t *env, ir_align align);
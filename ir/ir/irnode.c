@@ -102,11 +102,13 @@ ir_node *new_ir_node(dbg_info *db, ir_graph *irg, ir_node *block, ir_op *op,
 	set_irn_dbg_info(res, db);
 	res->node_nr = get_irp_new_node_nr();
 
-	for (ir_edge_kind_t i = EDGE_KIND_FIRST; i <= EDGE_KIND_LAST; ++i) {
-		INIT_LIST_HEAD(&res->edge_info[i].outs_head);
-		/* Edges will be built immediately. */
-		res->edge_info[i].edges_built = 1;
-		res->edge_info[i].out_count = 0;
+	/* Edges will be built immediately. */
+	res->edge_info.outs        = &res->edge_info.inline_out;
+	res->edge_info.edges_built = 1;
+	if (op == op_Block) {
+		irn_edge_info_t *const succ_edges = &res->attr.block.succ_edges;
+		succ_edges->outs        = &succ_edges->inline_out;
+		succ_edges->edges_built = 1;
 	}
 
 	/* don't put this into the for loop, arity is -1 for some nodes! */
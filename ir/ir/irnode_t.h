@@ -85,6 +85,32 @@ struct ir_switch_table {
 	ir_switch_table_entry entries[];
 };
 
+/**
+ * An out edge: input @p pos of @p src uses the node.
+ */
+struct ir_edge_t {
+	ir_node *src; /**< The source node of the edge. */
+	int      pos; /**< The position of the edge at @p src. */
+};
+
+/**
+ * Edge info to put into an irn.
+ * The out edges of a node form a contiguous vector.  The first one is stored
+ * inline, larger vectors are allocated in the edge arena of the graph.  For
+ * each input the index of its edge in the vector of the input is recorded, so
+ * an edge is found and removed in constant time.
+ */
+typedef struct irn_edge_kind_info_t {
+	ir_edge_t *outs;            /**< The out edges. */
+	unsigned  *in_idx;          /**< Index of the edge of input pos in the outs
+	                                 of that input, at pos + 1. */
+	unsigned   out_count;       /**< Number of out edges. */
+	unsigned   out_log     : 5; /**< log2 of the capacity of outs. */
+	unsigned   in_log      : 5; /**< log2 of the capacity of in_idx. */
+	unsigned   edges_built : 1; /**< Set edges where built for this node. */
+	ir_edge_t  inline_out;      /**< Storage for a single out edge. */
+} irn_edge_info_t;
+
 /** Attributes for Block nodes. */
 typedef struct block_attr {
 	ir_visited_t block_visited; /**< Visited flag for block walker. */
@@ -98,6 +124,8 @@ typedef struct block_attr {
 	ir_entity  *entity;         /**< entity representing this block */
 	ir_node    *phis;           /**< The list of Phi nodes in this block. */
 	double      execfreq;       /**< block execution frequency */
+	ir_loop    *loop;           /**< innermost loop containing this block */
+	irn_edge_info_t succ_edges; /**< Everlasting control flow out edges. */
 } block_attr;
 
 /** Attributes for Cond nodes. */
@@ -142,6 +170,7 @@ typedef struct call_attr {
 	except_attr exc;          /**< Exception attribute. MUST be first. */
 	ir_type     *type;        /**< type of called procedure */
 	ir_entity   **callee_arr; /**< result of callee analysis */
+	int          tail_call;   /**< may be implemented as a sibling call */
 } call_attr;
 
 /** Attributes for Builtin nodes. */
@@ -262,17 +291,6 @@ typedef union ir_attr {
 	switch_attr    switcha;
 } ir_attr;
 
-/**
- * Edge info to put into an irn.
- */
-typedef struct irn_edge_kind_info_t {
-	struct list_head outs_head;  /**< The list of all outs. */
-	unsigned edges_built : 1;    /**< Set edges where built for this node. */
-	unsigned out_count   : 31;   /**< Number of outs in the list. */
-} irn_edge_info_t;
-
-typedef irn_edge_info_t irn_edges_info_t[EDGE_KIND_LAST+1];
-
 /**
  * A Def-Use edge.
  */
@@ -290,27 +308,28 @@ typedef struct ir_def_use_edges {
  * Data of a function graph node.
  */
 struct ir_node {
+	/* Fields used by (almost) every pass come first and fit into one cache
+	 * line. Everything else is rarely accessed. */
 	firm_kind        kind;     /**< Distinguishes this node from others. */
 	unsigned         node_idx; /**< The node index of this node in its graph. */
 	ir_op           *op;       /**< The Opcode of this node. */
 	ir_mode         *mode;     /**< The Mode of this node. */
 	struct ir_node **in;       /**< The array of predecessors / operands. */
-	ir_graph        *irg;
 	ir_visited_t     visited;  /**< Visited counter for walks of the graph. */
 	void            *link;     /**< To attach additional information to the
 	                                node, e.g. used during optimization to link
 	                                to nodes that shall replace a node. */
-	dbg_info        *dbi;      /**< Information for debug support. */
-	long             node_nr;  /**< Globally unique node number. */
+	ir_graph        *irg;
+	void            *backend_info;
+	irn_edge_info_t  edge_info;    /**< Everlasting out edges. */
 
 	union {
 		ir_def_use_edges *out;    /**< array of def-use edges. */
 		unsigned          n_outs; /**< number of def-use edges (temporarily used
 		                               during construction of data structure) */
 	} o;
-	ir_loop         *loop;         /**< Loop information. */
-	void            *backend_info;
-	irn_edges_info_t edge_info;    /**< Everlasting out edges. */
+	dbg_info        *dbi;      /**< Information for debug support. */
+	long             node_nr;  /**< Globally unique node number. */
 
 	/** Attributes of this node. Depends on opcode. Must be last field. */
 	ir_attr attr;
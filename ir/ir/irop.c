@@ -286,7 +286,8 @@ static int attrs_equal_Call(const ir_node *a, const ir_node *b)
 {
 	const call_attr *pa = &a->attr.call;
 	const call_attr *pb = &b->attr.call;
-	return pa->type == pb->type && except_attrs_equal(&pa->exc, &pb->exc);
+	return pa->type == pb->type && pa->tail_call == pb->tail_call
+	    && except_attrs_equal(&pa->exc, &pb->exc);
 }
 
 /** Compares the attributes of two Sel nodes. */
@@ -451,7 +452,10 @@ static void call_copy_attr(ir_graph *irg, const ir_node *old_node,
 static void block_copy_attr(ir_graph *irg, const ir_node *old_node,
                             ir_node *new_node)
 {
+	/* the control flow edges belong to the new block */
+	irn_edge_info_t const succ_edges = new_node->attr.block.succ_edges;
 	default_copy_attr(irg, old_node, new_node);
+	new_node->attr.block.succ_edges    = succ_edges;
 	new_node->attr.block.phis          = NULL;
 	new_node->attr.block.backedge      = new_backedge_arr(get_irg_obstack(irg), get_irn_arity(new_node));
 	new_node->attr.block.block_visited = 0;
@@ -512,6 +512,7 @@ static ir_tarval *get_initializer_value(ir_initializer_t *const init, ir_mode *c
 	}
 
 	case IR_INITIALIZER_COMPOUND:
+	case IR_INITIALIZER_BLOB:
 		break;
 	}
 
@@ -0,0 +1,826 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2012 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Embedded MIP solver: a bounded primal revised simplex with the
+ *          basis inverse in product form and a depth-first branch and bound
+ *          for the binary variables.
+ *
+ * Every constraint row i gets a logical variable s_i so that all rows become
+ * equalities a_i x + s_i = b_i.  The bounds of s_i encode the constraint type,
+ * which makes the all-logical basis a valid (though possibly infeasible)
+ * starting point.  Infeasibilities are removed by a composite phase 1 which
+ * minimizes the sum of bound violations of the basic variables.  This also
+ * repairs the basis after branch and bound changed variable bounds, so every
+ * node warm-starts from the basis of the previously solved one.
+ */
+#include "lpp_simplex.h"
+
+#include "array.h"
+#include "timing.h"
+#include "xmalloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EPS_PIVOT          1e-9  /**< smallest acceptable pivot element */
+#define EPS_FEAS           1e-7  /**< tolerance for bound violations */
+#define EPS_OPT            1e-7  /**< tolerance for reduced costs */
+#define EPS_INT            1e-6  /**< tolerance for integrality */
+#define EPS_DROP           1e-12 /**< eta entries below this are dropped */
+#define REFACTOR_INTERVAL  64    /**< pivots between reinversions */
+#define MAX_DEGENERATE     50    /**< degenerate pivots before Bland's rule */
+
+typedef enum var_state_t {
+	at_lower,
+	at_upper,
+	basic,
+} var_state_t;
+
+typedef enum lp_result_t {
+	lp_optimal,
+	lp_infeasible,
+	lp_unbounded,
+	lp_aborted,
+} lp_result_t;
+
+/** An elementary transformation of the product form inverse. */
+typedef struct eta_t {
+	int    row;   /**< pivot row */
+	double pivot; /**< pivot element */
+	int    begin; /**< first off-pivot entry in the eta file */
+	int    end;   /**< end of the off-pivot entries */
+} eta_t;
+
+/** A pending branch and bound node. */
+typedef struct bb_node_t {
+	int    depth; /**< number of fixed variables including this one */
+	int    var;   /**< variable fixed by this node, -1 for the root */
+	double value; /**< value the variable is fixed to */
+	double bound; /**< objective of the parent relaxation */
+} bb_node_t;
+
+typedef struct simplex_t {
+	lpp_t       *lpp;
+	int          n_rows;    /**< number of constraints */
+	int          n_struct;  /**< number of structural variables */
+	int          n_vars;    /**< structural plus logical variables */
+	int         *col_begin; /**< constraint matrix in compressed column form */
+	int         *row_idx;
+	double      *val;
+	double      *cost;      /**< costs of the (minimization) objective */
+	double      *rhs;
+	double      *lower;
+	double      *upper;
+	bool        *is_int;    /**< structural variable must be integral */
+	bool         int_obj;   /**< objective is integral for integral solutions */
+	double      *x;         /**< current value of every variable */
+	var_state_t *state;
+	int         *head;      /**< variable which is basic in a row */
+	eta_t       *etas;      /**< product form of the basis inverse */
+	size_t       n_factor;  /**< number of etas from the last reinversion */
+	int         *eta_idx;
+	double      *eta_val;
+	double      *work;      /**< dense row-sized scratch vectors */
+	double      *dual;
+	ir_timer_t  *timer;
+	unsigned     iterations;
+	bool         timeout;
+} simplex_t;
+
+static bool time_exceeded(simplex_t *const s)
+{
+	double const limit = s->lpp->time_limit_secs;
+	if (limit > 0.0 && ir_timer_elapsed_sec(s->timer) > limit)
+		s->timeout = true;
+	return s->timeout;
+}
+
+/**
+ * Build the simplex data from the lpp matrix.  Row 0 of the matrix is the
+ * objective, column 0 the right hand side.
+ */
+static void simplex_init(simplex_t *const s, lpp_t *const lpp)
+{
+	memset(s, 0, sizeof(*s));
+	s->lpp      = lpp;
+	s->n_rows   = lpp->cst_next - 1;
+	s->n_struct = lpp->var_next - 1;
+	s->n_vars   = s->n_struct + s->n_rows;
+
+	int const n_rows   = s->n_rows;
+	int const n_struct = s->n_struct;
+	int const n_vars   = s->n_vars;
+	int const n_elems  = matrix_get_entries(lpp->m);
+	double const sign  = lpp->opt_type == lpp_minimize ? 1.0 : -1.0;
+
+	s->col_begin = XMALLOCN(int,         n_struct + 1);
+	s->row_idx   = XMALLOCN(int,         n_elems);
+	s->val       = XMALLOCN(double,      n_elems);
+	s->cost      = XMALLOCNZ(double,     n_vars);
+	s->rhs       = XMALLOCN(double,      n_rows);
+	s->lower     = XMALLOCN(double,      n_vars);
+	s->upper     = XMALLOCN(double,      n_vars);
+	s->is_int    = XMALLOCNZ(bool,       n_struct);
+	s->x         = XMALLOCNZ(double,     n_vars);
+	s->state     = XMALLOCN(var_state_t, n_vars);
+	s->head      = XMALLOCN(int,         n_rows);
+	s->work      = XMALLOCN(double,      n_rows);
+	s->dual      = XMALLOCN(double,      n_rows);
+	s->etas      = NEW_ARR_F(eta_t,  0);
+	s->eta_idx   = NEW_ARR_F(int,    0);
+	s->eta_val   = NEW_ARR_F(double, 0);
+
+	int n = 0;
+	for (int j = 0; j < n_struct; ++j) {
+		s->col_begin[j] = n;
+		matrix_foreach_in_col(lpp->m, 1 + j, elem) {
+			if (elem->row == 0) {
+				s->cost[j] = sign * elem->val;
+			} else if (elem->val != 0.0) {
+				s->row_idx[n] = elem->row - 1;
+				s->val[n]     = elem->val;
+				++n;
+			}
+		}
+
+		bool const binary = lpp->vars[1 + j]->type.var_type == lpp_binary;
+		s->is_int[j] = binary;
+		s->lower[j]  = 0.0;
+		s->upper[j]  = binary ? 1.0 : INFINITY;
+		s->state[j]  = at_lower;
+	}
+	s->col_begin[n_struct] = n;
+
+	s->int_obj = true;
+	for (int j = 0; j < n_struct; ++j) {
+		if (s->cost[j] != 0.0 && (!s->is_int[j] || s->cost[j] != floor(s->cost[j])))
+			s->int_obj = false;
+	}
+
+	for (int i = 0; i < n_rows; ++i) {
+		int const v = n_struct + i;
+		s->rhs[i] = matrix_get(lpp->m, 1 + i, 0);
+		switch (lpp->csts[1 + i]->type.cst_type) {
+		case lpp_less_equal:
+			s->lower[v] = 0.0;
+			s->upper[v] = INFINITY;
+			break;
+		case lpp_greater_equal:
+			s->lower[v] = -INFINITY;
+			s->upper[v] = 0.0;
+			break;
+		default:
+			s->lower[v] = 0.0;
+			s->upper[v] = 0.0;
+			break;
+		}
+		s->state[v] = basic;
+		s->head[i]  = v;
+	}
+}
+
+static void simplex_free(simplex_t *const s)
+{
+	free(s->col_begin);
+	free(s->row_idx);
+	free(s->val);
+	free(s->cost);
+	free(s->rhs);
+	free(s->lower);
+	free(s->upper);
+	free(s->is_int);
+	free(s->x);
+	free(s->state);
+	free(s->head);
+	free(s->work);
+	free(s->dual);
+	DEL_ARR_F(s->etas);
+	DEL_ARR_F(s->eta_idx);
+	DEL_ARR_F(s->eta_val);
+}
+
+/** Store column @p j of the constraint matrix into the dense vector @p a. */
+static void load_column(simplex_t const *const s, int const j, double *const a)
+{
+	memset(a, 0, s->n_rows * sizeof(*a));
+	if (j >= s->n_struct) {
+		a[j - s->n_struct] = 1.0;
+		return;
+	}
+	for (int k = s->col_begin[j], end = s->col_begin[j + 1]; k < end; ++k)
+		a[s->row_idx[k]] = s->val[k];
+}
+
+/** Computes B^-1 a in place. */
+static void ftran(simplex_t const *const s, double *const a)
+{
+	for (size_t e = 0, n = ARR_LEN(s->etas); e < n; ++e) {
+		eta_t const *const eta = &s->etas[e];
+		double             t   = a[eta->row];
+		if (t == 0.0)
+			continue;
+		t /= eta->pivot;
+		a[eta->row] = t;
+		for (int k = eta->begin; k < eta->end; ++k)
+			a[s->eta_idx[k]] -= s->eta_val[k] * t;
+	}
+}
+
+/** Computes y^T B^-1 in place. */
+static void btran(simplex_t const *const s, double *const y)
+{
+	for (size_t e = ARR_LEN(s->etas); e-- > 0;) {
+		eta_t const *const eta = &s->etas[e];
+		double             t   = y[eta->row];
+		for (int k = eta->begin; k < eta->end; ++k)
+			t -= s->eta_val[k] * y[s->eta_idx[k]];
+		y[eta->row] = t / eta->pivot;
+	}
+}
+
+/** Append the pivot on row @p row of the transformed column @p alpha. */
+static void add_eta(simplex_t *const s, int const row, double const *const alpha)
+{
+	eta_t eta = {
+		.row   = row,
+		.pivot = alpha[row],
+		.begin = (int)ARR_LEN(s->eta_idx),
+	};
+	for (int i = 0; i < s->n_rows; ++i) {
+		if (i == row || fabs(alpha[i]) < EPS_DROP)
+			continue;
+		ARR_APP1(int,    s->eta_idx, i);
+		ARR_APP1(double, s->eta_val, alpha[i]);
+	}
+	eta.end = (int)ARR_LEN(s->eta_idx);
+	ARR_APP1(eta_t, s->etas, eta);
+}
+
+static double nonbasic_value(simplex_t *const s, int const j)
+{
+	if (s->state[j] == at_lower && s->lower[j] == -INFINITY)
+		s->state[j] = at_upper;
+	else if (s->state[j] == at_upper && s->upper[j] == INFINITY)
+		s->state[j] = at_lower;
+	return s->state[j] == at_lower ? s->lower[j] : s->upper[j];
+}
+
+/** Recompute the values of all variables from the basis and the bounds. */
+static void compute_values(simplex_t *const s)
+{
+	double *const b = s->work;
+	memcpy(b, s->rhs, s->n_rows * sizeof(*b));
+	for (int j = 0; j < s->n_vars; ++j) {
+		if (s->state[j] == basic)
+			continue;
+		double const v = nonbasic_value(s, j);
+		s->x[j] = v;
+		if (v == 0.0)
+			continue;
+		if (j >= s->n_struct) {
+			b[j - s->n_struct] -= v;
+		} else {
+			for (int k = s->col_begin[j], end = s->col_begin[j + 1]; k < end; ++k)
+				b[s->row_idx[k]] -= s->val[k] * v;
+		}
+	}
+	ftran(s, b);
+	for (int i = 0; i < s->n_rows; ++i)
+		s->x[s->head[i]] = b[i];
+}
+
+static simplex_t const *sort_simplex;
+
+static int cmp_column_length(void const *const a, void const *const b)
+{
+	int const *const begin = sort_simplex->col_begin;
+	int        const ja    = *(int const*)a;
+	int        const jb    = *(int const*)b;
+	int        const la    = begin[ja + 1] - begin[ja];
+	int        const lb    = begin[jb + 1] - begin[jb];
+	return (la > lb) - (la < lb);
+}
+
+/**
+ * Pivot the structural column @p j into a free row.  Among the rows with an
+ * acceptably large transformed entry the one touched by the fewest remaining
+ * columns is chosen to limit the fill in later etas.  Returns false if the
+ * column is linearly dependent on the columns pivoted so far.
+ */
+static bool pivot_column(simplex_t *const s, int const j, bool *const taken,
+                         int const *const row_count)
+{
+	double *const alpha = s->work;
+	load_column(s, j, alpha);
+	ftran(s, alpha);
+
+	double max = 0.0;
+	for (int i = 0; i < s->n_rows; ++i) {
+		if (!taken[i])
+			max = fmax(max, fabs(alpha[i]));
+	}
+	if (max < EPS_PIVOT)
+		return false;
+
+	int row = -1;
+	for (int i = 0; i < s->n_rows; ++i) {
+		if (taken[i] || fabs(alpha[i]) < 0.1 * max)
+			continue;
+		if (row < 0 || row_count[i] < row_count[row])
+			row = i;
+	}
+	add_eta(s, row, alpha);
+	taken[row]   = true;
+	s->head[row] = j;
+	return true;
+}
+
+/**
+ * Rebuild the product form of the basis inverse from scratch.  Basic logicals
+ * keep their own row.  Structural columns are first pivoted on row singletons:
+ * a column touching no previously pivoted row passes ftran unchanged, so this
+ * triangular part causes no fill at all.  The remaining bump is pivoted in
+ * with the sparsest columns first.  Columns which turn out to be linearly
+ * dependent are replaced by the logical of a free row.
+ */
+static void refactor(simplex_t *const s)
+{
+	ARR_SHRINKLEN(s->etas,    0);
+	ARR_SHRINKLEN(s->eta_idx, 0);
+	ARR_SHRINKLEN(s->eta_val, 0);
+
+	int const n_rows  = s->n_rows;
+	bool     *taken   = XMALLOCNZ(bool, n_rows);
+	int      *columns = XMALLOCN(int, n_rows);
+	int       n_cols  = 0;
+	for (int i = 0; i < n_rows; ++i) {
+		int const v = s->head[i];
+		if (v < s->n_struct)
+			columns[n_cols++] = v;
+	}
+	for (int i = 0; i < n_rows; ++i) {
+		int const v = s->n_struct + i;
+		if (s->state[v] == basic) {
+			taken[i]   = true;
+			s->head[i] = v;
+		}
+	}
+
+	/* row-wise view of the basic structural columns in the free rows */
+	int *row_count = XMALLOCNZ(int, n_rows);
+	for (int c = 0; c < n_cols; ++c) {
+		int const j = columns[c];
+		for (int k = s->col_begin[j]; k < s->col_begin[j + 1]; ++k) {
+			if (!taken[s->row_idx[k]])
+				++row_count[s->row_idx[k]];
+		}
+	}
+	int *row_begin = XMALLOCN(int, n_rows + 1);
+	int  n_entries = 0;
+	for (int i = 0; i < n_rows; ++i) {
+		row_begin[i] = n_entries;
+		n_entries   += row_count[i];
+	}
+	row_begin[n_rows] = n_entries;
+	int *row_cols = XMALLOCN(int, n_entries);
+	int *pos      = XMALLOCNZ(int, n_rows);
+	for (int c = 0; c < n_cols; ++c) {
+		int const j = columns[c];
+		for (int k = s->col_begin[j]; k < s->col_begin[j + 1]; ++k) {
+			int const i = s->row_idx[k];
+			if (!taken[i])
+				row_cols[row_begin[i] + pos[i]++] = c;
+		}
+	}
+
+	bool *done    = XMALLOCNZ(bool, n_cols);
+	int  *queue   = XMALLOCN(int, n_rows);
+	int   n_queue = 0;
+	for (int i = 0; i < n_rows; ++i) {
+		if (row_count[i] == 1)
+			queue[n_queue++] = i;
+	}
+	while (n_queue > 0) {
+		int const r = queue[--n_queue];
+		if (taken[r] || row_count[r] != 1)
+			continue;
+		int c = -1;
+		for (int k = row_begin[r]; k < row_begin[r + 1]; ++k) {
+			if (!done[row_cols[k]]) {
+				c = row_cols[k];
+				break;
+			}
+		}
+		int    const j = columns[c];
+		double       pivot = 0.0;
+		for (int k = s->col_begin[j]; k < s->col_begin[j + 1]; ++k) {
+			if (s->row_idx[k] == r)
+				pivot = s->val[k];
+		}
+		if (fabs(pivot) < EPS_PIVOT)
+			continue;
+
+		load_column(s, j, s->work);
+		add_eta(s, r, s->work);
+		taken[r]   = true;
+		s->head[r] = j;
+		done[c]    = true;
+		for (int k = s->col_begin[j]; k < s->col_begin[j + 1]; ++k) {
+			int const i = s->row_idx[k];
+			if (!taken[i] && --row_count[i] == 1)
+				queue[n_queue++] = i;
+		}
+	}
+
+	/* the bump */
+	int n_bump = 0;
+	for (int c = 0; c < n_cols; ++c) {
+		if (!done[c])
+			columns[n_bump++] = columns[c];
+	}
+	sort_simplex = s;
+	qsort(columns, n_bump, sizeof(*columns), cmp_column_length);
+	for (int c = 0; c < n_bump; ++c) {
+		int const j = columns[c];
+		if (!pivot_column(s, j, taken, row_count))
+			s->state[j] = at_lower;
+		for (int k = s->col_begin[j]; k < s->col_begin[j + 1]; ++k)
+			--row_count[s->row_idx[k]];
+	}
+
+	/* rows left over get their logical back */
+	for (int i = 0; i < n_rows; ++i) {
+		if (taken[i])
+			continue;
+		int const v = s->n_struct + i;
+		s->head[i]  = v;
+		s->state[v] = basic;
+	}
+	free(queue);
+	free(done);
+	free(pos);
+	free(row_cols);
+	free(row_begin);
+	free(row_count);
+	free(columns);
+	free(taken);
+
+	s->n_factor = ARR_LEN(s->etas);
+	compute_values(s);
+}
+
+static double reduced_cost(simplex_t const *const s, int const j, bool const phase1)
+{
+	double const *const dual = s->dual;
+	double d = phase1 ? 0.0 : s->cost[j];
+	if (j >= s->n_struct)
+		return d - dual[j - s->n_struct];
+	for (int k = s->col_begin[j], end = s->col_begin[j + 1]; k < end; ++k)
+		d -= dual[s->row_idx[k]] * s->val[k];
+	return d;
+}
+
+/**
+ * Solve the LP relaxation for the current bounds starting from the current
+ * basis.
+ */
+static lp_result_t simplex_solve(simplex_t *const s)
+{
+	int const n_rows      = s->n_rows;
+	int const n_vars      = s->n_vars;
+	unsigned  max_iter    = s->iterations + 100 * (unsigned)(n_rows + n_vars) + 10000;
+	int       degenerate  = 0;
+	double   *const alpha = s->work;
+	double   *const dual  = s->dual;
+	double   *const x     = s->x;
+
+	/* the bounds changed since the last solve, the basis stays valid */
+	compute_values(s);
+	for (;;) {
+		if (ARR_LEN(s->etas) - s->n_factor >= REFACTOR_INTERVAL)
+			refactor(s);
+		if (s->iterations >= max_iter || time_exceeded(s))
+			return lp_aborted;
+
+		/* phase 1 as long as a basic variable violates its bounds */
+		bool phase1 = false;
+		for (int i = 0; i < n_rows; ++i) {
+			int const v = s->head[i];
+			double    c = 0.0;
+			if (x[v] < s->lower[v] - EPS_FEAS)
+				c = -1.0;
+			else if (x[v] > s->upper[v] + EPS_FEAS)
+				c = 1.0;
+			phase1 |= c != 0.0;
+			dual[i] = c;
+		}
+		if (!phase1) {
+			for (int i = 0; i < n_rows; ++i)
+				dual[i] = s->cost[s->head[i]];
+		}
+		btran(s, dual);
+
+		/* pricing: Dantzig's rule, Bland's rule when stalling */
+		bool const bland = degenerate > MAX_DEGENERATE;
+		int        enter = -1;
+		double     best  = 0.0;
+		for (int j = 0; j < n_vars; ++j) {
+			var_state_t const state = s->state[j];
+			if (state == basic || s->lower[j] == s->upper[j])
+				continue;
+			double const d = reduced_cost(s, j, phase1);
+			if ((state == at_lower && d < -EPS_OPT) ||
+			    (state == at_upper && d > EPS_OPT)) {
+				if (fabs(d) > best) {
+					best  = fabs(d);
+					enter = j;
+				}
+				if (bland)
+					break;
+			}
+		}
+		if (enter < 0)
+			return phase1 ? lp_infeasible : lp_optimal;
+
+		load_column(s, enter, alpha);
+		ftran(s, alpha);
+
+		/* ratio test, infeasible basic variables only block at the bound they
+		 * become feasible at */
+		double const dir         = s->state[enter] == at_lower ? 1.0 : -1.0;
+		double       theta       = s->upper[enter] - s->lower[enter];
+		int          leave       = -1;
+		var_state_t  leave_state = at_lower;
+		double       leave_alpha = 0.0;
+		for (int i = 0; i < n_rows; ++i) {
+			double const a = alpha[i];
+			if (fabs(a) < EPS_PIVOT)
+				continue;
+			int    const v     = s->head[i];
+			double const delta = -dir * a;
+			double       t;
+			var_state_t  state;
+			if (delta < 0.0) {
+				if (x[v] < s->lower[v] - EPS_FEAS)
+					continue;
+				state = x[v] > s->upper[v] + EPS_FEAS ? at_upper : at_lower;
+				double const bound = state == at_upper ? s->upper[v] : s->lower[v];
+				if (bound == -INFINITY)
+					continue;
+				t = (x[v] - bound) / -delta;
+			} else {
+				if (x[v] > s->upper[v] + EPS_FEAS)
+					continue;
+				state = x[v] < s->lower[v] - EPS_FEAS ? at_lower : at_upper;
+				double const bound = state == at_lower ? s->lower[v] : s->upper[v];
+				if (bound == INFINITY)
+					continue;
+				t = (bound - x[v]) / delta;
+			}
+			if (t < 0.0)
+				t = 0.0;
+			if (t < theta || (leave >= 0 && t <= theta + EPS_DROP && fabs(a) > fabs(leave_alpha))) {
+				theta       = t;
+				leave       = i;
+				leave_state = state;
+				leave_alpha = a;
+			}
+		}
+		if (theta == INFINITY)
+			return phase1 ? lp_infeasible : lp_unbounded;
+
+		++s->iterations;
+		degenerate = theta < EPS_DROP ? degenerate + 1 : 0;
+
+		for (int i = 0; i < n_rows; ++i)
+			x[s->head[i]] -= dir * alpha[i] * theta;
+
+		if (leave < 0) {
+			/* bound flip of the entering variable */
+			s->state[enter] = dir > 0 ? at_upper : at_lower;
+			x[enter] = dir > 0 ? s->upper[enter] : s->lower[enter];
+			continue;
+		}
+
+		int const v = s->head[leave];
+		s->state[v] = leave_state;
+		x[v]        = leave_state == at_lower ? s->lower[v] : s->upper[v];
+		x[enter]   += dir * theta;
+		add_eta(s, leave, alpha);
+		s->head[leave]  = enter;
+		s->state[enter] = basic;
+	}
+}
+
+static double objective_value(simplex_t const *const s)
+{
+	double obj = 0.0;
+	for (int j = 0; j < s->n_struct; ++j)
+		obj += s->cost[j] * s->x[j];
+	return obj;
+}
+
+/**
+ * Returns the most fractional integer variable or -1 if the current solution
+ * is integral.
+ */
+static int select_branch_var(simplex_t const *const s)
+{
+	int    var  = -1;
+	double best = EPS_INT;
+	for (int j = 0; j < s->n_struct; ++j) {
+		if (!s->is_int[j])
+			continue;
+		double const f    = s->x[j] - floor(s->x[j]);
+		double const dist = f < 0.5 ? f : 1.0 - f;
+		if (dist > best) {
+			best = dist;
+			var  = j;
+		}
+	}
+	return var;
+}
+
+static void set_int_bounds(simplex_t *const s, int const j, double const lower,
+                           double const upper)
+{
+	s->lower[j] = lower;
+	s->upper[j] = upper;
+}
+
+typedef struct incumbent_t {
+	double *x;
+	double  obj;
+	bool    valid;
+} incumbent_t;
+
+static void store_incumbent(simplex_t const *const s, incumbent_t *const inc,
+                            double const obj)
+{
+	for (int j = 0; j < s->n_struct; ++j)
+		inc->x[j] = s->is_int[j] ? floor(s->x[j] + 0.5) : s->x[j];
+	inc->obj   = obj;
+	inc->valid = true;
+	if (s->lpp->log != NULL)
+		fprintf(s->lpp->log, "simplex: incumbent %g after %u iterations\n",
+		        s->lpp->opt_type == lpp_minimize ? obj : -obj, s->iterations);
+}
+
+static bool can_prune(simplex_t const *const s, incumbent_t const *const inc,
+                      double bound)
+{
+	if (!inc->valid)
+		return false;
+	/* with an integral objective only a whole unit counts as improvement */
+	if (s->int_obj)
+		bound = ceil(bound - EPS_INT);
+	return bound >= inc->obj - 1e-6 * fmax(1.0, fabs(inc->obj));
+}
+
+/**
+ * Turn the start values of the integer variables into a first incumbent by
+ * fixing them and solving for the remaining variables.
+ */
+static void try_start_values(simplex_t *const s, incumbent_t *const inc)
+{
+	bool has_start = false;
+	for (int j = 0; j < s->n_struct; ++j) {
+		lpp_name_t const *const var = s->lpp->vars[1 + j];
+		if (!s->is_int[j] || var->value_kind != lpp_value_start)
+			continue;
+		double const v = var->value >= 0.5 ? 1.0 : 0.0;
+		set_int_bounds(s, j, v, v);
+		has_start = true;
+	}
+	if (!has_start)
+		return;
+
+	if (simplex_solve(s) == lp_optimal && select_branch_var(s) < 0)
+		store_incumbent(s, inc, objective_value(s));
+
+	for (int j = 0; j < s->n_struct; ++j) {
+		if (s->is_int[j])
+			set_int_bounds(s, j, 0.0, 1.0);
+	}
+}
+
+static void solve(simplex_t *const s)
+{
+	lpp_t *const lpp      = s->lpp;
+	double const sign     = lpp->opt_type == lpp_minimize ? 1.0 : -1.0;
+	incumbent_t  inc      = { .x = XMALLOCN(double, s->n_struct), .valid = false };
+	bb_node_t   *stack    = NEW_ARR_F(bb_node_t, 0);
+	int         *path     = NEW_ARR_F(int, 0);
+	bool         unbounded = false;
+
+	try_start_values(s, &inc);
+
+	bb_node_t const root = { .depth = 0, .var = -1, .bound = -INFINITY };
+	ARR_APP1(bb_node_t, stack, root);
+	while (ARR_LEN(stack) > 0) {
+		if (lpp->set_bound && inc.valid && inc.obj <= sign * lpp->bound + EPS_FEAS) {
+			ARR_SHRINKLEN(stack, 0);
+			break;
+		}
+
+		bb_node_t const node = stack[ARR_LEN(stack) - 1];
+		if (can_prune(s, &inc, node.bound)) {
+			ARR_SHRINKLEN(stack, ARR_LEN(stack) - 1);
+			continue;
+		}
+
+		/* move from the previous node to this one */
+		while ((int)ARR_LEN(path) >= node.depth && ARR_LEN(path) > 0) {
+			int const j = path[ARR_LEN(path) - 1];
+			set_int_bounds(s, j, 0.0, 1.0);
+			ARR_SHRINKLEN(path, ARR_LEN(path) - 1);
+		}
+		if (node.var >= 0) {
+			set_int_bounds(s, node.var, node.value, node.value);
+			ARR_APP1(int, path, node.var);
+		}
+
+		lp_result_t const res = simplex_solve(s);
+		if (res == lp_aborted)
+			break;
+		ARR_SHRINKLEN(stack, ARR_LEN(stack) - 1);
+		if (res == lp_unbounded) {
+			unbounded = true;
+			break;
+		}
+		if (res != lp_optimal)
+			continue;
+
+		double const obj = objective_value(s);
+		if (can_prune(s, &inc, obj))
+			continue;
+
+		int const j = select_branch_var(s);
+		if (j < 0) {
+			store_incumbent(s, &inc, obj);
+			continue;
+		}
+
+		/* explore the rounded value first */
+		double const near = s->x[j] >= 0.5 ? 1.0 : 0.0;
+		bb_node_t const far_child  = { node.depth + 1, j, 1.0 - near, obj };
+		bb_node_t const near_child = { node.depth + 1, j, near,       obj };
+		ARR_APP1(bb_node_t, stack, far_child);
+		ARR_APP1(bb_node_t, stack, near_child);
+	}
+
+	if (unbounded) {
+		lpp->sol_state = lpp_unbounded;
+	} else if (ARR_LEN(stack) > 0) {
+		/* stopped early, the best bound is the weakest open node */
+		double bound = inc.valid ? inc.obj : INFINITY;
+		for (size_t i = 0, n = ARR_LEN(stack); i < n; ++i)
+			bound = fmin(bound, stack[i].bound);
+		lpp->best_bound = sign * bound;
+		lpp->sol_state  = inc.valid ? lpp_feasible : lpp_unknown;
+	} else {
+		lpp->sol_state = inc.valid ? lpp_optimal : lpp_infeasible;
+		if (inc.valid)
+			lpp->best_bound = sign * inc.obj;
+	}
+
+	if (inc.valid) {
+		for (int j = 0; j < s->n_struct; ++j) {
+			lpp->vars[1 + j]->value      = inc.x[j];
+			lpp->vars[1 + j]->value_kind = lpp_value_solution;
+		}
+		lpp->objval = sign * inc.obj;
+	}
+
+	DEL_ARR_F(path);
+	DEL_ARR_F(stack);
+	free(inc.x);
+}
+
+void lpp_solve_simplex(lpp_t *lpp)
+{
+	simplex_t s;
+	simplex_init(&s, lpp);
+	s.timer = ir_timer_new();
+	ir_timer_reset_and_start(s.timer);
+
+	if (lpp->log != NULL)
+		fprintf(lpp->log, "simplex: %d constraints, %d variables\n",
+		        s.n_rows, s.n_struct);
+	solve(&s);
+
+	ir_timer_stop(s.timer);
+	lpp->sol_time   = ir_timer_elapsed_sec(s.timer);
+	lpp->iterations = s.iterations;
+	if (lpp->log != NULL)
+		fprintf(lpp->log, "simplex: %s%s after %u iterations, %.2fs\n",
+		        lpp_is_sol_valid(lpp) ? "solved" : "no solution",
+		        s.timeout ? " (time limit)" : "", s.iterations, lpp->sol_time);
+
+	ir_timer_free(s.timer);
+	simplex_free(&s);
+}
@@ -48,13 +48,14 @@
 /* define this to check that all type translations are monotone */
 #define VERIFY_MONOTONE
 
+#ifndef NDEBUG
 /* define this to check the consistency of partitions */
 #define CHECK_PARTITIONS
+#endif
 
 typedef struct node_t            node_t;
 typedef struct partition_t       partition_t;
 typedef struct opcode_key_t      opcode_key_t;
-typedef struct listmap_entry_t   listmap_entry_t;
 
 /** The type of the compute function. */
 typedef void (*compute_func)(node_t *node);
@@ -63,24 +64,10 @@ typedef void (*compute_func)(node_t *node);
  * An opcode map key.
  */
 struct opcode_key_t {
-	ir_node *irn;    /**< An IR node representing this opcode. */
+	ir_node  *irn;   /**< An IR node representing this opcode. */
+	unsigned  id;    /**< A dense id for (what-)mapping, >0. */
 };
 
-/**
- * An entry in the list_map.
- */
-struct listmap_entry_t {
-	void            *id;    /**< The id. */
-	node_t          *list;  /**< The associated list for this id. */
-	listmap_entry_t *next;  /**< Link to the next entry in the map. */
-};
-
-/** We must map id's to lists. */
-typedef struct listmap_t {
-	set             *map;    /**< Map id's to listmap_entry_t's */
-	listmap_entry_t *values; /**< List of all values in the map. */
-} listmap_t;
-
 /**
  * A lattice element. Because we handle constants and symbolic constants
  * different, we have to use this union.
@@ -130,19 +117,25 @@ struct partition_t {
 	bool         on_touched:1;    /**< Set, if this partition is on the touched set. */
 	bool         on_cprop:1;      /**< Set, if this partition is on the cprop list. */
 	bool         type_is_B_or_C:1;/**< Set, if all nodes in this partition have type Bottom or Constant. */
+	unsigned     nr;              /**< A unique dense number for (what-)mapping. */
 #ifdef DEBUG_libfirm
 	partition_t *dbg_next;       /**< Link all partitions for debugging */
-	unsigned     nr;             /**< A unique number for (what-)mapping, >0. */
 #endif
 };
 
 typedef struct environment_t {
 	struct obstack  obst;          /**< obstack to allocate data structures. */
+	node_t         *nodes;         /**< The nodes, indexed by IR-node index. */
 	partition_t    *worklist;      /**< The work list. */
 	partition_t    *cprop;         /**< The constant propagation list. */
 	partition_t    *touched;       /**< the touched set. */
 	partition_t    *initial;       /**< The initial partition. */
 	set            *opcode2id_map; /**< The opcodeMode->id map. */
+	pmap           *type2id_map;   /**< The type->id map. */
+	node_t        **split_lists;   /**< Node lists of split_by_what(), by id. */
+	unsigned       *split_ids;     /**< Ids of non-empty split_lists in order
+	                                    of their first use. */
+	unsigned        n_partitions;  /**< Number of created partitions. */
 	ir_node       **kept_memory;   /**< Array of memory nodes that must be kept. */
 	int             end_idx;       /**< -1 for local and 0 for global congruences. */
 	int             lambda_input;  /**< Captured argument for lambda_partition(). */
@@ -155,8 +148,8 @@ typedef struct environment_t {
 #endif
 } environment_t;
 
-/** Type of the what function. */
-typedef void *(*what_func)(const node_t *node, environment_t *env);
+/** Type of the what function: returns a dense id > 0 or 0 to ignore a node. */
+typedef unsigned (*what_func)(const node_t *node, environment_t *env);
 
 static inline node_t *get_irn_node(const ir_node *node)
 {
@@ -184,9 +177,6 @@ DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 /** The what reason. */
 DEBUG_ONLY(static const char *what_reason;)
 
-/** Next partition number. */
-DEBUG_ONLY(static unsigned part_nr = 0;)
-
 /* forward */
 static node_t *identity(node_t *node);
 
@@ -448,60 +438,6 @@ static void verify_type(const lattice_elem_t old_type, node_t *node)
 #define verify_type(old_type, node) (void)(old_type), (void)node
 #endif
 
-/**
- * Compare two pointer values of a listmap.
- */
-static int listmap_cmp_ptr(const void *elt, const void *key, size_t size)
-{
-	(void)size;
-	const listmap_entry_t *e1 = (listmap_entry_t*)elt;
-	const listmap_entry_t *e2 = (listmap_entry_t*)key;
-	return e1->id != e2->id;
-}
-
-/**
- * Initializes a listmap.
- *
- * @param map  the listmap
- */
-static void listmap_init(listmap_t *map)
-{
-	map->map    = new_set(listmap_cmp_ptr, 16);
-	map->values = NULL;
-}
-
-/**
- * Terminates a listmap.
- *
- * @param map  the listmap
- */
-static void listmap_term(listmap_t *map)
-{
-	del_set(map->map);
-}
-
-/**
- * Return the associated listmap entry for a given id.
- *
- * @param map  the listmap
- * @param id   the id to search for
- *
- * @return the associated listmap entry for the given id
- */
-static listmap_entry_t *listmap_find(listmap_t *map, void *id)
-{
-	listmap_entry_t  key   = { .id = id, .list = NULL, .next = NULL };
-	listmap_entry_t *entry = set_insert(listmap_entry_t, map->map, &key,
-	                                    sizeof(key), hash_ptr(id));
-
-	if (entry->list == NULL) {
-		/* a new entry, put into the list */
-		entry->next = map->values;
-		map->values = entry;
-	}
-	return entry;
-}
-
 /**
  * Calculate the hash value for an opcode map entry.
  *
@@ -614,8 +550,8 @@ static inline partition_t *new_partition(environment_t *env)
 #ifdef DEBUG_libfirm
 	part->dbg_next = env->dbg_list;
 	env->dbg_list  = part;
-	part->nr       = part_nr++;
 #endif
+	part->nr = env->n_partitions++;
 
 	return part;
 }
@@ -658,7 +594,7 @@ static node_t *create_partition_node(ir_node *irn, partition_t *part,
                                      environment_t *env)
 {
 	/* create a partition node and place it in the partition */
-	node_t *node = OALLOCZ(&env->obst, node_t);
+	node_t *node = &env->nodes[get_irn_idx(irn)];
 
 	INIT_LIST_HEAD(&node->node_list);
 	INIT_LIST_HEAD(&node->cprop_list);
@@ -900,11 +836,14 @@ static void follower_to_leader(node_t *n)
  * The environment for one race step.
  */
 typedef struct step_env {
-	node_t   *initial;  /**< The initial node list. */
-	node_t   *unwalked; /**< The unwalked node list. */
-	node_t   *walked;   /**< The walked node list. */
-	unsigned  index;    /**< Next index of follower use_def edge. */
-	unsigned  side;     /**< side number. */
+	node_t          *initial;      /**< The initial node list. */
+	list_head       *initial_pos;  /**< Next node of the initial leader list,
+	                                    walked backwards, if any. */
+	list_head const *initial_end;  /**< End of the initial leader list. */
+	node_t          *unwalked;     /**< The unwalked node list. */
+	node_t          *walked;       /**< The walked node list. */
+	unsigned         index;        /**< Next index of follower use_def edge. */
+	unsigned         side;         /**< side number. */
 } step_env;
 
 /**
@@ -987,6 +926,18 @@ static bool step(step_env *env)
 
 		return false;
 	}
+	if (env->initial_pos != env->initial_end) {
+		/* Move the next node of the initial leader list to unwalked. The
+		 * list is taken lazily, so a race costs only the steps of the
+		 * smaller side. */
+		node_t *n = list_entry(env->initial_pos, node_t, node_list);
+		env->initial_pos = env->initial_pos->prev;
+
+		n->race_next  = env->unwalked;
+		env->unwalked = n;
+
+		return false;
+	}
 
 	while (env->unwalked != NULL) {
 		/* let n be the first node in unwalked */
@@ -1096,27 +1047,23 @@ static partition_t *split(partition_t **pX, node_t *gg, environment_t *env)
 		node->race_next = g;
 		g               = node;
 	}
-	/* produce h */
-	node_t *h = NULL;
-	list_for_each_entry(node_t, node, &X->leader, node_list) {
-		node->race_next = h;
-		h               = node;
-	}
-	/* restore X.leader */
-	list_splice(&tmp, &X->leader);
-
+	/* X.leader now is h, it is walked in reverse order during the race */
 	step_env senv[2];
-	senv[0].initial   = g;
-	senv[0].unwalked  = NULL;
-	senv[0].walked    = NULL;
-	senv[0].index     = 0;
-	senv[0].side      = 1;
-
-	senv[1].initial   = h;
-	senv[1].unwalked  = NULL;
-	senv[1].walked    = NULL;
-	senv[1].index     = 0;
-	senv[1].side      = 2;
+	senv[0].initial     = g;
+	senv[0].initial_pos = NULL;
+	senv[0].initial_end = NULL;
+	senv[0].unwalked    = NULL;
+	senv[0].walked      = NULL;
+	senv[0].index       = 0;
+	senv[0].side        = 1;
+
+	senv[1].initial     = NULL;
+	senv[1].initial_pos = X->leader.prev;
+	senv[1].initial_end = &X->leader;
+	senv[1].unwalked    = NULL;
+	senv[1].walked      = NULL;
+	senv[1].index       = 0;
+	senv[1].side        = 2;
 
 	/*
 	 * Some informations on the race that are not stated clearly in Click's
@@ -1144,8 +1091,12 @@ static partition_t *split(partition_t **pX, node_t *gg, environment_t *env)
 		}
 	}
 	assert(senv[winner].initial == NULL);
+	assert(senv[winner].initial_pos == senv[winner].initial_end);
 	assert(senv[winner].unwalked == NULL);
 
+	/* restore X.leader */
+	list_splice(&tmp, &X->leader);
+
 	/* clear flags from walked/unwalked */
 	int shf         = winner;
 	int transitions = clear_flags(senv[0].unwalked) << shf;
@@ -1441,17 +1392,17 @@ static void cause_splits(environment_t *env)
 			Z->touched   = NULL;
 			Z->n_touched = 0;
 
+			/* split() leaves the partition with the remaining nodes (which
+			 * includes touched_ab) in Z, this might be a new one */
 			if (0 < n_touched_aa && n_touched_aa < Z->n_leaders) {
-				partition_t *Z_prime = Z;
-				DB((dbg, LEVEL_2, "Split part%d by touched_aa\n", Z_prime->nr));
-				split(&Z_prime, touched_aa, env);
+				DB((dbg, LEVEL_2, "Split part%d by touched_aa\n", Z->nr));
+				split(&Z, touched_aa, env);
 			} else
 				assert(n_touched_aa <= Z->n_leaders);
 
 			if (0 < n_touched_ab && n_touched_ab < Z->n_leaders) {
-				partition_t *Z_prime = Z;
-				DB((dbg, LEVEL_2, "Split part%d by touched_ab\n", Z_prime->nr));
-				split(&Z_prime, touched_ab, env);
+				DB((dbg, LEVEL_2, "Split part%d by touched_ab\n", Z->nr));
+				split(&Z, touched_ab, env);
 			} else
 				assert(n_touched_ab <= Z->n_leaders);
 		}
@@ -1508,29 +1459,41 @@ static void cause_splits(environment_t *env)
 static partition_t *split_by_what(partition_t *X, what_func What,
                                   partition_t **P, environment_t *env)
 {
-	/* Let map be an empty mapping from the range of What to (local) list of Nodes. */
-	listmap_t map;
-	listmap_init(&map);
+	/* Let map be an empty mapping from the range of What to (local) list of
+	 * Nodes.  The ids are dense, so the lists are simply indexed by them. */
+	assert(ARR_LEN(env->split_ids) == 0);
 	list_for_each_entry(node_t, x, &X->leader, node_list) {
-		void *id = What(x, env);
-		if (id == NULL) {
+		unsigned id = What(x, env);
+		if (id == 0) {
 			/* input not allowed, ignore */
 			continue;
 		}
 		/* Add x to map[What(x)]. */
-		listmap_entry_t *entry = listmap_find(&map, id);
-		x->next     = entry->list;
-		entry->list = x;
+		size_t n_lists = ARR_LEN(env->split_lists);
+		if (id >= n_lists) {
+			size_t new_len = MAX(id + 1, 2 * n_lists);
+			ARR_RESIZE(node_t*, env->split_lists, new_len);
+			memset(&env->split_lists[n_lists], 0,
+			       (new_len - n_lists) * sizeof(env->split_lists[0]));
+		}
+		node_t **list = &env->split_lists[id];
+		if (*list == NULL)
+			ARR_APP1(unsigned, env->split_ids, id);
+		x->next = *list;
+		*list   = x;
 	}
 	/* Let P be a set of Partitions. */
 
-	/* for all sets S except one in the range of map do */
-	for (listmap_entry_t *iter = map.values; iter != NULL; iter = iter->next) {
-		if (iter->next == NULL) {
+	/* for all sets S except one in the range of map do, starting with the
+	 * most recently used id */
+	for (size_t i = ARR_LEN(env->split_ids); i-- > 0; ) {
+		unsigned id = env->split_ids[i];
+		node_t  *S  = env->split_lists[id];
+		env->split_lists[id] = NULL;
+		if (i == 0) {
 			/* this is the last entry, ignore */
 			break;
 		}
-		node_t *S = iter->list;
 
 		/* Add SPLIT( X, S ) to P. */
 		DB((dbg, LEVEL_2, "Split part%d by WHAT = %s\n", X->nr, what_reason));
@@ -1538,31 +1501,37 @@ static partition_t *split_by_what(partition_t *X, what_func What,
 		R->split_next = *P;
 		*P            = R;
 	}
+	ARR_SHRINKLEN(env->split_ids, 0);
+
 	/* Add X to P. */
 	X->split_next = *P;
 	*P            = X;
 
-	listmap_term(&map);
 	return *P;
 }
 
 /** lambda n.(n.type) */
-static void *lambda_type(const node_t *node, environment_t *env)
+static unsigned lambda_type(const node_t *node, environment_t *env)
 {
-	(void)env;
-	return node->type.tv;
+	void *id = pmap_get(void, env->type2id_map, node->type.tv);
+	if (id == NULL) {
+		id = INT_TO_PTR(pmap_count(env->type2id_map) + 1);
+		pmap_insert(env->type2id_map, node->type.tv, id);
+	}
+	return PTR_TO_INT(id);
 }
 
 /** lambda n.(n.opcode) */
-static void *lambda_opcode(const node_t *node, environment_t *env)
+static unsigned lambda_opcode(const node_t *node, environment_t *env)
 {
-	opcode_key_t  key   = { .irn = node->node };
+	unsigned      id    = set_count(env->opcode2id_map) + 1;
+	opcode_key_t  key   = { .irn = node->node, .id = id };
 	opcode_key_t *entry = set_insert(opcode_key_t, env->opcode2id_map, &key, sizeof(key), opcode_hash(&key));
-	return entry;
+	return entry->id;
 }
 
 /** lambda n.(n[i].partition) */
-static void *lambda_partition(const node_t *node, environment_t *env)
+static unsigned lambda_partition(const node_t *node, environment_t *env)
 {
 	int      i   = env->lambda_input;
 	ir_node *irn = node->node;
@@ -1574,22 +1543,22 @@ static void *lambda_partition(const node_t *node, environment_t *env)
 		 * Note that in this case the partition is on the cprop list and will be
 		 * split again.
 		 */
-		return NULL;
+		return 0;
 	}
 
 	/* ignore the "control input" for non-pinned nodes
 	   if we are running in GCSE mode */
 	ir_node *skipped = skip_Proj(irn);
 	if (i < env->end_idx && !get_irn_pinned(skipped))
-		return NULL;
+		return 0;
 
 	ir_node *pred = i == -1 ? get_irn_n(skipped, i) : get_irn_n(irn, i);
 	node_t  *p    = get_irn_node(pred);
-	return p->part;
+	return p->part->nr + 1;
 }
 
 /** lambda n.(n[i].partition) for commutative nodes */
-static void *lambda_commutative_partition(const node_t *node, environment_t *env)
+static unsigned lambda_commutative_partition(const node_t *node, environment_t *env)
 {
 	int i = env->lambda_input;
 	if (i >= get_irn_arity(node->node)) {
@@ -1600,7 +1569,7 @@ static void *lambda_commutative_partition(const node_t *node, environment_t *env
 		 * Note that in this case the partition is on the cprop list and will be
 		 * split again.
 		 */
-		return NULL;
+		return 0;
 	}
 
 	/* ignore the "control input" for non-pinned nodes
@@ -1608,32 +1577,32 @@ static void *lambda_commutative_partition(const node_t *node, environment_t *env
 	ir_node *irn     = node->node;
 	ir_node *skipped = skip_Proj(irn);
 	if (i < env->end_idx && !get_irn_pinned(skipped))
-		return NULL;
+		return 0;
 
 	if (i == -1) {
 		ir_node *pred = get_irn_n(skipped, i);
 		node_t  *p    = get_irn_node(pred);
-		return p->part;
+		return p->part->nr + 1;
 	}
 
 	if (is_op_commutative(get_irn_op(irn))) {
 		/* normalize partition order by returning the "smaller" on input 0,
 		   the "bigger" on input 1. */
-		ir_node     *left  = get_binop_left(irn);
-		partition_t *pl    = get_irn_node(left)->part;
-		ir_node     *right = get_binop_right(irn);
-		partition_t *pr    = get_irn_node(right)->part;
+		ir_node  *left  = get_binop_left(irn);
+		unsigned  pl    = get_irn_node(left)->part->nr;
+		ir_node  *right = get_binop_right(irn);
+		unsigned  pr    = get_irn_node(right)->part->nr;
 
 		if (i == 0)
-			return MIN(pl, pr);
+			return MIN(pl, pr) + 1;
 		else
-			return MAX(pl, pr);
+			return MAX(pl, pr) + 1;
 	} else {
 		/* a not split out follower */
 		ir_node *pred = get_irn_n(irn, i);
 		node_t  *p    = get_irn_node(pred);
 
-		return p->part;
+		return p->part->nr + 1;
 	}
 }
 
@@ -2555,7 +2524,7 @@ static void segregate_def_use_chain(const ir_node *follower)
 static void propagate(environment_t *env)
 {
 	while (env->cprop != NULL) {
-		void *oldopcode = NULL;
+		unsigned oldopcode = 0;
 
 		/* remove the first partition X from cprop */
 		partition_t *X = env->cprop;
@@ -2580,7 +2549,7 @@ static void propagate(environment_t *env)
 
 			if (x->is_follower && identity(x) == x) {
 				/* check the opcode first */
-				if (oldopcode == NULL) {
+				if (oldopcode == 0) {
 					oldopcode = lambda_opcode(get_first_node(X), env);
 				}
 				if (oldopcode != lambda_opcode(x, env)) {
@@ -3194,7 +3163,11 @@ void combo(ir_graph *irg)
 	environment_t env;
 	memset(&env, 0, sizeof(env));
 	obstack_init(&env.obst);
+	env.nodes          = XMALLOCNZ(node_t, get_irg_last_idx(irg));
 	env.opcode2id_map  = new_set(cmp_opcode, iro_last * 4);
+	env.type2id_map    = pmap_create();
+	env.split_lists    = NEW_ARR_FZ(node_t*, 64);
+	env.split_ids      = NEW_ARR_F(unsigned, 0);
 	env.kept_memory    = NEW_ARR_F(ir_node *, 0);
 	env.end_idx        = get_opt_global_cse() ? 0 : -1;
 	/* options driving the optimization */
@@ -3204,7 +3177,6 @@ void combo(ir_graph *irg)
 	set_value_of_func(get_node_tarval);
 
 	set_compute_functions();
-	DEBUG_ONLY(part_nr = 0;)
 
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_PHI_LIST);
 
@@ -3268,8 +3240,12 @@ void combo(ir_graph *irg)
 	DEBUG_ONLY(set_dump_node_vcgattr_hook(NULL);)
 
 	DEL_ARR_F(env.kept_memory);
+	DEL_ARR_F(env.split_ids);
+	DEL_ARR_F(env.split_lists);
+	pmap_destroy(env.type2id_map);
 	del_set(env.opcode2id_map);
 	obstack_free(&env.obst, NULL);
+	free(env.nodes);
 
 	/* restore value_of() default behavior */
 	set_value_of_func(NULL);
@@ -81,7 +81,8 @@ void dead_node_elimination(ir_graph *irg)
 	free_irg_outs(irg);
 	free_loop_information(irg);
 	free_vrp_data(irg);
-	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE
+	                        | IR_GRAPH_PROPERTY_CONSISTENT_INLINE_SUMMARY);
 
 	/* A quiet place, where the old obstack can rest in peace,
 	   until it will be cremated. */
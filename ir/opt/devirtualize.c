@@ -0,0 +1,229 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Speculative devirtualization of indirect calls.
+ *
+ * An indirect call with few possible callees (as computed by cgana()) is
+ * replaced by a chain of guarded direct calls:
+ *
+ *   if (ptr == &f) f(args); else if (ptr == &g) g(args); else ptr(args);
+ *
+ * The direct calls can then be inlined or optimized with the properties of
+ * their callee.  The indirect call stays as a fallback, so the callee set
+ * does not need to be complete.
+ */
+#include "array.h"
+#include "cgana.h"
+#include "debug.h"
+#include "entity_t.h"
+#include "ircons.h"
+#include "irgmod.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irtools.h"
+#include "typerep.h"
+#include "util.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+typedef struct devirt_env_t {
+	unsigned   max_targets;
+	ir_node  **calls;
+} devirt_env_t;
+
+/** Returns true if @p callee can be called with the signature @p mtp. */
+static bool is_compatible(ir_entity const *const callee, ir_type const *const mtp)
+{
+	ir_type const *const callee_mtp = get_entity_type(callee);
+	size_t         const n_params   = get_method_n_params(mtp);
+	size_t         const n_ress     = get_method_n_ress(mtp);
+	if (get_method_n_params(callee_mtp) != n_params
+	    || get_method_n_ress(callee_mtp) != n_ress
+	    || is_method_variadic(callee_mtp) != is_method_variadic(mtp))
+		return false;
+	for (size_t i = 0; i < n_params; ++i) {
+		if (get_type_mode(get_method_param_type(callee_mtp, i))
+		    != get_type_mode(get_method_param_type(mtp, i)))
+			return false;
+	}
+	for (size_t i = 0; i < n_ress; ++i) {
+		ir_mode *const mode = get_type_mode(get_method_res_type(mtp, i));
+		if (mode == NULL
+		    || get_type_mode(get_method_res_type(callee_mtp, i)) != mode)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Orders targets with a graph, which might be inlined, before the others.
+ */
+static int cmp_targets(void const *const a, void const *const b)
+{
+	ir_entity *const ea = *(ir_entity**)a;
+	ir_entity *const eb = *(ir_entity**)b;
+	bool const ga = get_entity_linktime_irg(ea) != NULL;
+	bool const gb = get_entity_linktime_irg(eb) != NULL;
+	if (ga != gb)
+		return ga ? -1 : 1;
+	return QSORT_CMP(get_entity_nr(ea), get_entity_nr(eb));
+}
+
+/**
+ * Collects the known callees of @p call into @p targets and returns their
+ * number or 0 if the call is no candidate.
+ */
+static size_t get_targets(ir_node const *const call, unsigned const max_targets,
+                          ir_entity **const targets)
+{
+	ir_node *const ptr = get_Call_ptr(call);
+	/* direct calls and method selections, which are lowered later */
+	if (is_Address(ptr) || is_Member(ptr) || ir_throws_exception(call)
+	    || !cg_call_has_callees(call))
+		return 0;
+
+	ir_type *const mtp       = get_Call_type(call);
+	size_t         n_targets = 0;
+	for (size_t i = 0, n = cg_get_call_n_callees(call); i < n; ++i) {
+		ir_entity *const callee = cg_get_call_callee(call, i);
+		if (is_unknown_entity(callee))
+			continue;
+		if (n_targets == max_targets || !is_compatible(callee, mtp))
+			return 0;
+		targets[n_targets++] = callee;
+	}
+	QSORT(targets, n_targets, cmp_targets);
+	return n_targets;
+}
+
+static void collect_calls(ir_node *const node, void *const data)
+{
+	if (!is_Call(node))
+		return;
+	devirt_env_t *const env = (devirt_env_t*)data;
+	ir_entity **const targets = ALLOCAN(ir_entity*, env->max_targets);
+	if (get_targets(node, env->max_targets, targets) > 0)
+		ARR_APP1(ir_node*, env->calls, node);
+}
+
+/** Creates a Call of @p ptr in @p block with the operands of @p call. */
+static ir_node *new_call_like(ir_node *const block, ir_node *const call,
+                              ir_node *const ptr)
+{
+	int       const n_params = get_Call_n_params(call);
+	ir_node **const params   = get_Call_param_arr(call);
+	ir_node  *const mem      = get_Call_mem(call);
+	ir_type  *const mtp      = get_Call_type(call);
+	return new_r_Call(block, mem, ptr, n_params, params, mtp);
+}
+
+/** Replaces the indirect call @p call by a chain of guarded direct calls. */
+static void devirtualize_call(ir_node *const call, unsigned const max_targets)
+{
+	ir_entity **const targets   = ALLOCAN(ir_entity*, max_targets);
+	size_t      const n_targets = get_targets(call, max_targets, targets);
+	ir_graph   *const irg       = get_irn_irg(call);
+	ir_node    *const ptr       = get_Call_ptr(call);
+	ir_type    *const mtp       = get_Call_type(call);
+	size_t      const n_ress    = get_method_n_ress(mtp);
+	bool        const has_info  = get_irg_callee_info_state(irg) != irg_callee_info_none;
+	DB((dbg, LEVEL_2, "%+F: %zu guarded targets\n", call, n_targets));
+
+	ir_node *const lower_block = get_nodes_block(call);
+	part_block(call);
+	ir_node *block = get_nodes_block(call);
+
+	/* one path per target and the fallback path */
+	size_t    const n_paths = n_targets + 1;
+	ir_node **const jmps    = ALLOCAN(ir_node*, n_paths);
+	ir_node **const calls   = ALLOCAN(ir_node*, n_paths);
+	for (size_t i = 0; i < n_targets; ++i) {
+		ir_entity *const target = targets[i];
+		ir_node   *const addr   = new_r_Address(irg, target);
+		ir_node   *const cmp    = new_r_Cmp(block, ptr, addr, ir_relation_equal);
+		ir_node   *const cond   = new_r_Cond(block, cmp);
+		ir_node   *const t      = new_r_Proj(cond, mode_X, pn_Cond_true);
+		ir_node   *const f      = new_r_Proj(cond, mode_X, pn_Cond_false);
+
+		ir_node *const call_block = new_r_Block(irg, 1, &t);
+		calls[i] = new_call_like(call_block, call, addr);
+		jmps[i]  = new_r_Jmp(call_block);
+		if (has_info)
+			cg_set_call_callee_arr(calls[i], 1, &targets[i]);
+		block = new_r_Block(irg, 1, &f);
+	}
+	calls[n_targets] = new_call_like(block, call, ptr);
+	jmps[n_targets]  = new_r_Jmp(block);
+	if (has_info) {
+		ir_entity **const callees = call->attr.call.callee_arr;
+		cg_set_call_callee_arr(calls[n_targets], ARR_LEN(callees), callees);
+	}
+
+	/* replace the jump into the lower block by the paths */
+	assert(get_Block_n_cfgpreds(lower_block) == 1);
+	kill_node(get_Block_cfgpred(lower_block, 0));
+	set_irn_in(lower_block, n_paths, jmps);
+
+	ir_node **const ins = ALLOCAN(ir_node*, n_paths);
+	for (size_t i = 0; i < n_paths; ++i)
+		ins[i] = new_r_Proj(calls[i], mode_M, pn_Call_M);
+	ir_node *const mem = new_r_Phi(lower_block, n_paths, ins, mode_M);
+	collect_new_phi_node(mem);
+
+	ir_node **const results = ALLOCAN(ir_node*, n_ress);
+	for (size_t r = 0; r < n_ress; ++r) {
+		ir_mode *const mode = get_type_mode(get_method_res_type(mtp, r));
+		for (size_t i = 0; i < n_paths; ++i) {
+			ir_node *const res = new_r_Proj(calls[i], mode_T, pn_Call_T_result);
+			ins[i] = new_r_Proj(res, mode, r);
+		}
+		results[r] = new_r_Phi(lower_block, n_paths, ins, mode);
+		collect_new_phi_node(results[r]);
+	}
+
+	ir_node *const call_in[] = {
+		[pn_Call_M]        = mem,
+		[pn_Call_T_result] = new_r_Tuple(lower_block, n_ress, results),
+	};
+	assert(pn_Call_M == 0 && pn_Call_T_result == 1);
+	set_nodes_block(call, lower_block);
+	turn_into_tuple(call, ARRAY_SIZE(call_in), call_in);
+}
+
+void opt_speculative_devirtualization(ir_graph *const irg,
+                                      unsigned const max_targets)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.devirtualize");
+	if (max_targets == 0)
+		return;
+
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_TUPLES);
+	devirt_env_t env = {
+		.max_targets = max_targets,
+		.calls       = NEW_ARR_F(ir_node*, 0),
+	};
+	irg_walk_graph(irg, NULL, collect_calls, &env);
+
+	size_t const n_calls = ARR_LEN(env.calls);
+	if (n_calls > 0) {
+		/* part_block() needs the Phi lists and the Projs linked */
+		ir_resources_t const resources = IR_RESOURCE_IRN_LINK
+		                               | IR_RESOURCE_PHI_LIST;
+		ir_reserve_resources(irg, resources);
+		collect_phiprojs_and_start_block_nodes(irg);
+		for (size_t i = 0; i < n_calls; ++i)
+			devirtualize_call(env.calls[i], max_targets);
+		ir_free_resources(irg, resources);
+	}
+	DEL_ARR_F(env.calls);
+
+	DB((dbg, LEVEL_1, "%+F: %zu calls devirtualized\n", irg, n_calls));
+	confirm_irg_properties(irg, n_calls == 0 ? IR_GRAPH_PROPERTIES_ALL
+	                                         : IR_GRAPH_PROPERTIES_NONE);
+}
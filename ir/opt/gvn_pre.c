@@ -10,6 +10,7 @@
  * @author  Michael Beck
  * @brief
  */
+#include "array.h"
 #include "debug.h"
 #include "ircons.h"
 #include "irdom.h"
@@ -21,14 +22,14 @@
 #include "irgwalk.h"
 #include "irloop.h"
 #include "irnode_t.h"
-#include "irnodehashmap.h"
 #include "irnodeset.h"
 #include "iropt_dbg.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
 #include "irouts.h"
+#include "pdeq.h"
+#include "raw_bitset.h"
 #include "tv_t.h"
-#include "valueset.h"
 
 /* suggested by GVN-PRE authors */
 #define MAX_ANTIC_ITER 10
@@ -60,20 +61,67 @@
 #define OPTIMIZE_NODES 0
 
 
+/** A value number together with the expression representing it. */
+typedef struct value_entry {
+	unsigned  id;    /* value number */
+	ir_node  *expr;  /* leader of the value */
+} value_entry;
+
+/**
+ * A set of values. Membership is a bitset over the dense value numbers,
+ * the leaders are kept in insertion order.
+ */
+typedef struct value_set {
+	unsigned    *members;  /* raw bitset of the contained value numbers */
+	value_entry *entries;  /* contained values in insertion order */
+} value_set;
+
+/** Phi translation of one element of the antic_in set of a successor. */
+typedef struct trans_entry {
+	ir_node *expr;   /* the translated leader */
+	ir_node *trans;  /* its translation, valid while expr is the leader */
+} trans_entry;
+
 /** Additional info we need for every block. */
 typedef struct block_info {
-	ir_valueset_t     *exp_gen;    /* contains this blocks clean expressions */
-	ir_valueset_t     *avail_out;  /* available values at block end */
-	ir_valueset_t     *antic_in;   /* clean anticipated values at block entry */
-	ir_valueset_t     *antic_done; /* keeps elements of antic_in after insert nodes phase */
-	ir_valueset_t     *new_set;    /* new by hoisting made available values */
-	ir_nodehashmap_t  *trans;      /* contains translated nodes translated into block */
-	ir_node           *avail;      /* saves available node for insert node phase */
-	int                found;      /* saves kind of availability for insert_node phase */
-	ir_node           *block;      /* block of the block_info */
-	struct block_info *next;       /* links all instances for easy access */
+	value_set          exp_gen;     /* contains this blocks clean expressions */
+	value_set          antic_in;    /* clean anticipated values at block entry */
+	value_set          antic_done;  /* keeps elements of antic_in after insert nodes phase */
+	value_entry       *avail_gen;   /* values computed in this block, in topological order */
+	trans_entry       *trans;       /* translations of the successors antic_in into this block,
+	                                   indexed like its entries */
+	ir_node           *avail;       /* saves available node for insert node phase */
+	int                found;       /* saves kind of availability for insert_node phase */
+	unsigned           n_visits;    /* number of antic_in computations */
+	bool               in_worklist; /* block is queued for antic_in computation */
+	ir_node           *block;       /* block of the block_info */
+	struct block_info *next;        /* links all instances for easy access */
 } block_info;
 
+/**
+ * Availability of a value in a block and all blocks dominated by it.
+ * The newest entry whose block dominates a block provides the leader there.
+ */
+typedef struct avail_entry {
+	ir_node            *block; /* block the value is available in */
+	ir_node            *expr;  /* leader of the value */
+	struct avail_entry *next;  /* the next older entry of the same value */
+} avail_entry;
+
+/** Information about a value, indexed by its value number. */
+typedef struct value_info {
+	ir_node     *value;     /* node representing the value */
+	avail_entry *avail;     /* availability of the value, newest first */
+	unsigned     antic_pos; /* position in the antic_in set being computed */
+	unsigned     trans_pos; /* position in the antic_in set being translated */
+} value_info;
+
+/** GVN information of a node, indexed by the node index. */
+typedef struct node_info {
+	ir_node  *value; /* value of the node, if it has been remembered */
+	unsigned  id;    /* value number, if the node represents a value */
+} node_info;
+
 /**
  * A pair of nodes to be exchanged.
  * We have to defer the exchange because there are still needed references
@@ -98,7 +146,8 @@ typedef struct pre_env {
 	unsigned        last_idx;     /* last node index of input graph */
 	char            changes;      /* flag for fixed point iterations - non-zero if changes occurred */
 	char            first_iter;   /* non-zero for first fixed point iteration */
-	int             iteration;    /* iteration counter */
+	node_info      *nodes;        /* GVN information of all nodes */
+	value_info     *values;       /* information of all value numbers */
 #if OPTIMIZE_NODES
 	pset           *value_table;   /* standard value table*/
 	pset           *gvnpre_values; /* GVN-PRE value table */
@@ -107,12 +156,65 @@ typedef struct pre_env {
 
 static pre_env *environment;
 
-/* custom GVN value map */
-static ir_nodehashmap_t value_map;
-
 /* debug module handle */
 DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 
+/* --------------------------------------------------------
+ * Value sets
+ * --------------------------------------------------------
+ */
+
+#define foreach_value_set(set, entry) \
+	for (value_entry *entry = (set)->entries, *entry##_end = entry + ARR_LEN((set)->entries); entry != entry##_end; ++entry)
+
+static void value_set_init(value_set *set)
+{
+	set->members = NEW_ARR_F(unsigned, 0);
+	set->entries = NEW_ARR_F(value_entry, 0);
+}
+
+static void value_set_free(value_set *set)
+{
+	DEL_ARR_F(set->members);
+	DEL_ARR_F(set->entries);
+}
+
+static bool value_set_contains(value_set const *set, unsigned id)
+{
+	return id / BITS_PER_ELEM < ARR_LEN(set->members)
+	    && rbitset_is_set(set->members, id);
+}
+
+/**
+ * Appends a value which is not yet contained in a set.
+ *
+ * @return the position of the new entry
+ */
+static unsigned value_set_append(value_set *set, unsigned id, ir_node *expr)
+{
+	size_t const n_elems = ARR_LEN(set->members);
+	size_t const elem    = id / BITS_PER_ELEM;
+	if (elem >= n_elems) {
+		ARR_RESIZE(unsigned, set->members, elem + 1);
+		memset(&set->members[n_elems], 0, (elem + 1 - n_elems) * sizeof(*set->members));
+	}
+	rbitset_set(set->members, id);
+
+	value_entry const entry = { id, expr };
+	ARR_APP1(value_entry, set->entries, entry);
+	return ARR_LEN(set->entries) - 1;
+}
+
+/**
+ * Inserts a value into a set, keeping the old leader if the value is
+ * already contained.
+ */
+static void value_set_insert(value_set *set, unsigned id, ir_node *expr)
+{
+	if (!value_set_contains(set, id))
+		value_set_append(set, id, expr);
+}
+
 #ifdef DEBUG_libfirm
 
 /* --------------------------------------------------------
@@ -176,15 +278,13 @@ static void print_stats(void)
  * @param txt    a text to describe the set
  * @param block  the owner block of the set
  */
-static void dump_value_set(ir_valueset_t *set, const char *txt, ir_node *block)
+static void dump_value_set(value_set const *set, const char *txt, ir_node *block)
 {
-	ir_valueset_iterator_t iter;
-	ir_node *value, *expr;
-	int i;
-
 	DB((dbg, LEVEL_2, "%s(%+F) = {\n", txt, block));
-	i = 0;
-	foreach_valueset(set, value, expr, iter) {
+	int i = 0;
+	foreach_value_set(set, entry) {
+		ir_node *value = environment->values[entry->id].value;
+		ir_node *expr  = entry->expr;
 		if ((i & 3) == 3)
 			DB((dbg, LEVEL_2, "\n"));
 		if (value != expr)
@@ -204,7 +304,7 @@ static void dump_value_set(ir_valueset_t *set, const char *txt, ir_node *block)
 static void dump_all_expgen_sets(block_info *list)
 {
 	for (block_info *block_info = list; block_info != NULL; block_info = block_info->next) {
-		dump_value_set(block_info->exp_gen, "[Exp_gen]", block_info->block);
+		dump_value_set(&block_info->exp_gen, "[Exp_gen]", block_info->block);
 	}
 }
 
@@ -276,6 +376,37 @@ static int compare_gvn_identities(const void *elt, const void *key)
 	return !a->op->ops.attrs_equal(a, b);
 }
 
+/**
+ * Returns the GVN information of a node.
+ * The returned pointer is invalidated by the creation of new nodes.
+ */
+static node_info *get_node_info(const ir_node *irn)
+{
+	unsigned const idx = get_irn_idx(irn);
+	size_t   const len = ARR_LEN(environment->nodes);
+	if (idx >= len) {
+		unsigned const last_idx = get_irg_last_idx(environment->graph);
+		ARR_RESIZE(node_info, environment->nodes, last_idx);
+		memset(&environment->nodes[len], 0, (last_idx - len) * sizeof(*environment->nodes));
+	}
+	return &environment->nodes[idx];
+}
+
+/**
+ * Returns the dense value number of a value node.
+ * A new number is assigned on first use.
+ */
+static unsigned get_value_id(ir_node *value)
+{
+	node_info *info = get_node_info(value);
+	if (info->id == 0) {
+		value_info const vinfo = { value, NULL, 0, 0 };
+		info->id = ARR_LEN(environment->values);
+		ARR_APP1(value_info, environment->values, vinfo);
+	}
+	return info->id;
+}
+
 /**
  * Identify does a lookup in the GVN value table.
  * To be used when no new GVN values are to be created.
@@ -285,7 +416,7 @@ static int compare_gvn_identities(const void *elt, const void *key)
  */
 static ir_node *identify(ir_node *irn)
 {
-	ir_node *value = ir_nodehashmap_get(ir_node, &value_map, irn);
+	ir_node *value = get_node_info(irn)->value;
 	if (value)
 		return value;
 	/* irn represents a new value, so return the leader */
@@ -354,7 +485,7 @@ static ir_node *remember(ir_node *irn)
 	free(in);
 
 	DB((dbg, LEVEL_4, "Remember %+F as value %+F\n", irn, value));
-	ir_nodehashmap_insert(&value_map, irn, value);
+	get_node_info(irn)->value = value;
 
 	return value;
 }
@@ -365,7 +496,7 @@ static ir_node *remember(ir_node *irn)
  */
 static ir_node *identify_or_remember(ir_node *irn)
 {
-	ir_node *value = ir_nodehashmap_get(ir_node, &value_map, irn);
+	ir_node *value = get_node_info(irn)->value;
 	if (value)
 		return value;
 	else
@@ -388,17 +519,16 @@ static void alloc_block_info(ir_node *block, pre_env *env)
 	block_info *info = OALLOC(&env->obst, block_info);
 
 	set_irn_link(block, info);
-	info->exp_gen    = ir_valueset_new(16);
-	info->avail_out  = ir_valueset_new(16);
-	info->antic_in   = ir_valueset_new(16);
-	info->antic_done = ir_valueset_new(16);
-	info->trans = XMALLOC(ir_nodehashmap_t);
-	ir_nodehashmap_init(info->trans);
-
-	info->new_set = NULL;
-	info->avail   = NULL;
-	info->block   = block;
-	info->found   = 1;
+	value_set_init(&info->exp_gen);
+	value_set_init(&info->antic_in);
+	value_set_init(&info->antic_done);
+	info->avail_gen   = NEW_ARR_F(value_entry, 0);
+	info->trans       = NULL;
+	info->avail       = NULL;
+	info->block       = block;
+	info->found       = 1;
+	info->n_visits    = 0;
+	info->in_worklist = false;
 
 	info->next = env->list;
 	env->list  = info;
@@ -406,15 +536,13 @@ static void alloc_block_info(ir_node *block, pre_env *env)
 
 static void free_block_info(block_info *block_info)
 {
-	ir_valueset_del(block_info->exp_gen);
-	ir_valueset_del(block_info->avail_out);
-	ir_valueset_del(block_info->antic_in);
-	if (block_info->trans) {
-		ir_nodehashmap_destroy(block_info->trans);
-		free(block_info->trans);
-	}
-	if (block_info->new_set)
-		ir_valueset_del(block_info->new_set);
+	value_set_free(&block_info->exp_gen);
+	value_set_free(&block_info->antic_in);
+	value_set_free(&block_info->antic_done);
+	if (block_info->avail_gen)
+		DEL_ARR_F(block_info->avail_gen);
+	if (block_info->trans)
+		DEL_ARR_F(block_info->trans);
 }
 
 /**
@@ -439,6 +567,45 @@ static block_info *get_block_info(ir_node *block)
 	return (block_info*)get_irn_link(block);
 }
 
+/* --------------------------------------------------------
+ * Availability
+ * --------------------------------------------------------
+ */
+
+/**
+ * Returns the leader of a value available at the end of a block or NULL.
+ */
+static ir_node *get_avail(ir_node *block, unsigned id)
+{
+	for (avail_entry const *avail = environment->values[id].avail; avail != NULL; avail = avail->next) {
+		if (block_dominates(avail->block, block))
+			return avail->expr;
+	}
+	return NULL;
+}
+
+/**
+ * Makes expr the leader of a value in a block and the blocks it dominates.
+ */
+static void replace_avail(ir_node *block, unsigned id, ir_node *expr)
+{
+	avail_entry *avail = OALLOC(&environment->obst, avail_entry);
+	avail->block = block;
+	avail->expr  = expr;
+	avail->next  = environment->values[id].avail;
+	environment->values[id].avail = avail;
+}
+
+/**
+ * Makes expr the leader of a value in a block unless the value is
+ * already available there.
+ */
+static void insert_avail(ir_node *block, unsigned id, ir_node *expr)
+{
+	if (get_avail(block, id) == NULL)
+		replace_avail(block, id, expr);
+}
+
 /* --------------------------------------------------------
  * Infinite loop analysis
  * --------------------------------------------------------
@@ -634,7 +801,7 @@ static unsigned is_nice_value(ir_node *n)
  * @param block  the block
  * @return non-zero value for clean node
  */
-static unsigned is_clean_in_block(ir_node *n, ir_node *block, ir_valueset_t *valueset)
+static unsigned is_clean_in_block(ir_node *n, ir_node *block, value_set const *valueset)
 {
 	if (is_Phi(n))
 		return 1;
@@ -675,8 +842,8 @@ static unsigned is_clean_in_block(ir_node *n, ir_node *block, ir_valueset_t *val
 		if (!is_nice_value(pred))
 			return 0;
 
-		ir_node *const value = identify(pred);
-		if (!ir_valueset_lookup(valueset, value))
+		unsigned const value = get_value_id(identify(pred));
+		if (!value_set_contains(valueset, value))
 			return 0;
 	}
 	return 1;
@@ -710,19 +877,22 @@ static void topo_walker(ir_node *irn, void *ctx)
 
 	ir_node    *block = get_nodes_block(irn);
 	block_info *info  = get_block_info(block);
+	unsigned    id    = get_value_id(value);
 
-	if (get_irn_mode(irn) != mode_X)
-		ir_valueset_insert(info->avail_out, value, irn);
+	if (get_irn_mode(irn) != mode_X) {
+		value_entry const entry = { id, irn };
+		ARR_APP1(value_entry, info->avail_gen, entry);
+	}
 
 	/* values that are not in antic_in also don't need to be in any other set */
 
 	if (!is_nice_value(irn))
 		return;
 
-	if (is_clean_in_block(irn, block, info->exp_gen)) {
+	if (is_clean_in_block(irn, block, &info->exp_gen)) {
 		DB((dbg, LEVEL_3, "%+F clean in block %+F\n", irn, block));
 
-		ir_valueset_insert(info->exp_gen, value, irn);
+		value_set_insert(&info->exp_gen, id, irn);
 	}
 }
 
@@ -732,37 +902,85 @@ static void topo_walker(ir_node *irn, void *ctx)
  */
 
 /**
- * Gets result of nodes phi translation into block.
+ * Gets result of the phi translation of an element of the antic_in set of
+ * the successor of block.
  *
- * @param node   the node
  * @param block  the target block
+ * @param pos    the position of the element in the antic_in set
+ * @param expr   the leader of the element
  *
- * @return a phi translation of node node into block block or NULL
+ * @return a phi translation of expr into block block or NULL
  */
-static ir_node *get_translated(ir_node *block, ir_node *node)
+static ir_node *get_translated(ir_node *block, unsigned pos, ir_node *expr)
 {
-	if (is_irn_constlike(node))
-		return node;
+	if (is_irn_constlike(expr))
+		return expr;
 
-	return ir_nodehashmap_get(ir_node, get_block_info(block)->trans, node);
+	trans_entry const *trans = get_block_info(block)->trans;
+	if (trans != NULL && pos < ARR_LEN(trans) && trans[pos].expr == expr)
+		return trans[pos].trans;
+	return NULL;
 }
 
 /**
- * Saves result of phi translation of node into predecessor
- * at pos of block succ.
+ * Saves result of phi translation of an element of the antic_in set of
+ * the successor of block.
  *
- * @param node   the node
- * @param succ   the successor of the translation target block
- * @param pos    the position of the predecessor block
+ * @param block  the target block
+ * @param pos    the position of the element in the antic_in set
+ * @param expr   the leader of the element
  * @param trans  the translation result
+ */
+static void set_translated(ir_node *block, unsigned pos, ir_node *expr, ir_node *trans)
+{
+	if (is_irn_constlike(expr))
+		return;
+
+	block_info *info = get_block_info(block);
+	if (info->trans == NULL)
+		info->trans = NEW_ARR_F(trans_entry, 0);
+
+	size_t const len = ARR_LEN(info->trans);
+	if (pos >= len) {
+		ARR_RESIZE(trans_entry, info->trans, pos + 1);
+		memset(&info->trans[len], 0, (pos + 1 - len) * sizeof(*info->trans));
+	}
+	info->trans[pos].expr  = expr;
+	info->trans[pos].trans = trans;
+}
+
+/**
+ * Records the positions of the elements of an antic_in set, which are
+ * needed to look up their translations by value.
+ */
+static void set_trans_pos(value_set const *antic)
+{
+	value_info *values = environment->values;
+	for (size_t i = 0, n = ARR_LEN(antic->entries); i < n; ++i)
+		values[antic->entries[i].id].trans_pos = i;
+}
+
+/**
+ * Gets the phi translation of the value of node into pred_block.
+ * The anti leader of the value is the representative which has been
+ * translated. set_trans_pos() must have been called for leaderset.
+ *
+ * @param pred_block  the target block
+ * @param leaderset   the antic_in set of the successor of pred_block
+ * @param node        the node
  *
+ * @return a phi translation of the value of node or NULL
  */
-static void set_translated(ir_nodehashmap_t *map, ir_node *node, ir_node *trans)
+static ir_node *get_translated_value(ir_node *pred_block, value_set const *leaderset, ir_node *node)
 {
+	unsigned const value = get_value_id(identify(node));
+	if (value_set_contains(leaderset, value)) {
+		unsigned const pos = environment->values[value].trans_pos;
+		return get_translated(pred_block, pos, leaderset->entries[pos].expr);
+	}
 	if (is_irn_constlike(node))
-		return;
-	/* insert or replace */
-	ir_nodehashmap_insert(map, node, trans);
+		return node;
+	return NULL;
 }
 
 /**
@@ -771,10 +989,11 @@ static void set_translated(ir_nodehashmap_t *map, ir_node *node, ir_node *trans)
  * @param node        the node
  * @param block       the block the node is translated into
  * @param pos         the input number of the destination block
+ * @param leaderset   the antic_in set of block
  *
  * @return a node representing the translated value
  */
-static ir_node *phi_translate(ir_node *node, ir_node *block, int pos, ir_valueset_t *leaderset)
+static ir_node *phi_translate(ir_node *node, ir_node *block, int pos, value_set const *leaderset)
 {
 	ir_node *pred_block = get_Block_cfgpred_block(block, pos);
 
@@ -794,19 +1013,11 @@ static ir_node *phi_translate(ir_node *node, ir_node *block, int pos, ir_valuese
 	   value we always use the anti leader. The anti leader can be found by
 	   antic_in(identify(node)). */
 	foreach_irn_in(node, i, pred) {
-		ir_node *value  = identify(pred);
-		/* get leader for pred to lookup its translated value */
-		ir_node *leader = ir_valueset_lookup(leaderset, value);
-		ir_node *pred_trans;
 		ir_node *new_pred;
 
-		if (!leader)
-			leader = pred;
-
 		/* we cannot find this value in antic_in, because the value
 		   has (possibly) changed! */
-		pred_trans = get_translated(pred_block, leader);
-
+		ir_node *pred_trans = get_translated_value(pred_block, leaderset, pred);
 
 #if DIVMODS
 		if (is_Div(node)) {
@@ -819,7 +1030,7 @@ static ir_node *phi_translate(ir_node *node, ir_node *block, int pos, ir_valuese
 		}
 #endif
 
-		DB((dbg, LEVEL_3, "trans %+F of %+F is  %+F\n", leader, pred_block, pred_trans));
+		DB((dbg, LEVEL_3, "trans %+F of %+F is  %+F\n", pred, pred_block, pred_trans));
 		if (pred_trans == NULL) {
 			new_pred = pred;
 		} else {
@@ -875,119 +1086,131 @@ static ir_node *phi_translate(ir_node *node, ir_node *block, int pos, ir_valuese
 }
 
 /**
- * Block-walker, computes Antic_in(block).
+
+/**
+ * Replaces the leader of a value in the antic_in set being computed or
+ * adds the value.
+ */
+static void antic_replace(value_set *antic, unsigned id, ir_node *expr)
+{
+	value_info *values = environment->values;
+	if (value_set_contains(antic, id))
+		antic->entries[values[id].antic_pos].expr = expr;
+	else
+		values[id].antic_pos = value_set_append(antic, id, expr);
+}
+
+/**
+ * Computes Antic_in(block).
  * Builds a value tree out of the graph by translating values
  * over phi nodes.
  *
- * @param block  the block
- * @param ctx    the walker environment
+ * @param info  the block info of the block
+ * @param env   the environment
+ *
+ * @return true if Antic_in(block) has changed
  */
-static void compute_antic(ir_node *block, void *ctx)
+static bool compute_antic(block_info *info, pre_env *env)
 {
-	pre_env                *env   = (pre_env *)ctx;
-	ir_node                *value;
-	ir_node                *expr;
-	ir_valueset_iterator_t  iter;
-
-	/* filter blocks from topological walker */
-	if (!is_Block(block))
-		return;
-
-	/* the end block has no successor */
-	if (block == env->end_block)
-		return;
-
-	block_info *info = get_block_info(block);
+	ir_node   *block = info->block;
+	value_set *antic = &info->antic_in;
 	/* track changes */
-	size_t size   = ir_valueset_size(info->antic_in);
-	int    n_succ = get_Block_n_cfg_outs(block);
+	size_t     size   = ARR_LEN(antic->entries);
+	int        n_succ = get_Block_n_cfg_outs(block);
+	/* After MAX_ANTIC_ITER computations antic_in is not extended anymore,
+	   but the translations are still completed for the insert phase. */
+	bool       grow   = info->n_visits < MAX_ANTIC_ITER;
 
 	/* add exp_gen */
-	if (env->first_iter) {
+	if (info->n_visits++ == 0) {
 #if IGNORE_INF_LOOPS
 		/* keep antic_in of infinite loops empty */
 		if (!is_in_infinite_loop(block)) {
-			foreach_valueset(info->exp_gen, value, expr, iter) {
-				ir_valueset_insert(info->antic_in, value, expr);
+			foreach_value_set(&info->exp_gen, entry) {
+				value_set_insert(antic, entry->id, entry->expr);
 			}
 		}
 #else
-		foreach_valueset(info->exp_gen, value, expr, iter) {
-			ir_valueset_insert(info->antic_in, value, expr);
+		foreach_value_set(&info->exp_gen, entry) {
+			value_set_insert(antic, entry->id, entry->expr);
 		}
 #endif
 	}
 
+	value_info *values = env->values;
+	for (size_t i = 0, n = ARR_LEN(antic->entries); i < n; ++i)
+		values[antic->entries[i].id].antic_pos = i;
+
 	/* successor might have phi nodes */
 	if (n_succ == 1 && get_irn_arity(get_Block_cfg_out(block, 0)) > 1) {
 		int         pos;
-		ir_node    *succ      = get_Block_cfg_out_ex(block, 0, &pos);
-		block_info *succ_info = get_block_info(succ);
+		ir_node    *succ       = get_Block_cfg_out_ex(block, 0, &pos);
+		value_set  *succ_antic = &get_block_info(succ)->antic_in;
 
-		/* initialize translated set */
-		if (env->first_iter) {
-			info->trans = XMALLOC(ir_nodehashmap_t);
-			ir_nodehashmap_init(info->trans);
-		}
+		set_trans_pos(succ_antic);
 
-		foreach_valueset(succ_info->antic_in, value, expr, iter) {
-			ir_node *trans = get_translated(block, expr);
-			ir_node *trans_value;
-			ir_node *represent;
+		/* The set may grow while iterating over it in case of a self loop. */
+		for (unsigned i = 0; i < ARR_LEN(succ_antic->entries); ++i) {
+			unsigned  value = succ_antic->entries[i].id;
+			ir_node  *expr  = succ_antic->entries[i].expr;
+			ir_node  *trans = get_translated(block, i, expr);
 
 			if (trans == NULL)
-				trans = phi_translate(expr, succ, pos, get_block_info(succ)->antic_in);
+				trans = phi_translate(expr, succ, pos, succ_antic);
 
 			/* create new value if necessary */
-			trans_value = identify_or_remember(trans);
+			unsigned trans_value = get_value_id(identify_or_remember(trans));
 
-			DB((dbg, LEVEL_3, "Translate %+F %+F to %d = %+F (%+F)\n", expr, succ, pos, trans, trans_value));
+			DB((dbg, LEVEL_3, "Translate %+F %+F to %d = %+F (%+F)\n", expr, succ, pos, trans, env->values[trans_value].value));
 
 			/* On value change (phi present) we need the translated node
 			   to represent the new value for possible further translation. */
-			represent = value != trans_value ? trans : expr;
+			ir_node *represent = value != trans_value ? trans : expr;
 
-			if (is_clean_in_block(expr, block, info->antic_in)) {
+			if (grow && is_clean_in_block(expr, block, antic)) {
 #if NO_INF_LOOPS
 				/* Prevent information flow over the backedge of endless loops. */
-				if (env->iteration <= 2 || (is_backedge(succ, pos) && !is_in_infinite_loop(succ))) {
-					ir_valueset_replace(info->antic_in, trans_value, represent);
+				if (info->n_visits <= 2 || (is_backedge(succ, pos) && !is_in_infinite_loop(succ))) {
+					antic_replace(antic, trans_value, represent);
 				}
 #else
-				ir_valueset_replace(info->antic_in, trans_value, represent);
+				antic_replace(antic, trans_value, represent);
 #endif
+				if (succ == block)
+					env->values[trans_value].trans_pos = env->values[trans_value].antic_pos;
 			}
-			set_translated(info->trans, expr, represent);
+			set_translated(block, i, expr, represent);
 		}
 
-	} else if (n_succ > 1) {
-		ir_node    *common     = NULL;
-		ir_node    *succ0      = get_Block_cfg_out(block, 0);
-		block_info *succ0_info = get_block_info(succ0);
+	} else if (n_succ > 1 && grow) {
+		ir_node   *succ0       = get_Block_cfg_out(block, 0);
+		value_set *succ0_antic = &get_block_info(succ0)->antic_in;
 
 		/* disjoint of antic_ins */
-		foreach_valueset(succ0_info->antic_in, value, expr, iter) {
+		for (size_t i = 0; i < ARR_LEN(succ0_antic->entries); ++i) {
+			unsigned  value  = succ0_antic->entries[i].id;
+			ir_node  *expr   = succ0_antic->entries[i].expr;
+			bool      common = true;
+
 			/* iterate over remaining successors */
-			for (int i = 1; i < n_succ; ++i) {
-				ir_node    *succ      = get_Block_cfg_out(block, i);
-				block_info *succ_info = get_block_info(succ);
+			for (int j = 1; j < n_succ; ++j) {
+				ir_node *succ = get_Block_cfg_out(block, j);
 
 				/* value in antic_in? */
-				common = ir_valueset_lookup(succ_info->antic_in, value);
-				if (common == NULL)
+				if (!value_set_contains(&get_block_info(succ)->antic_in, value)) {
+					common = false;
 					break;
+				}
 			}
 
-			if (common && is_clean_in_block(expr, block, info->antic_in))
-				ir_valueset_replace(info->antic_in, value, expr);
+			if (common && is_clean_in_block(expr, block, antic))
+				antic_replace(antic, value, expr);
 		}
 	}
 
+	DEBUG_ONLY(dump_value_set(antic, "Antic_in", block);)
 
-	DEBUG_ONLY(dump_value_set(info->antic_in, "Antic_in", block);)
-
-	if (size != ir_valueset_size(info->antic_in))
-		env->changes |= 1;
+	return size != ARR_LEN(antic->entries);
 }
 
 /* --------------------------------------------------------
@@ -1001,6 +1224,9 @@ static void compute_antic(ir_node *block, void *ctx)
  * Avail_in(block)  = Avail_out(dom(block))
  * Avail_out(block) = Avail_in(block) \/ Nodes(block)
  *
+ * Avail_in(block) is inherited implicitly by the availability entries
+ * of the dominators, so only the new values of the block are recorded.
+ *
  * Precondition:
  *  This function must be called in the top-down topological order:
  *  Then it computes Leader(Nodes(block)) instead of Nodes(block) !
@@ -1017,21 +1243,13 @@ static void compute_avail_top_down(ir_node *block, void *ctx)
 
 	block_info *info = get_block_info(block);
 
-	/* Add all nodes from the immediate dominator.
-	   This ensures that avail_out contains the leader. */
-	if (block != env->start_block) {
-		ir_node                *dom_block = get_Block_idom(block);
-		block_info             *dom_info  = get_block_info(dom_block);
-		ir_node                *value;
-		ir_node                *expr;
-		ir_valueset_iterator_t  iter;
-
-		foreach_valueset(dom_info->avail_out, value, expr, iter)
-			/* replace: use the leader from dominator, not local exp_gen */
-			ir_valueset_replace(info->avail_out, value, expr);
+	/* Values available in the immediate dominator keep their leader. */
+	for (size_t i = 0, n = ARR_LEN(info->avail_gen); i < n; ++i) {
+		value_entry const *entry = &info->avail_gen[i];
+		insert_avail(block, entry->id, entry->expr);
 	}
-
-	DEBUG_ONLY(dump_value_set(info->avail_out, "Avail_out", block);)
+	DEL_ARR_F(info->avail_gen);
+	info->avail_gen = NULL;
 }
 
 /* --------------------------------------------------------
@@ -1044,10 +1262,11 @@ static void compute_avail_top_down(ir_node *block, void *ctx)
  *
  * @param block   the block
  * @param expr    the expression
+ * @param pos     the position of expr in the antic_in set of block
  *
  * @return mode of the expression if it is partially redundant else NULL
  */
-static ir_mode *is_partially_redundant(ir_node *block, ir_node *expr, ir_node *value)
+static ir_mode *is_partially_redundant(ir_node *block, ir_node *expr, unsigned pos)
 {
 	ir_node *first_avail         = NULL;
 	int      arity               = get_irn_arity(block);
@@ -1055,22 +1274,21 @@ static ir_mode *is_partially_redundant(ir_node *block, ir_node *expr, ir_node *v
 	bool     partially_redundant = false;
 	ir_mode *mode                = NULL;
 
-	(void)value;
-	DB((dbg, LEVEL_3, "is partially redundant %+F(%+F) of %+F\n", expr, value, block));
+	DB((dbg, LEVEL_3, "is partially redundant %+F of %+F\n", expr, block));
 
 	/* for each predecessor blocks */
-	for (int pos = 0; pos < arity; ++pos) {
-		ir_node    *pred_block  = get_Block_cfgpred_block(block, pos);
+	for (int i = 0; i < arity; ++i) {
+		ir_node    *pred_block  = get_Block_cfgpred_block(block, i);
 		ir_node    *avail_expr;
 
 		block_info *pred_info  = get_block_info(pred_block);
-		ir_node    *trans_expr = get_translated(pred_block, expr);
+		ir_node    *trans_expr = get_translated(pred_block, pos, expr);
 		ir_node    *trans_value = identify(trans_expr);
 
 		if (is_Const(trans_expr))
 			avail_expr = trans_expr;
 		else
-			avail_expr = (ir_node*)ir_valueset_lookup(pred_info->avail_out, trans_value);
+			avail_expr = get_avail(pred_block, get_value_id(trans_value));
 
 		/* value might be available through a not yet existing constant */
 		if (avail_expr == NULL && is_Const(trans_expr)) {
@@ -1116,36 +1334,6 @@ static ir_mode *is_partially_redundant(ir_node *block, ir_node *expr, ir_node *v
 	return mode;
 }
 
-/**
- * Updates the new_set of a block by adding the new_set of
- * the immediate dominating block.
- *
- * @param  the block
- */
-static void update_new_set(ir_node *block, ir_node *idom)
-{
-	ir_node                *value;
-	ir_node                *expr;
-	ir_valueset_iterator_t  iter;
-	block_info             *curr_info = get_block_info(block);
-	block_info             *idom_info = get_block_info(idom);
-	int                     updated   = 0;
-
-	DEBUG_ONLY(dump_value_set(idom_info->new_set, "[New Set]", idom);)
-	foreach_valueset(idom_info->new_set, value, expr, iter) {
-		/* inherit new_set from immediate dominator */
-		ir_valueset_insert(curr_info->new_set, value, expr);
-		/* replace in avail_out */
-		updated |= ir_valueset_replace(curr_info->avail_out, value, expr);
-	}
-#ifdef DEBUG_libfirm
-	if (updated)
-		dump_value_set(curr_info->avail_out, "Updated [Avail_out]", block);
-#else
-	(void)updated;
-#endif
-}
-
 /**
  * Checks if hoisting irn is greedy.
  * Greedy hoisting means that there are non partially redundant nodes
@@ -1160,8 +1348,7 @@ static unsigned is_hoisting_greedy(ir_node *irn, ir_node *block)
 	/* As long as the predecessor values are available in all predecessor blocks,
 	   we can hoist this value. */
 	for (int pos = 0; pos < block_arity; ++pos) {
-		ir_node    *pred_block = get_Block_cfgpred_block(block, pos);
-		block_info *pred_info  = get_block_info(pred_block);
+		ir_node *pred_block = get_Block_cfgpred_block(block, pos);
 
 		foreach_irn_in(irn, i, pred) {
 #if MIN_CUT
@@ -1174,12 +1361,7 @@ static unsigned is_hoisting_greedy(ir_node *irn, ir_node *block)
 				continue;
 
 			DB((dbg, LEVEL_3, "pred %+F\n", pred));
-			ir_node *value = identify(pred);
-			ir_node *leader = ir_valueset_lookup(info->antic_in, value);
-			if (!leader)
-				leader = pred;
-			DB((dbg, LEVEL_3, "lead %+F\n", leader));
-			ir_node *trans = get_translated(pred_block, leader);
+			ir_node *trans = get_translated_value(pred_block, &info->antic_in, pred);
 			if (!trans)
 				trans = pred;
 			DB((dbg, LEVEL_3, "trans %+F\n", trans));
@@ -1210,14 +1392,14 @@ static unsigned is_hoisting_greedy(ir_node *irn, ir_node *block)
 			if (is_irn_constlike(trans_val))
 				continue;
 
-			ir_node *avail = ir_valueset_lookup(pred_info->avail_out, trans_val);
+			ir_node *avail = get_avail(pred_block, get_value_id(trans_val));
 
 			DB((dbg, LEVEL_3, "avail %+F\n", avail));
 			if (!avail)
 				return 1;
 #if MIN_CUT
 			/* only optimize if predecessors have been optimized */
-			if (ir_valueset_lookup(info->antic_done, value) == NULL)
+			if (!value_set_contains(&info->antic_done, get_value_id(identify(pred))))
 				return 1;
 #endif
 		}
@@ -1228,15 +1410,16 @@ static unsigned is_hoisting_greedy(ir_node *irn, ir_node *block)
 /**
  * Perform insertion of partially redundant values.
  * For every block node, do the following:
- * 1.  Propagate the NEW_SETS of the dominator into the current block.
+ * 1.  The values made available by the dominators are inherited
+ *     through the availability entries.
  * If the block has multiple predecessors,
  *     2a. Iterate over the ANTIC expressions for the block to see if
  *         any of them are partially redundant.
  *     2b. If so, insert them into the necessary predecessors to make
  *         the expression fully redundant.
  *     2c. Insert a new Phi merging the values of the predecessors.
- *     2d. Insert the new Phi, and the new expressions, into the
- *         NEW_SETS set.
+ *     2d. Make the new Phi the leader of the value in the block and
+ *         all blocks dominated by it.
  *
  * @param block  the block
  * @param ctx    the walker environment
@@ -1245,51 +1428,46 @@ static void insert_nodes_walker(ir_node *block, void *ctx)
 {
 	pre_env *env = (pre_env *)ctx;
 
-	/* ensure that even the start block has a new_set */
-	block_info *info = get_block_info(block);
-	if (info->new_set)
-		ir_valueset_del(info->new_set);
-	info->new_set = ir_valueset_new(16);
-
 	if (block == env->start_block)
 		return;
 
 	DB((dbg, LEVEL_2, "Insert operation of %+F\n", block));
 
-	ir_node *idom = get_Block_idom(block);
-	update_new_set(block, idom);
-
 	/* process only path joining blocks */
 	int arity = get_irn_arity(block);
 	if (arity < 2) {
 		return;
 	}
 
-	ir_node                *value;
-	ir_node                *expr;
-	ir_valueset_iterator_t  iter;
+	ir_node    *idom = get_Block_idom(block);
+	block_info *info = get_block_info(block);
+
+	set_trans_pos(&info->antic_in);
 
 	/* This is the main reason antic_in is preferred over antic_out;
 	   we may iterate over every anticipated value first and not
 	   over the predecessor blocks. */
-	foreach_valueset(info->antic_in, value, expr, iter) {
+	for (unsigned idx = 0, n = ARR_LEN(info->antic_in.entries); idx < n; ++idx) {
+		unsigned  value = info->antic_in.entries[idx].id;
+		ir_node  *expr  = info->antic_in.entries[idx].expr;
+
 		/* already done? */
-		if (ir_valueset_lookup(info->antic_done, value))
+		if (value_set_contains(&info->antic_done, value))
 			continue;
 
 		/* filter phi nodes from antic_in */
 		if (is_Phi(expr))
 			continue;
 
-		DB((dbg, LEVEL_2, "Insert for %+F (value %+F) in %+F\n", expr, value, block));
+		DB((dbg, LEVEL_2, "Insert for %+F (value %+F) in %+F\n", expr, env->values[value].value, block));
 
 		/* A value computed in the dominator is totally redundant.
 		   Hence we have nothing to insert. */
-		if (ir_valueset_lookup(get_block_info(idom)->avail_out, value)) {
-			DB((dbg, LEVEL_2, "Fully redundant expr %+F value %+F\n", expr, value));
+		if (get_avail(idom, value)) {
+			DB((dbg, LEVEL_2, "Fully redundant expr %+F value %+F\n", expr, env->values[value].value));
 			DEBUG_ONLY(inc_stats(gvnpre_stats->fully);)
 
-			ir_valueset_insert(info->antic_done, value, expr);
+			value_set_insert(&info->antic_done, value, expr);
 			continue;
 		}
 
@@ -1298,7 +1476,7 @@ static void insert_nodes_walker(ir_node *block, void *ctx)
 			continue;
 		}
 
-		ir_mode  *mode = is_partially_redundant(block, expr, value);
+		ir_mode  *mode = is_partially_redundant(block, expr, idx);
 		if (mode == NULL)
 			continue;
 
@@ -1339,20 +1517,13 @@ static void insert_nodes_walker(ir_node *block, void *ctx)
 				ir_node  *target_block = pred_block;
 
 				foreach_irn_in(expr, i, pred) {
-					const ir_node *value = identify(pred);
-
 					/* transform knowledge over the predecessor from
 					   anti-leader world into leader world. */
 
 					DB((dbg, LEVEL_3, "pred %+F\n", pred));
 
-					/* get leader for pred to lookup its translated value */
-					ir_node *leader = ir_valueset_lookup(info->antic_in, value);
-					if (!leader)
-						leader = pred;
-					DB((dbg, LEVEL_3, "lead %+F\n", leader));
-
-					ir_node *trans = get_translated(pred_block, leader);
+					/* the translation of the anti leader of pred */
+					ir_node *trans = get_translated_value(pred_block, &info->antic_in, pred);
 					if (!trans)
 						trans = pred;
 					DB((dbg, LEVEL_3, "trans %+F\n", trans));
@@ -1375,7 +1546,7 @@ static void insert_nodes_walker(ir_node *block, void *ctx)
 					/* use the leader
 					   In case of loads we need to make sure the hoisted
 					   loads are found despite their unique value. */
-					ir_node *avail = ir_valueset_lookup(pred_info->avail_out, trans_val);
+					ir_node *avail = get_avail(pred_block, get_value_id(trans_val));
 					DB((dbg, LEVEL_3, "avail %+F\n", avail));
 
 					assert(avail && "predecessor has to be available");
@@ -1395,14 +1566,14 @@ static void insert_nodes_walker(ir_node *block, void *ctx)
 				/* value is now available in target block through trans
 				   insert (not replace) because it has not been available */
 				ir_node *new_value = identify_or_remember(trans);
-				ir_valueset_insert(pred_info->avail_out, new_value, trans);
+				insert_avail(pred_block, get_value_id(new_value), trans);
 				DB((dbg, LEVEL_4, "avail%+F+= trans %+F(%+F)\n", pred_block, trans, new_value));
 
-				ir_node *new_value2 = identify(get_translated(pred_block, expr));
-				ir_valueset_insert(pred_info->avail_out, new_value2, trans);
+				ir_node *new_value2 = identify(get_translated(pred_block, idx, expr));
+				insert_avail(pred_block, get_value_id(new_value2), trans);
 				DB((dbg, LEVEL_4, "avail%+F+= trans %+F(%+F)\n", pred_block, trans, new_value2));
 
-				DB((dbg, LEVEL_3, "Use new %+F in %+F because %+F(%+F) not available\n", trans, pred_block, expr, value));
+				DB((dbg, LEVEL_3, "Use new %+F in %+F because %+F(%+F) not available\n", trans, pred_block, expr, env->values[value].value));
 
 				phi_in[pos] = trans;
 			} else {
@@ -1418,32 +1589,18 @@ static void insert_nodes_walker(ir_node *block, void *ctx)
 			ir_node *phi = new_r_Phi(block, arity, phi_in, mode);
 			DB((dbg, LEVEL_3, "New %+F for redundant %+F created\n", phi, expr));
 
-			/* This value is now available through the new phi.
-			   insert || replace in avail_out */
-			ir_valueset_replace(info->avail_out, value, phi);
-			ir_valueset_insert(info->new_set, value, phi);
+			/* This value is now available through the new phi. */
+			replace_avail(block, value, phi);
 		}
 		free(phi_in);
 
 		/* already optimized this value in this block */
-		ir_valueset_insert(info->antic_done, value, expr);
+		value_set_insert(&info->antic_done, value, expr);
 		env->changes |= 1;
 	}
 }
 
 #if HOIST_HIGH
-static void update_new_set_walker(ir_node *block, void *ctx)
-{
-	pre_env *env = (pre_env*)ctx;
-
-	if (!is_Block(block))
-		return;
-	if (block == env->start_block)
-		return;
-
-	update_new_set(block, get_Block_idom(block));
-}
-
 /**
  * Domtree block walker to insert nodes with dying operands
  * into the highest possible block whilst still being anticipated.
@@ -1452,28 +1609,26 @@ static void hoist_high(ir_node *block, void *ctx)
 {
 	(void)ctx;
 
-	ir_valueset_iterator_t  iter;
-	ir_node                *expr;
-	ir_node                *value;
-	int                     arity = get_irn_arity(block);
+	int arity = get_irn_arity(block);
 
 	if (!is_Block(block))
 		return;
 
 	block_info *curr_info = get_block_info(block);
 
-	if (curr_info->new_set)
-		ir_valueset_del(curr_info->new_set);
-	curr_info->new_set = ir_valueset_new(16);
-
 	if (arity < 2)
 		return;
 
 	DB((dbg, LEVEL_2, "High hoisting %+F\n", block));
 
+	set_trans_pos(&curr_info->antic_in);
+
 	/* foreach entry optimized by insert node phase */
-	foreach_valueset(curr_info->antic_done, value, expr, iter) {
-		int pos;
+	foreach_value_set(&curr_info->antic_done, entry) {
+		ir_node  *expr      = entry->expr;
+		unsigned  trans_pos = environment->values[entry->id].trans_pos;
+		ir_node  *value     = environment->values[entry->id].value;
+		int       pos;
 
 		/* TODO currently we cannot handle load and their projections */
 		if (is_memop(expr) || is_Proj(expr))
@@ -1484,13 +1639,12 @@ static void hoist_high(ir_node *block, void *ctx)
 		/* visit hoisted expressions */
 		for (pos = 0; pos < arity; ++pos) {
 			/* standard target is predecessor block */
-			ir_node    *target     = get_Block_cfgpred_block(block, pos);
-			block_info *pred_info  = get_block_info(target);
+			ir_node *target = get_Block_cfgpred_block(block, pos);
 
 			/* get phi translated value */
-			ir_node *trans_expr  = get_translated(target, expr);
+			ir_node *trans_expr  = get_translated(target, trans_pos, expr);
 			ir_node *trans_value = identify(trans_expr);
-			ir_node *avail       = (ir_node*)ir_valueset_lookup(pred_info->avail_out, trans_value);
+			ir_node *avail       = get_avail(target, get_value_id(trans_value));
 
 			/* get the used expr on this path */
 
@@ -1499,6 +1653,7 @@ static void hoist_high(ir_node *block, void *ctx)
 				continue;
 
 			value = identify(avail);
+			unsigned const value_id = get_value_id(value);
 
 			/* anticipation border */
 			ir_node  *new_target = NULL;
@@ -1526,7 +1681,7 @@ static void hoist_high(ir_node *block, void *ctx)
 				   being set during antic computation. */
 
 				/* check if available node is still anticipated and clean */
-				if (!ir_valueset_lookup(dom_info->antic_in, value)) {
+				if (!value_set_contains(&dom_info->antic_in, value_id)) {
 					DB((dbg, LEVEL_4, "%+F not antic in %+F\n", value, dom));
 					break;
 				}
@@ -1544,14 +1699,14 @@ static void hoist_high(ir_node *block, void *ctx)
 
 				/* check for uses on current path */
 				foreach_irn_in(avail, i, pred) {
-					ir_node *const pred_value = identify(pred);
+					unsigned const pred_value = get_value_id(identify(pred));
 
 					if (dom == NULL)
 						break;
 
 					DB((dbg, LEVEL_4, "testing pred %+F\n", pred));
 
-					if (!ir_valueset_lookup(dom_info->avail_out, pred_value)) {
+					if (!get_avail(dom, pred_value)) {
 						DB((dbg, LEVEL_4, "pred %+F not available\n", pred));
 						dom = NULL;
 						break;
@@ -1587,15 +1742,14 @@ static void hoist_high(ir_node *block, void *ctx)
 
 			/* put node into new target block */
 			if (new_target) {
-				block_info *target_info = get_block_info(new_target);
-				int         nn_arity    = get_irn_arity(avail);
-				ir_node   **in          = XMALLOCN(ir_node *, nn_arity);
+				int       nn_arity = get_irn_arity(avail);
+				ir_node **in       = XMALLOCN(ir_node *, nn_arity);
 
 				DB((dbg, LEVEL_2, "Hoisting %+F into %+F\n", avail, new_target));
 				DEBUG_ONLY(inc_stats(gvnpre_stats->hoist_high);)
 
 				foreach_irn_in(avail, i, pred) {
-					ir_node *avail_pred = ir_valueset_lookup(target_info->avail_out, identify(pred));
+					ir_node *avail_pred = get_avail(new_target, get_value_id(identify(pred)));
 					assert(avail_pred);
 					in[i] = avail_pred;
 				}
@@ -1603,11 +1757,9 @@ static void hoist_high(ir_node *block, void *ctx)
 				free(in);
 
 				identify_or_remember(nn);
-				/* TODO Nodes are inserted into a dominating block and should
-				   be available from this point on. Currently we do not push
-				   the availability information through during the walk. */
-				ir_valueset_insert(target_info->new_set, value, nn);
-				ir_valueset_insert(target_info->avail_out, value, nn);
+				/* Nodes are inserted into a dominating block and are
+				   available in all blocks dominated by it from now on. */
+				insert_avail(new_target, value_id, nn);
 			}
 		}
 	}
@@ -1637,8 +1789,7 @@ static void eliminate(ir_node *irn, void *ctx)
 
 		if (value != NULL) {
 			ir_node    *block = get_nodes_block(irn);
-			block_info *info  = get_block_info(block);
-			ir_node    *expr  = (ir_node *)ir_valueset_lookup(info->avail_out, value);
+			ir_node    *expr  = get_avail(block, get_value_id(value));
 			DB((dbg, LEVEL_3, "Elim %+F(%+F) avail %+F\n", irn, value, expr));
 
 			if (expr != NULL && expr != irn) {
@@ -1717,8 +1868,6 @@ static void gvn_pre(ir_graph *irg, pre_env *env)
 	/* allocate block info */
 	irg_walk_blkwise_graph(irg, block_info_walker, NULL, env);
 
-	ir_nodehashmap_init(&value_map);
-
 	/* generate exp_gen */
 	irg_walk_blkwise_graph(irg, NULL, topo_walker, env);
 	dump_all_expgen_sets(env->list);
@@ -1726,21 +1875,38 @@ static void gvn_pre(ir_graph *irg, pre_env *env)
 	/* compute the avail_out sets for all blocks */
 	dom_tree_walk_irg(irg, compute_avail_top_down, NULL, env);
 
-	/* compute the anticipated value sets for all blocks */
+	/* compute the anticipated value sets for all blocks,
+	   successors first */
+	deq_t worklist;
+	deq_init(&worklist);
+	for (block_info *info = env->list; info != NULL; info = info->next) {
+		if (info->block == env->end_block)
+			continue;
+		deq_push_pointer_left(&worklist, info);
+		info->in_worklist = true;
+	}
+
 	unsigned antic_iter = 0;
-	env->first_iter = 1;
+	while (!deq_empty(&worklist)) {
+		block_info *info = deq_pop_pointer_left(block_info, &worklist);
+		info->in_worklist = false;
 
-	env->iteration = 1;
-	/* antic_in passes */
-	do {
-		++antic_iter;
-		DB((dbg, LEVEL_2, "= Antic_in Iteration %d ========================\n", antic_iter));
-		env->changes = 0;
-		irg_walk_blkwise_graph(irg, compute_antic, NULL, env);
-		env->first_iter = 0;
-		DB((dbg, LEVEL_2, "----------------------------------------------\n"));
-		env->iteration ++;
-	} while (env->changes != 0 && antic_iter < MAX_ANTIC_ITER);
+		bool const changed = compute_antic(info, env);
+		antic_iter = MAX(antic_iter, info->n_visits);
+		if (!changed)
+			continue;
+
+		/* the antic_in sets of the predecessors depend on this block */
+		for (int i = 0, arity = get_Block_n_cfgpreds(info->block); i < arity; ++i) {
+			ir_node    *pred      = get_Block_cfgpred_block(info->block, i);
+			block_info *pred_info = get_block_info(pred);
+			if (!pred_info->in_worklist) {
+				deq_push_pointer_right(&worklist, pred_info);
+				pred_info->in_worklist = true;
+			}
+		}
+	}
+	deq_free(&worklist);
 
 	DEBUG_ONLY(set_stats(gvnpre_stats->antic_iterations, antic_iter);)
 
@@ -1763,8 +1929,6 @@ static void gvn_pre(ir_graph *irg, pre_env *env)
 	/* An attempt to reduce lifetimes by hoisting already hoisted values
 	   even higher if their operands die. */
 	dom_tree_walk_irg(irg, hoist_high, NULL, NULL);
-	/* update avail_out for elimination */
-	dom_tree_walk_irg(irg, update_new_set_walker, NULL, env);
 #endif
 
 	/* Deactivate edges to prevent intelligent removal of nodes,
@@ -1821,6 +1985,9 @@ void do_gvn_pre(ir_graph *irg)
 	env.pairs        = NULL;
 	env.keeps        = &keeps;
 	env.last_idx     = get_irg_last_idx(irg);
+	env.nodes        = NEW_ARR_FZ(node_info, env.last_idx);
+	/* value number 0 is unused */
+	env.values       = NEW_ARR_FZ(value_info, 1);
 	obstack_init(&env.obst);
 
 	/* Detect and set links of infinite loops to non-zero. */
@@ -1855,7 +2022,8 @@ void do_gvn_pre(ir_graph *irg)
 	}
 
 	DEBUG_ONLY(free_stats();)
-	ir_nodehashmap_destroy(&value_map);
+	DEL_ARR_F(env.nodes);
+	DEL_ARR_F(env.values);
 	obstack_free(&env.obst, NULL);
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_LOOP_LINK);
 
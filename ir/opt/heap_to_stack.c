@@ -0,0 +1,549 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Escape analysis and promotion of heap allocations to the frame.
+ *
+ * A call of a malloc-like function (a function with the property
+ * mtp_property_malloc taking the size as its only argument) with a constant,
+ * small size is promoted to a frame entity if the pointer it returns does not
+ * escape: it is only used for address arithmetic, as the address of Loads,
+ * Stores and CopyBs, in comparisons and as the argument of calls to free.
+ * Passing the pointer to a function whose graph is known is allowed if the
+ * function does not let the parameter escape either; these summaries are
+ * computed on demand and cached.
+ *
+ * The pointer cannot flow through Phis or memory, so an allocation inside a
+ * loop is dead once the iteration ends and all iterations can share the same
+ * entity.  The calls to free are removed, the frame is released on return.
+ *
+ * If the object is only accessed by Loads and Stores at constant offsets, the
+ * entity gets a struct type with a member per offset and the accesses use
+ * these members, so scalar replacement can turn the object into values.
+ */
+#include "array.h"
+#include "debug.h"
+#include "ircons.h"
+#include "irgmod.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irouts_t.h"
+#include "irtools.h"
+#include "pmap.h"
+#include "tv.h"
+#include "typerep.h"
+#include "util.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+/** Maximum depth of calls followed when computing parameter summaries. */
+#define MAX_SUMMARY_DEPTH 3
+
+/** Offset of pointers not known to be at a constant offset of the object. */
+#define UNKNOWN_OFFSET LONG_MIN
+
+typedef struct access_t {
+	ir_node *node;   /**< a Load or Store */
+	long     offset; /**< offset of the accessed address in the object */
+} access_t;
+
+typedef struct promotion_t {
+	ir_node   *call;
+	ir_node   *result;   /**< the pointer returned by the call */
+	long       size;
+	bool       typed;    /**< all accesses are Loads or Stores at constant offsets */
+	ir_node  **frees;    /**< calls freeing the object */
+	ir_node  **cmps;     /**< comparisons with the null pointer */
+	access_t  *accesses;
+} promotion_t;
+
+typedef struct escape_env_t {
+	pmap        *derived;    /**< pointers derived from the object */
+	promotion_t *promotion;  /**< NULL while computing a summary */
+	unsigned     depth;
+} escape_env_t;
+
+/** Escape summaries: for every graph a bitset of non-escaping parameters. */
+static pmap *summaries;
+
+/** Marks graphs whose summary is being computed. */
+#define SUMMARY_PENDING ((void*)1)
+
+/** Parameters beyond this one are assumed to escape. */
+#define MAX_SUMMARY_PARAMS 30
+
+/** Set in every computed summary, distinguishing it from SUMMARY_PENDING. */
+#define SUMMARY_COMPUTED (1u << 31)
+
+static bool pointer_escapes(escape_env_t *env, ir_node *ptr, long offset);
+static bool param_escapes(ir_graph *irg, size_t pos, unsigned depth);
+
+static bool is_derived(escape_env_t const *const env, ir_node const *const node)
+{
+	return pmap_contains(env->derived, node);
+}
+
+/** Returns true if @p callee is free(). */
+static bool is_free(ir_entity const *const callee)
+{
+	return callee != NULL && strcmp(get_entity_ld_name(callee), "free") == 0;
+}
+
+/** Returns the callee of the malloc-like @p call or NULL. */
+static ir_entity *get_malloc_callee(ir_node const *const call)
+{
+	ir_entity *const callee = get_Call_callee(call);
+	if (callee == NULL
+	    || !(get_entity_additional_properties(callee) & mtp_property_malloc))
+		return NULL;
+	ir_type *const mtp = get_Call_type(call);
+	if (get_method_n_params(mtp) != 1 || get_method_n_ress(mtp) != 1)
+		return NULL;
+	return callee;
+}
+
+/** Returns true if @p call may throw or has exception control flow. */
+static bool has_exception_flow(ir_node const *const call)
+{
+	foreach_irn_out_r(call, i, proj) {
+		if (get_irn_mode(proj) == mode_X)
+			return true;
+	}
+	return false;
+}
+
+/** Returns true if the derived pointer @p ptr is used in @p call. */
+static bool escapes_in_call(escape_env_t *const env, ir_node *const call,
+                            ir_node const *const ptr)
+{
+	if (get_Call_ptr(call) == ptr || has_exception_flow(call))
+		return true;
+	ir_entity *const callee = get_Call_callee(call);
+	if (is_free(callee)) {
+		/* only the object itself may be freed, and not by a callee */
+		if (env->promotion == NULL || ptr != env->promotion->result)
+			return true;
+		ARR_APP1(ir_node*, env->promotion->frees, call);
+		return false;
+	}
+	ir_graph *const callee_irg = callee != NULL
+		? get_entity_linktime_irg(callee) : NULL;
+	if (callee_irg == NULL || env->depth >= MAX_SUMMARY_DEPTH)
+		return true;
+	if (env->promotion != NULL)
+		env->promotion->typed = false;
+	for (int i = 0, n = get_Call_n_params(call); i < n; ++i) {
+		if (get_Call_param(call, i) == ptr
+		    && param_escapes(callee_irg, i, env->depth + 1))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Returns true if the pointer @p ptr derived from the object escapes through
+ * its user @p user.
+ */
+static bool escapes_in_user(escape_env_t *const env, ir_node *const user,
+                            ir_node *const ptr, long const offset)
+{
+	promotion_t *const promotion = env->promotion;
+	switch (get_irn_opcode(user)) {
+	case iro_Load:
+		if (get_Load_volatility(user) == volatility_is_volatile)
+			return true;
+		if (promotion != NULL) {
+			access_t const access = { user, offset };
+			ARR_APP1(access_t, promotion->accesses, access);
+		}
+		return false;
+
+	case iro_Store:
+		if (get_Store_value(user) == ptr
+		    || get_Store_volatility(user) == volatility_is_volatile)
+			return true;
+		if (promotion != NULL) {
+			access_t const access = { user, offset };
+			ARR_APP1(access_t, promotion->accesses, access);
+		}
+		return false;
+
+	case iro_CopyB:
+		if (promotion != NULL)
+			promotion->typed = false;
+		return false;
+
+	case iro_Cmp: {
+		ir_node *const other = get_Cmp_left(user) == ptr
+			? get_Cmp_right(user) : get_Cmp_left(user);
+		if (promotion != NULL) {
+			ir_relation const rel = get_Cmp_relation(user);
+			if (offset == 0 && is_Const(other) && is_Const_null(other)
+			    && (rel == ir_relation_equal
+			        || rel == ir_relation_less_greater)) {
+				ARR_APP1(ir_node*, promotion->cmps, user);
+			} else {
+				promotion->typed = false;
+			}
+		}
+		return false;
+	}
+
+	case iro_Add: {
+		ir_node *const other = get_Add_left(user) == ptr
+			? get_Add_right(user) : get_Add_left(user);
+		if (is_derived(env, other) || mode_is_reference(get_irn_mode(other)))
+			return true;
+		long new_offset = UNKNOWN_OFFSET;
+		if (offset != UNKNOWN_OFFSET && is_Const(other)
+		    && tarval_is_long(get_Const_tarval(other)))
+			new_offset = offset + get_tarval_long(get_Const_tarval(other));
+		return pointer_escapes(env, user, new_offset);
+	}
+
+	case iro_Sub: {
+		/* the difference of two pointers does not let either escape */
+		if (!mode_is_reference(get_irn_mode(user)))
+			return false;
+		ir_node *const other = get_Sub_right(user);
+		if (other == ptr)
+			return true;
+		long new_offset = UNKNOWN_OFFSET;
+		if (offset != UNKNOWN_OFFSET && is_Const(other)
+		    && tarval_is_long(get_Const_tarval(other)))
+			new_offset = offset - get_tarval_long(get_Const_tarval(other));
+		return pointer_escapes(env, user, new_offset);
+	}
+
+	case iro_Member: {
+		ir_entity *const entity = get_Member_entity(user);
+		ir_type   *const owner  = get_entity_owner(entity);
+		long new_offset = UNKNOWN_OFFSET;
+		if (offset != UNKNOWN_OFFSET && get_type_state(owner) == layout_fixed
+		    && get_entity_bitfield_size(entity) == 0)
+			new_offset = offset + get_entity_offset(entity);
+		return pointer_escapes(env, user, new_offset);
+	}
+
+	case iro_Sel: {
+		if (get_Sel_index(user) == ptr)
+			return true;
+		ir_node *const index    = get_Sel_index(user);
+		ir_type *const elements = get_array_element_type(get_Sel_type(user));
+		long new_offset = UNKNOWN_OFFSET;
+		if (offset != UNKNOWN_OFFSET && is_Const(index)
+		    && tarval_is_long(get_Const_tarval(index))
+		    && get_type_state(elements) == layout_fixed)
+			new_offset = offset + get_tarval_long(get_Const_tarval(index))
+			                      * (long)get_type_size(elements);
+		return pointer_escapes(env, user, new_offset);
+	}
+
+	case iro_Confirm:
+		if (get_Confirm_bound(user) == ptr)
+			return true;
+		return pointer_escapes(env, user, offset);
+
+	case iro_Call:
+		return escapes_in_call(env, user, ptr);
+
+	case iro_End:
+		return false;
+
+	default:
+		/* Phis, Returns, Convs and everything else */
+		return true;
+	}
+}
+
+/** Returns true if the pointer @p ptr derived from the object escapes. */
+static bool pointer_escapes(escape_env_t *const env, ir_node *const ptr,
+                            long const offset)
+{
+	if (is_derived(env, ptr))
+		return true;
+	pmap_insert(env->derived, ptr, ptr);
+	foreach_irn_out_r(ptr, i, user) {
+		if (escapes_in_user(env, user, ptr, offset))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Returns true if the parameter @p pos of @p irg may escape from a call of
+ * @p irg.
+ */
+static bool param_escapes(ir_graph *const irg, size_t const pos,
+                          unsigned const depth)
+{
+	if (pos >= MAX_SUMMARY_PARAMS)
+		return true;
+	void *const summary = pmap_get(void, summaries, irg);
+	if (summary == SUMMARY_PENDING)
+		return true;
+	if (summary != NULL)
+		return !(PTR_TO_INT(summary) & (1u << pos));
+
+	/* compute the summary of all parameters at once */
+	pmap_insert(summaries, irg, SUMMARY_PENDING);
+	assure_irg_outs(irg);
+	/* parameters without uses do not escape */
+	unsigned       non_escaping = (1u << MAX_SUMMARY_PARAMS) - 1;
+	ir_node *const args         = get_irg_args(irg);
+	foreach_irn_out_r(args, i, proj) {
+		unsigned const num = get_Proj_num(proj);
+		if (num >= MAX_SUMMARY_PARAMS || !(non_escaping & (1u << num)))
+			continue;
+		escape_env_t env = {
+			.derived   = pmap_create(),
+			.promotion = NULL,
+			.depth     = depth,
+		};
+		if (!mode_is_reference(get_irn_mode(proj))
+		    || pointer_escapes(&env, proj, UNKNOWN_OFFSET))
+			non_escaping &= ~(1u << num);
+		pmap_destroy(env.derived);
+	}
+	pmap_insert(summaries, irg, INT_TO_PTR(non_escaping | SUMMARY_COMPUTED));
+	DB((dbg, LEVEL_3, "%+F: non-escaping parameters %x\n", irg, non_escaping));
+	return !(non_escaping & (1u << pos));
+}
+
+static void free_promotion(promotion_t *const promotion)
+{
+	DEL_ARR_F(promotion->frees);
+	DEL_ARR_F(promotion->cmps);
+	DEL_ARR_F(promotion->accesses);
+}
+
+static int cmp_accesses(void const *const a, void const *const b)
+{
+	access_t const *const aa = (access_t const*)a;
+	access_t const *const ab = (access_t const*)b;
+	return QSORT_CMP(aa->offset, ab->offset);
+}
+
+static ir_mode *get_access_mode(ir_node const *const access)
+{
+	return is_Load(access) ? get_Load_mode(access)
+	                       : get_irn_mode(get_Store_value(access));
+}
+
+/**
+ * Checks whether the accesses of @p promotion use disjoint ranges of the
+ * object with one mode each and sorts them by offset.
+ */
+static bool has_disjoint_accesses(promotion_t *const promotion)
+{
+	QSORT_ARR(promotion->accesses, cmp_accesses);
+	long end = 0;
+	for (size_t i = 0, n = ARR_LEN(promotion->accesses); i < n; ++i) {
+		access_t const *const access = &promotion->accesses[i];
+		ir_mode        *const mode   = get_access_mode(access->node);
+		long            const size   = get_mode_size_bytes(mode);
+		if (access->offset == UNKNOWN_OFFSET || access->offset < 0
+		    || access->offset + size > promotion->size)
+			return false;
+		if (i > 0 && access->offset == promotion->accesses[i - 1].offset) {
+			if (mode != get_access_mode(promotion->accesses[i - 1].node))
+				return false;
+			continue;
+		}
+		if (access->offset < end)
+			return false;
+		end = access->offset + size;
+	}
+	return true;
+}
+
+/** Checks whether the allocation @p call can be promoted. */
+static bool analyze_call(ir_node *const call, unsigned const max_size,
+                         promotion_t *const promotion)
+{
+	if (get_malloc_callee(call) == NULL || has_exception_flow(call))
+		return false;
+	ir_node *const size = get_Call_param(call, 0);
+	if (!is_Const(size) || !tarval_is_long(get_Const_tarval(size)))
+		return false;
+	long const n_bytes = get_tarval_long(get_Const_tarval(size));
+	if (n_bytes <= 0 || n_bytes > (long)max_size)
+		return false;
+
+	ir_node *result = NULL;
+	foreach_irn_out_r(call, i, proj) {
+		if (get_Proj_num(proj) != pn_Call_T_result)
+			continue;
+		foreach_irn_out_r(proj, j, res) {
+			if (get_Proj_num(res) == 0)
+				result = res;
+		}
+	}
+	if (result == NULL)
+		return false;
+
+	*promotion = (promotion_t) {
+		.call     = call,
+		.result   = result,
+		.size     = n_bytes,
+		.typed    = true,
+		.frees    = NEW_ARR_F(ir_node*, 0),
+		.cmps     = NEW_ARR_F(ir_node*, 0),
+		.accesses = NEW_ARR_F(access_t, 0),
+	};
+	escape_env_t env = {
+		.derived   = pmap_create(),
+		.promotion = promotion,
+		.depth     = 0,
+	};
+	bool const escapes = pointer_escapes(&env, result, 0);
+	pmap_destroy(env.derived);
+	if (escapes) {
+		free_promotion(promotion);
+		return false;
+	}
+	for (size_t i = 0, n = ARR_LEN(promotion->frees); i < n; ++i) {
+		if (has_exception_flow(promotion->frees[i])) {
+			free_promotion(promotion);
+			return false;
+		}
+	}
+	promotion->typed = promotion->typed && has_disjoint_accesses(promotion);
+	return true;
+}
+
+static void collect_calls(ir_node *const node, void *const data)
+{
+	if (is_Call(node)) {
+		ir_node ***const calls = (ir_node***)data;
+		ARR_APP1(ir_node*, *calls, node);
+	}
+}
+
+/** Removes the call @p call without results from the memory chain. */
+static void remove_call(ir_node *const call)
+{
+	ir_node *const mem = get_Call_mem(call);
+	foreach_irn_out_r(call, i, proj) {
+		if (get_irn_mode(proj) == mode_M)
+			exchange(proj, mem);
+	}
+}
+
+/**
+ * Creates a struct type with a member for each access of @p promotion and
+ * redirects the accesses to the members.
+ */
+static ir_type *build_typed_object(promotion_t const *const promotion,
+                                   ir_node *const object)
+{
+	long      const nr       = get_irn_node_nr(promotion->call);
+	ir_type  *const type     = new_type_struct(new_id_fmt("malloc%ld$type", nr));
+	unsigned        align    = 1;
+	ir_entity      *member   = NULL;
+	long            previous = -1;
+	for (size_t i = 0, n = ARR_LEN(promotion->accesses); i < n; ++i) {
+		access_t const *const access = &promotion->accesses[i];
+		if (access->offset != previous) {
+			ir_mode *const mode   = get_access_mode(access->node);
+			ir_type *const mtype  = get_type_for_mode(mode);
+			ident   *const id     = new_id_fmt("m%ld", access->offset);
+			member   = new_entity(type, id, mtype);
+			previous = access->offset;
+			set_entity_offset(member, access->offset);
+			align = MAX(align, get_type_alignment(mtype));
+		}
+		ir_node *const node  = access->node;
+		ir_node *const block = get_nodes_block(node);
+		ir_node *const addr  = new_r_Member(block, object, member);
+		if (is_Load(node))
+			set_Load_ptr(node, addr);
+		else
+			set_Store_ptr(node, addr);
+	}
+	set_type_size(type, promotion->size);
+	set_type_alignment(type, align);
+	set_type_state(type, layout_fixed);
+	return type;
+}
+
+/** Replaces the allocation described by @p promotion by a frame entity. */
+static void promote(promotion_t const *const promotion)
+{
+	ir_node  *const call  = promotion->call;
+	ir_graph *const irg   = get_irn_irg(call);
+	long      const nr    = get_irn_node_nr(call);
+	ir_node  *const block = get_irg_start_block(irg);
+	ir_type  *const frame = get_irg_frame_type(irg);
+	DB((dbg, LEVEL_2, "%+F: promoting %+F (%ld bytes%s)\n", irg, call,
+	    promotion->size, promotion->typed ? ", typed" : ""));
+
+	/* the entity starts out untyped and gets its type once the accesses
+	 * refer to it */
+	ir_type   *const bytes  = new_type_array(get_type_for_mode(mode_Bu),
+	                                         promotion->size);
+	ir_entity *const entity = new_entity(frame, new_id_fmt("malloc%ld$stack", nr),
+	                                     bytes);
+	ir_node   *const object = new_r_Member(block, get_irg_frame(irg), entity);
+	if (promotion->typed) {
+		set_entity_type(entity, build_typed_object(promotion, object));
+	} else {
+		/* keep the alignment malloc guarantees */
+		set_type_alignment(bytes, 2 * get_mode_size_bytes(mode_P));
+	}
+
+	ir_node *const t = new_r_Const(irg, tarval_b_true);
+	ir_node *const f = new_r_Const(irg, tarval_b_false);
+	for (size_t i = 0, n = ARR_LEN(promotion->cmps); i < n; ++i) {
+		ir_node *const cmp = promotion->cmps[i];
+		exchange(cmp, get_Cmp_relation(cmp) == ir_relation_equal ? f : t);
+	}
+	for (size_t i = 0, n = ARR_LEN(promotion->frees); i < n; ++i)
+		remove_call(promotion->frees[i]);
+	exchange(promotion->result, object);
+	remove_call(call);
+}
+
+void opt_heap_to_stack(ir_graph *const irg, unsigned const max_size)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.heap-to-stack");
+	assure_irg_properties(irg,
+		IR_GRAPH_PROPERTY_NO_TUPLES | IR_GRAPH_PROPERTY_CONSISTENT_OUTS);
+
+	ir_node **calls = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_calls, &calls);
+
+	summaries = pmap_create();
+	/* the graph itself may not be summarized while it changes */
+	pmap_insert(summaries, irg, SUMMARY_PENDING);
+	promotion_t *promotions = NEW_ARR_F(promotion_t, 0);
+	for (size_t i = 0, n = ARR_LEN(calls); i < n; ++i) {
+		promotion_t promotion;
+		if (analyze_call(calls[i], max_size, &promotion))
+			ARR_APP1(promotion_t, promotions, promotion);
+	}
+	pmap_destroy(summaries);
+	DEL_ARR_F(calls);
+
+	bool typed = false;
+	for (size_t i = 0, n = ARR_LEN(promotions); i < n; ++i) {
+		promote(&promotions[i]);
+		typed |= promotions[i].typed;
+		free_promotion(&promotions[i]);
+	}
+	size_t const n_promoted = ARR_LEN(promotions);
+	DEL_ARR_F(promotions);
+
+	DB((dbg, LEVEL_1, "%+F: %zu allocations promoted\n", irg, n_promoted));
+	confirm_irg_properties(irg, n_promoted == 0
+		? IR_GRAPH_PROPERTIES_ALL : IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+	if (typed)
+		scalar_replacement_opt(irg);
+}
@@ -7241,6 +7241,16 @@ handle_tv:
 		}
 		return false;
 	}
+	case IR_INITIALIZER_BLOB: {
+		/* the blob is in memory order already, the rest is zero */
+		size_t               blob_size = get_initializer_blob_size(initializer);
+		unsigned char const *data      = get_initializer_blob_data(initializer);
+		unsigned             end       = MIN(initializer_size,
+		                                     (unsigned)(offset + mode_size));
+		for (unsigned b = (unsigned)MAX(0, offset); b < end; ++b)
+			buf[b-offset] = b < blob_size ? data[b] : 0;
+		return true;
+	}
 	case IR_INITIALIZER_COMPOUND:
 		if (is_Array_type(type)) {
 			ir_type  *el_type = get_array_element_type(type);
@@ -7383,6 +7393,10 @@ handle_tv:;
 		 * here, but it's unclear to me if that improves things */
 		return NULL;
 	}
+	case IR_INITIALIZER_BLOB:
+		if (offset + get_mode_size_bytes(mode) > size)
+			return NULL;
+		return sim_store_load(type, initializer, offset, mode, irg);
 	case IR_INITIALIZER_COMPOUND: {
 		if (is_Array_type(type)) {
 			ir_type  *el_type = get_array_element_type(type);
@@ -21,6 +21,7 @@
 #include "irgwalk.h"
 #include "irhooks.h"
 #include "irmemory.h"
+#include "irmemssa.h"
 #include "irmode_t.h"
 #include "irnode_t.h"
 #include "irnodehashmap.h"
@@ -249,6 +250,7 @@ static void handle_load_update(ir_node *load)
 			ir_node *jmp = new_r_Jmp(get_nodes_block(load));
 			exchange(info->projs[pn_Load_X_regular], jmp);
 		}
+		memssa_remove(load, mem);
 		kill_node(load);
 		reduce_node_usage(ptr);
 	}
@@ -297,6 +299,7 @@ static void kill_and_reduce_usage(ir_node *node)
 		panic("cannot handle node %+F", node);
 	}
 
+	memssa_remove(node, get_memop_mem(node));
 	kill_node(node);
 	reduce_node_usage(ptr);
 	if (value != NULL) {
@@ -619,22 +622,23 @@ static bool try_update_ptr_CopyB(track_load_env_t *env, ir_node *copyb)
  */
 
 /**
- * Follow the memory chain as long as there are only Loads,
- * alias free Stores, and constant Calls and try to replace the
- * current Load by a previous ones.
+ * Follow the memory versions of the loaded alias class as long as there are
+ * only Loads, alias free Stores and operations not writing the class and try
+ * to replace the current Load by a previous ones.
  * Note that in unreachable loops it might happen that we reach
  * load again, as well as we can fall into a cycle.
  * We break such cycles using a special visited flag.
  *
  * INC_MASTER() must be called before dive into
  */
-static changes_t follow_load_mem_chain(track_load_env_t *env, ir_node *start)
+static changes_t follow_load_mem_chain(track_load_env_t *env, ir_node *mem)
 {
 	ir_node  *load      = env->load;
 	ir_type  *load_type = get_Load_type(load);
 	unsigned  load_size = get_mode_size_bytes(get_Load_mode(load));
+	unsigned  cls       = memssa_get_class(env->ptr);
 
-	ir_node   *node = start;
+	ir_node   *node = memssa_get_version(mem, cls);
 	changes_t  res  = NO_CHANGES;
 	for (;;) {
 		ldst_info_t *node_info = (ldst_info_t *)get_irn_link(node);
@@ -656,14 +660,14 @@ static changes_t follow_load_mem_chain(track_load_env_t *env, ir_node *start)
 			/* if the might be an alias, we cannot pass this Store */
 			if (rel != ir_no_alias)
 				break;
-			node = skip_Proj(get_Store_mem(node));
+			node = memssa_get_version(get_Store_mem(node), cls);
 		} else if (is_Load(node)) {
 			/* try load-after-load */
 			changes_t changes = try_load_after_load(env, node);
 			if (changes != NO_CHANGES)
 				return changes | res;
 			/* we can skip any load */
-			node = skip_Proj(get_Load_mem(node));
+			node = memssa_get_version(get_Load_mem(node), cls);
 		} else if (is_CopyB(node)) {
 			/*
 			 * We cannot replace the Load with another
@@ -684,6 +688,8 @@ static changes_t follow_load_mem_chain(track_load_env_t *env, ir_node *start)
 				ir_node *new_value = predict_load(env->ptr, load_mode);
 				if (new_value != NULL)
 					return replace_load(load, new_value) | res;
+				/* continue with the class of the source */
+				cls = memssa_get_class(env->ptr);
 			}
 
 			/* check aliasing with the CopyB */
@@ -696,9 +702,9 @@ static changes_t follow_load_mem_chain(track_load_env_t *env, ir_node *start)
 			/* possible alias => we cannot continue */
 			if (rel != ir_no_alias)
 				break;
-			node = skip_Proj(get_CopyB_mem(node));
-		} else if (is_irn_const_memory(node)) {
-			node = skip_Proj(get_memop_mem(node));
+			node = memssa_get_version(get_CopyB_mem(node), cls);
+		} else if (is_memop(node) && !memssa_may_write(node, cls)) {
+			node = memssa_get_version(get_memop_mem(node), cls);
 		} else {
 			/* be conservative about any other node and assume aliasing
 			 * that changes the loaded value */
@@ -714,8 +720,7 @@ static changes_t follow_load_mem_chain(track_load_env_t *env, ir_node *start)
 	if (is_Sync(node)) {
 		/* handle all Sync predecessors */
 		foreach_irn_in(node, i, in) {
-			ir_node *skipped = skip_Proj(in);
-			res |= follow_load_mem_chain(env, skipped);
+			res |= follow_load_mem_chain(env, in);
 			if ((res & ~NODES_CREATED) != NO_CHANGES)
 				break;
 		}
@@ -839,7 +844,7 @@ static changes_t optimize_load(ir_node *load)
 	 */
 	INC_MASTER();
 	env.load = load;
-	res = follow_load_mem_chain(&env, skip_Proj(mem));
+	res = follow_load_mem_chain(&env, mem);
 	return res;
 }
 
@@ -859,11 +864,11 @@ static bool is_partially_same(ir_node *small, ir_node *large)
 }
 
 /**
- * follow the memory chain as long as there are only Loads and alias free
- * Stores.
+ * follow the memory versions of the stored alias class as long as there are
+ * only alias free Loads and Stores.
  * INC_MASTER() must be called before dive into
  */
-static changes_t follow_store_mem_chain(ir_node *store, ir_node *start,
+static changes_t follow_store_mem_chain(ir_node *store, ir_node *start_mem,
                                         bool had_split)
 {
 	changes_t    res   = NO_CHANGES;
@@ -874,8 +879,9 @@ static changes_t follow_store_mem_chain(ir_node *store, ir_node *start,
 	ir_type     *type  = get_Store_type(store);
 	unsigned     size  = get_mode_size_bytes(get_irn_mode(value));
 	ir_node     *block = get_nodes_block(store);
+	unsigned     cls   = memssa_get_class(ptr);
 
-	ir_node *node = start;
+	ir_node *node = memssa_get_version(start_mem, cls);
 	while (node != store) {
 		ldst_info_t *node_info = (ldst_info_t *)get_irn_link(node);
 
@@ -967,7 +973,7 @@ static changes_t follow_store_mem_chain(ir_node *store, ir_node *start,
 			/* if the might be an alias, we cannot pass this Store */
 			if (rel != ir_no_alias)
 				break;
-			node = skip_Proj(get_Store_mem(node));
+			node = memssa_get_version(get_Store_mem(node), cls);
 		} else if (is_Load(node)) {
 			ir_node           *load_ptr  = get_Load_ptr(node);
 			ir_type           *load_type = get_Load_type(node);
@@ -978,7 +984,7 @@ static changes_t follow_store_mem_chain(ir_node *store, ir_node *start,
 			if (rel != ir_no_alias)
 				break;
 
-			node = skip_Proj(get_Load_mem(node));
+			node = memssa_get_version(get_Load_mem(node), cls);
 		} else if (is_CopyB(node)) {
 			ir_node           *copyb_src  = get_CopyB_src(node);
 			ir_type           *copyb_type = get_CopyB_type(node);
@@ -994,8 +1000,9 @@ static changes_t follow_store_mem_chain(ir_node *store, ir_node *start,
 				ptr, type, size);
 			if (dst_rel != ir_no_alias)
 				break;
+			node = memssa_get_version(get_CopyB_mem(node), cls);
 		} else {
-			/* follow only Load chains */
+			/* any other access of the class may read the stored value */
 			break;
 		}
 
@@ -1008,8 +1015,7 @@ static changes_t follow_store_mem_chain(ir_node *store, ir_node *start,
 	if (is_Sync(node)) {
 		/* handle all Sync predecessors */
 		foreach_irn_in(node, i, in) {
-			ir_node *skipped = skip_Proj(in);
-			res |= follow_store_mem_chain(store, skipped, true);
+			res |= follow_store_mem_chain(store, in, true);
 			if (res != NO_CHANGES)
 				break;
 		}
@@ -1038,7 +1044,7 @@ static changes_t optimize_store(ir_node *store)
 	/* follow the memory chain as long as there are only Loads */
 	INC_MASTER();
 
-	return follow_store_mem_chain(store, skip_Proj(mem), false);
+	return follow_store_mem_chain(store, mem, false);
 }
 
 /**
@@ -1408,6 +1414,7 @@ static changes_t optimize_phi(ir_node *phi, walk_env_t *wenv)
 
 	info = get_ldst_info(store, &wenv->obst);
 	info->projs[pn_Store_M] = projM;
+	memssa_add_access(store);
 
 	/* fifths step: repair exception flow */
 	changes_t res = NO_CHANGES;
@@ -1433,6 +1440,7 @@ static changes_t optimize_phi(ir_node *phi, walk_env_t *wenv)
 	/* sixth step: replace old Phi */
 	if (get_Phi_loop(phi))
 		remove_keep_alive(phi);
+	memssa_remove(phi, projM);
 	exchange(phi, projM);
 
 	return res | DF_CHANGED;
@@ -1537,6 +1545,7 @@ static changes_t eliminate_dead_copyb(ir_node *copyb)
 		    copyb, entity));
 		reduce_node_usage(get_CopyB_dst(copyb));
 		reduce_node_usage(get_CopyB_src(copyb));
+		memssa_remove(copyb, get_CopyB_mem(copyb));
 		exchange(copyb, get_CopyB_mem(copyb));
 		return DF_CHANGED;
 	}
@@ -2291,6 +2300,7 @@ void combine_memops(ir_graph *irg)
 		return;
 
 	irg_walk_graph(irg, combine_memop, NULL, NULL);
+	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
 }
 
 void optimize_load_store(ir_graph *irg)
@@ -2301,18 +2311,13 @@ void optimize_load_store(ir_graph *irg)
 	                         | IR_GRAPH_PROPERTY_NO_TUPLES
 	                         | IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE
 	                         | IR_GRAPH_PROPERTY_CONSISTENT_POSTDOMINANCE
-	                         | IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE);
+	                         | IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE
+	                         | IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA);
 
 	FIRM_DBG_REGISTER(dbg, "firm.opt.ldstopt");
 
 	assert(get_irg_pinned(irg) != op_pin_state_floats);
 
-	const ir_disambiguator_options opts =
-		get_irg_memory_disambiguator_options(irg);
-	if ((opts & aa_opt_always_alias) == 0) {
-		assure_irp_globals_entity_usage_computed();
-	}
-
 	walk_env_t env = { .changes = NO_CHANGES };
 	obstack_init(&env.obst);
 
@@ -2342,5 +2347,6 @@ void optimize_load_store(ir_graph *irg)
 		/*NODES_CREATED*/ IR_GRAPH_PROPERTIES_CONTROL_FLOW
 		| IR_GRAPH_PROPERTY_NO_BADS | IR_GRAPH_PROPERTY_NO_TUPLES
 		| IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE
-		| IR_GRAPH_PROPERTY_MANY_RETURNS);
+		| IR_GRAPH_PROPERTY_MANY_RETURNS
+		| IR_GRAPH_PROPERTY_CONSISTENT_MEMSSA);
 }
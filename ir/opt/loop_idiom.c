@@ -0,0 +1,824 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Replaces loops computing well-known functions by calls and builtins.
+ *
+ * Innermost loops whose only effect is to store a constant to a contiguous
+ * range of memory or to copy such a range become memset, memcpy or memmove
+ * calls, or a CopyB if the size is constant.  This is opt-in, as
+ * freestanding code may not have these functions, and never done in the
+ * functions themselves, which would become infinitely recursive.  Loops counting the set bits or
+ * the trailing zeros of a value become popcount or ctz Builtins.  The backend
+ * expands these in the best way for the target.
+ *
+ * Addresses and iteration counts come from the scalar evolution analysis.
+ * A recognized loop is bypassed: the edge entering it is redirected to a new
+ * block computing the result, which continues at the target of the single
+ * loop exit.  Uses of loop values after the loop are replaced by the result.
+ */
+#include "array.h"
+#include "debug.h"
+#include "ircons_t.h"
+#include "irdom.h"
+#include "irgmod.h"
+#include "irgwalk.h"
+#include "irloop_t.h"
+#include "irmemory.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irouts_t.h"
+#include "irscev.h"
+#include "irtools.h"
+#include "pmap.h"
+#include "tv.h"
+#include "typerep.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+typedef struct idiom_loop_t {
+	ir_loop  *loop;
+	ir_node  *header;       /**< block entered from outside */
+	int       entry;        /**< index of the entry edge in the header */
+	ir_node  *exit_block;   /**< target of the exit edge */
+	int       exit;         /**< index of the exit edge in exit_block */
+	bool      complex;      /**< several entry or exit edges */
+	bool      other_memory; /**< memory operations besides Loads and Stores */
+	ir_node **nodes;        /**< nodes in the loop */
+	ir_node **loads;
+	ir_node **stores;
+	ir_node **mem_phis;
+} idiom_loop_t;
+
+static bool is_innermost_loop(ir_loop const *const loop)
+{
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		if (*get_loop_element(loop, i).kind == k_ir_loop)
+			return false;
+	}
+	return true;
+}
+
+/** Returns the innermost loop of @p block if it contains no other loop. */
+static ir_loop *get_innermost_loop(ir_node const *const block)
+{
+	ir_loop *const loop = get_irn_loop(block);
+	if (loop == NULL || get_loop_depth(loop) == 0 || !is_innermost_loop(loop))
+		return NULL;
+	return loop;
+}
+
+static idiom_loop_t *get_loop_info(pmap *const loops, ir_loop *const loop)
+{
+	idiom_loop_t *info = pmap_get(idiom_loop_t, loops, loop);
+	if (info == NULL) {
+		info           = XMALLOCZ(idiom_loop_t);
+		info->loop     = loop;
+		info->nodes    = NEW_ARR_F(ir_node*, 0);
+		info->loads    = NEW_ARR_F(ir_node*, 0);
+		info->stores   = NEW_ARR_F(ir_node*, 0);
+		info->mem_phis = NEW_ARR_F(ir_node*, 0);
+		pmap_insert(loops, loop, info);
+	}
+	return info;
+}
+
+static void collect_edges(pmap *const loops, ir_node *const block)
+{
+	ir_loop *const loop = get_innermost_loop(block);
+	for (int i = 0, n = get_Block_n_cfgpreds(block); i < n; ++i) {
+		ir_node *const pred_block = get_Block_cfgpred_block(block, i);
+		if (pred_block == NULL)
+			continue;
+		ir_loop *const pred_loop = get_innermost_loop(pred_block);
+		if (pred_loop == loop)
+			continue;
+
+		if (pred_loop != NULL) {
+			idiom_loop_t *const info = get_loop_info(loops, pred_loop);
+			if (info->exit_block != NULL)
+				info->complex = true;
+			info->exit_block = block;
+			info->exit       = i;
+		}
+		if (loop != NULL) {
+			idiom_loop_t *const info = get_loop_info(loops, loop);
+			if (info->header != NULL)
+				info->complex = true;
+			info->header = block;
+			info->entry  = i;
+		}
+	}
+}
+
+static void collect_walker(ir_node *const node, void *const data)
+{
+	pmap *const loops = (pmap*)data;
+	if (is_Block(node)) {
+		collect_edges(loops, node);
+		return;
+	}
+	ir_loop *const loop = get_innermost_loop(get_nodes_block(node));
+	if (loop == NULL)
+		return;
+
+	idiom_loop_t *const info = get_loop_info(loops, loop);
+	ARR_APP1(ir_node*, info->nodes, node);
+	if (is_Load(node)) {
+		ARR_APP1(ir_node*, info->loads, node);
+	} else if (is_Store(node)) {
+		ARR_APP1(ir_node*, info->stores, node);
+	} else if (get_irn_mode(node) == mode_M) {
+		if (is_Phi(node)) {
+			ARR_APP1(ir_node*, info->mem_phis, node);
+		} else if (!is_Proj(node) || (!is_Load(get_Proj_pred(node))
+		                              && !is_Store(get_Proj_pred(node)))) {
+			info->other_memory = true;
+		}
+	}
+}
+
+static bool block_in_loop(ir_node const *const block, ir_loop const *const loop)
+{
+	return get_irn_loop(block) == loop;
+}
+
+/**
+ * Returns true if @p user is a data use outside of @p loop. Keep-alive edges
+ * and control flow do not count.
+ */
+static bool is_outside_use(ir_node const *const user, ir_loop const *const loop)
+{
+	return !is_End(user) && !is_Block(user)
+	    && !block_in_loop(get_nodes_block(user), loop);
+}
+
+/** Returns true if @p node is used after leaving @p loop. */
+static bool is_used_outside(ir_node const *const node, ir_loop const *const loop)
+{
+	foreach_irn_out_r(node, i, user) {
+		if (is_outside_use(user, loop))
+			return true;
+	}
+	return false;
+}
+
+/** Replaces the uses of @p node after leaving @p loop by @p value. */
+static void replace_outside_uses(ir_node *const node, ir_loop const *const loop,
+                                 ir_node *const value)
+{
+	for (unsigned i = 0, n = get_irn_n_outs(node); i < n; ++i) {
+		int            pos;
+		ir_node *const user = get_irn_out_ex(node, i, &pos);
+		if (is_outside_use(user, loop))
+			set_irn_n(user, pos, value);
+	}
+}
+
+/** Returns true if each iteration of @p loop taking a back edge runs @p block. */
+static bool runs_every_iteration(idiom_loop_t const *const info,
+                                 ir_node const *const block)
+{
+	ir_node *const header = info->header;
+	for (int i = 0, n = get_Block_n_cfgpreds(header); i < n; ++i) {
+		ir_node *const pred_block = get_Block_cfgpred_block(header, i);
+		if (pred_block != NULL && block_in_loop(pred_block, info->loop)
+		    && !block_dominates(block, pred_block))
+			return false;
+	}
+	return true;
+}
+
+static bool is_expandable(scev_t const *const scev)
+{
+	switch (scev->kind) {
+	case SCEV_CONST:
+	case SCEV_VALUE:
+		return true;
+	case SCEV_CONV:
+		return is_expandable(scev->u.op);
+	case SCEV_ADD:
+	case SCEV_MUL:
+		return is_expandable(scev->u.bin.left)
+		    && is_expandable(scev->u.bin.right);
+	case SCEV_ADDREC:
+		return false;
+	}
+	panic("invalid scev kind");
+}
+
+/** Builds the nodes computing the loop invariant @p scev in @p block. */
+static ir_node *expand_scev(ir_node *const block, scev_t const *const scev)
+{
+	ir_graph *const irg = get_irn_irg(block);
+	switch (scev->kind) {
+	case SCEV_CONST:
+		return new_r_Const(irg, scev->u.tv);
+	case SCEV_VALUE:
+		return scev->u.node;
+	case SCEV_CONV:
+		return new_r_Conv(block, expand_scev(block, scev->u.op), scev->mode);
+	case SCEV_ADD:
+		return new_r_Add(block, expand_scev(block, scev->u.bin.left),
+		                 expand_scev(block, scev->u.bin.right));
+	case SCEV_MUL:
+		return new_r_Mul(block, expand_scev(block, scev->u.bin.left),
+		                 expand_scev(block, scev->u.bin.right));
+	case SCEV_ADDREC:
+		break;
+	}
+	panic("cannot expand %d", scev->kind);
+}
+
+/**
+ * Returns the value of @p node in the first iteration of @p loop, if it is
+ * an address or invariant, or NULL.
+ */
+static scev_t const *get_initial_value(ir_node *const node,
+                                       ir_loop const *const loop)
+{
+	scev_t const *scev = scev_get(node);
+	if (scev == NULL)
+		return NULL;
+	if (scev->kind == SCEV_ADDREC && scev->u.rec.loop == loop)
+		scev = scev->u.rec.start;
+	if (!scev_is_invariant(scev, loop) || !is_expandable(scev))
+		return NULL;
+	return scev;
+}
+
+static bool is_memory_proj(ir_node const *const node, ir_node const *const pred)
+{
+	return is_Proj(node) && get_Proj_pred(node) == pred
+	    && get_irn_mode(node) == mode_M;
+}
+
+/**
+ * Returns the constant stride of the address @p ptr in @p loop and sets
+ * @p start to its first value, or returns 0.
+ */
+static long get_stride(ir_node *const ptr, ir_loop const *const loop,
+                       scev_t const **const start)
+{
+	scev_t const *const scev = scev_get(ptr);
+	if (scev == NULL || scev->kind != SCEV_ADDREC || scev->u.rec.loop != loop)
+		return 0;
+	scev_t const *const step = scev->u.rec.step;
+	if (step->kind != SCEV_CONST || !tarval_is_long(step->u.tv)
+	    || !is_expandable(scev->u.rec.start))
+		return 0;
+	*start = scev->u.rec.start;
+	return get_tarval_long(step->u.tv);
+}
+
+/** Splits @p scev into a node and a constant offset. */
+static ir_node *get_base(scev_t const *scev, long *const offset)
+{
+	*offset = 0;
+	if (scev->kind == SCEV_ADD && scev->u.bin.right->kind == SCEV_CONST
+	    && tarval_is_long(scev->u.bin.right->u.tv)) {
+		*offset = get_tarval_long(scev->u.bin.right->u.tv);
+		scev    = scev->u.bin.left;
+	}
+	return scev->kind == SCEV_VALUE ? scev->u.node : NULL;
+}
+
+typedef enum copy_kind_t {
+	COPY_NONE,
+	COPY_MEMCPY,  /**< the ranges do not overlap */
+	COPY_MEMMOVE, /**< the destination is below the source */
+} copy_kind_t;
+
+/**
+ * Determines whether copying forward from @p src to @p dst can be done by
+ * memcpy or memmove.
+ */
+static copy_kind_t get_copy_kind(scev_t const *const dst, ir_node *const store,
+                                 scev_t const *const src, ir_node *const load,
+                                 unsigned const size)
+{
+	long           dst_offset;
+	long           src_offset;
+	ir_node *const dst_base = get_base(dst, &dst_offset);
+	ir_node *const src_base = get_base(src, &src_offset);
+	if (dst_base == NULL || src_base == NULL)
+		return COPY_NONE;
+	if (dst_base == src_base)
+		return dst_offset <= src_offset ? COPY_MEMMOVE : COPY_NONE;
+	/* the bases must be unrelated, the constant offsets are ignored here */
+	if (get_alias_relation(dst_base, get_Store_type(store), size,
+	                       src_base, get_Load_type(load), size) == ir_no_alias)
+		return COPY_MEMCPY;
+	return COPY_NONE;
+}
+
+static ir_type *get_libc_type(unsigned const n_params,
+                              ir_type *const *const params)
+{
+	ir_type *const mtp = new_type_method(n_params, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	for (unsigned i = 0; i < n_params; ++i)
+		set_method_param_type(mtp, i, params[i]);
+	set_method_res_type(mtp, 0, get_type_for_mode(mode_P));
+	return mtp;
+}
+
+static ir_node *new_libc_call(dbg_info *const dbgi, ir_node *const block,
+                              ir_node *const mem, char const *const name,
+                              ir_node *const dst, ir_node *const arg,
+                              ir_node *const size)
+{
+	ir_type *const params[] = {
+		get_type_for_mode(mode_P),
+		get_type_for_mode(get_irn_mode(arg)),
+		get_type_for_mode(get_irn_mode(size)),
+	};
+	ir_type   *const mtp    = get_libc_type(ARRAY_SIZE(params), params);
+	ir_entity *const entity = create_compilerlib_entity(name, mtp);
+	ir_node   *const callee = new_r_Address(get_irn_irg(block), entity);
+	ir_node   *const in[]   = { dst, arg, size };
+	ir_node   *const call   = new_rd_Call(dbgi, block, mem, callee,
+	                                      ARRAY_SIZE(in), in, mtp);
+	return new_r_Proj(call, mode_M, pn_Call_M);
+}
+
+/**
+ * Returns true if the memory loops of @p irg may become libc calls, which
+ * is not the case for the libc functions themselves.
+ */
+static bool may_call_libc(ir_graph *const irg)
+{
+	char const *const name = get_entity_ld_name(get_irg_entity(irg));
+	return !streq(name, "memset") && !streq(name, "memcpy")
+	    && !streq(name, "memmove");
+}
+
+/** Returns true if memset can store the loop invariant @p value. */
+static bool is_memset_value(ir_node const *const value)
+{
+	ir_mode *const mode = get_irn_mode(value);
+	if (!mode_is_int(mode) && !mode_is_reference(mode))
+		return false;
+	if (get_mode_size_bits(mode) == 8)
+		return true;
+	if (!is_Const(value))
+		return false;
+	ir_tarval *const tv = get_Const_tarval(value);
+	return tarval_is_null(tv) || (mode_is_int(mode) && tarval_is_all_one(tv));
+}
+
+/** Builds the byte memset stores for @p value in @p block. */
+static ir_node *build_memset_value(ir_node *const block, ir_node *const value)
+{
+	if (get_mode_size_bits(get_irn_mode(value)) == 8)
+		return new_r_Conv(block, value, mode_Is);
+	ir_graph *const irg = get_irn_irg(block);
+	if (tarval_is_null(get_Const_tarval(value)))
+		return new_r_Const_null(irg, mode_Is);
+	return new_r_Const(irg, get_mode_all_one(mode_Is));
+}
+
+/**
+ * Creates the block taking the place of the loop described by @p info and
+ * returns it.
+ */
+static ir_node *new_bypass_block(idiom_loop_t const *const info)
+{
+	ir_node *const header = info->header;
+	ir_node *const entry  = get_Block_cfgpred(header, info->entry);
+	return new_r_Block(get_irn_irg(header), 1, &entry);
+}
+
+/** Lets @p block continue after the loop and disconnects the loop. */
+static void bypass_loop(idiom_loop_t const *const info, ir_node *const block)
+{
+	ir_graph *const irg = get_irn_irg(block);
+	set_Block_cfgpred(info->exit_block, info->exit, new_r_Jmp(block));
+	set_Block_cfgpred(info->header, info->entry, new_r_Bad(irg, mode_X));
+}
+
+/**
+ * Builds the number of times @p block runs in the loop described by
+ * @p info, which takes @p count back edges if the first exit test fails.
+ * A symbolic count needs this test, so *@p new_block is replaced by the
+ * block joining both of its outcomes.
+ */
+static ir_node *build_run_count(idiom_loop_t const *const info,
+                                ir_node **const new_block,
+                                ir_node const *const block,
+                                scev_t const *const count)
+{
+	ir_node  *const cur   = *new_block;
+	ir_graph *const irg   = get_irn_irg(cur);
+	ir_node  *      res   = expand_scev(cur, count);
+	ir_mode  *const mode  = get_irn_mode(res);
+	ir_node  *const exit  = get_Block_cfgpred(info->exit_block, info->exit);
+	ir_node  *const cond  = get_Proj_pred(exit);
+	/* a block before the exit test runs once more */
+	bool      const early = block_dominates(block, get_nodes_block(cond));
+	if (early)
+		res = new_r_Add(cur, res, new_r_Const_one(irg, mode));
+	if (count->kind == SCEV_CONST)
+		return res;
+
+	ir_node      *const cmp   = get_Cond_selector(cond);
+	ir_loop      *const loop  = info->loop;
+	scev_t const *const left  = get_initial_value(get_Cmp_left(cmp), loop);
+	scev_t const *const right = get_initial_value(get_Cmp_right(cmp), loop);
+	ir_relation         rel   = get_Cmp_relation(cmp);
+	if (get_Proj_num(exit) == pn_Cond_true)
+		rel = get_negated_relation(rel);
+	ir_node *const stays    = new_r_Cmp(cur, expand_scev(cur, left),
+	                                    expand_scev(cur, right), rel);
+	ir_node *const test     = new_r_Cond(cur, stays);
+	ir_node *const t        = new_r_Proj(test, mode_X, pn_Cond_true);
+	ir_node *const enter    = new_r_Block(irg, 1, &t);
+	ir_node *const preds[]  = {
+		new_r_Jmp(enter),
+		new_r_Proj(test, mode_X, pn_Cond_false),
+	};
+	ir_node *const join     = new_r_Block(irg, ARRAY_SIZE(preds), preds);
+	ir_node *const counts[] = {
+		res,
+		early ? new_r_Const_one(irg, mode) : new_r_Const_null(irg, mode),
+	};
+	*new_block = join;
+	return new_r_Phi(join, ARRAY_SIZE(counts), counts, mode);
+}
+
+/**
+ * Checks whether the exit test of the loop described by @p info can be
+ * evaluated before the loop.
+ */
+static bool has_initial_test(idiom_loop_t const *const info)
+{
+	ir_node *const exit = get_Block_cfgpred(info->exit_block, info->exit);
+	if (!is_Proj(exit) || !is_Cond(get_Proj_pred(exit)))
+		return false;
+	ir_node *const cmp = get_Cond_selector(get_Proj_pred(exit));
+	return is_Cmp(cmp)
+	    && get_initial_value(get_Cmp_left(cmp), info->loop) != NULL
+	    && get_initial_value(get_Cmp_right(cmp), info->loop) != NULL;
+}
+
+/**
+ * Replaces a loop storing a constant to or copying a contiguous range of
+ * memory.
+ */
+static bool replace_memory_loop(idiom_loop_t *const info)
+{
+	if (ARR_LEN(info->stores) != 1 || ARR_LEN(info->loads) > 1
+	    || ARR_LEN(info->mem_phis) != 1 || info->other_memory)
+		return false;
+	ir_loop *const loop   = info->loop;
+	ir_node *const header = info->header;
+	ir_node *const phi    = info->mem_phis[0];
+	ir_node *const store  = info->stores[0];
+	ir_node *const value  = get_Store_value(store);
+	ir_mode *const mode   = get_irn_mode(value);
+	unsigned const bits   = get_mode_size_bits(mode);
+	if (get_nodes_block(phi) != header
+	    || get_Store_volatility(store) == volatility_is_volatile
+	    || ir_throws_exception(store) || bits % 8 != 0 || bits == 0
+	    || !runs_every_iteration(info, get_nodes_block(store)))
+		return false;
+
+	/* the loop only stores, maybe what it loaded before */
+	ir_node *const load = ARR_LEN(info->loads) == 1 ? info->loads[0] : NULL;
+	ir_node *const mem  = get_Store_mem(store);
+	if (load != NULL) {
+		if (!is_Proj(value) || get_Proj_pred(value) != load
+		    || get_Load_volatility(load) == volatility_is_volatile
+		    || ir_throws_exception(load) || get_Load_mem(load) != phi
+		    || (mem != phi && !is_memory_proj(mem, load)))
+			return false;
+	} else if (mem != phi || block_in_loop(get_nodes_block(value), loop)) {
+		return false;
+	}
+	for (int i = 0, n = get_Phi_n_preds(phi); i < n; ++i) {
+		if (i != info->entry && !is_memory_proj(get_Phi_pred(phi, i), store))
+			return false;
+	}
+	for (size_t i = 0, n = ARR_LEN(info->nodes); i < n; ++i) {
+		ir_node *const node = info->nodes[i];
+		if (get_irn_mode(node) != mode_M && is_used_outside(node, loop))
+			return false;
+	}
+
+	unsigned     const size = bits / 8;
+	scev_t const      *dst;
+	scev_t const      *src   = NULL;
+	scev_t const *const count = scev_get_backedge_count(loop);
+	if (count == NULL || !is_expandable(count)
+	    || get_stride(get_Store_ptr(store), loop, &dst) != (long)size
+	    || (load != NULL
+	        && get_stride(get_Load_ptr(load), loop, &src) != (long)size)
+	    || (count->kind != SCEV_CONST && !has_initial_test(info)))
+		return false;
+	copy_kind_t const kind = load != NULL
+		? get_copy_kind(dst, store, src, load, size) : COPY_NONE;
+	if (load != NULL ? kind == COPY_NONE : !is_memset_value(value))
+		return false;
+
+	ir_node        *block     = new_bypass_block(info);
+	ir_graph *const irg       = get_irn_irg(block);
+	dbg_info *const dbgi      = get_irn_dbg_info(store);
+	ir_mode  *const size_mode = find_unsigned_mode(get_reference_offset_mode(mode_P));
+	ir_node  *const n_elems   = build_run_count(info, &block,
+	                                            get_nodes_block(store), count);
+	ir_node  *const n_bytes   = new_r_Mul(block,
+		new_r_Conv(block, n_elems, size_mode),
+		new_r_Const_long(irg, size_mode, size));
+	ir_node  *const dst_ptr   = expand_scev(block, dst);
+	ir_node  *const entry_mem = get_Phi_pred(phi, info->entry);
+	ir_node  *      new_mem;
+	if (load == NULL) {
+		ir_node *const byte = build_memset_value(block, value);
+		new_mem = new_libc_call(dbgi, block, entry_mem, "memset", dst_ptr,
+		                        byte, n_bytes);
+	} else if (is_Const(n_bytes) && kind == COPY_MEMCPY) {
+		/* CopyB is lowered to moves or a memcpy call, whichever is better */
+		long     const n  = get_tarval_long(get_Const_tarval(n_bytes));
+		ir_type *const tp = new_type_array(get_Store_type(store), n / size);
+		new_mem = new_rd_CopyB(dbgi, block, entry_mem, dst_ptr,
+		                       expand_scev(block, src), tp, cons_none);
+	} else {
+		new_mem = new_libc_call(dbgi, block, entry_mem,
+		                        kind == COPY_MEMCPY ? "memcpy" : "memmove",
+		                        dst_ptr, expand_scev(block, src), n_bytes);
+	}
+	DB((dbg, LEVEL_2, "%+F replaced by %+F\n", loop, new_mem));
+
+	for (size_t i = 0, n = ARR_LEN(info->nodes); i < n; ++i) {
+		ir_node *const node = info->nodes[i];
+		if (get_irn_mode(node) == mode_M)
+			replace_outside_uses(node, loop, new_mem);
+	}
+	bypass_loop(info, block);
+	return true;
+}
+
+typedef enum bit_loop_kind_t {
+	BIT_POPCOUNT_SHIFT, /**< x >>= 1, counts x & 1 */
+	BIT_POPCOUNT_CLEAR, /**< x &= x - 1, counts iterations */
+	BIT_CTZ,            /**< x >>= 1 while (x & 1) == 0, counts iterations */
+} bit_loop_kind_t;
+
+static bool is_const_long(ir_node const *const node, long const value)
+{
+	if (!is_Const(node))
+		return false;
+	ir_tarval *const tv = get_Const_tarval(node);
+	return tarval_is_long(tv) && get_tarval_long(tv) == value;
+}
+
+/** Matches x & 1. */
+static bool is_low_bit(ir_node const *const node, ir_node const *const x)
+{
+	return is_And(node)
+	    && ((get_And_left(node) == x && is_const_long(get_And_right(node), 1))
+	     || (get_And_right(node) == x && is_const_long(get_And_left(node), 1)));
+}
+
+/** Matches x - 1. */
+static bool is_decrement(ir_node const *const node, ir_node const *const x)
+{
+	if (is_Sub(node))
+		return get_Sub_left(node) == x && is_const_long(get_Sub_right(node), 1);
+	return is_Add(node)
+	    && ((get_Add_left(node) == x && is_const_long(get_Add_right(node), -1))
+	     || (get_Add_right(node) == x && is_const_long(get_Add_left(node), -1)));
+}
+
+/** Matches the next value of the tested value @p x. */
+static bool is_bit_step(ir_node const *const next, ir_node const *const x,
+                        bit_loop_kind_t const kind)
+{
+	switch (kind) {
+	case BIT_POPCOUNT_SHIFT:
+		return is_Shr(next) && get_Shr_left(next) == x
+		    && is_const_long(get_Shr_right(next), 1);
+	case BIT_POPCOUNT_CLEAR:
+		return is_And(next)
+		    && ((get_And_left(next) == x && is_decrement(get_And_right(next), x))
+		     || (get_And_right(next) == x && is_decrement(get_And_left(next), x)));
+	case BIT_CTZ:
+		return (is_Shr(next) && get_Shr_left(next) == x
+		        && is_const_long(get_Shr_right(next), 1))
+		    || (is_Shrs(next) && get_Shrs_left(next) == x
+		        && is_const_long(get_Shrs_right(next), 1));
+	}
+	panic("invalid bit loop kind");
+}
+
+/** Matches the increment of a counter in a loop of @p kind testing @p x. */
+static bool is_count_step(ir_node const *const inc, ir_node const *const x,
+                          bit_loop_kind_t const kind)
+{
+	if (kind != BIT_POPCOUNT_SHIFT)
+		return is_const_long(inc, 1);
+	ir_node const *const bit = is_Conv(inc) ? get_Conv_op(inc) : inc;
+	return is_low_bit(bit, x);
+}
+
+/**
+ * Returns the Phi @p phi of the header of the loop described by @p info
+ * takes from the back edges, or NULL if they differ.
+ */
+static ir_node *get_back_value(idiom_loop_t const *const info,
+                               ir_node *const phi)
+{
+	ir_node *res = NULL;
+	for (int i = 0, n = get_Phi_n_preds(phi); i < n; ++i) {
+		if (i == info->entry)
+			continue;
+		ir_node *const pred = get_Phi_pred(phi, i);
+		if (res != NULL && res != pred)
+			return NULL;
+		res = pred;
+	}
+	return res;
+}
+
+/**
+ * Replaces a loop counting the set bits or trailing zeros of a value by a
+ * Builtin.
+ */
+static bool replace_bit_loop(idiom_loop_t *const info)
+{
+	if (ARR_LEN(info->stores) != 0 || ARR_LEN(info->loads) != 0
+	    || info->other_memory)
+		return false;
+	ir_node *const header = info->header;
+	ir_node *const exit   = get_Block_cfgpred(info->exit_block, info->exit);
+	if (get_nodes_block(exit) != header || !is_Proj(exit)
+	    || !is_Cond(get_Proj_pred(exit)))
+		return false;
+	ir_node *const cmp = get_Cond_selector(get_Proj_pred(exit));
+	if (!is_Cmp(cmp))
+		return false;
+
+	/* the loop runs while x != 0 or (x & 1) == 0 */
+	ir_node    *tested = get_Cmp_left(cmp);
+	ir_node    *zero   = get_Cmp_right(cmp);
+	ir_relation rel    = get_Cmp_relation(cmp);
+	if (is_Const(tested)) {
+		tested = zero;
+		zero   = get_Cmp_left(cmp);
+		rel    = get_inversed_relation(rel);
+	}
+	if (get_Proj_num(exit) == pn_Cond_true)
+		rel = get_negated_relation(rel);
+	rel &= ~ir_relation_unordered;
+	if (!is_const_long(zero, 0))
+		return false;
+
+	bit_loop_kind_t kind;
+	ir_node        *x;
+	/* x > 0 is the same as x != 0 for unsigned x */
+	if (rel == ir_relation_greater && !mode_is_signed(get_irn_mode(tested)))
+		rel = ir_relation_less_greater;
+	if (rel == ir_relation_less_greater && is_Phi(tested)) {
+		x    = tested;
+		kind = BIT_POPCOUNT_SHIFT;
+	} else if (rel == ir_relation_equal && is_And(tested)) {
+		x    = get_And_left(tested);
+		kind = BIT_CTZ;
+		if (!is_low_bit(tested, x)) {
+			x = get_And_right(tested);
+			if (!is_low_bit(tested, x))
+				return false;
+		}
+	} else {
+		return false;
+	}
+	if (!is_Phi(x) || get_nodes_block(x) != header
+	    || !mode_is_int(get_irn_mode(x)))
+		return false;
+	ir_node *const x_next = get_back_value(info, x);
+	if (x_next == NULL)
+		return false;
+	if (kind == BIT_POPCOUNT_SHIFT && !is_bit_step(x_next, x, kind))
+		kind = BIT_POPCOUNT_CLEAR;
+	if (!is_bit_step(x_next, x, kind))
+		return false;
+
+	/* all other values of the header must be counters or unchanged */
+	ir_loop *const loop = info->loop;
+	for (size_t i = 0, n = ARR_LEN(info->nodes); i < n; ++i) {
+		ir_node *const node = info->nodes[i];
+		if (node == x) {
+			if (kind == BIT_CTZ && is_used_outside(node, loop))
+				return false;
+			continue;
+		}
+		if (!is_Phi(node)) {
+			if (is_used_outside(node, loop))
+				return false;
+			continue;
+		}
+		ir_node *const next = get_back_value(info, node);
+		if (next == node && get_nodes_block(node) == header)
+			continue;
+		if (next == NULL || !is_Add(next) || !mode_is_int(get_irn_mode(node))
+		    || get_nodes_block(node) != header)
+			return false;
+		ir_node *const left  = get_Add_left(next);
+		ir_node *const right = get_Add_right(next);
+		if (!(left == node && is_count_step(right, x, kind))
+		    && !(right == node && is_count_step(left, x, kind)))
+			return false;
+	}
+
+	ir_graph *const irg   = get_irn_irg(header);
+	dbg_info *const dbgi  = get_irn_dbg_info(cmp);
+	ir_mode  *const umode = find_unsigned_mode(get_irn_mode(x));
+	ir_node  *const x0    = get_Phi_pred(x, info->entry);
+	ir_node  *      block = new_bypass_block(info);
+	if (kind == BIT_CTZ) {
+		/* the loop does not terminate for 0, keep it for this case */
+		ir_node *const nonzero = new_r_Cmp(block, x0,
+			new_r_Const_null(irg, get_irn_mode(x0)), ir_relation_less_greater);
+		ir_node *const cond    = new_r_Cond(block, nonzero);
+		ir_node *const t       = new_r_Proj(cond, mode_X, pn_Cond_true);
+		ir_node *const f       = new_r_Proj(cond, mode_X, pn_Cond_false);
+		set_Block_cfgpred(header, info->entry, f);
+		add_End_keepalive(get_irg_end(irg), header);
+		block = new_r_Block(irg, 1, &t);
+	}
+
+	ir_type *const mtp = new_type_method(1, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	set_method_param_type(mtp, 0, get_type_for_mode(umode));
+	set_method_res_type(mtp, 0, get_type_for_mode(mode_Is));
+	ir_node *const arg     = new_r_Conv(block, x0, umode);
+	ir_node *const builtin = new_rd_Builtin(dbgi, block, get_irg_no_mem(irg),
+		1, &arg, kind == BIT_CTZ ? ir_bk_ctz : ir_bk_popcount, mtp);
+	ir_node *const res     = new_r_Proj(builtin, mode_Is, pn_Builtin_max + 1);
+	DB((dbg, LEVEL_2, "%+F replaced by %+F\n", loop, builtin));
+
+	for (size_t i = 0, n = ARR_LEN(info->nodes); i < n; ++i) {
+		ir_node *const node = info->nodes[i];
+		if (node == x) {
+			replace_outside_uses(node, loop,
+			                     new_r_Const_null(irg, get_irn_mode(x)));
+		} else if (is_Phi(node)) {
+			ir_node *const start = get_Phi_pred(node, info->entry);
+			if (get_back_value(info, node) == node) {
+				replace_outside_uses(node, loop, start);
+				continue;
+			}
+			ir_node *const count = new_r_Conv(block, res, get_irn_mode(node));
+			replace_outside_uses(node, loop, new_r_Add(block, start, count));
+		}
+	}
+	if (kind == BIT_CTZ)
+		set_Block_cfgpred(info->exit_block, info->exit, new_r_Jmp(block));
+	else
+		bypass_loop(info, block);
+	return true;
+}
+
+void opt_loop_idioms(ir_graph *const irg, int const libc_calls)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.loop-idiom");
+
+	assure_irg_properties(irg,
+		IR_GRAPH_PROPERTY_NO_BADS
+		| IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
+		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
+		| IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO
+		| IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE
+		| IR_GRAPH_PROPERTY_CONSISTENT_SCEV);
+
+	pmap *const loops = pmap_create();
+	irg_walk_graph(irg, NULL, collect_walker, loops);
+
+	/* CopyB may be lowered to a memcpy call, too */
+	bool const memory_loops = libc_calls && may_call_libc(irg);
+	unsigned   n_replaced   = 0;
+	foreach_pmap(loops, entry) {
+		idiom_loop_t *const info = (idiom_loop_t*)entry->value;
+		if (info->header != NULL && info->exit_block != NULL && !info->complex
+		    && ((memory_loops && replace_memory_loop(info))
+		        || replace_bit_loop(info)))
+			++n_replaced;
+		DEL_ARR_F(info->nodes);
+		DEL_ARR_F(info->loads);
+		DEL_ARR_F(info->stores);
+		DEL_ARR_F(info->mem_phis);
+		free(info);
+	}
+	pmap_destroy(loops);
+
+	DB((dbg, LEVEL_1, "%+F: %u loops replaced\n", irg, n_replaced));
+	confirm_irg_properties(irg, n_replaced == 0
+		? IR_GRAPH_PROPERTIES_ALL : IR_GRAPH_PROPERTIES_NONE);
+}
@@ -14,6 +14,8 @@
 #include "debug.h"
 #include <assert.h>
 #include "irnode_t.h"
+#include "irscev.h"
+#include <limits.h>
 
 DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
 
@@ -257,151 +259,57 @@ static unsigned find_optimal_factor(unsigned long number, unsigned max) {
 }
 
 /**
- * walk trivial phis (with only one input) until another node is found
+ * Checks whether a conditional jump in @p header leaves @p loop.
  */
-static ir_node* skip_trivial_phis(ir_node *start) {
-	if (is_Phi(start) && get_Phi_n_preds(start) == 1) {
-		return skip_trivial_phis(get_Phi_pred(start, 0));
+static bool header_has_exit(ir_node *const header, ir_loop *const loop)
+{
+	unsigned const n_outs = get_irn_n_outs(header);
+	for (unsigned i = 0; i < n_outs; ++i) {
+		ir_node *const node = get_irn_out(header, i);
+		if (!is_Proj(node) || get_irn_mode(node) != mode_X || !is_Cond(get_Proj_pred(node)))
+			continue;
+		unsigned const n_succs = get_irn_n_outs(node);
+		for (unsigned j = 0; j < n_succs; ++j) {
+			ir_node *const succ = get_irn_out(node, j);
+			if (is_Block(succ) && !block_is_inside_loop(succ, loop))
+				return true;
+		}
 	}
-	return start;
+	return false;
 }
 
 /**
  * Analyzes loop and decides whether it should be unrolled or not and chooses a suitable unroll factor.
  *
- * Currently only loops featuring a counter variable with constant start, step and limit known at compile time
+ * Currently only loops with a single exit in the loop header whose iteration count is known at compile time
  * are considered for unrolling.
  * Tries to find a divisor of the number of loop iterations which is smaller than the maximum unroll factor
  * and is a power of two. In this case, additional optimizations are possible.
  *
+ * @param loop the loop
  * @param header loop header
  * @param max max allowed unroll factor
  * @param fully_unroll pointer to where the decision to fully unroll the loop is stored
  * @return unroll factor to use fot this loop; 0 if loop should not be unrolled
  */
-static unsigned find_suitable_factor(ir_node *const header, unsigned max, bool *fully_unroll) {
+static unsigned find_suitable_factor(ir_loop *const loop, ir_node *const header, unsigned max, bool *fully_unroll) {
 	unsigned const DONT_UNROLL = 0;
-	unsigned const n_outs = get_irn_n_outs(header);
-	unsigned factor = 1;
-	for (unsigned i = 0; i < n_outs; ++i) {
-		ir_node *const node = get_irn_out(header, i);
-		assert(!is_Block(node));
-		if (get_nodes_block(node) != header)
-			continue;
-
-		if (is_Cmp(node)) {
-
-			ir_relation cmp_rel = get_Cmp_relation(node);
-			if (cmp_rel == ir_relation_less_greater || cmp_rel == ir_relation_equal || cmp_rel & ir_relation_unordered) {
-				return DONT_UNROLL;
-			}
-
-			ir_tarval *tv_init = NULL;
-			ir_tarval *tv_step = NULL;
-			ir_tarval *tv_limit = NULL;
-
-			ir_node *header_phi;
-			ir_node *cmp_right = get_Cmp_right(node);
-			if (is_Const(cmp_right) && mode_is_int(get_irn_mode(cmp_right))) {
-				if (!is_Phi(get_Cmp_left(node))) {
-					return DONT_UNROLL;
-				}
-				// found Cmp(?, const)
-				header_phi = get_Cmp_left(node);
-				tv_limit = get_Const_tarval(get_Cmp_right(node));
-			} else {
-				return DONT_UNROLL;
-			}
-			int phi_preds = get_Phi_n_preds(header_phi);
-			ir_node *cnt_add = NULL;
-			for (int j = 0; j < phi_preds; j++) {
-				ir_node *phi_pred = get_Phi_pred(header_phi, j);
-				if (is_Const(phi_pred) && mode_is_int(get_irn_mode(cmp_right))) {
-					// found constant init for (possible) counter
-					ir_tarval *const_tv = get_Const_tarval(phi_pred);
-					if (tv_init == NULL || tarval_cmp(tv_init, const_tv) == ir_relation_equal) {
-						tv_init = const_tv;
-						continue;
-					}
-				}
-				phi_pred = skip_trivial_phis(phi_pred);
-				// is_binop() would find more cases, but we currently can only optimize further if we have an Add here
-				if (is_Add(phi_pred) && cnt_add == NULL) {
-					cnt_add = phi_pred;
-					ir_node *left = get_binop_left(phi_pred);
-					ir_node *right = get_binop_right(phi_pred);
-					if (is_Const(right) && is_Phi(left)) {
-						// found Add(phi, const)
-
-						bool found_constant_step = false;
-						// LCSSA construction builds additional phi nodes
-						do {
-							if (left == header_phi) {
-								found_constant_step = true;
-								tv_step = get_Const_tarval(right);
-								break;
-							}
-							left = get_Phi_pred(left, 0);
-
-						} while (is_Phi(left) && (get_Phi_n_preds(left) == 1 || left == header_phi));
-
-						if (found_constant_step) {
-							continue;
-						}
-					}
-					return DONT_UNROLL;
-				}
-				// multiple uses of the same loop counter increment/decrement
-				if (phi_pred == cnt_add) {
-					continue;
-				} else {
-					return DONT_UNROLL;
-				}
-			}
-
-			assert(tv_limit != NULL && tv_init != NULL && tv_step != NULL);
-
-			// normalize: use less or less_equal as relation
-			if (cmp_rel & ir_relation_greater) {
-				ir_tarval *tmp = tv_init;
-				tv_init = tv_limit;
-				tv_limit = tmp;
-				tv_step = tarval_neg(tv_step);
-				cmp_rel = get_inversed_relation(cmp_rel);
-			}
-
-			ir_tarval *tv_interval = tarval_sub(tv_limit, tv_init);
-			if (tarval_is_negative(tv_interval) || tarval_is_negative(tv_step)) {
-				return DONT_UNROLL;
-			}
-
-			ir_tarval *tv_one = new_tarval_from_long(1, get_tarval_mode(tv_interval));
-			// normalize: use less_equal as relation
-			if (!(cmp_rel & ir_relation_equal)) {
-				// interval -= 1
-				tarval_sub(tv_interval, tv_one);
-			}
-
-			assert(!tarval_is_null(tv_step));
-			// calculate loop iterations; add one iteration to count the first iteration
-			ir_tarval *tv_loop_count = (tarval_add(tarval_div(tv_interval, tv_step), tv_one));
-			long loop_count = get_tarval_long(tv_loop_count);
-			if (loop_count <= 0) {
-				return DONT_UNROLL;
-			}
-
-#ifdef DEBUG_libfirm
-			long limit = get_tarval_long(tv_limit);
-			long step = get_tarval_long(tv_step);
-			long init = get_tarval_long(tv_init);
-			DB((dbg, LEVEL_3 , "\tinit: %ld, step: %ld, limit: %ld, loop count: %ld\n", init, step, limit, loop_count));
-#endif
-			factor = find_optimal_factor((unsigned long) loop_count, max);
-			if (factor == (unsigned long) loop_count) {
-				*fully_unroll = true;
-			}
-			break;
-		}
+	// the unrolled copies of the header keep the exit test
+	if (!header_has_exit(header, loop))
+		return DONT_UNROLL;
+
+	scev_t const *const count = scev_get_backedge_count(loop);
+	if (count == NULL || count->kind != SCEV_CONST || !tarval_is_long(count->u.tv))
+		return DONT_UNROLL;
+	// the body runs once per taken back edge, the exit test once more
+	long const loop_count = get_tarval_long(count->u.tv);
+	if (loop_count <= 0 || (unsigned long)loop_count > UINT_MAX)
+		return DONT_UNROLL;
+	DB((dbg, LEVEL_3, "\tloop count: %ld\n", loop_count));
+
+	unsigned const factor = find_optimal_factor((unsigned long) loop_count, max);
+	if (factor == (unsigned long) loop_count) {
+		*fully_unroll = true;
 	}
 	return factor;
 }
@@ -542,7 +450,7 @@ static void unroll_loop(ir_loop *const loop, unsigned factor)
 	DB((dbg, LEVEL_3, "\tfound loop header %N\n", header));
 
 	bool fully_unroll = false;
-	factor = find_suitable_factor(header, factor, &fully_unroll);
+	factor = find_suitable_factor(loop, header, factor, &fully_unroll);
 	if (factor < 1 || (factor == 1 && !fully_unroll)) {
 		return;
 	}
@@ -626,9 +534,10 @@ void unroll_loops(ir_graph *const irg, unsigned factor, unsigned maxsize)
 	n_loops_unrolled = 0;
 	assure_lcssa(irg);
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO | IR_GRAPH_PROPERTY_CONSISTENT_OUTS | IR_GRAPH_PROPERTY_NO_BADS | IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+	assure_irg_scev(irg);
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
 	duplicate_innermost_loops(get_irg_loop(irg), factor, maxsize, true);
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
-	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE | IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO);
+	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE | IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO | IR_GRAPH_PROPERTY_CONSISTENT_SCEV);
 	DB((dbg, LEVEL_1, "%+F: %d loops unrolled\n", irg, n_loops_unrolled));
 }
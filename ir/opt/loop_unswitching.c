@@ -0,0 +1,440 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Loop unswitching for branches on loop invariant conditions.
+ *
+ * A Cond inside a loop whose selector does not change while the loop
+ * iterates is hoisted in front of the loop: a new block evaluates the
+ * selector and enters either the loop or a copy of it.  In the loop the Cond
+ * is fixed to true, in the copy to false, so later local optimizations and
+ * control flow optimization remove the dead half of each copy.
+ *
+ * A condition is hoisted out of the outermost loop it is invariant in whose
+ * size fits the remaining code growth budget.  Each round unswitches the
+ * candidate with the highest execution frequency, which comes from the
+ * profile if there is one.  Loops are duplicated in loop-closed SSA form,
+ * so only the Phis in the exit blocks need an operand for each copy.
+ */
+#include "array.h"
+#include "debug.h"
+#include "execfreq_t.h"
+#include "ircons.h"
+#include "irgmod.h"
+#include "irgwalk.h"
+#include "irloop_t.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irouts_t.h"
+#include "irtools.h"
+#include "lcssa_t.h"
+#include "tv.h"
+#include "util.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+/** Maximum depth of the loop invariant expressions copied before a loop. */
+#define MAX_INVARIANT_DEPTH 4
+
+typedef struct candidate_t {
+	ir_node *cond;
+	ir_loop *loop;   /**< the loop to unswitch */
+	double   freq;   /**< execution frequency of the Cond */
+	size_t   size;   /**< number of nodes in the loop */
+} candidate_t;
+
+typedef struct unswitch_env_t {
+	candidate_t *candidates;
+	unsigned     budget;     /**< number of nodes still to be added */
+	unsigned     n_unswitched;
+} unswitch_env_t;
+
+static bool is_inner_loop(ir_loop *const outer_loop, ir_loop *inner_loop)
+{
+	ir_loop *old_inner_loop;
+	do {
+		old_inner_loop = inner_loop;
+		inner_loop = get_loop_outer_loop(inner_loop);
+	} while (inner_loop != old_inner_loop && inner_loop != outer_loop);
+	return inner_loop != old_inner_loop;
+}
+
+static bool block_is_inside_loop(ir_node const *const block,
+                                 ir_loop *const loop)
+{
+	ir_loop *const block_loop = get_irn_loop(block);
+	if (block_loop == NULL)
+		return false;
+	return block_loop == loop || is_inner_loop(loop, block_loop);
+}
+
+static bool is_inside_loop(ir_node const *const node, ir_loop *const loop)
+{
+	return block_is_inside_loop(get_nodes_block(node), loop);
+}
+
+/** Returns the number of nodes in @p loop. */
+static size_t count_nodes(ir_loop const *const loop)
+{
+	size_t n_nodes = 0;
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		loop_element const element = get_loop_element(loop, i);
+		if (*element.kind == k_ir_node)
+			n_nodes += get_irn_n_outs(element.node) + 1;
+		else if (*element.kind == k_ir_loop)
+			n_nodes += count_nodes(element.son);
+	}
+	return n_nodes;
+}
+
+/**
+ * Returns the block of @p loop entered from outside, if it is entered by a
+ * single edge, or NULL.
+ */
+static ir_node *get_loop_header(ir_loop *const loop, int *const entry)
+{
+	ir_node *header = NULL;
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		loop_element const element = get_loop_element(loop, i);
+		if (*element.kind != k_ir_node)
+			continue;
+		ir_node *const block = element.node;
+		for (int p = 0, n_preds = get_Block_n_cfgpreds(block); p < n_preds;
+		     ++p) {
+			ir_node *const pred = get_Block_cfgpred_block(block, p);
+			if (pred == NULL || block_is_inside_loop(pred, loop))
+				continue;
+			if (header != NULL)
+				return NULL;
+			header = block;
+			*entry = p;
+		}
+	}
+	return header;
+}
+
+/**
+ * Returns true if @p node does not change while @p loop iterates and can be
+ * computed in front of it.
+ */
+static bool is_invariant(ir_node *const node, ir_loop *const loop,
+                         unsigned const depth)
+{
+	if (!is_inside_loop(node, loop))
+		return true;
+	if (depth == 0 || is_Phi(node) || is_Proj(node)
+	    || get_irn_pinned(node) != op_pin_state_floats
+	    || get_irn_mode(node) == mode_M)
+		return false;
+	foreach_irn_in(node, i, pred) {
+		if (!is_invariant(pred, loop, depth - 1))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Returns true if values of @p block only leave its loop @p loop through
+ * Phis in the exit blocks.
+ */
+static bool is_block_closed(ir_node *const block, ir_loop *const loop)
+{
+	foreach_irn_out_r(block, i, node) {
+		if (get_nodes_block(node) != block)
+			continue;
+		for (unsigned j = 0, n = get_irn_n_outs(node); j < n; ++j) {
+			int            pos;
+			ir_node *const user = get_irn_out_ex(node, j, &pos);
+			if (is_End(user) || is_Block(user) || is_inside_loop(user, loop))
+				continue;
+			if (!is_Phi(user))
+				return false;
+			ir_node *const user_block = get_nodes_block(user);
+			ir_node *const pred_block = get_Block_cfgpred_block(user_block, pos);
+			if (pred_block == NULL || !block_is_inside_loop(pred_block, loop))
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool is_loop_closed(ir_loop *const loop)
+{
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		loop_element const element = get_loop_element(loop, i);
+		if (*element.kind == k_ir_node) {
+			if (!is_block_closed(element.node, loop))
+				return false;
+		} else if (*element.kind == k_ir_loop) {
+			if (!is_loop_closed(element.son))
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool can_unswitch(ir_loop *const loop)
+{
+	int entry;
+	return get_loop_header(loop, &entry) != NULL && is_loop_closed(loop);
+}
+
+static void collect_candidates(ir_node *const node, void *const data)
+{
+	unswitch_env_t *const env = (unswitch_env_t*)data;
+	if (!is_Cond(node))
+		return;
+	ir_node *const selector = get_Cond_selector(node);
+	if (is_Const(selector))
+		return;
+
+	/* find the outermost loop small enough which the selector is invariant in */
+	ir_node *const block = get_nodes_block(node);
+	ir_loop *const root  = get_irg_loop(get_irn_irg(node));
+	ir_loop       *best  = NULL;
+	size_t         size  = 0;
+	for (ir_loop *loop = get_irn_loop(block); loop != NULL && loop != root;
+	     loop = get_loop_outer_loop(loop)) {
+		if (!is_invariant(selector, loop, MAX_INVARIANT_DEPTH))
+			break;
+		size_t const loop_size = count_nodes(loop);
+		if (loop_size > env->budget)
+			break;
+		if (can_unswitch(loop)) {
+			best = loop;
+			size = loop_size;
+		}
+	}
+	if (best == NULL)
+		return;
+
+	candidate_t const candidate = {
+		.cond = node,
+		.loop = best,
+		.freq = get_block_execfreq(block),
+		.size = size,
+	};
+	ARR_APP1(candidate_t, env->candidates, candidate);
+}
+
+static int cmp_candidates(void const *const a, void const *const b)
+{
+	candidate_t const *const ca = (candidate_t const*)a;
+	candidate_t const *const cb = (candidate_t const*)b;
+	if (ca->freq != cb->freq)
+		return ca->freq < cb->freq ? 1 : -1;
+	return get_irn_idx(ca->cond) < get_irn_idx(cb->cond) ? -1 : 1;
+}
+
+static void duplicate_node(ir_node *const node, ir_node *const new_block)
+{
+	ir_node *const new_node = exact_copy(node);
+	if (!is_Block(new_node))
+		set_nodes_block(new_node, new_block);
+	set_irn_link(node, new_node);
+	DB((dbg, LEVEL_3, "\tduplicating node %+F, new node %+F\n", node, new_node));
+}
+
+static void duplicate_loop(ir_loop *const loop, ir_node ***const nodes)
+{
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		loop_element const element = get_loop_element(loop, i);
+		if (*element.kind == k_ir_loop) {
+			duplicate_loop(element.son, nodes);
+			continue;
+		}
+		if (*element.kind != k_ir_node)
+			continue;
+		ir_node *const block = element.node;
+		duplicate_node(block, NULL);
+		ARR_APP1(ir_node*, *nodes, block);
+		foreach_irn_out_r(block, j, node) {
+			if (get_nodes_block(node) != block)
+				continue;
+			duplicate_node(node, get_irn_link(block));
+			ARR_APP1(ir_node*, *nodes, node);
+		}
+	}
+}
+
+static void add_edge(ir_node *const node, ir_node *const pred)
+{
+	int       const arity = get_irn_arity(node);
+	ir_node **const in    = ALLOCAN(ir_node*, arity + 1);
+	for (int i = 0; i < arity; ++i)
+		in[i] = get_irn_n(node, i);
+	in[arity] = pred;
+	set_irn_in(node, arity + 1, in);
+}
+
+/** Adds an operand for the copy of the exit edge @p pos to @p block. */
+static void add_exit_edge(ir_node *const block, int const pos)
+{
+	ir_node *const pred = get_Block_cfgpred(block, pos);
+	add_edge(block, get_irn_link(pred));
+	foreach_irn_out_r(block, i, phi) {
+		if (!is_Phi(phi) || get_nodes_block(phi) != block)
+			continue;
+		ir_node *const value = get_Phi_pred(phi, pos);
+		ir_node *const copy  = get_irn_link(value);
+		add_edge(phi, copy != NULL ? copy : value);
+	}
+}
+
+/**
+ * Connects the copies of the nodes in @p nodes to the copies of their
+ * operands and adds the copies of the exit edges to the exit blocks.
+ */
+static void rewire_copies(ir_node **const nodes, ir_loop *const loop)
+{
+	ir_graph *const irg = get_irn_irg(nodes[0]);
+	ir_node  *const end = get_irg_end(irg);
+	for (size_t i = 0, n = ARR_LEN(nodes); i < n; ++i) {
+		ir_node *const node = nodes[i];
+		ir_node *const copy = get_irn_link(node);
+		foreach_irn_in(node, p, pred) {
+			ir_node *const pred_copy = get_irn_link(pred);
+			if (pred_copy != NULL)
+				set_irn_n(copy, p, pred_copy);
+		}
+		for (unsigned j = 0, n_outs = get_irn_n_outs(node); j < n_outs; ++j) {
+			int            pos;
+			ir_node *const user = get_irn_out_ex(node, j, &pos);
+			if (is_End(user))
+				add_End_keepalive(end, copy);
+			else if (is_Block(user) && !block_is_inside_loop(user, loop))
+				add_exit_edge(user, pos);
+		}
+	}
+}
+
+/** Copies the loop invariant expression @p node into @p block. */
+static ir_node *copy_invariant(ir_node *const node, ir_node *const block,
+                               ir_loop *const loop)
+{
+	if (!is_inside_loop(node, loop))
+		return node;
+	ir_node *const copy = exact_copy(node);
+	set_nodes_block(copy, block);
+	foreach_irn_in(node, i, pred) {
+		set_irn_n(copy, i, copy_invariant(pred, block, loop));
+	}
+	return copy;
+}
+
+/** Splits the execution frequency of the blocks in @p nodes with the copies. */
+static void split_frequencies(ir_node **const nodes)
+{
+	for (size_t i = 0, n = ARR_LEN(nodes); i < n; ++i) {
+		ir_node *const block = nodes[i];
+		if (!is_Block(block))
+			continue;
+		double const freq = get_block_execfreq(block) / 2;
+		set_block_execfreq(block, freq);
+		set_block_execfreq(get_irn_link(block), freq);
+	}
+}
+
+static void unswitch_loop(candidate_t const *const candidate)
+{
+	ir_loop  *const loop     = candidate->loop;
+	ir_node  *const cond     = candidate->cond;
+	ir_node  *const selector = get_Cond_selector(cond);
+	ir_graph *const irg      = get_irn_irg(cond);
+	int             entry;
+	ir_node  *const header   = get_loop_header(loop, &entry);
+	DB((dbg, LEVEL_2, "unswitching %+F on %+F\n", loop, cond));
+
+	irg_walk_graph(irg, firm_clear_link, NULL, NULL);
+	ir_node **nodes = NEW_ARR_F(ir_node*, 0);
+	duplicate_loop(loop, &nodes);
+	rewire_copies(nodes, loop);
+
+	/* decide in front of the loop which copy to enter */
+	ir_node *const entry_pred = get_Block_cfgpred(header, entry);
+	ir_node *const block      = new_r_Block(irg, 1, &entry_pred);
+	ir_node *const new_sel    = copy_invariant(selector, block, loop);
+	ir_node *const new_cond   = new_r_Cond(block, new_sel);
+	ir_node *const proj_true  = new_r_Proj(new_cond, mode_X, pn_Cond_true);
+	ir_node *const proj_false = new_r_Proj(new_cond, mode_X, pn_Cond_false);
+	set_Block_cfgpred(header, entry, proj_true);
+	set_Block_cfgpred(get_irn_link(header), entry, proj_false);
+	set_block_execfreq(block, get_block_execfreq(get_nodes_block(entry_pred)));
+	split_frequencies(nodes);
+
+	/* fix all branches on the selector in both loops */
+	ir_node *const t = new_r_Const(irg, tarval_b_true);
+	ir_node *const f = new_r_Const(irg, tarval_b_false);
+	for (size_t i = 0, n = ARR_LEN(nodes); i < n; ++i) {
+		ir_node *const node = nodes[i];
+		if (is_Cond(node) && get_Cond_selector(node) == selector) {
+			set_Cond_selector(node, t);
+			set_Cond_selector(get_irn_link(node), f);
+		}
+	}
+	DEL_ARR_F(nodes);
+}
+
+/**
+ * Unswitches the best candidate.  Unswitching changes the outs and the
+ * entries of neighbouring loops, so every round recomputes them.
+ */
+static bool unswitch_round(ir_graph *const irg, unswitch_env_t *const env)
+{
+	assure_lcssa(irg);
+	assure_irg_properties(irg,
+		IR_GRAPH_PROPERTY_NO_BADS
+		| IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
+		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
+		| IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO
+		| IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+
+	env->candidates = NEW_ARR_F(candidate_t, 0);
+	irg_walk_graph(irg, NULL, collect_candidates, env);
+	QSORT_ARR(env->candidates, cmp_candidates);
+
+	bool changed = false;
+	for (size_t i = 0, n = ARR_LEN(env->candidates); i < n; ++i) {
+		candidate_t const *const candidate = &env->candidates[i];
+		if (candidate->size > env->budget)
+			continue;
+		ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
+		unswitch_loop(candidate);
+		ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
+		env->budget -= candidate->size;
+		++env->n_unswitched;
+		changed = true;
+		break;
+	}
+
+	DEL_ARR_F(env->candidates);
+	if (changed)
+		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
+	return changed;
+}
+
+void unswitch_loops(ir_graph *const irg, unsigned const max_growth)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.loop-unswitching");
+
+	/* use the existing frequencies, which may come from a profile */
+	if (get_block_execfreq(get_irg_start_block(irg)) <= 0.0)
+		ir_estimate_execfreq(irg);
+
+	unswitch_env_t env = {
+		.candidates   = NULL,
+		.budget       = max_growth,
+		.n_unswitched = 0,
+	};
+	while (unswitch_round(irg, &env)) {
+	}
+
+	DB((dbg, LEVEL_1, "%+F: %u loops unswitched\n", irg, env.n_unswitched));
+	confirm_irg_properties(irg, env.n_unswitched == 0
+		? IR_GRAPH_PROPERTIES_ALL : IR_GRAPH_PROPERTIES_NONE);
+}
@@ -40,6 +40,7 @@
 #include <assert.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 DEBUG_ONLY(static firm_dbg_module_t *dbg;)
 
@@ -633,47 +634,71 @@ typedef struct call_entry {
 	bool       all_const:1; /**< Set if this call has only constant parameters. */
 } call_entry;
 
+/**
+ * Summary of a graph used by the inliner.
+ *
+ * The summary lives on the obstack of its graph and is kept while
+ * IR_GRAPH_PROPERTY_CONSISTENT_INLINE_SUMMARY is set, so the weights of
+ * graphs which did not change since the last inlining run are not computed
+ * again. Passes which only clear individual properties may rewrite the graph
+ * without clearing it, so a cached summary is checked against the graph
+ * before it is used. The inliner keeps the summary of a caller up to date
+ * while inlining into it.
+ */
+typedef struct inline_summary_t {
+	list_head        calls;         /**< List of of all inlinable calls in this graph. */
+	unsigned         n_nodes;       /**< Number of nodes in graph except Id, Tuple, Proj, Start, End. */
+	unsigned         n_blocks;      /**< Number of Blocks in graph without Start and End block. */
+	unsigned         n_call_nodes;  /**< Number of Call nodes in the graph. */
+	size_t           n_params;      /**< Number of parameters of the graph. */
+	unsigned        *local_weights; /**< Once allocated, the beneficial weight for transmitting local addresses. */
+	unsigned        *param_weights; /**< Once allocated, the beneficial weight for constant arguments. */
+	ptr_access_kind *param_access;  /**< Once allocated, how pointer arguments are accessed. */
+	bool             recursive;     /**< Set, if this function is self recursive. */
+} inline_summary_t;
+
 /**
  * Environment for inlining irgs.
  */
 typedef struct {
-	list_head calls;             /**< List of of all call nodes in this graph. */
-	unsigned  *local_weights;    /**< Once allocated, the beneficial weight for transmitting local addresses. */
-	unsigned  n_nodes;           /**< Number of nodes in graph except Id, Tuple, Proj, Start, End. */
-	unsigned  n_blocks;          /**< Number of Blocks in graph without Start and End block. */
-	unsigned  n_nodes_orig;      /**< for statistics */
-	unsigned  n_call_nodes;      /**< Number of Call nodes in the graph. */
-	unsigned  n_call_nodes_orig; /**< for statistics */
-	unsigned  n_callers;         /**< Number of known graphs that call this graphs. */
-	unsigned  n_callers_orig;    /**< for statistics */
-	unsigned  got_inline:1;      /**< Set, if at least one call inside this graph was inlined. */
-	unsigned  recursive:1;       /**< Set, if this function is self recursive. */
+	inline_summary_t *summary;           /**< The summary of the graph. */
+	unsigned          n_nodes_orig;      /**< for statistics */
+	unsigned          n_call_nodes_orig; /**< for statistics */
+	unsigned          n_callers;         /**< Number of known graphs that call this graphs. */
+	unsigned          n_callers_orig;    /**< for statistics */
+	bool              got_inline;        /**< Set, if at least one call inside this graph was inlined. */
 } inline_irg_env;
 
+/**
+ * Environment of an inlining run over the whole program.
+ */
+typedef struct inline_env_t {
+	unsigned  maxsize;          /**< Do not inline into graphs bigger than this. */
+	int       inline_threshold; /**< Threshold for the inline decision. */
+	opt_ptr   after_inline_opt; /**< Optimizations run after inlining into a graph. */
+	pmap     *copied_graphs;    /**< Copies of recursive graphs. */
+	size_t    budget;           /**< Number of nodes inlining may add, SIZE_MAX if unlimited. */
+	size_t    growth;           /**< Number of nodes added so far. */
+} inline_env_t;
+
 /**
  * Allocate a new environment for inlining.
  */
 static inline_irg_env *alloc_inline_irg_env(void)
 {
-	inline_irg_env *env = OALLOC(&temp_obst, inline_irg_env);
-	INIT_LIST_HEAD(&env->calls);
-	env->local_weights     = NULL;
-	env->n_nodes           = 0;
-	env->n_blocks          = -1; /* do not count count End Block */
-	env->n_nodes_orig      = 0;
-	env->n_call_nodes      = 0;
-	env->n_call_nodes_orig = 0;
-	env->n_callers         = 0;
-	env->n_callers_orig    = 0;
-	env->got_inline        = 0;
-	env->recursive         = 0;
+	inline_irg_env *env = OALLOCZ(&temp_obst, inline_irg_env);
 	return env;
 }
 
-typedef struct walker_env {
-	inline_irg_env *x;              /**< the inline environment */
-	bool            ignore_callers; /**< if set, do change callers data */
-} wenv_t;
+static inline_irg_env *get_inline_irg_env(ir_graph const *const irg)
+{
+	return (inline_irg_env*)get_irg_link(irg);
+}
+
+static inline_summary_t *get_inline_summary(ir_graph const *const irg)
+{
+	return get_inline_irg_env(irg)->summary;
+}
 
 static bool is_nop(const ir_node *node)
 {
@@ -702,55 +727,136 @@ static bool is_nop(const ir_node *node)
 }
 
 /**
- * post-walker: collect all calls in the inline-environment
+ * post-walker: collect all calls in the inline summary
  * of a graph and sum some statistics.
  */
 static void collect_calls2(ir_node *node, void *ctx)
 {
-	wenv_t         *env = (wenv_t*)ctx;
-	inline_irg_env *x   = env->x;
+	inline_summary_t *summary = (inline_summary_t*)ctx;
 
 	if (is_nop(node))
 		return;
 
 	if (is_Block(node)) {
-		++x->n_blocks;
+		++summary->n_blocks;
 	} else {
-		++x->n_nodes;
-		++x->n_nodes_orig;
+		++summary->n_nodes;
 	}
 
 	if (!is_Call(node))
 		return;
 
 	/* collect all call nodes */
-	++x->n_call_nodes;
-	++x->n_call_nodes_orig;
+	++summary->n_call_nodes;
 
 	ir_entity *callee_ent = get_Call_callee(node);
 	if (callee_ent == NULL)
 		return;
 	ir_graph *callee = get_entity_linktime_irg(callee_ent);
 	if (callee != NULL) {
-		if (!env->ignore_callers) {
-			inline_irg_env *callee_env = (inline_irg_env*)get_irg_link(callee);
-			/* count all static callers */
-			++callee_env->n_callers;
-			++callee_env->n_callers_orig;
-		}
-		if (callee == current_ir_graph)
-			x->recursive = 1;
+		ir_graph *irg = get_irn_irg(node);
+		if (callee == irg)
+			summary->recursive = true;
 
 		/* link it in the list of possible inlinable entries */
-		call_entry *entry = OALLOC(&temp_obst, call_entry);
+		call_entry *entry = OALLOCZ(get_irg_obstack(irg), call_entry);
 		entry->call       = node;
 		entry->callee     = callee;
 		entry->loop_depth = get_irn_loop(get_nodes_block(node))->depth;
-		entry->benefice   = 0;
-		entry->all_const  = false;
 
-		list_add_tail(&entry->list, &x->calls);
+		list_add_tail(&entry->list, &summary->calls);
+	}
+}
+
+typedef struct summary_check_t {
+	pmap    *calls;        /**< maps the listed calls to their callees */
+	size_t   n_calls;      /**< number of calls with a known callee graph */
+	unsigned n_nodes;
+	unsigned n_blocks;
+	unsigned n_call_nodes;
+	bool     valid;
+} summary_check_t;
+
+/** post-walker: counts like collect_calls2() and looks up the calls. */
+static void check_calls(ir_node *node, void *ctx)
+{
+	summary_check_t *check = (summary_check_t*)ctx;
+	if (is_nop(node))
+		return;
+
+	if (is_Block(node)) {
+		++check->n_blocks;
+	} else {
+		++check->n_nodes;
+	}
+
+	if (!is_Call(node))
+		return;
+
+	++check->n_call_nodes;
+	ir_entity *callee_ent = get_Call_callee(node);
+	ir_graph  *callee     = callee_ent != NULL
+		? get_entity_linktime_irg(callee_ent) : NULL;
+	if (callee == NULL)
+		return;
+	++check->n_calls;
+	if (pmap_get(ir_graph, check->calls, node) != callee)
+		check->valid = false;
+}
+
+/**
+ * Checks that the cached summary of @p irg lists exactly the calls with a
+ * known callee graph and has the node counts of the graph. This catches,
+ * e.g., calls which became direct after the summary was computed.
+ */
+static bool is_summary_valid(ir_graph *const irg,
+                             inline_summary_t const *const summary)
+{
+	summary_check_t check = {
+		.calls    = pmap_create(),
+		.n_blocks = -1, /* do not count the End Block */
+		.valid    = true,
+	};
+	size_t n_listed = 0;
+	list_for_each_entry(call_entry, entry, &summary->calls, list) {
+		pmap_insert(check.calls, entry->call, entry->callee);
+		++n_listed;
+	}
+	irg_walk_graph(irg, NULL, check_calls, &check);
+	pmap_destroy(check.calls);
+
+	return check.valid && check.n_calls == n_listed
+	    && check.n_nodes == summary->n_nodes
+	    && check.n_blocks == summary->n_blocks
+	    && check.n_call_nodes == summary->n_call_nodes;
+}
+
+/**
+ * Computes the inline summary of a graph unless the cached one is still
+ * up to date.
+ */
+static inline_summary_t *assure_inline_summary(ir_graph *const irg)
+{
+	if (irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_INLINE_SUMMARY)) {
+		if (is_summary_valid(irg, irg->inline_summary))
+			return irg->inline_summary;
+		DB((dbg, LEVEL_3, "%+F: cached summary is stale\n", irg));
 	}
+
+	inline_summary_t *summary = OALLOCZ(get_irg_obstack(irg), inline_summary_t);
+	INIT_LIST_HEAD(&summary->calls);
+	summary->n_blocks = -1; /* do not count count End Block */
+	summary->n_params = get_method_n_params(get_entity_type(get_irg_entity(irg)));
+
+	free_callee_info(irg);
+	assure_loopinfo(irg);
+	irg_walk_graph(irg, NULL, collect_calls2, summary);
+
+	irg->inline_summary = summary;
+	add_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_INLINE_SUMMARY);
+	DB((dbg, LEVEL_3, "%+F: computed summary, %u nodes, %u calls\n", irg,
+	    summary->n_nodes, summary->n_call_nodes));
+	return summary;
 }
 
 /**
@@ -764,7 +870,7 @@ static void collect_calls2(ir_node *node, void *ctx)
 static call_entry *duplicate_call_entry(const call_entry *entry,
                                         ir_node *new_call, int loop_depth_delta)
 {
-	call_entry *nentry = OALLOC(&temp_obst, call_entry);
+	call_entry *nentry = OALLOC(get_irg_obstack(get_irn_irg(new_call)), call_entry);
 	nentry->call       = new_call;
 	nentry->callee     = entry->callee;
 	nentry->benefice   = entry->benefice;
@@ -838,18 +944,16 @@ static unsigned calc_method_local_weight(ir_node *arg)
  * Calculate the parameter weights for transmitting the address of a local
  * variable.
  */
-static void analyze_irg_local_weights(inline_irg_env *env, ir_graph *irg)
+static void analyze_irg_local_weights(inline_summary_t *summary, ir_graph *irg)
 {
-	ir_entity *ent     = get_irg_entity(irg);
-	ir_type   *mtp     = get_entity_type(ent);
-	size_t     nparams = get_method_n_params(mtp);
-	env->local_weights = OALLOCNZ(&temp_obst, unsigned, nparams);
+	summary->local_weights
+		= OALLOCNZ(get_irg_obstack(irg), unsigned, summary->n_params);
 
 	assure_irg_outs(irg);
 	ir_node *irg_args = get_irg_args(irg);
 	foreach_irn_out_r(irg_args, i, arg) {
 		unsigned const pn = get_Proj_num(arg);
-		env->local_weights[pn] = calc_method_local_weight(arg);
+		summary->local_weights[pn] = calc_method_local_weight(arg);
 	}
 }
 
@@ -860,13 +964,41 @@ static void analyze_irg_local_weights(inline_irg_env *env, ir_graph *irg)
  */
 static unsigned get_method_local_adress_weight(ir_graph *callee, size_t pos)
 {
-	inline_irg_env *env = (inline_irg_env*)get_irg_link(callee);
+	inline_summary_t *summary = get_inline_summary(callee);
+	assert(pos < summary->n_params);
+
+	/* the address escapes in the callee, the variable stays in memory */
+	if (summary->param_access == NULL) {
+		ir_entity *ent = get_irg_entity(callee);
+		summary->param_access = OALLOCN(get_irg_obstack(callee),
+		                                ptr_access_kind, summary->n_params);
+		for (size_t i = 0; i < summary->n_params; ++i)
+			summary->param_access[i] = get_method_param_access(ent, i);
+	}
+	if (summary->param_access[pos] & ptr_access_store)
+		return 0;
 
-	if (env->local_weights == NULL)
-		analyze_irg_local_weights(env, callee);
+	if (summary->local_weights == NULL)
+		analyze_irg_local_weights(summary, callee);
+	return summary->local_weights[pos];
+}
 
-	assert(pos < get_method_n_params(get_entity_type(get_irg_entity(callee))));
-	return env->local_weights[pos];
+/**
+ * Returns the benefice of passing a constant as argument @p pos to
+ * @p callee.
+ */
+static unsigned get_method_const_weight(ir_graph *callee, size_t pos)
+{
+	inline_summary_t *summary = get_inline_summary(callee);
+	assert(pos < summary->n_params);
+	if (summary->param_weights == NULL) {
+		ir_entity *ent = get_irg_entity(callee);
+		summary->param_weights = OALLOCN(get_irg_obstack(callee), unsigned,
+		                                 summary->n_params);
+		for (size_t i = 0; i < summary->n_params; ++i)
+			summary->param_weights[i] = get_method_param_weight(ent, i);
+	}
+	return summary->param_weights[pos];
 }
 
 /**
@@ -911,19 +1043,24 @@ static int calc_inline_benefice(call_entry *entry, ir_graph *callee)
 	}
 
 	/* constant parameters improve the benefice */
-	ir_node *frame_ptr = get_irg_frame(current_ir_graph);
-	bool     all_const = true;
+	inline_summary_t *callee_summary = get_inline_summary(callee);
+	ir_node          *frame_ptr      = get_irg_frame(current_ir_graph);
+	bool              all_const      = true;
 	for (size_t i = 0; i < n_params; ++i) {
 		ir_node *param = get_Call_param(call, i);
+		/* variadic arguments are not part of the summary */
+		if (i >= callee_summary->n_params) {
+			all_const &= is_Const(param);
+			continue;
+		}
 
 		if (is_Const(param)) {
-			weight += get_method_param_weight(ent, i);
+			weight += get_method_const_weight(callee, i);
 		} else {
 			all_const = false;
 			if (is_Address(param) || is_Align(param) || is_Offset(param) || is_Size(param))
-				weight += get_method_param_weight(ent, i);
-			else if (is_Sel(param) && get_Sel_ptr(param) == frame_ptr
-			         && i < get_method_n_params(mtp)) {
+				weight += get_method_const_weight(callee, i);
+			else if (is_Sel(param) && get_Sel_ptr(param) == frame_ptr) {
 				/*
 				 * An address of a local variable is transmitted. After
 				 * inlining, scalar_replacement might be able to remove the
@@ -935,7 +1072,7 @@ static int calc_inline_benefice(call_entry *entry, ir_graph *callee)
 	}
 	entry->all_const = all_const;
 
-	inline_irg_env *callee_env = (inline_irg_env*)get_irg_link(callee);
+	inline_irg_env *callee_env = get_inline_irg_env(callee);
 	if (callee_env->n_callers == 1 &&
 	    callee != current_ir_graph &&
 	    !entity_is_externally_visible(ent)) {
@@ -943,16 +1080,16 @@ static int calc_inline_benefice(call_entry *entry, ir_graph *callee)
 	}
 
 	/* give a bonus for functions with one block */
-	if (callee_env->n_blocks == 1)
+	if (callee_summary->n_blocks == 1)
 		weight = weight * 3 / 2;
 
 	/* and one for small non-recursive functions: we want them to be inlined in mostly every case */
-	if (callee_env->n_nodes < 30 && !callee_env->recursive)
+	if (callee_summary->n_nodes < 30 && !callee_summary->recursive)
 		weight += 2000;
 
 	/* and finally for leafs: they do not increase the register pressure
 	   because of callee safe registers */
-	if (callee_env->n_call_nodes == 0)
+	if (callee_summary->n_call_nodes == 0)
 		weight += 400;
 
 	/** it's important to inline inner loops first */
@@ -971,46 +1108,6 @@ static int calc_inline_benefice(call_entry *entry, ir_graph *callee)
 	return entry->benefice = weight;
 }
 
-typedef struct walk_env_t {
-	ir_graph **irgs;
-	size_t     last_irg;
-} walk_env_t;
-
-/**
- * Call graph walker, collect all visited graphs.
- */
-static void callgraph_walker(ir_graph *irg, void *data)
-{
-	walk_env_t *env = (walk_env_t *)data;
-	env->irgs[env->last_irg++] = irg;
-}
-
-/**
- * Creates an inline order for all graphs.
- *
- * @return the list of graphs.
- */
-static ir_graph **create_irg_list(void)
-{
-	ir_entity **free_methods;
-	cgana(&free_methods);
-	free(free_methods);
-
-	compute_callgraph();
-
-	size_t     n_irgs = get_irp_n_irgs();
-	walk_env_t env;
-	env.irgs     = XMALLOCNZ(ir_graph*, n_irgs);
-	env.last_irg = 0;
-
-	callgraph_walk(NULL, callgraph_walker, &env);
-	assert(n_irgs == env.last_irg);
-
-	free_callgraph();
-
-	return env.irgs;
-}
-
 /**
  * Push a call onto the priority list if its benefice is big enough.
  *
@@ -1056,32 +1153,29 @@ static void maybe_push_call(pqueue_t *pqueue, call_entry *call,
  * Try to inline calls into a graph.
  *
  * @param irg      the graph into which we inline
- * @param maxsize  do NOT inline if the size of irg gets
- *                 bigger than this amount
- * @param inline_threshold
- *                 threshold value for inline decision
- * @param copied_graphs
- *                 map containing copied of recursive graphs
+ * @param ienv     the environment of the inlining run
  */
-static void inline_into(ir_graph *irg, unsigned maxsize,
-                        int inline_threshold, pmap *copied_graphs)
+static void inline_into(ir_graph *irg, inline_env_t *ienv)
 {
-	inline_irg_env *env = (inline_irg_env*)get_irg_link(irg);
-	if (env->n_call_nodes == 0)
+	inline_irg_env   *env     = get_inline_irg_env(irg);
+	inline_summary_t *summary = env->summary;
+	if (summary->n_call_nodes == 0)
 		return;
 
-	if (env->n_nodes > maxsize) {
-		DB((dbg, LEVEL_2, "%+F: too big (%d)\n", irg, env->n_nodes));
+	unsigned const maxsize = ienv->maxsize;
+	if (summary->n_nodes > maxsize) {
+		DB((dbg, LEVEL_2, "%+F: too big (%d)\n", irg, summary->n_nodes));
 		return;
 	}
 
+	int const inline_threshold = ienv->inline_threshold;
 	current_ir_graph = irg;
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK|IR_RESOURCE_PHI_LIST);
 
 	/* put irgs into the pqueue */
 	pqueue_t *pqueue = new_pqueue();
 
-	list_for_each_entry(call_entry, curr_call, &env->calls, list) {
+	list_for_each_entry(call_entry, curr_call, &summary->calls, list) {
 		assert(is_Call(curr_call->call));
 		maybe_push_call(pqueue, curr_call, inline_threshold);
 	}
@@ -1089,20 +1183,28 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 	/* note that the list of possible calls is updated during the process */
 	bool phiproj_computed = false;
 	while (!pqueue_empty(pqueue)) {
-		call_entry     *curr_call  = (call_entry*)pqueue_pop_front(pqueue);
-		ir_graph       *callee     = curr_call->callee;
-		inline_irg_env *callee_env = (inline_irg_env*)get_irg_link(callee);
-		ir_entity      *ent        = get_irg_entity(callee);
+		call_entry       *curr_call      = (call_entry*)pqueue_pop_front(pqueue);
+		ir_graph         *callee         = curr_call->callee;
+		inline_irg_env   *callee_env     = get_inline_irg_env(callee);
+		inline_summary_t *callee_summary = callee_env->summary;
+		ir_entity        *ent            = get_irg_entity(callee);
 		mtp_additional_properties props
 			= get_entity_additional_properties(ent);
-		if (!(props & mtp_property_always_inline)
-		    && env->n_nodes + callee_env->n_nodes > maxsize) {
+		bool const always_inline = props & mtp_property_always_inline;
+		if (!always_inline
+		    && summary->n_nodes + callee_summary->n_nodes > maxsize) {
 			DB((dbg, LEVEL_2, "%+F: too big (%d) + %+F (%d)\n", irg,
-			    env->n_nodes, callee, callee_env->n_nodes));
+			    summary->n_nodes, callee, callee_summary->n_nodes));
+			continue;
+		}
+		if (!always_inline
+		    && ienv->growth + callee_summary->n_nodes > ienv->budget) {
+			DB((dbg, LEVEL_2, "%+F: inline budget exhausted for %+F (%d)\n",
+			    irg, callee, callee_summary->n_nodes));
 			continue;
 		}
 
-		ir_graph *calleee = pmap_get(ir_graph, copied_graphs, callee);
+		ir_graph *calleee = pmap_get(ir_graph, ienv->copied_graphs, callee);
 		if (calleee != NULL) {
 			int benefice = curr_call->benefice;
 			/*
@@ -1117,8 +1219,9 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 			/*
 			 * Remap callee if we have a copy.
 			 */
-			callee     = calleee;
-			callee_env = (inline_irg_env*)get_irg_link(callee);
+			callee         = calleee;
+			callee_env     = get_inline_irg_env(callee);
+			callee_summary = callee_env->summary;
 		}
 
 		if (current_ir_graph == callee) {
@@ -1152,14 +1255,6 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 
 			ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK|IR_RESOURCE_PHI_LIST);
 
-			/* allocate a new environment */
-			callee_env = alloc_inline_irg_env();
-			set_irg_link(copy, callee_env);
-
-			assure_irg_properties(copy, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO);
-			wenv_t wenv = { .x = callee_env, .ignore_callers = true };
-			irg_walk_graph(copy, NULL, collect_calls2, &wenv);
-
 			/*
 			 * Enter the entity of the original graph. This is needed
 			 * for inline_method(). However, note that ent->irg still points
@@ -1167,7 +1262,13 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 			 */
 			set_irg_entity(copy, get_irg_entity(callee));
 
-			pmap_insert(copied_graphs, callee, copy);
+			/* allocate a new environment */
+			callee_env = alloc_inline_irg_env();
+			set_irg_link(copy, callee_env);
+			callee_summary      = assure_inline_summary(copy);
+			callee_env->summary = callee_summary;
+
+			pmap_insert(ienv->copied_graphs, callee, copy);
 			callee = copy;
 
 			/* we have only one caller: the original graph */
@@ -1192,13 +1293,13 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 		list_del(&curr_call->list);
 
 		/* callee was inline. Append its call list. */
-		env->got_inline = 1;
-		--env->n_call_nodes;
+		env->got_inline = true;
+		--summary->n_call_nodes;
 
 		/* we just generate a bunch of new calls */
 		int loop_depth = curr_call->loop_depth;
-		list_for_each_entry(call_entry, centry, &callee_env->calls, list) {
-			inline_irg_env *penv = (inline_irg_env*)get_irg_link(centry->callee);
+		list_for_each_entry(call_entry, centry, &callee_summary->calls, list) {
+			inline_irg_env *penv = get_inline_irg_env(centry->callee);
 
 			/* after we have inlined callee, all called methods inside
 			 * callee are now called once more */
@@ -1219,90 +1320,136 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 
 			call_entry *new_entry
 				= duplicate_call_entry(centry, new_call, loop_depth);
-			list_add_tail(&new_entry->list, &env->calls);
+			list_add_tail(&new_entry->list, &summary->calls);
+			if (centry->callee == irg)
+				summary->recursive = true;
 			maybe_push_call(pqueue, new_entry, inline_threshold);
 		}
 		ir_free_resources(callee, IR_RESOURCE_IRN_LINK);
 
-		env->n_call_nodes += callee_env->n_call_nodes;
-		env->n_nodes += callee_env->n_nodes;
+		summary->n_call_nodes += callee_summary->n_call_nodes;
+		summary->n_nodes      += callee_summary->n_nodes;
+		summary->n_blocks     += callee_summary->n_blocks;
+		ienv->growth          += callee_summary->n_nodes;
 		--callee_env->n_callers;
+
+		/* the summary was updated along with the graph */
+		add_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_INLINE_SUMMARY);
 	}
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK|IR_RESOURCE_PHI_LIST);
 	del_pqueue(pqueue);
 }
 
-/*
- * Heuristic inliner. Calculates a benefice value for every call and inlines
- * those calls with a value higher than the threshold.
+/**
+ * Callgraph SCC walker: inline into all graphs of a strongly connected
+ * component. The callees outside the component have already been processed,
+ * so their summaries describe their final, optimized state.
  */
-void inline_functions(unsigned maxsize, int inline_threshold,
-                      opt_ptr after_inline_opt)
+static void inline_scc(ir_graph *const *members, size_t n, void *ctx)
 {
-	ir_graph *rem = current_ir_graph;
-	obstack_init(&temp_obst);
+	inline_env_t *ienv = (inline_env_t*)ctx;
 
-	ir_graph **irgs = create_irg_list();
+	for (size_t i = 0; i < n; ++i)
+		inline_into(members[i], ienv);
 
-	/* a map for the copied graphs, used to inline recursive calls */
-	pmap *copied_graphs = pmap_create();
+	for (size_t i = 0; i < n; ++i) {
+		ir_graph       *irg = members[i];
+		inline_irg_env *env = get_inline_irg_env(irg);
+		if (!env->got_inline)
+			continue;
 
-	/* extend all irgs by a temporary data structure for inlining. */
-	size_t n_irgs = get_irp_n_irgs();
-	for (size_t i = 0; i < n_irgs; ++i)
-		set_irg_link(irgs[i], alloc_inline_irg_env());
+		if (ienv->after_inline_opt != NULL) {
+			/* this irg got calls inlined: optimize it */
+			ienv->after_inline_opt(irg);
+		}
+		/* callers of this graph should see its size after optimization */
+		env->summary = assure_inline_summary(irg);
+	}
+}
 
-	/* Precompute information in temporary data structure. */
-	wenv_t wenv;
-	wenv.ignore_callers = false;
-	for (size_t i = 0; i < n_irgs; ++i) {
-		ir_graph *irg = irgs[i];
+void inline_functions_budget(unsigned maxsize, int inline_threshold,
+                             unsigned max_growth, opt_ptr after_inline_opt)
+{
+	ir_graph *rem = current_ir_graph;
+	obstack_init(&temp_obst);
 
-		free_callee_info(irg);
+	ir_entity **free_methods;
+	cgana(&free_methods);
+	free(free_methods);
+	compute_callgraph();
 
-		wenv.x = (inline_irg_env*)get_irg_link(irg);
-		assure_loopinfo(irg);
-		irg_walk_graph(irg, NULL, collect_calls2, &wenv);
+	/* extend all irgs by a temporary data structure for inlining and fetch
+	 * (or compute) their summaries. */
+	size_t n_nodes = 0;
+	foreach_irp_irg(i, irg) {
+		inline_irg_env *env = alloc_inline_irg_env();
+		set_irg_link(irg, env);
+		env->summary           = assure_inline_summary(irg);
+		env->n_nodes_orig      = env->summary->n_nodes;
+		env->n_call_nodes_orig = env->summary->n_call_nodes;
+		n_nodes += env->summary->n_nodes;
 	}
 
-	/* -- and now inline. -- */
-	for (size_t i = 0; i < n_irgs; ++i) {
-		ir_graph *irg = irgs[i];
-		inline_into(irg, maxsize, inline_threshold, copied_graphs);
+	/* count all static callers */
+	foreach_irp_irg(i, irg) {
+		inline_summary_t *summary = get_inline_summary(irg);
+		list_for_each_entry(call_entry, entry, &summary->calls, list) {
+			inline_irg_env *callee_env = get_inline_irg_env(entry->callee);
+			++callee_env->n_callers;
+			++callee_env->n_callers_orig;
+		}
 	}
 
-	for (size_t i = 0; i < n_irgs; ++i) {
-		ir_graph *irg = irgs[i];
+	inline_env_t ienv = {
+		.maxsize          = maxsize,
+		.inline_threshold = inline_threshold,
+		.after_inline_opt = after_inline_opt,
+		.copied_graphs    = pmap_create(),
+		.budget           = max_growth == 0 ? SIZE_MAX
+		                                    : n_nodes * max_growth / 100,
+		.growth           = 0,
+	};
 
-		inline_irg_env *env = (inline_irg_env*)get_irg_link(irg);
-		if (env->got_inline && after_inline_opt != NULL) {
-			/* this irg got calls inlined: optimize it */
-			after_inline_opt(irg);
-		}
+	/* -- and now inline bottom-up. -- */
+	callgraph_walk_scc(inline_scc, &ienv);
+	free_callgraph();
+
+	foreach_irp_irg(i, irg) {
+		inline_irg_env *env = get_inline_irg_env(irg);
 		if (env->got_inline || (env->n_callers_orig != env->n_callers)) {
 			DB((dbg, LEVEL_1, "Nodes:%3d ->%3d, calls:%3d ->%3d, callers:%3d ->%3d, -- %s\n",
-			env->n_nodes_orig, env->n_nodes, env->n_call_nodes_orig, env->n_call_nodes,
-			env->n_callers_orig, env->n_callers,
+			env->n_nodes_orig, env->summary->n_nodes, env->n_call_nodes_orig,
+			env->summary->n_call_nodes, env->n_callers_orig, env->n_callers,
 			get_entity_name(get_irg_entity(irg))));
 		}
 	}
+	DB((dbg, LEVEL_1, "inlining added %zu nodes (budget %zu)\n",
+	    ienv.growth, ienv.budget));
 
 	/* kill the copied graphs: we don't need them anymore */
-	foreach_pmap(copied_graphs, pm_entry) {
+	foreach_pmap(ienv.copied_graphs, pm_entry) {
 		ir_graph *copy = (ir_graph*)pm_entry->value;
 
 		/* reset the entity, otherwise it will be deleted in the next step ... */
 		set_irg_entity(copy, NULL);
 		free_ir_graph(copy);
 	}
-	pmap_destroy(copied_graphs);
-
-	free(irgs);
+	pmap_destroy(ienv.copied_graphs);
 
 	obstack_free(&temp_obst, NULL);
 	current_ir_graph = rem;
 }
 
+/*
+ * Heuristic inliner. Calculates a benefice value for every call and inlines
+ * those calls with a value higher than the threshold.
+ */
+void inline_functions(unsigned maxsize, int inline_threshold,
+                      opt_ptr after_inline_opt)
+{
+	inline_functions_budget(maxsize, inline_threshold, 0, after_inline_opt);
+}
+
 void firm_init_inline(void)
 {
 	FIRM_DBG_REGISTER(dbg, "firm.opt.inline");
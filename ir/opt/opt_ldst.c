@@ -19,6 +19,7 @@
 #include "irgopt.h"
 #include "irgwalk.h"
 #include "irmemory.h"
+#include "irmemssa.h"
 #include "irnode_t.h"
 #include "irnodehashmap.h"
 #include "iropt.h"
@@ -109,6 +110,8 @@ typedef struct ldst_env_t {
 	unsigned        *curr_set;         /**< current set of addresses */
 	memop_t         **curr_id_2_memop; /**< current map of address ids to memops */
 	unsigned        curr_adr_id;       /**< number for address mapping */
+	unsigned        *id_2_class;       /**< maps address ids to alias classes */
+	unsigned        **class_2_ids;     /**< maps alias classes to address ids */
 	unsigned        n_mem_ops;         /**< number of memory operations (Loads/Stores) */
 	size_t          rbs_size;          /**< size of all bitsets in bytes */
 	int             max_cfg_preds;     /**< maximum number of block cfg predecessors */
@@ -297,6 +300,12 @@ restart:
 		entry->id = env.curr_adr_id++;
 		ir_nodehashmap_insert(&env.adr_map, adr, entry);
 
+		unsigned const cls = memssa_get_class(adr);
+		ARR_APP1(unsigned, env.id_2_class, cls);
+		while (ARR_LEN(env.class_2_ids) <= cls)
+			ARR_APP1(unsigned*, env.class_2_ids, NEW_ARR_F(unsigned, 0));
+		ARR_APP1(unsigned, env.class_2_ids[cls], entry->id);
+
 		DB((dbg, LEVEL_3, "ADDRESS %+F has ID %u\n", adr, entry->id));
 #ifdef DEBUG_libfirm
 		ARR_APP1(ir_node *, env.id_2_address, adr);
@@ -907,17 +916,45 @@ static void kill_all(void)
 	rbitset_set(env.curr_set, env.rbs_size - 1);
 }
 
+/**
+ * Kill all addresses which the memory operation @p node may read or modify
+ * from the current set. Only addresses of the alias classes it may access
+ * are affected.
+ *
+ * @param node  the memory operation
+ */
+static void kill_accessed(ir_node *node)
+{
+	if (!is_memop(node)) {
+		kill_all();
+		return;
+	}
+
+	size_t end = env.rbs_size - 1;
+	for (unsigned cls = 0, n = ARR_LEN(env.class_2_ids); cls < n; ++cls) {
+		if (!memssa_may_read(node, cls) && !memssa_may_write(node, cls))
+			continue;
+		unsigned const *ids = env.class_2_ids[cls];
+		for (size_t i = 0, n_ids = ARR_LEN(ids); i < n_ids && ids[i] < end; ++i)
+			rbitset_clear(env.curr_set, ids[i]);
+	}
+}
+
 /**
  * Kill memops that are not alias free due to a Store value from the current set.
+ * Only addresses in the alias class of the Store are checked.
  *
  * @param value  the Store value
  */
 static void kill_memops(const value_t *value)
 {
-	size_t end = env.rbs_size - 1;
-	size_t pos;
+	size_t          end = env.rbs_size - 1;
+	unsigned const *ids = env.class_2_ids[env.id_2_class[value->id]];
 
-	for (pos = rbitset_next(env.curr_set, 0, 1); pos < end; pos = rbitset_next(env.curr_set, pos + 1, 1)) {
+	for (size_t i = 0, n = ARR_LEN(ids); i < n && ids[i] < end; ++i) {
+		unsigned const pos = ids[i];
+		if (!rbitset_is_set(env.curr_set, pos))
+			continue;
 		memop_t *op = env.curr_id_2_memop[pos];
 
 		ir_type *value_type = get_type_for_mode(value->mode);
@@ -1102,7 +1139,7 @@ static void calc_gen_kill_avail(block_t *bl)
 			break;
 		default:
 			if (op->flags & FLAG_KILL_ALL)
-				kill_all();
+				kill_accessed(op->node);
 		}
 	}
 }
@@ -1233,7 +1270,7 @@ static int backward_antic(block_t *bl)
 			break;
 		default:
 			if (op->flags & FLAG_KILL_ALL)
-				kill_all();
+				kill_accessed(op->node);
 		}
 	}
 
@@ -1770,12 +1807,16 @@ void opt_ldst(ir_graph *irg)
 		assure_irp_globals_entity_usage_computed();
 	}
 
+	assure_irg_memssa(irg);
+
 	obstack_init(&env.obst);
 	ir_nodehashmap_init(&env.adr_map);
 
 	env.forward       = NULL;
 	env.backward      = NULL;
 	env.curr_adr_id   = 0;
+	env.id_2_class    = NEW_ARR_F(unsigned, 0);
+	env.class_2_ids   = NEW_ARR_F(unsigned*, 0);
 	env.n_mem_ops     = 0;
 	env.max_cfg_preds = 0;
 	env.changed       = 0;
@@ -1784,7 +1825,7 @@ void opt_ldst(ir_graph *irg)
 	env.id_2_address  = NEW_ARR_F(ir_node *, 0);
 #endif
 
-	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_BLOCK_MARK);
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_BLOCK_MARK | IR_RESOURCE_PHI_LIST);
 
 	/* first step: allocate block entries. Note that some blocks might be
 	   unreachable here. Using the normal walk ensures that ALL blocks are initialized. */
@@ -1876,9 +1917,13 @@ no_changes:
 		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_ALL);
 	}
 
-	ir_free_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_BLOCK_MARK);
+	ir_free_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_BLOCK_MARK | IR_RESOURCE_PHI_LIST);
 	ir_nodehashmap_destroy(&env.adr_map);
 	obstack_free(&env.obst, NULL);
+	for (size_t i = 0, n = ARR_LEN(env.class_2_ids); i < n; ++i)
+		DEL_ARR_F(env.class_2_ids[i]);
+	DEL_ARR_F(env.class_2_ids);
+	DEL_ARR_F(env.id_2_class);
 
 #ifdef DEBUG_libfirm
 	DEL_ARR_F(env.id_2_address);
@@ -18,6 +18,7 @@
 #include "irgraph_t.h"
 #include "irgwalk.h"
 #include "irmemory.h"
+#include "irmemssa.h"
 #include "irnode_t.h"
 #include "irnodeset.h"
 #include "iroptimize.h"
@@ -30,11 +31,44 @@ typedef struct parallelize_info
 	ir_node      *origin_ptr;
 	ir_type      *origin_type;  /**< Type if ptr destination. */
 	unsigned      origin_size;  /**< size of memory access. */
+	unsigned      origin_cls;   /**< alias class of the accessed memory. */
 	ir_nodeset_t  this_mem;
 	ir_nodeset_t  user_mem;
 	ir_nodeset_t  all_visited;
 } parallelize_info;
 
+static bool is_volatile(ir_node const *const node)
+{
+	return (is_Load(node) && get_Load_volatility(node) != volatility_non_volatile)
+	    || (is_Store(node) && get_Store_volatility(node) != volatility_non_volatile)
+	    || (is_CopyB(node) && get_CopyB_volatility(node) != volatility_non_volatile);
+}
+
+/**
+ * Returns true if the memory operation @p node cannot conflict with an
+ * access to alias class @p cls, so no alias queries are needed for it. This
+ * also holds for Calls and other operations which cannot touch the class.
+ *
+ * @param writes  whether the access writes the class, otherwise it reads it
+ */
+static bool is_independent(ir_node *const node, unsigned const cls,
+                           bool const writes)
+{
+	if (is_volatile(node) || memssa_may_write(node, cls))
+		return false;
+	return !writes || !memssa_may_read(node, cls);
+}
+
+/**
+ * Returns true if the memory operation @p node cannot conflict with the
+ * CopyB @p origin.
+ */
+static bool is_independent_copyB(ir_node *const node, ir_node *const origin)
+{
+	return is_independent(node, memssa_get_class(get_CopyB_dst(origin)), true)
+	    && is_independent(node, memssa_get_class(get_CopyB_src(origin)), false);
+}
+
 static void parallelize_load(parallelize_info *pi, ir_node *irn)
 {
 	/* There is no point in investigating the same subgraph twice */
@@ -46,9 +80,8 @@ static void parallelize_load(parallelize_info *pi, ir_node *irn)
 	if (get_nodes_block(irn) == pi->origin_block) {
 		if (is_Proj(irn)) {
 			ir_node *pred = get_Proj_pred(irn);
-			if (is_Load(pred) &&
-			    get_Load_volatility(pred) == volatility_non_volatile) {
-				ir_node *mem = get_Load_mem(pred);
+			if (is_memop(pred) && is_independent(pred, pi->origin_cls, false)) {
+				ir_node *mem = get_memop_mem(pred);
 				ir_nodeset_insert(&pi->user_mem, irn);
 				parallelize_load(pi, mem);
 				return;
@@ -74,6 +107,10 @@ static void parallelize_load(parallelize_info *pi, ir_node *irn)
 				parallelize_load(pi, sync_pred);
 			}
 			return;
+		} else if (is_CopyB(irn) && is_independent(irn, pi->origin_cls, false)) {
+			ir_nodeset_insert(&pi->user_mem, irn);
+			parallelize_load(pi, get_CopyB_mem(irn));
+			return;
 		} else if (is_CopyB(irn) &&
 		           get_CopyB_volatility(irn) == volatility_non_volatile) {
 			ir_type *org_type   = pi->origin_type;
@@ -105,7 +142,12 @@ static void parallelize_store(parallelize_info *pi, ir_node *irn)
 	if (get_nodes_block(irn) == pi->origin_block) {
 		if (is_Proj(irn)) {
 			ir_node *pred = get_Proj_pred(irn);
-			if (is_Load(pred)
+			if (is_memop(pred) && is_independent(pred, pi->origin_cls, true)) {
+				ir_node *mem = get_memop_mem(pred);
+				ir_nodeset_insert(&pi->user_mem, irn);
+				parallelize_store(pi, mem);
+				return;
+			} else if (is_Load(pred)
 			    && get_Load_volatility(pred) == volatility_non_volatile) {
 				ir_node *org_ptr   = pi->origin_ptr;
 				ir_type *org_type  = pi->origin_type;
@@ -142,6 +184,10 @@ static void parallelize_store(parallelize_info *pi, ir_node *irn)
 				parallelize_store(pi, sync_pred);
 			}
 			return;
+		} else if (is_CopyB(irn) && is_independent(irn, pi->origin_cls, true)) {
+			ir_nodeset_insert(&pi->user_mem, irn);
+			parallelize_store(pi, get_CopyB_mem(irn));
+			return;
 		} else if (is_CopyB(irn)
 		           && get_CopyB_volatility(irn) == volatility_non_volatile) {
 			ir_node *org_ptr    = pi->origin_ptr;
@@ -176,7 +222,12 @@ static void parallelize_copyB(parallelize_info *pi, ir_node *origin, ir_node *ir
 	if (get_nodes_block(irn) == pi->origin_block) {
 		if (is_Proj(irn)) {
 			ir_node *pred = get_Proj_pred(irn);
-			if (is_Load(pred)
+			if (is_memop(pred) && is_independent_copyB(pred, origin)) {
+				ir_node *mem = get_memop_mem(pred);
+				ir_nodeset_insert(&pi->user_mem, irn);
+				parallelize_copyB(pi, origin, mem);
+				return;
+			} else if (is_Load(pred)
 			    && get_Load_volatility(pred) == volatility_non_volatile) {
 				ir_node *org_ptr   = get_CopyB_dst(origin);
 				ir_type *org_type  = pi->origin_type;
@@ -216,6 +267,10 @@ static void parallelize_copyB(parallelize_info *pi, ir_node *origin, ir_node *ir
 				parallelize_copyB(pi, origin, sync_pred);
 			}
 			return;
+		} else if (is_CopyB(irn) && is_independent_copyB(irn, origin)) {
+			ir_nodeset_insert(&pi->user_mem, irn);
+			parallelize_copyB(pi, origin, get_CopyB_mem(irn));
+			return;
 		} else if (is_CopyB(irn)
 		           && get_CopyB_volatility(irn) == volatility_non_volatile) {
 			ir_node *org_src    = get_CopyB_src(origin);
@@ -268,6 +323,7 @@ static void walker(ir_node *proj, void *env)
 		pi.origin_ptr   = get_Load_ptr(mem_op);
 		pi.origin_size  = get_mode_size_bytes(get_Load_mode(mem_op));
 		pi.origin_type  = get_Load_type(mem_op);
+		pi.origin_cls   = memssa_get_class(pi.origin_ptr);
 		ir_nodeset_init(&pi.this_mem);
 		ir_nodeset_init(&pi.user_mem);
 		ir_nodeset_init(&pi.all_visited);
@@ -283,6 +339,7 @@ static void walker(ir_node *proj, void *env)
 		pi.origin_ptr   = get_Store_ptr(mem_op);
 		pi.origin_size  = get_mode_size_bytes(get_irn_mode(get_Store_value(mem_op)));
 		pi.origin_type  = get_Store_type(mem_op);
+		pi.origin_cls   = memssa_get_class(pi.origin_ptr);
 		ir_nodeset_init(&pi.this_mem);
 		ir_nodeset_init(&pi.user_mem);
 		ir_nodeset_init(&pi.all_visited);
@@ -496,6 +553,9 @@ void opt_parallelize_mem(ir_graph *irg)
 {
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
 	                           | IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+	/* only the alias classes are used, they stay valid while the memory
+	 * graph changes */
+	assure_irg_memssa(irg);
 	irg_walk_blkwise_dom_top_down(irg, NULL, walker, NULL);
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
 	eliminate_sync_edges(irg);
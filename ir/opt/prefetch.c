@@ -0,0 +1,321 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2026 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Software prefetching for strided loads in innermost loops.
+ *
+ * The scalar evolution of the address of every Load in an innermost loop is
+ * examined.  If the address advances by a constant stride per iteration, a
+ * prefetch Builtin for the address some iterations ahead is inserted in front
+ * of the Load.  Loads whose addresses start at the same base up to a constant
+ * offset and have the same stride form one stream and share a single
+ * prefetch.
+ *
+ * The prefetch distance is the number of iterations needed to hide the
+ * memory latency, assuming one cycle per node in the loop body, but at least
+ * one cache line.  Loops with a known trip count below the distance and loops
+ * iterating only a few times per entry according to the block execution
+ * frequencies (which come from the profile if there is one) are skipped.
+ */
+#include "array.h"
+#include "debug.h"
+#include "execfreq_t.h"
+#include "ircons.h"
+#include "irgmod.h"
+#include "irgwalk.h"
+#include "irloop_t.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irouts_t.h"
+#include "irscev.h"
+#include "irtools.h"
+#include "pmap.h"
+#include "tv.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/** Memory latency in cycles if the user does not specify one. */
+#define DEFAULT_LATENCY      200
+/** Assumed cache line size in bytes, prefetch at least this far ahead. */
+#define CACHE_LINE_SIZE      64
+/** Maximum prefetch distance in bytes. */
+#define MAX_DISTANCE         4096
+/** Minimum number of iterations per loop entry worth prefetching for. */
+#define MIN_ITERATIONS       4.0
+/** Maximum number of prefetch streams per loop. */
+#define MAX_STREAMS          8
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+typedef struct stream_t {
+	scev_t const *base;   /**< start address without constant offsets */
+	long          stride; /**< stride in bytes per iteration */
+	ir_node      *load;   /**< Load which gets the prefetch */
+} stream_t;
+
+typedef struct loop_info_t {
+	ir_loop  *loop;
+	ir_node **loads;   /**< Loads in the loop */
+	unsigned  n_nodes; /**< size estimate of the loop body */
+} loop_info_t;
+
+typedef struct prefetch_env_t {
+	pmap        *loops;   /**< maps ir_loop to loop_info_t */
+	unsigned     latency;
+	unsigned     n_prefetches;
+} prefetch_env_t;
+
+static bool is_innermost_loop(ir_loop const *const loop)
+{
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		if (*get_loop_element(loop, i).kind == k_ir_loop)
+			return false;
+	}
+	return true;
+}
+
+static bool block_in_loop(ir_node const *const block, ir_loop const *const loop)
+{
+	return get_irn_loop(block) == loop;
+}
+
+static bool is_in_loop(ir_node const *const node, ir_loop const *const loop)
+{
+	return block_in_loop(get_nodes_block(node), loop);
+}
+
+static loop_info_t *get_loop_info(prefetch_env_t *const env, ir_loop *const loop)
+{
+	loop_info_t *info = pmap_get(loop_info_t, env->loops, loop);
+	if (info == NULL) {
+		info        = XMALLOCZ(loop_info_t);
+		info->loop  = loop;
+		info->loads = NEW_ARR_F(ir_node*, 0);
+		pmap_insert(env->loops, loop, info);
+	}
+	return info;
+}
+
+static void collect_walker(ir_node *const node, void *const data)
+{
+	if (is_Block(node))
+		return;
+	ir_loop *const loop = get_irn_loop(get_nodes_block(node));
+	if (loop == NULL || get_loop_depth(loop) == 0 || !is_innermost_loop(loop))
+		return;
+
+	prefetch_env_t *const env  = (prefetch_env_t*)data;
+	loop_info_t    *const info = get_loop_info(env, loop);
+	if (!is_Proj(node) && !is_Phi(node) && !is_irn_constlike(node))
+		++info->n_nodes;
+	if (is_Load(node) && get_Load_volatility(node) != volatility_is_volatile)
+		ARR_APP1(ir_node*, info->loads, node);
+}
+
+/**
+ * Returns the single block of @p loop entered from outside or NULL.
+ */
+static ir_node *get_loop_header(ir_loop const *const loop)
+{
+	ir_node *header = NULL;
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		loop_element const element = get_loop_element(loop, i);
+		if (*element.kind != k_ir_node)
+			continue;
+		ir_node *const block = element.node;
+		foreach_irn_in(block, j, pred) {
+			if (is_Bad(pred) || is_in_loop(pred, loop))
+				continue;
+			if (header != NULL && header != block)
+				return NULL;
+			header = block;
+		}
+	}
+	return header;
+}
+
+/**
+ * Decomposes the address @p ptr of a Load in @p loop into a loop invariant
+ * base plus a constant @p stride in bytes per iteration. The base is the
+ * start value of the address without constant offsets, so accesses to
+ * neighbouring elements share it.
+ */
+static bool get_stride(ir_node *const ptr, ir_loop const *const loop,
+                       long *const stride, scev_t const **const base)
+{
+	scev_t const *const scev = scev_get(ptr);
+	if (scev == NULL || scev->kind != SCEV_ADDREC || scev->u.rec.loop != loop)
+		return false;
+	scev_t const *const step = scev->u.rec.step;
+	if (step->kind != SCEV_CONST || !tarval_is_long(step->u.tv))
+		return false;
+	*stride = get_tarval_long(step->u.tv);
+
+	scev_t const *start = scev->u.rec.start;
+	while (start->kind == SCEV_ADD && start->u.bin.right->kind == SCEV_CONST)
+		start = start->u.bin.left;
+	*base = start;
+	return true;
+}
+
+/**
+ * Returns an upper bound for the trip count of @p loop or -1 if none is
+ * known.
+ */
+static long get_trip_count_bound(ir_loop *const loop)
+{
+	ir_tarval *const max = scev_get_max_backedge_count(loop);
+	if (max == NULL || !tarval_is_long(max))
+		return -1;
+	/* the header runs once more than the back edges are taken */
+	long const count = get_tarval_long(max);
+	return count < LONG_MAX ? count + 1 : -1;
+}
+
+/**
+ * Estimates the number of iterations per entry of @p loop from the block
+ * execution frequencies.
+ */
+static double get_estimated_iterations(ir_loop const *const loop,
+                                       ir_node *const header)
+{
+	double entry = 0.0;
+	for (int i = 0, n = get_Block_n_cfgpreds(header); i < n; ++i) {
+		ir_node *const pred_block = get_Block_cfgpred_block(header, i);
+		if (pred_block == NULL || block_in_loop(pred_block, loop))
+			continue;
+		unsigned const n_succs = get_Block_n_cfg_outs(pred_block);
+		entry += get_block_execfreq(pred_block) / MAX(n_succs, 1u);
+	}
+	if (entry <= 0.0)
+		return 0.0;
+	return get_block_execfreq(header) / entry;
+}
+
+static void insert_prefetch(prefetch_env_t *const env, ir_node *const load,
+                            long const distance)
+{
+	ir_node  *const block  = get_nodes_block(load);
+	ir_graph *const irg    = get_irn_irg(block);
+	dbg_info *const dbgi   = get_irn_dbg_info(load);
+	ir_node  *const ptr    = get_Load_ptr(load);
+	ir_mode  *const mode   = get_reference_offset_mode(get_irn_mode(ptr));
+	ir_node  *const offset = new_r_Const_long(irg, mode, distance);
+	ir_node  *const addr   = new_rd_Add(dbgi, block, ptr, offset);
+	ir_node  *const in[]   = {
+		addr,
+		new_r_Const_long(irg, mode_Is, 0), /* read */
+		new_r_Const_long(irg, mode_Is, 3), /* high temporal locality */
+	};
+	ir_node  *const mem      = get_Load_mem(load);
+	ir_node  *const prefetch = new_rd_Builtin(dbgi, block, mem, ARRAY_SIZE(in),
+	                                          in, ir_bk_prefetch,
+	                                          get_unknown_type());
+	ir_node  *const new_mem  = new_r_Proj(prefetch, mode_M, pn_Builtin_M);
+	set_Load_mem(load, new_mem);
+	++env->n_prefetches;
+	DB((dbg, LEVEL_2, "  %+F prefetches %ld bytes ahead of %+F\n", prefetch,
+	    distance, load));
+}
+
+static void prefetch_loop(prefetch_env_t *const env, loop_info_t *const info)
+{
+	ir_loop *const loop = info->loop;
+	size_t   const n_loads = ARR_LEN(info->loads);
+	if (n_loads == 0)
+		return;
+	ir_node *const header = get_loop_header(loop);
+	if (header == NULL)
+		return;
+
+	double const iterations = get_estimated_iterations(loop, header);
+	if (iterations < MIN_ITERATIONS) {
+		DB((dbg, LEVEL_2, "%+F: skipped, %.1f iterations per entry\n", header,
+		    iterations));
+		return;
+	}
+
+	/* iterations needed to hide the latency */
+	unsigned const n_nodes = MAX(info->n_nodes, 1u);
+	long     const ahead   = (env->latency + n_nodes - 1) / n_nodes;
+	long     const trips   = get_trip_count_bound(loop);
+
+	stream_t streams[MAX_STREAMS];
+	unsigned n_streams = 0;
+	for (size_t i = 0; i < n_loads; ++i) {
+		ir_node      *const load = info->loads[i];
+		scev_t const *      base;
+		long                stride;
+		if (!get_stride(get_Load_ptr(load), loop, &stride, &base)
+		    || stride == 0 || labs(stride) > MAX_DISTANCE)
+			continue;
+
+		bool known = false;
+		for (unsigned s = 0; s < n_streams; ++s) {
+			if (streams[s].base == base && streams[s].stride == stride) {
+				known = true;
+				break;
+			}
+		}
+		if (known || n_streams == MAX_STREAMS)
+			continue;
+		streams[n_streams++] = (stream_t){
+			.base = base, .stride = stride, .load = load
+		};
+	}
+
+	for (unsigned s = 0; s < n_streams; ++s) {
+		long const stride     = streams[s].stride;
+		long const abs_stride = labs(stride);
+		long       n_ahead    = MAX(ahead, (CACHE_LINE_SIZE + abs_stride - 1) / abs_stride);
+		n_ahead = MIN(n_ahead, MAX(MAX_DISTANCE / abs_stride, 1));
+		if (trips >= 0 && trips <= n_ahead) {
+			DB((dbg, LEVEL_2, "%+F: stream of %+F skipped, at most %ld iterations\n",
+			    header, streams[s].load, trips));
+			continue;
+		}
+		insert_prefetch(env, streams[s].load, n_ahead * stride);
+	}
+}
+
+void insert_prefetches(ir_graph *const irg, unsigned const latency)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.prefetch");
+
+	/* use the existing frequencies, which may come from a profile */
+	if (get_block_execfreq(get_irg_start_block(irg)) <= 0.0)
+		ir_estimate_execfreq(irg);
+
+	assure_irg_properties(irg,
+		IR_GRAPH_PROPERTY_NO_BADS
+		| IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
+		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
+		| IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO
+		| IR_GRAPH_PROPERTY_CONSISTENT_SCEV);
+
+	prefetch_env_t env = {
+		.loops   = pmap_create(),
+		.latency = latency != 0 ? latency : DEFAULT_LATENCY,
+	};
+	irg_walk_graph(irg, NULL, collect_walker, &env);
+
+	foreach_pmap(env.loops, entry) {
+		loop_info_t *const info = (loop_info_t*)entry->value;
+		prefetch_loop(&env, info);
+		DEL_ARR_F(info->loads);
+		free(info);
+	}
+	pmap_destroy(env.loops);
+
+	DB((dbg, LEVEL_1, "%+F: %u prefetches inserted\n", irg, env.n_prefetches));
+	confirm_irg_properties(irg, env.n_prefetches == 0
+		? IR_GRAPH_PROPERTIES_ALL
+		: IR_GRAPH_PROPERTIES_CONTROL_FLOW | IR_GRAPH_PROPERTY_NO_BADS
+		  | IR_GRAPH_PROPERTY_NO_TUPLES);
+}
@@ -610,3 +610,94 @@ void opt_tail_rec_irg(ir_graph *irg)
 	free(env.parameter_projs);
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
 }
+
+/**
+ * Clears stale tail call marks and checks for nodes which need the frame of
+ * the caller to stay alive.
+ */
+static void clear_tail_calls(ir_node *const node, void *const data)
+{
+	bool *const frame_needed = (bool*)data;
+	if (is_Alloc(node)) {
+		*frame_needed = true;
+	} else if (is_Call(node)) {
+		set_Call_tail_call(node, false);
+		ir_type *const type = get_Call_type(node);
+		if (get_method_additional_properties(type) & mtp_property_returns_twice)
+			*frame_needed = true;
+	}
+}
+
+/**
+ * Checks that the results and the memory of @p call are only used by the
+ * Return @p ret, which returns exactly the results of the call.
+ */
+static bool is_returned_directly(ir_node const *const call,
+                                 ir_node const *const ret)
+{
+	size_t const n_ress = get_Return_n_ress(ret);
+	if (n_ress != 0 && n_ress != get_method_n_ress(get_Call_type(call)))
+		return false;
+	for (size_t i = 0; i < n_ress; ++i) {
+		ir_node *const res = get_Return_res(ret, i);
+		if (!is_Proj(res) || get_Proj_num(res) != i
+		 || skip_Proj(get_Proj_pred(res)) != call)
+			return false;
+	}
+
+	foreach_irn_out_r(call, i, proj) {
+		switch ((pn_Call)get_Proj_num(proj)) {
+		case pn_Call_M:
+			if (get_irn_n_outs(proj) != 1)
+				return false;
+			break;
+		case pn_Call_T_result:
+			foreach_irn_out_r(proj, j, res) {
+				foreach_irn_out_r(res, k, user) {
+					if (user != ret)
+						return false;
+				}
+			}
+			break;
+		case pn_Call_X_regular:
+		case pn_Call_X_except:
+			return false;
+		}
+	}
+	return true;
+}
+
+void mark_tail_calls(ir_graph *irg)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.tailrec");
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUTS);
+
+	bool frame_needed = false;
+	irg_walk_graph(irg, NULL, clear_tail_calls, &frame_needed);
+
+	/* the frame of the caller is gone when the callee runs */
+	ir_type *const mtp = get_entity_type(get_irg_entity(irg));
+	if (frame_needed || is_method_variadic(mtp)
+	 || !check_lifetime_of_locals(irg))
+		goto end;
+
+	ir_node *const end_block = get_irg_end_block(irg);
+	for (int i = get_Block_n_cfgpreds(end_block); i-- > 0; ) {
+		ir_node *const ret = get_Block_cfgpred(end_block, i);
+		if (!is_Return(ret))
+			continue;
+		ir_node *const mem = get_Return_mem(ret);
+		if (!is_Proj(mem))
+			continue;
+		ir_node *const call = get_Proj_pred(mem);
+		if (!is_Call(call) || get_nodes_block(call) != get_nodes_block(ret)
+		 || ir_throws_exception(call) || !is_returned_directly(call, ret))
+			continue;
+
+		DB((dbg, LEVEL_2, "  %+F is a tail call\n", call));
+		set_Call_tail_call(call, true);
+	}
+
+end:
+	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_ALL);
+}
@@ -67,6 +67,11 @@ static ir_entity *new_entity_vis(ir_type *owner, ident *name, ir_type *type,
 		res->attr.mtd_attr.vtable_number = IR_VTABLE_NUM_NOT_SET;
 		res->attr.mtd_attr.param_access  = NULL;
 		res->attr.mtd_attr.param_weight  = NULL;
+		res->attr.mtd_attr.bits_type     = NULL;
+		res->attr.mtd_attr.param_bits    = NULL;
+		res->attr.mtd_attr.res_bits      = NULL;
+		res->attr.mtd_attr.param_ranges  = NULL;
+		res->attr.mtd_attr.res_ranges    = NULL;
 		res->attr.mtd_attr.irg           = NULL;
 	} else if (is_compound_type(owner) && !is_segment_type(owner)) {
 		res = intern_new_entity(owner, IR_ENTITY_COMPOUND_MEMBER, name, type,
@@ -177,6 +182,22 @@ static void free_entity_attrs(ir_entity *ent)
 			DEL_ARR_F(ent->attr.mtd_attr.param_weight);
 			ent->attr.mtd_attr.param_weight = NULL;
 		}
+		if (ent->attr.mtd_attr.param_bits) {
+			DEL_ARR_F(ent->attr.mtd_attr.param_bits);
+			ent->attr.mtd_attr.param_bits = NULL;
+		}
+		if (ent->attr.mtd_attr.res_bits) {
+			DEL_ARR_F(ent->attr.mtd_attr.res_bits);
+			ent->attr.mtd_attr.res_bits = NULL;
+		}
+		if (ent->attr.mtd_attr.param_ranges) {
+			DEL_ARR_F(ent->attr.mtd_attr.param_ranges);
+			ent->attr.mtd_attr.param_ranges = NULL;
+		}
+		if (ent->attr.mtd_attr.res_ranges) {
+			DEL_ARR_F(ent->attr.mtd_attr.res_ranges);
+			ent->attr.mtd_attr.res_ranges = NULL;
+		}
 	}
 }
 
@@ -191,6 +212,11 @@ ir_entity *clone_entity(ir_entity const *const old, ident *const name,
 		/* do NOT copy them, reanalyze. This might be the best solution */
 		res->attr.mtd_attr.param_access = NULL;
 		res->attr.mtd_attr.param_weight = NULL;
+		res->attr.mtd_attr.bits_type    = NULL;
+		res->attr.mtd_attr.param_bits   = NULL;
+		res->attr.mtd_attr.res_bits     = NULL;
+		res->attr.mtd_attr.param_ranges = NULL;
+		res->attr.mtd_attr.res_ranges   = NULL;
 	}
 	res->overwrites    = NULL;
 	res->overwrittenby = NULL;
@@ -425,6 +451,7 @@ const char *get_initializer_kind_name(ir_initializer_kind_t ini)
 	X(IR_INITIALIZER_TARVAL);
 	X(IR_INITIALIZER_NULL);
 	X(IR_INITIALIZER_COMPOUND);
+	X(IR_INITIALIZER_BLOB);
 	}
 #undef X
 	return "BAD VALUE";
@@ -481,6 +508,26 @@ ir_initializer_t *create_initializer_compound(size_t n_entries)
 	return initializer;
 }
 
+ir_initializer_t *create_initializer_blob_ref(const void *data, size_t size)
+{
+	struct obstack *obst = get_irg_obstack(get_const_code_irg());
+
+	ir_initializer_t *initializer
+		= (ir_initializer_t*)OALLOC(obst, ir_initializer_blob_t);
+	initializer->kind      = IR_INITIALIZER_BLOB;
+	initializer->blob.size = size;
+	initializer->blob.data = (unsigned char const*)data;
+
+	return initializer;
+}
+
+ir_initializer_t *create_initializer_blob(const void *data, size_t size)
+{
+	struct obstack *obst = get_irg_obstack(get_const_code_irg());
+	void           *copy = obstack_copy(obst, data, size);
+	return create_initializer_blob_ref(copy, size);
+}
+
 ir_node *get_initializer_const_value(const ir_initializer_t *initializer)
 {
 	assert(initializer->kind == IR_INITIALIZER_CONST);
@@ -517,6 +564,19 @@ ir_initializer_t *get_initializer_compound_value(
 	return initializer->compound.initializers[index];
 }
 
+size_t get_initializer_blob_size(const ir_initializer_t *initializer)
+{
+	assert(initializer->kind == IR_INITIALIZER_BLOB);
+	return initializer->blob.size;
+}
+
+const unsigned char *get_initializer_blob_data(
+		const ir_initializer_t *initializer)
+{
+	assert(initializer->kind == IR_INITIALIZER_BLOB);
+	return initializer->blob.data;
+}
+
 ir_initializer_kind_t get_initializer_kind(const ir_initializer_t *initializer)
 {
 	return initializer->kind;
@@ -531,6 +591,7 @@ static void check_entity_initializer(ir_entity *entity)
 	ir_type          *entity_tp   = get_entity_type(entity);
 	switch (initializer->kind) {
 	case IR_INITIALIZER_COMPOUND:
+	case IR_INITIALIZER_BLOB:
 		assert(is_aggregate_type(entity_tp));
 		break;
 
@@ -90,12 +90,22 @@ typedef struct ir_initializer_tarval_t {
 	ir_tarval             *value;
 } ir_initializer_tarval_t ;
 
+/**
+ * An initializer containing raw bytes.
+ */
+typedef struct ir_initializer_blob_t {
+	ir_initializer_base_t  base;
+	size_t                 size;
+	unsigned char const   *data;
+} ir_initializer_blob_t;
+
 union ir_initializer_t {
 	ir_initializer_kind_t      kind;
 	ir_initializer_base_t      base;
 	ir_initializer_compound_t  compound;
 	ir_initializer_const_t     consti;
 	ir_initializer_tarval_t    tarval;
+	ir_initializer_blob_t      blob;
 };
 
 typedef struct global_ent_attr {
@@ -109,6 +119,19 @@ typedef struct normal_ent_attr {
 	ir_initializer_t *initializer; /**< entity initializer */
 } normal_ent_attr;
 
+/** Known zero and one bits of a parameter or result, as in constbits. */
+typedef struct ir_known_bits {
+	ir_tarval *z; /**< 0 = bit is zero, NULL if the value is not analyzed */
+	ir_tarval *o; /**< 1 = bit is one */
+} ir_known_bits;
+
+/** Value range of a parameter or result, as in VRP. */
+typedef struct ir_known_range {
+	ir_tarval *bottom;  /**< lower bound, NULL if the value is not analyzed */
+	ir_tarval *top;     /**< upper bound, the range is empty if below bottom */
+	unsigned   n_joins; /**< number of times the range was widened */
+} ir_known_range;
+
 /** The attributes for methods. */
 typedef struct method_ent_attr {
 	global_ent_attr           base;
@@ -121,6 +144,13 @@ typedef struct method_ent_attr {
 	ptr_access_kind *param_access; /**< the parameter access */
 	unsigned *param_weight;        /**< The weight of method's parameters. Parameters
 	                                    with a high weight are good candidates for procedure cloning. */
+
+	ir_type        *bits_type;    /**< the method type the known bits and
+	                                   ranges were computed for */
+	ir_known_bits  *param_bits;   /**< known bits of the parameters */
+	ir_known_bits  *res_bits;     /**< known bits of the results */
+	ir_known_range *param_ranges; /**< value ranges of the parameters */
+	ir_known_range *res_ranges;   /**< value ranges of the results */
 } method_ent_attr;
 
 /** additional attributes for code entities */
@@ -161,6 +161,20 @@ static bool check_initializer(const ir_initializer_t *initializer,
 		}
 		return fine;
 	}
+	case IR_INITIALIZER_BLOB: {
+		size_t size = get_initializer_blob_size(initializer);
+		if (!is_aggregate_type(type)) {
+			report_error("blob initializer for non-array/compound type in entity %+F",
+			             context);
+			fine = false;
+		} else if (size > get_type_size(type)
+		           && !(is_Array_type(type) && get_array_size(type) == 0)) {
+			report_error("blob initializer of %+F larger than its type",
+			             context);
+			fine = false;
+		}
+		return fine;
+	}
 	case IR_INITIALIZER_COMPOUND: {
 		size_t n_entries = get_initializer_compound_n_entries(initializer);
 		if (is_Array_type(type)) {
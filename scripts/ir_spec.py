@@ -308,6 +308,8 @@ class Call(Node):
     attrs = [
         Attribute("type", type="ir_type*",
                   comment="type of the call (usually type of the called procedure)"),
+        Attribute("tail_call", type="int", init="0",
+                  comment="Set when the call may be implemented as a sibling call, see mark_tail_calls()"),
     ]
     attr_struct = "call_attr"
     pinned = "exception"
@@ -0,0 +1,218 @@
+#include "firm.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Stress test and benchmark driver for combo().
+ *
+ * Builds functions made of blocks with 12 random operations (commutative
+ * operations, Loads, Mux, ...), each block followed by a diamond and every
+ * 8th block starting a loop. This creates many congruent nodes and many
+ * partition splits.
+ *
+ * Usage: combo [n_functions [n_blocks]]
+ * Without arguments a small instance is checked against the results of
+ * combo() before its partition splitting was optimized: the node and Phi
+ * counts, a hash of the graphs and the number of nodes allocated.  With
+ * arguments larger instances measure the time spent in combo(), e.g.
+ * "combo 4 2000".
+ */
+static unsigned rnd_state = 4711;
+
+static unsigned rnd(void)
+{
+	rnd_state = rnd_state * 1103515245 + 12345;
+	return rnd_state >> 8;
+}
+
+static ir_node *build_op(ir_node *const ptr, ir_type *const int_type)
+{
+	ir_node *const x = get_value(rnd() % 4, mode_Is);
+	ir_node *const y = get_value(rnd() % 4, mode_Is);
+	switch (rnd() % 9) {
+	case 0: return new_Add(x, y);
+	case 1: return new_Add(y, x);
+	case 2: return new_Mul(x, new_Const_long(mode_Is, 1 + rnd() % 2));
+	case 3: return new_Eor(x, x);
+	case 4: return new_Sub(x, new_Const_long(mode_Is, 0));
+	case 5: return new_Or(x, new_Const_long(mode_Is, rnd() % 3));
+	case 6: {
+		ir_node *const mask   = new_Const_long(mode_Is, 60);
+		ir_node *const offset = new_Conv(new_And(x, mask), mode_Ls);
+		ir_node *const load   = new_Load(get_store(), new_Add(ptr, offset),
+		                                 mode_Is, int_type, cons_none);
+		set_store(new_Proj(load, mode_M, pn_Load_M));
+		return new_Proj(load, mode_Is, pn_Load_res);
+	}
+	case 7: return new_Mux(new_Cmp(x, y, ir_relation_less), x, y);
+	default: return x;
+	}
+}
+
+static void new_Block_from(ir_node *const pred)
+{
+	ir_node *const block = new_immBlock();
+	add_immBlock_pred(block, pred);
+	mature_immBlock(block);
+	set_cur_block(block);
+}
+
+static void build_function(ir_type *const mtp, int const n, int const n_blocks)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "f%d", n);
+	ir_entity *const ent = new_global_entity(get_glob_type(),
+		new_id_from_str(name), mtp, ir_visibility_external,
+		IR_LINKAGE_DEFAULT);
+	ir_graph *const irg = new_ir_graph(ent, 4);
+	set_current_ir_graph(irg);
+
+	ir_type *const int_type = get_type_for_mode(mode_Is);
+	ir_node *const args     = get_irg_args(irg);
+	ir_node *const ptr      = new_Proj(args, mode_P, 0);
+	set_value(0, new_Proj(args, mode_Is, 1));
+	set_value(1, new_Proj(args, mode_Is, 2));
+	set_value(2, new_Const_long(mode_Is, 7));
+	set_value(3, get_value(0, mode_Is));
+
+	for (int b = 0; b < n_blocks; ++b) {
+		ir_node *loop_head = NULL;
+		if (b % 8 == 0) {
+			ir_node *const jmp = new_Jmp();
+			loop_head = new_immBlock();
+			add_immBlock_pred(loop_head, jmp);
+			set_cur_block(loop_head);
+		}
+		for (int o = 0; o < 12; ++o) {
+			ir_node *const op = build_op(ptr, int_type);
+			set_value(rnd() % 4, op);
+		}
+
+		/* diamond */
+		ir_node *const cmp  = new_Cmp(get_value(0, mode_Is),
+		                              get_value(rnd() % 4, mode_Is),
+		                              ir_relation_less);
+		ir_node *const cond = new_Cond(cmp);
+		ir_node *const t    = new_Proj(cond, mode_X, pn_Cond_true);
+		ir_node *const f    = new_Proj(cond, mode_X, pn_Cond_false);
+		new_Block_from(t);
+		set_value(rnd() % 4, new_Add(get_value(2, mode_Is),
+		                             get_value(3, mode_Is)));
+		ir_node *const jmp_t = new_Jmp();
+		new_Block_from(f);
+		set_value(rnd() % 4, new_Add(get_value(3, mode_Is),
+		                             get_value(2, mode_Is)));
+		ir_node *const jmp_f = new_Jmp();
+		ir_node *const join  = new_immBlock();
+		add_immBlock_pred(join, jmp_t);
+		add_immBlock_pred(join, jmp_f);
+		mature_immBlock(join);
+		set_cur_block(join);
+
+		if (loop_head != NULL) {
+			ir_node *const hundred = new_Const_long(mode_Is, 100);
+			ir_node *const lcmp    = new_Cmp(get_value(1, mode_Is), hundred,
+			                                 ir_relation_less);
+			ir_node *const lcond   = new_Cond(lcmp);
+			add_immBlock_pred(loop_head,
+			                  new_Proj(lcond, mode_X, pn_Cond_true));
+			mature_immBlock(loop_head);
+			new_Block_from(new_Proj(lcond, mode_X, pn_Cond_false));
+		}
+	}
+
+	ir_node *const sum0 = new_Add(get_value(0, mode_Is), get_value(1, mode_Is));
+	ir_node *const sum1 = new_Add(get_value(2, mode_Is), get_value(3, mode_Is));
+	ir_node *const res  = new_Add(sum0, sum1);
+	ir_node *const ret  = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+}
+
+typedef struct node_counts_t {
+	unsigned n_nodes;
+	unsigned n_phis;
+	unsigned last_idx; /**< number of nodes ever allocated in the graph */
+	unsigned hash;     /**< of the opcodes and arities in walk order */
+} node_counts_t;
+
+static void count_node(ir_node *const node, void *const data)
+{
+	node_counts_t *const counts = (node_counts_t*)data;
+	++counts->n_nodes;
+	if (is_Phi(node))
+		++counts->n_phis;
+	counts->hash = counts->hash * 31 + get_irn_opcode(node);
+	counts->hash = counts->hash * 31 + (unsigned)get_irn_arity(node);
+	if (is_Const(node))
+		counts->hash += (unsigned)get_tarval_long(get_Const_tarval(node));
+}
+
+static node_counts_t count_nodes(ir_graph *const irg)
+{
+	node_counts_t counts = { 0, 0, get_irg_last_idx(irg), 0 };
+	irg_walk_graph(irg, NULL, count_node, &counts);
+	return counts;
+}
+
+/* results for the default instance, 2 functions x 60 blocks */
+static node_counts_t const expected[] = {
+	{ 1301, 60, 2401, 0xa52e0c16 },
+	{ 1377, 58, 2453, 0x631fa01a },
+};
+
+int main(int argc, char **argv)
+{
+	bool const benchmark   = argc > 1;
+	int  const n_functions = benchmark ? atoi(argv[1]) : 2;
+	int  const n_blocks    = argc > 2 ? atoi(argv[2]) : 60;
+
+	ir_init();
+
+	ir_type *const int_type = get_type_for_mode(mode_Is);
+	ir_type *const mtp = new_type_method(3, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	set_method_param_type(mtp, 0, new_type_pointer(int_type));
+	set_method_param_type(mtp, 1, int_type);
+	set_method_param_type(mtp, 2, int_type);
+	set_method_res_type(mtp, 0, int_type);
+
+	/* keep the redundancies for combo */
+	set_optimize(0);
+	for (int i = 0; i < n_functions; ++i)
+		build_function(mtp, i, n_blocks);
+	set_optimize(1);
+
+	ir_timer_t *const timer = ir_timer_new();
+	ir_timer_start(timer);
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i)
+		combo(get_irp_irg(i));
+	ir_timer_stop(timer);
+	if (benchmark) {
+		printf("combo: %d functions x %d blocks: %.3f s\n", n_functions,
+		       n_blocks, ir_timer_elapsed_sec(timer));
+	}
+	ir_timer_free(timer);
+
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i) {
+		ir_graph     *const irg    = get_irp_irg(i);
+		node_counts_t const counts = count_nodes(irg);
+		assert(irg_verify(irg));
+		if (benchmark) {
+			printf("%s: %u nodes, %u Phis, %u allocated, hash %x\n",
+			       get_entity_name(get_irg_entity(irg)), counts.n_nodes,
+			       counts.n_phis, counts.last_idx, counts.hash);
+		} else {
+			assert(counts.n_nodes == expected[i].n_nodes);
+			assert(counts.n_phis == expected[i].n_phis);
+			assert(counts.last_idx == expected[i].last_idx);
+			assert(counts.hash == expected[i].hash);
+		}
+	}
+
+	ir_finish();
+	return 0;
+}
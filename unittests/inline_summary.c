@@ -0,0 +1,96 @@
+#include "firm.h"
+#include <assert.h>
+#include <stdbool.h>
+
+/*
+ * Builds
+ *
+ *   int f(int x) { return x + 1; }
+ *   int g(int x) { return (1 == 1 ? f : h)(x); }
+ *
+ * The call in g only becomes direct once the Mux is folded, after the first
+ * inlining run cached the summary of g.
+ */
+static ir_entity *new_function(char const *const name, ir_type *const mtp)
+{
+	return new_global_entity(get_glob_type(), new_id_from_str(name), mtp,
+	                         ir_visibility_external, IR_LINKAGE_DEFAULT);
+}
+
+static void finish_graph(ir_node *const res)
+{
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(current_ir_graph), ret);
+	mature_immBlock(get_irg_end_block(current_ir_graph));
+	irg_finalize_cons(current_ir_graph);
+}
+
+static void build_f(ir_entity *const f)
+{
+	ir_graph *const irg = new_ir_graph(f, 0);
+	set_current_ir_graph(irg);
+	ir_node *const x = new_Proj(get_irg_args(irg), mode_Is, 0);
+	finish_graph(new_Add(x, new_Const_long(mode_Is, 1)));
+}
+
+static ir_graph *build_g(ir_entity *const g, ir_entity *const f,
+                         ir_entity *const h)
+{
+	ir_graph *const irg = new_ir_graph(g, 0);
+	set_current_ir_graph(irg);
+	ir_node *const x   = new_Proj(get_irg_args(irg), mode_Is, 0);
+	ir_node *const one = new_Const_long(mode_Is, 1);
+	ir_node *const sel = new_Cmp(one, one, ir_relation_equal);
+	ir_node *const ptr = new_Mux(sel, new_Address(h), new_Address(f));
+	ir_node *const call = new_Call(get_store(), ptr, 1, &x,
+	                               get_entity_type(f));
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	ir_node *const ress = new_Proj(call, mode_T, pn_Call_T_result);
+	finish_graph(new_Proj(ress, mode_Is, 0));
+	return irg;
+}
+
+static void count_calls(ir_node *const node, void *const data)
+{
+	if (is_Call(node))
+		++*(unsigned*)data;
+}
+
+static unsigned get_n_calls(ir_graph *const irg)
+{
+	unsigned n_calls = 0;
+	irg_walk_graph(irg, NULL, count_calls, &n_calls);
+	return n_calls;
+}
+
+int main(void)
+{
+	ir_init();
+
+	ir_type *const int_type = get_type_for_mode(mode_Is);
+	ir_type *const mtp = new_type_method(1, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	set_method_param_type(mtp, 0, int_type);
+	set_method_res_type(mtp, 0, int_type);
+	ir_entity *const f = new_function("f", mtp);
+	ir_entity *const g = new_function("g", mtp);
+	ir_entity *const h = new_function("h", mtp);
+
+	/* keep the Mux for the first inlining run */
+	set_optimize(0);
+	build_f(f);
+	ir_graph *const g_irg = build_g(g, f, h);
+	set_optimize(1);
+
+	inline_functions(750, 0, NULL);
+	assert(get_n_calls(g_irg) == 1);
+
+	/* folds the Mux without clearing any graph property */
+	local_optimize_graph(g_irg);
+	inline_functions(750, 0, NULL);
+	assert(irg_verify(g_irg));
+	assert(get_n_calls(g_irg) == 0);
+
+	ir_finish();
+	return 0;
+}
@@ -0,0 +1,98 @@
+#include "firm.h"
+#include <assert.h>
+#include <stdbool.h>
+
+/*
+ * Builds
+ *
+ *   static int f(int x) { return x; }
+ *   int g(void) { return f(3) + f(5); }
+ *
+ * The known bits of x are only 0bxx1 = [1,7], the joined range is [3,5].
+ */
+static ir_entity *build_f(ir_type *const mtp)
+{
+	ir_entity *const ent = new_global_entity(get_glob_type(),
+		new_id_from_str("f"), mtp, ir_visibility_local, IR_LINKAGE_DEFAULT);
+	ir_graph *const irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+
+	ir_node *const x   = new_Proj(get_irg_args(irg), mode_Is, 0);
+	ir_node *const ret = new_Return(get_store(), 1, &x);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return ent;
+}
+
+static ir_node *call_f(ir_entity *const f, long const value)
+{
+	ir_node *const arg  = new_Const_long(mode_Is, value);
+	ir_node *const call = new_Call(get_store(), new_Address(f), 1, &arg,
+	                               get_entity_type(f));
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	ir_node *const ress = new_Proj(call, mode_T, pn_Call_T_result);
+	return new_Proj(ress, mode_Is, 0);
+}
+
+static ir_node *build_g(ir_entity *const f, ir_node **const res)
+{
+	ir_type *const mtp = new_type_method(0, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	set_method_res_type(mtp, 0, get_type_for_mode(mode_Is));
+	ir_entity *const ent = new_global_entity(get_glob_type(),
+		new_id_from_str("g"), mtp, ir_visibility_external,
+		IR_LINKAGE_DEFAULT);
+	ir_graph *const irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+
+	*res = call_f(f, 3);
+	ir_node *const sum = new_Add(*res, call_f(f, 5));
+	ir_node *const ret = new_Return(get_store(), 1, &sum);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return sum;
+}
+
+static void check_range(ir_node const *const node, long const bottom,
+                        long const top)
+{
+	vrp_attr const *const vrp = vrp_get_info(node);
+	assert(vrp != NULL && vrp->range_type == VRP_RANGE);
+	assert(get_tarval_long(vrp->range_bottom) == bottom);
+	assert(get_tarval_long(vrp->range_top) == top);
+}
+
+int main(void)
+{
+	ir_init();
+
+	ir_type *const int_type = get_type_for_mode(mode_Is);
+	ir_type *const mtp = new_type_method(1, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	set_method_param_type(mtp, 0, int_type);
+	set_method_res_type(mtp, 0, int_type);
+	ir_entity *const f = build_f(mtp);
+	ir_node        *res;
+	ir_node  *const sum = build_g(f, &res);
+
+	mark_private_methods();
+	compute_interprocedural_bits();
+
+	ir_graph *const f_irg = get_entity_irg(f);
+	set_vrp_data(f_irg);
+	ir_node *const ret = get_Block_cfgpred(get_irg_end_block(f_irg), 0);
+	check_range(get_Return_res(ret, 0), 3, 5);
+	free_vrp_data(f_irg);
+
+	/* the results of both calls are in [3,5] */
+	ir_graph *const g_irg = get_irn_irg(sum);
+	set_vrp_data(g_irg);
+	check_range(res, 3, 5);
+	check_range(sum, 6, 10);
+	free_vrp_data(g_irg);
+
+	ir_finish();
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include "firm.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * Builds
+ *
+ *   int f(void) { return 1; }
+ *   int g(void) { int a = 1; { int a = 2; } return a + f(); }
+ *
+ * and checks that reading the other local and changing the callee, which
+ * may be inlined, both change the key of g.
+ */
+static ir_type *int_type;
+static ir_type *mtp;
+
+static ir_entity *new_function(char const *const name)
+{
+	return new_global_entity(get_glob_type(), new_id_from_str(name), mtp,
+	                         ir_visibility_external, IR_LINKAGE_DEFAULT);
+}
+
+static void finish_graph(ir_node *const res)
+{
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(current_ir_graph), ret);
+	mature_immBlock(get_irg_end_block(current_ir_graph));
+	irg_finalize_cons(current_ir_graph);
+}
+
+static ir_node *build_f(ir_entity *const f)
+{
+	ir_graph *const irg = new_ir_graph(f, 0);
+	set_current_ir_graph(irg);
+	ir_node *const one = new_Const_long(mode_Is, 1);
+	finish_graph(one);
+	return one;
+}
+
+static void store_local(ir_entity *const local, long const value)
+{
+	ir_node *const ptr   = new_Member(get_irg_frame(current_ir_graph), local);
+	ir_node *const store = new_Store(get_store(), ptr,
+	                                 new_Const_long(mode_Is, value), int_type,
+	                                 cons_none);
+	set_store(new_Proj(store, mode_M, pn_Store_M));
+}
+
+static ir_node *build_g(ir_entity *const g, ir_entity *const f,
+                        ir_entity **const locals)
+{
+	ir_graph *const irg = new_ir_graph(g, 0);
+	set_current_ir_graph(irg);
+	ir_type *const frame = get_irg_frame_type(irg);
+	for (unsigned i = 0; i < 2; ++i) {
+		locals[i] = new_entity(frame, new_id_from_str("a"), int_type);
+		store_local(locals[i], i + 1);
+	}
+
+	ir_node *const ptr  = new_Member(get_irg_frame(irg), locals[0]);
+	ir_node *const load = new_Load(get_store(), ptr, mode_Is, int_type,
+	                               cons_none);
+	set_store(new_Proj(load, mode_M, pn_Load_M));
+	ir_node *const value = new_Proj(load, mode_Is, pn_Load_res);
+
+	ir_node *const call = new_Call(get_store(), new_Address(f), 0, NULL, mtp);
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	ir_node *const ress = new_Proj(call, mode_T, pn_Call_T_result);
+	finish_graph(new_Add(value, new_Proj(ress, mode_Is, 0)));
+	return ptr;
+}
+
+int main(void)
+{
+	ir_init();
+	int_type = get_type_for_mode(mode_Is);
+	mtp      = new_type_method(0, 1, false, cc_cdecl_set, mtp_no_property);
+	set_method_res_type(mtp, 0, int_type);
+
+	/* keep both locals and the call */
+	set_optimize(0);
+	ir_entity     *locals[2];
+	ir_entity     *f     = new_function("f");
+	ir_node *const f_res = build_f(f);
+	ir_node *const ptr   = build_g(new_function("g"), f, locals);
+	ir_graph *const irg  = get_irn_irg(ptr);
+	set_optimize(1);
+
+	ir_cache_t *const cache = ir_cache_open(".", 1 << 20, NULL);
+	char key[IR_CACHE_KEY_SIZE];
+	char first_key[IR_CACHE_KEY_SIZE];
+	char other_key[IR_CACHE_KEY_SIZE];
+	assert(ir_cache_key(cache, irg, first_key) == 0);
+	assert(ir_cache_key(cache, irg, key) == 0);
+	assert(strcmp(key, first_key) == 0);
+
+	/* read the other local */
+	set_Member_entity(ptr, locals[1]);
+	assert(ir_cache_key(cache, irg, other_key) == 0);
+	assert(strcmp(other_key, first_key) != 0);
+	set_Member_entity(ptr, locals[0]);
+	assert(ir_cache_key(cache, irg, key) == 0);
+	assert(strcmp(key, first_key) == 0);
+
+	/* change the result of the callee */
+	set_Const_tarval(f_res, new_tarval_from_long(2, mode_Is));
+	assert(ir_cache_key(cache, irg, key) == 0);
+	assert(strcmp(key, first_key) != 0);
+
+	ir_cache_close(cache);
+	ir_finish();
+	return 0;
+}
@@ -0,0 +1,49 @@
+#include "firm.h"
+#include "jit.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SLAB_SIZE ((uintptr_t)64 * 1024)
+
+static uintptr_t get_slab(void const *const block)
+{
+	return (uintptr_t)block & ~(SLAB_SIZE - 1);
+}
+
+static char *alloc_block(ir_jit_memory_t *const memory)
+{
+	char *const block = (char*)be_jit_memory_alloc(memory, 32);
+	/* faults if the block is not writable */
+	memset(block, 0, 32);
+	return block;
+}
+
+int main(void)
+{
+	ir_init();
+
+	uintptr_t const page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+	unsigned  const n_pages   = SLAB_SIZE / page_size;
+
+	/* protecting every block on its own costs a page, not a slab */
+	ir_jit_memory_t *const memory = be_new_jit_memory();
+	char *blocks[16];
+	for (unsigned i = 0; i < n_pages && i < 16; ++i) {
+		blocks[i] = alloc_block(memory);
+		be_jit_memory_protect(memory);
+		assert(get_slab(blocks[i]) == get_slab(blocks[0]));
+	}
+
+	/* an empty slab is written again */
+	for (unsigned i = 0; i < n_pages && i < 16; ++i)
+		be_jit_memory_free(memory, blocks[i]);
+	char *const reused = alloc_block(memory);
+	assert(get_slab(reused) == get_slab(blocks[0]));
+	be_jit_memory_protect(memory);
+
+	be_destroy_jit_memory(memory);
+	ir_finish();
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include "firm.h"
+#include <assert.h>
+#include <stdbool.h>
+
+/*
+ * Builds
+ *
+ *   int f(int n, int c) {
+ *     int s = 0;
+ *     for (int i = 0; i < n; ++i) if (c) s += i; else s -= i;
+ *     for (int j = 0; j < n; ++j) if (c) s += j; else s -= j;
+ *     return s;
+ *   }
+ *
+ * where the first loop exits directly into the header of the second one.
+ */
+static void build_loop(ir_node **const entry, ir_node *const n,
+                       ir_node *const c, int const slot)
+{
+	ir_node *const header = new_immBlock();
+	add_immBlock_pred(header, *entry);
+	set_cur_block(header);
+	ir_node *const cmp  = new_Cmp(get_value(slot, mode_Is), n, ir_relation_less);
+	ir_node *const cond = new_Cond(cmp);
+	ir_node *const body_x = new_Proj(cond, mode_X, pn_Cond_true);
+	*entry = new_Proj(cond, mode_X, pn_Cond_false);
+
+	ir_node *const body = new_immBlock();
+	add_immBlock_pred(body, body_x);
+	mature_immBlock(body);
+	set_cur_block(body);
+	ir_node *const zero  = new_Const_long(mode_Is, 0);
+	ir_node *const sel   = new_Cmp(c, zero, ir_relation_less_greater);
+	ir_node *const cond2 = new_Cond(sel);
+	ir_node *const then_x = new_Proj(cond2, mode_X, pn_Cond_true);
+	ir_node *const else_x = new_Proj(cond2, mode_X, pn_Cond_false);
+
+	ir_node *const then_block = new_immBlock();
+	add_immBlock_pred(then_block, then_x);
+	mature_immBlock(then_block);
+	set_cur_block(then_block);
+	set_value(0, new_Add(get_value(0, mode_Is), get_value(slot, mode_Is)));
+	ir_node *const then_jmp = new_Jmp();
+
+	ir_node *const else_block = new_immBlock();
+	add_immBlock_pred(else_block, else_x);
+	mature_immBlock(else_block);
+	set_cur_block(else_block);
+	set_value(0, new_Sub(get_value(0, mode_Is), get_value(slot, mode_Is)));
+	ir_node *const else_jmp = new_Jmp();
+
+	ir_node *const latch = new_immBlock();
+	add_immBlock_pred(latch, then_jmp);
+	add_immBlock_pred(latch, else_jmp);
+	mature_immBlock(latch);
+	set_cur_block(latch);
+	ir_node *const one = new_Const_long(mode_Is, 1);
+	set_value(slot, new_Add(get_value(slot, mode_Is), one));
+	add_immBlock_pred(header, new_Jmp());
+	mature_immBlock(header);
+}
+
+static void count_const_conds(ir_node *const node, void *const data)
+{
+	if (is_Cond(node) && is_Const(get_Cond_selector(node)))
+		++*(unsigned*)data;
+}
+
+int main(void)
+{
+	ir_init();
+
+	ir_type *const int_type = get_type_for_mode(mode_Is);
+	ir_type *const mtp = new_type_method(2, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	set_method_param_type(mtp, 0, int_type);
+	set_method_param_type(mtp, 1, int_type);
+	set_method_res_type(mtp, 0, int_type);
+	ir_entity *const ent = new_global_entity(get_glob_type(),
+		new_id_from_str("f"), mtp, ir_visibility_external, IR_LINKAGE_DEFAULT);
+
+	ir_graph *const irg = new_ir_graph(ent, 3);
+	set_current_ir_graph(irg);
+	ir_node *const args = get_irg_args(irg);
+	ir_node *const n    = new_Proj(args, mode_Is, 0);
+	ir_node *const c    = new_Proj(args, mode_Is, 1);
+	ir_node *const zero = new_Const_long(mode_Is, 0);
+	set_value(0, zero);
+	set_value(1, zero);
+	set_value(2, zero);
+	ir_node *entry = new_Jmp();
+	build_loop(&entry, n, c, 1);
+	build_loop(&entry, n, c, 2);
+
+	ir_node *const exit_block = new_immBlock();
+	add_immBlock_pred(exit_block, entry);
+	mature_immBlock(exit_block);
+	set_cur_block(exit_block);
+	ir_node *const res = get_value(0, mode_Is);
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	assert(irg_verify(irg));
+
+	unswitch_loops(irg, 1000);
+	assert(irg_verify(irg));
+
+	/* each unswitched loop leaves its Cond fixed in both copies */
+	unsigned n_const_conds = 0;
+	irg_walk_graph(irg, count_const_conds, NULL, &n_const_conds);
+	assert(n_const_conds == 4);
+
+	ir_finish();
+	return 0;
+}
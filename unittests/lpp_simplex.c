@@ -0,0 +1,99 @@
+#include "lpp.h"
+#include <assert.h>
+#include <math.h>
+
+static bool near(double const a, double const b)
+{
+	return fabs(a - b) < 1e-6;
+}
+
+/* max 3x + 2y  s.t.  x + y <= 4, x + 3y <= 6, x <= 3  =>  x = 3, y = 1 */
+static void test_feasible(void)
+{
+	lpp_t *const lpp = lpp_new("feasible", lpp_maximize);
+	int const x = lpp_add_var(lpp, "x", lpp_continous, 3.0);
+	int const y = lpp_add_var(lpp, "y", lpp_continous, 2.0);
+	int const c0 = lpp_add_cst(lpp, "c0", lpp_less_equal, 4.0);
+	lpp_set_factor_fast(lpp, c0, x, 1.0);
+	lpp_set_factor_fast(lpp, c0, y, 1.0);
+	int const c1 = lpp_add_cst(lpp, "c1", lpp_less_equal, 6.0);
+	lpp_set_factor_fast(lpp, c1, x, 1.0);
+	lpp_set_factor_fast(lpp, c1, y, 3.0);
+	int const c2 = lpp_add_cst(lpp, "c2", lpp_less_equal, 3.0);
+	lpp_set_factor_fast(lpp, c2, x, 1.0);
+
+	lpp_solve(lpp, "simplex");
+	assert(lpp_get_sol_state(lpp) == lpp_optimal);
+	assert(near(lpp->objval, 11.0));
+	assert(near(lpp_get_var_sol(lpp, x), 3.0));
+	assert(near(lpp_get_var_sol(lpp, y), 1.0));
+	lpp_free(lpp);
+}
+
+/* x + y >= 5 and x + y <= 3 contradict each other */
+static void test_infeasible(void)
+{
+	lpp_t *const lpp = lpp_new("infeasible", lpp_minimize);
+	int const x = lpp_add_var(lpp, "x", lpp_continous, 1.0);
+	int const y = lpp_add_var(lpp, "y", lpp_continous, 1.0);
+	int const c0 = lpp_add_cst(lpp, "c0", lpp_greater_equal, 5.0);
+	lpp_set_factor_fast(lpp, c0, x, 1.0);
+	lpp_set_factor_fast(lpp, c0, y, 1.0);
+	int const c1 = lpp_add_cst(lpp, "c1", lpp_less_equal, 3.0);
+	lpp_set_factor_fast(lpp, c1, x, 1.0);
+	lpp_set_factor_fast(lpp, c1, y, 1.0);
+
+	lpp_solve(lpp, "simplex");
+	assert(lpp_get_sol_state(lpp) == lpp_infeasible);
+	lpp_free(lpp);
+}
+
+/* max x + y  s.t.  x - y <= 1  grows without limit along x = y + 1 */
+static void test_unbounded(void)
+{
+	lpp_t *const lpp = lpp_new("unbounded", lpp_maximize);
+	int const x = lpp_add_var(lpp, "x", lpp_continous, 1.0);
+	int const y = lpp_add_var(lpp, "y", lpp_continous, 1.0);
+	int const c0 = lpp_add_cst(lpp, "c0", lpp_less_equal, 1.0);
+	lpp_set_factor_fast(lpp, c0, x, 1.0);
+	lpp_set_factor_fast(lpp, c0, y, -1.0);
+
+	lpp_solve(lpp, "simplex");
+	assert(lpp_get_sol_state(lpp) == lpp_unbounded);
+	lpp_free(lpp);
+}
+
+/* knapsack  max 8a + 11b + 6c + 4d  s.t.  5a + 7b + 4c + 3d <= 14
+ * The relaxation takes a, b and half of c (22), the integral optimum is
+ * b, c and d (21). */
+static void test_branching(void)
+{
+	lpp_t *const lpp = lpp_new("knapsack", lpp_maximize);
+	static double const value[]  = { 8.0, 11.0, 6.0, 4.0 };
+	static double const weight[] = { 5.0, 7.0, 4.0, 3.0 };
+	static char const *const name[] = { "a", "b", "c", "d" };
+	int const cap = lpp_add_cst(lpp, "capacity", lpp_less_equal, 14.0);
+	int var[4];
+	for (int i = 0; i < 4; ++i) {
+		var[i] = lpp_add_var(lpp, name[i], lpp_binary, value[i]);
+		lpp_set_factor_fast(lpp, cap, var[i], weight[i]);
+	}
+
+	lpp_solve(lpp, "simplex");
+	assert(lpp_get_sol_state(lpp) == lpp_optimal);
+	assert(near(lpp->objval, 21.0));
+	assert(near(lpp_get_var_sol(lpp, var[0]), 0.0));
+	assert(near(lpp_get_var_sol(lpp, var[1]), 1.0));
+	assert(near(lpp_get_var_sol(lpp, var[2]), 1.0));
+	assert(near(lpp_get_var_sol(lpp, var[3]), 1.0));
+	lpp_free(lpp);
+}
+
+int main(void)
+{
+	test_feasible();
+	test_infeasible();
+	test_unbounded();
+	test_branching();
+	return 0;
+}
@@ -0,0 +1,88 @@
+#include "firm.h"
+#include <assert.h>
+#include <stdbool.h>
+
+/*
+ * Builds
+ *
+ *   int f(void) { int x; x = 42; ext(); return x; }
+ *
+ * The address of x is never taken, so ext() can neither read nor modify it.
+ */
+static ir_graph *build_graph(char const *const name, ir_node **const load)
+{
+	ir_type *const int_type = get_type_for_mode(mode_Is);
+	ir_type *const ext_type = new_type_method(0, 0, false, cc_cdecl_set,
+	                                          mtp_no_property);
+	ir_entity *const ext = new_global_entity(get_glob_type(), id_unique("ext"),
+		ext_type, ir_visibility_external, IR_LINKAGE_DEFAULT);
+
+	ir_type *const mtp = new_type_method(0, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	set_method_res_type(mtp, 0, int_type);
+	ir_entity *const ent = new_global_entity(get_glob_type(),
+		new_id_from_str(name), mtp, ir_visibility_external,
+		IR_LINKAGE_DEFAULT);
+	ir_graph *const irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+
+	ir_entity *const x = new_entity(get_irg_frame_type(irg),
+	                                new_id_from_str("x"), int_type);
+	ir_node *const x_addr = new_Member(get_irg_frame(irg), x);
+
+	/* opt_ldst does not look at the start block */
+	ir_node *const jmp   = new_Jmp();
+	ir_node *const block = new_immBlock();
+	add_immBlock_pred(block, jmp);
+	mature_immBlock(block);
+	set_cur_block(block);
+
+	ir_node *const value = new_Const_long(mode_Is, 42);
+	ir_node *const store = new_Store(get_store(), x_addr, value, int_type,
+	                                 cons_none);
+	set_store(new_Proj(store, mode_M, pn_Store_M));
+
+	ir_node *const call = new_Call(get_store(), new_Address(ext), 0, NULL,
+	                               ext_type);
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+
+	*load = new_Load(get_store(), x_addr, mode_Is, int_type, cons_none);
+	set_store(new_Proj(*load, mode_M, pn_Load_M));
+	ir_node *const res = new_Proj(*load, mode_Is, pn_Load_res);
+
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+static ir_node *get_result(ir_graph *const irg)
+{
+	ir_node *const end_block = get_irg_end_block(irg);
+	ir_node *const ret       = get_Block_cfgpred(end_block, 0);
+	return skip_Id(get_Return_res(ret, 0));
+}
+
+int main(void)
+{
+	ir_init();
+
+	/* opt_ldst forwards the stored value across the call */
+	ir_node        *load;
+	ir_graph *const ldst = build_graph("f_ldst", &load);
+	opt_ldst(ldst);
+	assert(irg_verify(ldst));
+	ir_node *const res = get_result(ldst);
+	assert(is_Const(res) && get_tarval_long(get_Const_tarval(res)) == 42);
+
+	/* opt_parallelize_mem makes the load independent of the call */
+	ir_graph *const par = build_graph("f_par", &load);
+	opt_parallelize_mem(par);
+	assert(irg_verify(par));
+	ir_node *const mem = get_Load_mem(load);
+	assert(is_Proj(mem) && is_Store(get_Proj_pred(mem)));
+
+	ir_finish();
+	return 0;
+}
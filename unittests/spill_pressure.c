@@ -0,0 +1,127 @@
+#include "firm.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/*
+ * Builds
+ *
+ *   long long pressure(long long *a, int n)
+ *   {
+ *       long long v0 = a[0] + 0, ..., v19 = a[3] + 19;
+ *       for (int i = 0; i < n; ++i) {
+ *           long long x = a[i];
+ *           v0  = v0  * 3  + (x ^ 0);
+ *           ...
+ *           v19 = v19 * 22 + (x ^ 133);
+ *       }
+ *       return (...(v0 * 5 ^ v1) * 5 ^ ...) ^ v19;
+ *   }
+ *
+ * and compiles it for i686 with the loop spiller. Load/store optimization
+ * leaves four loaded values, which are used all over the start block. The
+ * backend verifier aborts if the register pressure exceeds the number of
+ * registers anywhere.
+ */
+#define N_VALUES 20
+
+static ir_type *long_type;
+
+static ir_node *load(ir_node *const base, ir_node *const index)
+{
+	ir_mode *const offset_mode = get_reference_offset_mode(mode_P);
+	ir_node *const offset = new_Mul(new_Conv(index, offset_mode),
+	                                new_Const_long(offset_mode, 8));
+	ir_node *const ptr  = new_Add(base, offset);
+	ir_node *const ld   = new_Load(get_store(), ptr, mode_Ls, long_type,
+	                               cons_none);
+	set_store(new_Proj(ld, mode_M, pn_Load_M));
+	return new_Proj(ld, mode_Ls, pn_Load_res);
+}
+
+static void build_pressure(ir_entity *const ent)
+{
+	ir_graph *const irg = new_ir_graph(ent, N_VALUES + 1);
+	set_current_ir_graph(irg);
+	ir_node *const args = get_irg_args(irg);
+	ir_node *const base = new_Proj(args, mode_P, 0);
+	ir_node *const n    = new_Proj(args, mode_Is, 1);
+	for (int k = 0; k < N_VALUES; ++k) {
+		ir_node *const value = load(base, new_Const_long(mode_Is, k % 4));
+		set_value(1 + k, new_Add(value, new_Const_long(mode_Ls, k)));
+	}
+
+	/* the loop counter is value 0 */
+	set_value(0, new_Const_long(mode_Is, 0));
+	ir_node *const entry = new_Jmp();
+	ir_node *const head  = new_immBlock();
+	add_immBlock_pred(head, entry);
+	set_cur_block(head);
+	ir_node *const cmp  = new_Cmp(get_value(0, mode_Is), n, ir_relation_less);
+	ir_node *const cond = new_Cond(cmp);
+
+	ir_node *const body = new_immBlock();
+	add_immBlock_pred(body, new_Proj(cond, mode_X, pn_Cond_true));
+	mature_immBlock(body);
+	set_cur_block(body);
+	ir_node *const i = get_value(0, mode_Is);
+	ir_node *const x = load(base, i);
+	for (int k = 0; k < N_VALUES; ++k) {
+		ir_node *const v   = get_value(1 + k, mode_Ls);
+		ir_node *const mul = new_Mul(v, new_Const_long(mode_Ls, 3 + k));
+		ir_node *const eor = new_Eor(x, new_Const_long(mode_Ls, k * 7));
+		set_value(1 + k, new_Add(mul, eor));
+	}
+	set_value(0, new_Add(i, new_Const_long(mode_Is, 1)));
+	add_immBlock_pred(head, new_Jmp());
+	mature_immBlock(head);
+
+	ir_node *const after = new_immBlock();
+	add_immBlock_pred(after, new_Proj(cond, mode_X, pn_Cond_false));
+	mature_immBlock(after);
+	set_cur_block(after);
+	ir_node *res = get_value(1, mode_Ls);
+	for (int k = 1; k < N_VALUES; ++k) {
+		ir_node *const mul = new_Mul(res, new_Const_long(mode_Ls, 5));
+		res = new_Eor(mul, get_value(1 + k, mode_Ls));
+	}
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+}
+
+int main(void)
+{
+	ir_init();
+	if (!ir_target_set("i686-linux-gnu"))
+		return 1;
+	if (ir_target_option("spill-algo=loop") != 1
+	 || ir_target_option("verify=1") != 1)
+		return 1;
+	ir_target_init();
+	long_type = get_type_for_mode(mode_Ls);
+
+	ir_type *const mtp = new_type_method(2, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	set_method_param_type(mtp, 0, new_type_pointer(long_type));
+	set_method_param_type(mtp, 1, get_type_for_mode(mode_Is));
+	set_method_res_type(mtp, 0, long_type);
+	ir_entity *const ent = new_global_entity(get_glob_type(),
+		new_id_from_str("pressure"), mtp, ir_visibility_external,
+		IR_LINKAGE_DEFAULT);
+	build_pressure(ent);
+
+	lower_highlevel();
+	ir_graph *const irg = get_entity_irg(ent);
+	optimize_graph_df(irg);
+	optimize_load_store(irg);
+	optimize_graph_df(irg);
+	be_lower_for_target();
+	FILE *const out = fopen("spill_pressure.s", "w");
+	assert(out != NULL);
+	be_main(out, "spill_pressure");
+	fclose(out);
+	ir_finish();
+	return 0;
+}
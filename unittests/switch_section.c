@@ -0,0 +1,132 @@
+#include "firm.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Builds
+ *
+ *   __attribute__((hot)) int sw(int x)
+ *   {
+ *       switch (x) { case 0: return 1; ... case 7: return 22; }
+ *       return -1;
+ *   }
+ *
+ *   __attribute__((hot)) int sw_cold(int x)
+ *   {
+ *       if (x > 100) { switch (x) { ... } }
+ *       return 0;
+ *   }
+ *
+ * and checks that the code behind the jump tables returns to .text.hot and
+ * .text.unlikely for the switch in the cold part of sw_cold, so the assembler
+ * can compute the sizes of the functions.
+ */
+#define N_CASES 8
+
+static ir_type *int_type;
+
+static ir_entity *new_function(char const *const name)
+{
+	ir_type *const mtp = new_type_method(1, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	set_method_param_type(mtp, 0, int_type);
+	set_method_res_type(mtp, 0, int_type);
+	ir_entity *const ent = new_global_entity(get_glob_type(),
+		new_id_from_str(name), mtp, ir_visibility_external,
+		IR_LINKAGE_DEFAULT);
+	add_entity_additional_properties(ent, mtp_property_hot);
+	return ent;
+}
+
+static void return_value(ir_node *const block, long const value)
+{
+	set_cur_block(block);
+	ir_node *const res = new_Const_long(mode_Is, value);
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(current_ir_graph), ret);
+}
+
+/** Switches over @p x in the current block. */
+static void build_switch(ir_node *const x)
+{
+	ir_graph        *const irg   = current_ir_graph;
+	ir_switch_table *const table = ir_new_switch_table(irg, N_CASES);
+	for (unsigned i = 0; i < N_CASES; ++i) {
+		ir_tarval *const value = new_tarval_from_long(i, mode_Is);
+		ir_switch_table_set(table, i, value, value, i + 1);
+	}
+	ir_node *const swtch = new_Switch(x, N_CASES + 1, table);
+	for (unsigned pn = 0; pn <= N_CASES; ++pn) {
+		ir_node *const proj  = new_Proj(swtch, mode_X, pn);
+		ir_node *const block = new_immBlock();
+		add_immBlock_pred(block, proj);
+		mature_immBlock(block);
+		return_value(block, pn == 0 ? -1 : (long)pn * 3 - 2);
+	}
+}
+
+static void build_sw(ir_entity *const ent)
+{
+	ir_graph *const irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+	build_switch(new_Proj(get_irg_args(irg), mode_Is, 0));
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+}
+
+static void build_sw_cold(ir_entity *const ent)
+{
+	ir_graph *const irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+	ir_node *const x     = new_Proj(get_irg_args(irg), mode_Is, 0);
+	ir_node *const limit = new_Const_long(mode_Is, 100);
+	ir_node *const cond  = new_Cond(new_Cmp(x, limit, ir_relation_greater));
+
+	ir_node *const cold = new_immBlock();
+	add_immBlock_pred(cold, new_Proj(cond, mode_X, pn_Cond_true));
+	mature_immBlock(cold);
+	set_cur_block(cold);
+	build_switch(x);
+
+	ir_node *const hot = new_immBlock();
+	add_immBlock_pred(hot, new_Proj(cond, mode_X, pn_Cond_false));
+	mature_immBlock(hot);
+	return_value(hot, 0);
+
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+}
+
+int main(void)
+{
+	ir_init();
+	if (!ir_target_set("x86_64-linux-gnu"))
+		return 1;
+	/* the switch of sw stays hot, the one of sw_cold is cold */
+	if (ir_target_option("blocksched-coldfreq=0.3") != 1)
+		return 1;
+	ir_target_init();
+	int_type = get_type_for_mode(mode_Is);
+
+	build_sw(new_function("sw"));
+	build_sw_cold(new_function("sw_cold"));
+
+	lower_highlevel();
+	be_lower_for_target();
+	char const *const asm_name = "switch_section.s";
+	FILE *const out = fopen(asm_name, "w");
+	assert(out != NULL);
+	be_main(out, "switch_section");
+	fclose(out);
+	ir_finish();
+
+#if defined(__x86_64__) && defined(__linux__)
+	/* fails with ".size expression for sw[.cold] does not evaluate to a
+	 * constant" if the code behind a jump table is in the wrong section */
+	int const res = system("cc -c -o switch_section.o switch_section.s");
+	assert(res == 0);
+#endif
+	return 0;
+}